@@ -321,7 +321,7 @@ void AISRecentEntryDetailView::set_entry(const AISRecentEntry& entry) {
 }
 
 AISAppView::AISAppView(NavigationView& nav) : nav_ { nav } {
-	baseband::run_image(portapack::spi_flash::image_tag_ais);
+	baseband::run_image(portapack::spi_flash::image_tag_graph);
 
 	add_children({
 		&label_channel,
@@ -353,6 +353,15 @@ AISAppView::AISAppView(NavigationView& nav) : nav_ { nav } {
     	receiver_model.set_baseband_bandwidth(baseband_bandwidth);
     	receiver_model.enable();  // Before using radio::enable(), but not updating Ant.DC-Bias.
 	
+	const baseband::GraphConfig graph_config {
+		baseband::graph::stages_ais,
+		sampling_rate,
+		taps_11k0_decim_0,
+		taps_11k0_decim_1,
+		taps_11k0_channel
+	};
+	graph_config.apply(0);
+	
 	options_channel.on_change = [this](size_t, OptionsField::value_t v) {
 		this->on_frequency_changed(v);
 	};
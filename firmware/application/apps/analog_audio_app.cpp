@@ -35,13 +35,29 @@ using namespace tonekey;
 #include "utility.hpp"
 
 #include "string_format.hpp"
+#include "dcs_codes.hpp"
 
 namespace ui {
 
+namespace {
+
+constexpr int32_t dcs_inverted_flag = 1 << 9;
+
+/* DCS codes are written in octal */
+std::string dcs_code_string(const uint16_t code) {
+	return {
+		static_cast<char>('0' + ((code >> 6) & 7)),
+		static_cast<char>('0' + ((code >> 3) & 7)),
+		static_cast<char>('0' + (code & 7))
+	};
+}
+
+} /* namespace */
+
 /* AMOptionsView *********************************************************/
 
 AMOptionsView::AMOptionsView(
-	const Rect parent_rect, const Style* const style
+	AnalogAudioView* view, const Rect parent_rect, const Style* const style
 ) : View { parent_rect }
 {
 	set_style(style);
@@ -52,15 +68,16 @@ AMOptionsView::AMOptionsView(
 	});
 
 	options_config.set_selected_index(receiver_model.am_configuration());
-	options_config.on_change = [this](size_t n, OptionsField::value_t) {
+	options_config.on_change = [this, view](size_t n, OptionsField::value_t) {
 		receiver_model.set_am_configuration(n);
+		view->show_cw_decode(receiver_model.am_cw());
 	};
 }
 
 /* NBFMOptionsView *******************************************************/
 
 NBFMOptionsView::NBFMOptionsView(
-	const Rect parent_rect, const Style* const style
+	AnalogAudioView* view, const Rect parent_rect, const Style* const style
 ) : View { parent_rect }
 {
 	set_style(style);
@@ -69,7 +86,8 @@ NBFMOptionsView::NBFMOptionsView(
 		&label_config,
 		&options_config,
 		&text_squelch,
-		&field_squelch
+		&field_squelch,
+		&options_dcs
 	});
 
 	options_config.set_selected_index(receiver_model.nbfm_configuration());
@@ -81,6 +99,17 @@ NBFMOptionsView::NBFMOptionsView(
 	field_squelch.on_change = [this](int32_t v) {
 		receiver_model.set_squelch_level(v);
 	};
+
+	OptionsField::options_t dcs_options { { "  off", 0 } };
+	for(const auto code : dcs::standard_codes) {
+		dcs_options.emplace_back("D" + dcs_code_string(code) + "N", code);
+		dcs_options.emplace_back("D" + dcs_code_string(code) + "I", code | dcs_inverted_flag);
+	}
+	options_dcs.set_options(dcs_options);
+	options_dcs.set_by_value(view->get_dcs_code() | (view->get_dcs_inverted() ? dcs_inverted_flag : 0));
+	options_dcs.on_change = [view](size_t, OptionsField::value_t v) {
+		view->set_dcs(v & dcs::code_mask, v & dcs_inverted_flag);
+	};
 }
 
 /* SPECOptionsView *******************************************************/
@@ -125,9 +154,12 @@ AnalogAudioView::AnalogAudioView(
 		&options_modulation,
 		&field_volume,
 		&text_ctcss,
+		&text_cw,
 		&record_view,
 		&waterfall
 	});
+	
+	text_cw.hidden(true);
 
 	// load app settings
 	auto rc = settings.load("rx_audio", &app_settings);
@@ -219,6 +251,24 @@ void AnalogAudioView::set_spec_trigger(uint16_t trigger) {
     baseband::set_spectrum(spec_bw, spec_trigger);
 }
 
+uint16_t AnalogAudioView::get_dcs_code() const {
+	return dcs_code;
+}
+
+bool AnalogAudioView::get_dcs_inverted() const {
+	return dcs_inverted;
+}
+
+void AnalogAudioView::set_dcs(const uint16_t code, const bool inverted) {
+	// Reconfiguring the decoder drops its lock, only do it for a new code
+	if ((code == dcs_code) && (inverted == dcs_inverted))
+		return;
+
+	dcs_code = code;
+	dcs_inverted = inverted;
+	baseband::set_dcs(code != 0, code, inverted);
+}
+
 AnalogAudioView::~AnalogAudioView() {
 
 	// save app settings
@@ -245,7 +295,8 @@ void AnalogAudioView::on_hide() {
 void AnalogAudioView::set_parent_rect(const Rect new_parent_rect) {
 	View::set_parent_rect(new_parent_rect);
 	
-	const ui::Rect waterfall_rect { 0, header_height, new_parent_rect.width(), new_parent_rect.height() - header_height };
+	const Dim top = header_height + (text_cw.hidden() ? 0 : 16);
+	const ui::Rect waterfall_rect { 0, top, new_parent_rect.width(), new_parent_rect.height() - top };
 	waterfall.set_parent_rect(waterfall_rect);
 }
 
@@ -322,26 +373,30 @@ void AnalogAudioView::on_show_options_modulation() {
 	const auto modulation = static_cast<ReceiverModel::Mode>(receiver_model.modulation());
 	switch(modulation) {
 	case ReceiverModel::Mode::AMAudio:
-		widget = std::make_unique<AMOptionsView>(options_view_rect, &style_options_group);
+		widget = std::make_unique<AMOptionsView>(this, options_view_rect, &style_options_group);
 		waterfall.show_audio_spectrum_view(false);
 		text_ctcss.hidden(true);
+		show_cw_decode(receiver_model.am_cw());
 		break;
 
 	case ReceiverModel::Mode::NarrowbandFMAudio:
-		widget = std::make_unique<NBFMOptionsView>(nbfm_view_rect, &style_options_group);
+		widget = std::make_unique<NBFMOptionsView>(this, nbfm_view_rect, &style_options_group);
 		waterfall.show_audio_spectrum_view(false);
 		text_ctcss.hidden(false);
+		show_cw_decode(false);
 		break;
 	
 	case ReceiverModel::Mode::WidebandFMAudio:
 		waterfall.show_audio_spectrum_view(true);
 		text_ctcss.hidden(true);
+		show_cw_decode(false);
 		break;
 	
 	case ReceiverModel::Mode::SpectrumAnalysis:
 		widget = std::make_unique<SPECOptionsView>(this, nbfm_view_rect, &style_options_group);
 		waterfall.show_audio_spectrum_view(false);
 		text_ctcss.hidden(true);
+		show_cw_decode(false);
 		break;
 		
 	default:
@@ -396,6 +451,10 @@ void AnalogAudioView::update_modulation(const ReceiverModel::Mode modulation) {
 
 	receiver_model.enable();
 
+	// A fresh NFM image doesn't gate, configure it only if a code is set
+	if ((modulation == ReceiverModel::Mode::NarrowbandFMAudio) && dcs_code)
+		baseband::set_dcs(true, dcs_code, dcs_inverted);
+
 	// TODO: This doesn't belong here! There's a better way.
 	size_t sampling_rate = 0;
 	switch(modulation) {
@@ -414,6 +473,9 @@ void AnalogAudioView::update_modulation(const ReceiverModel::Mode modulation) {
 
 
 void AnalogAudioView::handle_coded_squelch(const uint32_t value) {
+	if (dcs_present || !squelch_open)
+		return;
+	
 	float diff, min_diff = value;
 	size_t min_idx { 0 };
 	size_t c;
@@ -434,4 +496,43 @@ void AnalogAudioView::handle_coded_squelch(const uint32_t value) {
 		text_ctcss.set("???");
 }
 
+void AnalogAudioView::show_cw_decode(const bool show) {
+	if (text_cw.hidden() != show)
+		return;
+	
+	cw_text.clear();
+	text_cw.set("");
+	text_cw.hidden(!show);
+	
+	// Nothing to move yet while the view is being constructed
+	if (parent_rect())
+		set_parent_rect(parent_rect());
+}
+
+void AnalogAudioView::handle_cw(const CWRxMessage& message) {
+	if (message.character) {
+		cw_text += message.character;
+		if (cw_text.size() > 26)
+			cw_text.erase(0, cw_text.size() - 26);
+	}
+	
+	// Speed, a key indicator and the tail of the decoded text
+	text_cw.set(to_string_dec_uint(message.wpm, 2) + (message.key ? "* " : "  ") + cw_text);
+}
+
+void AnalogAudioView::handle_squelch(const SquelchEventMessage& message) {
+	squelch_open = message.open;
+	if (!squelch_open && !dcs_present)
+		text_ctcss.set("");
+}
+
+void AnalogAudioView::handle_dcs(const DCSMessage& message) {
+	dcs_present = (message.code != 0);
+	
+	if (dcs_present)
+		text_ctcss.set("D" + dcs_code_string(message.code) + (message.inverted ? "I " : "N ") + to_string_dec_uint(message.confidence, 3) + "%");
+	else
+		text_ctcss.set("");
+}
+
 } /* namespace ui */
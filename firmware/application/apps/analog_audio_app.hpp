@@ -41,9 +41,11 @@ constexpr Style style_options_group {
 	.foreground = Color::white(),
 };
 
+class AnalogAudioView;
+
 class AMOptionsView : public View {
 public:
-	AMOptionsView(const Rect parent_rect, const Style* const style);
+	AMOptionsView(AnalogAudioView* view, const Rect parent_rect, const Style* const style);
 
 private:
 	Text label_config {
@@ -65,7 +67,7 @@ private:
 
 class NBFMOptionsView : public View {
 public:
-	NBFMOptionsView(const Rect parent_rect, const Style* const style);
+	NBFMOptionsView(AnalogAudioView* view, const Rect parent_rect, const Style* const style);
 
 private:
 	Text label_config {
@@ -83,19 +85,26 @@ private:
 	};
 	
 	Text text_squelch {
-		{ 9 * 8, 0 * 16, 8 * 8, 1 * 16 },
-		"SQ   /99"
+		{ 8 * 8, 0 * 16, 2 * 8, 1 * 16 },
+		"SQ"
 	};
 	NumberField field_squelch {
-		{ 12 * 8, 0 * 16 },
+		{ 10 * 8, 0 * 16 },
 		2,
 		{ 0, 99 },
 		1,
 		' ',
 	};
-};
 
-class AnalogAudioView;
+	// Coded squelch, value is the code with bit 9 set for inverted
+	OptionsField options_dcs {
+		{ 13 * 8, 0 * 16 },
+		5,
+		{
+			{ "  off", 0 },
+		}
+	};
+};
 
 class SPECOptionsView : public View {
 public:
@@ -151,6 +160,13 @@ public:
 	uint16_t get_spec_trigger();
 	void set_spec_trigger(uint16_t trigger);
 
+	/* Coded squelch of this app only, code 0 passes audio regardless of DCS */
+	uint16_t get_dcs_code() const;
+	bool get_dcs_inverted() const;
+	void set_dcs(const uint16_t code, const bool inverted);
+
+	void show_cw_decode(const bool show);
+
 private:
 	static constexpr ui::Dim header_height = 3 * 16;
 
@@ -165,6 +181,9 @@ private:
 	uint32_t spec_bw = 20000000;
 	uint16_t spec_trigger = 63;
 
+	uint16_t dcs_code = 0;
+	bool dcs_inverted = false;
+
 	NavigationView& nav_;
 	//bool exit_on_squelch { false };
 	
@@ -216,6 +235,13 @@ private:
 		""
 	};
 
+	// Decoded Morse in CW mode, the waterfall moves down a row to make room
+	Text text_cw {
+		{ 0 * 8, 3 * 16, 30 * 8, 1 * 16 },
+		""
+	};
+	std::string cw_text { };
+
 	std::unique_ptr<Widget> options_widget { };
 
 	RecordView record_view {
@@ -246,6 +272,14 @@ private:
 	
 	//void squelched();
 	void handle_coded_squelch(const uint32_t value);
+	void handle_dcs(const DCSMessage& message);
+	void handle_cw(const CWRxMessage& message);
+	void handle_squelch(const SquelchEventMessage& message);
+
+	// Keeps the CTCSS estimate from overwriting a decoded DCS code
+	bool dcs_present { false };
+	// Tones are only worth showing while there's a signal
+	bool squelch_open { true };
 	
 	/*MessageHandlerRegistration message_handler_squelch_signal {
 		Message::ID::RequestSignal,
@@ -262,6 +296,30 @@ private:
 			this->handle_coded_squelch(message.value);
 		}
 	};
+	
+	MessageHandlerRegistration message_handler_dcs {
+		Message::ID::DCS,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const DCSMessage*>(p);
+			this->handle_dcs(message);
+		}
+	};
+
+	MessageHandlerRegistration message_handler_cw {
+		Message::ID::CWRx,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const CWRxMessage*>(p);
+			this->handle_cw(message);
+		}
+	};
+
+	MessageHandlerRegistration message_handler_squelch {
+		Message::ID::SquelchEvent,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const SquelchEventMessage*>(p);
+			this->handle_squelch(message);
+		}
+	};
 };
 
 } /* namespace ui */
@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "ism_app.hpp"
+
+#include "baseband_api.hpp"
+#include "encoders.hpp"
+#include "ui_encoders.hpp"
+
+#include "portapack.hpp"
+using namespace portapack;
+
+#include "string_format.hpp"
+
+namespace ism {
+
+namespace format {
+
+std::string protocol(const size_t index) {
+	return (index < protocols.size()) ? protocols[index].name : "?";
+}
+
+std::string coding(const PulseAnalysis& analysis) {
+	if( !analysis.valid ) {
+		return "unknown";
+	}
+
+	std::string result = (analysis.modulation == Modulation::FSK) ? "FSK " : "OOK ";
+	switch(analysis.coding) {
+	case Coding::PWM:			return result + "PWM";
+	case Coding::PPM:			return result + "PPM";
+	case Coding::Manchester:	return result + "Manchester";
+	case Coding::NRZ:			return result + "NRZ";
+	default:					return result + "?";
+	}
+}
+
+std::string timing(const PulseAnalysis& analysis) {
+	if( !analysis.valid ) {
+		return "-";
+	}
+
+	std::string result = to_string_dec_uint(analysis.short_us);
+	if( analysis.long_us != analysis.short_us ) {
+		result += "/" + to_string_dec_uint(analysis.long_us);
+	}
+	result += "us";
+	if( analysis.pulse_us ) {
+		result += " P" + to_string_dec_uint(analysis.pulse_us) + "us";
+	}
+	return result;
+}
+
+std::string clusters(const clusters_t& clusters) {
+	std::string result;
+	for(const auto& cluster : clusters) {
+		if( cluster.count ) {
+			result += to_string_dec_uint(cluster.width_us) + "x" + to_string_dec_uint(cluster.count) + " ";
+		}
+	}
+	return result.empty() ? "-" : result;
+}
+
+std::string data(const Record& record) {
+	std::string result;
+	const size_t bytes = (record.bit_count() + 7) / 8;
+	for(size_t i=0; i<bytes; i++) {
+		result += to_string_hex(record.byte(i), 2);
+	}
+	return result;
+}
+
+} /* namespace format */
+
+/* FNV-1a over the packed bits, so repeats of a packet land on one entry */
+static uint64_t digest(const Record& record) {
+	uint64_t hash = 14695981039346656037ULL;
+	const size_t bytes = (record.bit_count() + 7) / 8;
+	for(size_t i=0; i<bytes; i++) {
+		hash = (hash ^ record.byte(i)) * 1099511628211ULL;
+	}
+	return hash ^ record.bit_count();
+}
+
+} /* namespace ism */
+
+void ISMLogger::on_packet(const ism::Record& record, const uint32_t target_frequency) {
+	const auto tuning_frequency_str = to_string_dec_uint(target_frequency, 10);
+
+	std::string entry = tuning_frequency_str + " " + ism::format::protocol(record.protocol) + " " + to_string_dec_uint(record.bit_count()) + " " + ism::format::data(record);
+	log_file.write_entry(record.timestamp(), entry);
+}
+
+const ISMRecentEntry::Key ISMRecentEntry::invalid_key = { ism::protocols.size(), 0 };
+
+void ISMRecentEntry::update(const ism::Record& record) {
+	received_count++;
+	last_record = record;
+}
+
+namespace ui {
+
+template<>
+void RecentEntriesTable<ISMRecentEntries>::draw(
+	const Entry& entry,
+	const Rect& target_rect,
+	Painter& painter,
+	const Style& style
+) {
+	std::string line = ism::format::protocol(entry.protocol);
+	line.resize(9, ' ');
+
+	auto data = ism::format::data(entry.last_record);
+	if( data.size() > 10 ) {
+		data.resize(9);
+		data += "+";
+	}
+	data.resize(10, ' ');
+	line += " " + data;
+
+	line += " " + to_string_dec_uint(entry.last_record.bit_count(), 3);
+
+	if( entry.received_count > 999 ) {
+		line += " +++";
+	} else {
+		line += " " + to_string_dec_uint(entry.received_count, 3);
+	}
+
+	line.resize(target_rect.width() / 8, ' ');
+	painter.draw_string(target_rect.location(), style, line);
+}
+
+PulseAnalysisView::PulseAnalysisView() {
+	add_children({
+		&labels,
+		&text_trains,
+		&text_pulses,
+		&text_coding,
+		&text_timing,
+		&text_sync,
+		&text_highs,
+		&text_lows,
+		&text_data,
+		&button_export,
+	});
+
+	button_export.on_select = [this](Button&) {
+		if( on_export ) {
+			on_export();
+		}
+	};
+}
+
+void PulseAnalysisView::focus() {
+	button_export.focus();
+}
+
+void PulseAnalysisView::on_analysis(const ism::PulseAnalysis& analysis) {
+	text_trains.set(to_string_dec_uint(analysis.trains));
+	text_pulses.set(to_string_dec_uint(analysis.pulses));
+	text_coding.set(ism::format::coding(analysis));
+	text_timing.set(ism::format::timing(analysis));
+	text_sync.set(analysis.sync_us ? (to_string_dec_uint(analysis.sync_us) + "us") : "-");
+	text_highs.set(ism::format::clusters(analysis.highs));
+	text_lows.set(ism::format::clusters(analysis.lows));
+
+	if( analysis.record.bit_count() ) {
+		text_data.set(to_string_dec_uint(analysis.record.bit_count()) + "b " + ism::format::data(analysis.record));
+	} else {
+		text_data.set("-");
+	}
+}
+
+ISMAppView::ISMAppView(
+	NavigationView& nav
+) : nav_ { nav }
+{
+	baseband::run_image(portapack::spi_flash::image_tag_ism);
+
+	add_children({
+		&rssi,
+		&channel,
+		&options_band,
+		&options_mode,
+		&field_rf_amp,
+		&field_lna,
+		&field_vga,
+		&recent_entries_view,
+		&analysis_view,
+	});
+
+	// load app settings
+	auto rc = settings.load("rx_ism", &app_settings);
+	if(rc == SETTINGS_OK) {
+		field_lna.set_value(app_settings.lna);
+		field_vga.set_value(app_settings.vga);
+		field_rf_amp.set_value(app_settings.rx_amp);
+		target_frequency_ = app_settings.rx_frequency;
+	}
+
+	radio::enable({
+		tuning_frequency(),
+		sampling_rate,
+		baseband_bandwidth,
+		rf::Direction::Receive,
+		receiver_model.rf_amp(),
+		static_cast<int8_t>(receiver_model.lna()),
+		static_cast<int8_t>(receiver_model.vga()),
+	});
+
+	options_band.on_change = [this](size_t, OptionsField::value_t v) {
+		this->on_band_changed(v);
+	};
+	options_band.set_by_value(target_frequency());
+
+	options_mode.on_change = [this](size_t, OptionsField::value_t v) {
+		this->on_mode_changed(v == 1);
+	};
+	options_mode.set_selected_index(0);
+	on_mode_changed(false);
+
+	analysis_view.on_export = [this]() {
+		this->on_export();
+	};
+
+	logger = std::make_unique<ISMLogger>();
+	if( logger ) {
+		logger->append(u"ism.txt");
+	}
+}
+
+ISMAppView::~ISMAppView() {
+	// save app settings
+	app_settings.rx_frequency = target_frequency_;
+	settings.save("rx_ism", &app_settings);
+
+	radio::disable();
+
+	baseband::shutdown();
+}
+
+void ISMAppView::focus() {
+	options_band.focus();
+}
+
+void ISMAppView::set_parent_rect(const Rect new_parent_rect) {
+	View::set_parent_rect(new_parent_rect);
+
+	const Rect content_rect { 0, header_height, new_parent_rect.width(), new_parent_rect.height() - header_height };
+	recent_entries_view.set_parent_rect(content_rect);
+	analysis_view.set_parent_rect(content_rect);
+}
+
+void ISMAppView::on_mode_changed(const bool analyze) {
+	recent_entries_view.hidden(analyze);
+	analysis_view.hidden(!analyze);
+
+	last_analysis = { };
+	analysis_view.on_analysis(last_analysis);
+
+	baseband::set_ism(analyze);
+	set_dirty();
+}
+
+void ISMAppView::on_analysis(const ism::PulseAnalysis& analysis) {
+	last_analysis = analysis;
+	analysis_view.on_analysis(last_analysis);
+}
+
+void ISMAppView::on_export() {
+	encoders::encoder_def_t def;
+	switch( encoders::make_encoder_def(last_analysis, def) ) {
+	case encoders::LearnResult::Ok:
+		break;
+
+	case encoders::LearnResult::SyncTooLong:
+		nav_.display_modal("Error", "Sync gap too long\nfor the encoder.");
+		return;
+
+	default:
+		nav_.display_modal("Error", "No OOK timing\nlearned yet.");
+		return;
+	}
+
+	// Replacing this view destroys it, only use locals from here on
+	const auto word = encoders::make_word(last_analysis.record, def);
+	auto& nav = nav_;
+	nav.replace<EncodersView>(def, word);
+}
+
+void ISMAppView::on_packet(const ism::Record& record) {
+	if( logger ) {
+		logger->on_packet(record, target_frequency());
+	}
+
+	auto& entry = ::on_packet(recent, ISMRecentEntry::Key { record.protocol, ism::digest(record) });
+	entry.update(record);
+	recent_entries_view.set_dirty();
+}
+
+void ISMAppView::on_band_changed(const uint32_t new_band_frequency) {
+	set_target_frequency(new_band_frequency);
+}
+
+void ISMAppView::set_target_frequency(const uint32_t new_value) {
+	target_frequency_ = new_value;
+	radio::set_tuning_frequency(tuning_frequency());
+}
+
+uint32_t ISMAppView::target_frequency() const {
+	return target_frequency_;
+}
+
+uint32_t ISMAppView::tuning_frequency() const {
+	return target_frequency() - (sampling_rate / 4);
+}
+
+} /* namespace ui */
@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __ISM_APP_H__
+#define __ISM_APP_H__
+
+#include "ui_widget.hpp"
+#include "ui_navigation.hpp"
+#include "ui_receiver.hpp"
+#include "ui_rssi.hpp"
+#include "ui_channel.hpp"
+#include "app_settings.hpp"
+#include "event_m0.hpp"
+
+#include "log_file.hpp"
+
+#include "recent_entries.hpp"
+
+#include "ism_packet.hpp"
+
+struct ISMRecentEntry {
+	/* Protocol index and a digest of the decoded bits */
+	using Key = std::pair<size_t, uint64_t>;
+
+	static const Key invalid_key;
+
+	size_t protocol { invalid_key.first };
+	uint64_t digest { invalid_key.second };
+
+	size_t received_count { 0 };
+
+	ism::Record last_record { };
+
+	ISMRecentEntry(
+		const Key& key
+	) : protocol { key.first },
+		digest { key.second }
+	{
+	}
+
+	Key key() const {
+		return { protocol, digest };
+	}
+
+	void update(const ism::Record& record);
+};
+
+using ISMRecentEntries = RecentEntries<ISMRecentEntry>;
+
+class ISMLogger {
+public:
+	Optional<File::Error> append(const std::filesystem::path& filename) {
+		return log_file.append(filename);
+	}
+
+	void on_packet(const ism::Record& record, const uint32_t target_frequency);
+
+private:
+	LogFile log_file { };
+};
+
+namespace ui {
+
+using ISMRecentEntriesView = RecentEntriesView<ISMRecentEntries>;
+
+/* Results of the M4 pulse analyzer, for reverse-engineering unknown devices */
+class PulseAnalysisView : public View {
+public:
+	std::function<void()> on_export { };
+
+	PulseAnalysisView();
+
+	void focus() override;
+
+	void on_analysis(const ism::PulseAnalysis& analysis);
+
+private:
+	Labels labels {
+		{ { 0 * 8, 0 * 16 }, "Trains:", Color::light_grey() },
+		{ { 14 * 8, 0 * 16 }, "Pulses:", Color::light_grey() },
+		{ { 0 * 8, 1 * 16 }, "Coding:", Color::light_grey() },
+		{ { 0 * 8, 2 * 16 }, "Timing:", Color::light_grey() },
+		{ { 0 * 8, 3 * 16 }, "Sync:", Color::light_grey() },
+		{ { 0 * 8, 4 * 16 }, "Highs:", Color::light_grey() },
+		{ { 0 * 8, 5 * 16 }, "Lows:", Color::light_grey() },
+		{ { 0 * 8, 6 * 16 }, "Data:", Color::light_grey() },
+	};
+
+	Text text_trains {
+		{ 8 * 8, 0 * 16, 6 * 8, 16 },
+		"0"
+	};
+
+	Text text_pulses {
+		{ 22 * 8, 0 * 16, 8 * 8, 16 },
+		"0"
+	};
+
+	Text text_coding {
+		{ 8 * 8, 1 * 16, 22 * 8, 16 },
+		"-"
+	};
+
+	Text text_timing {
+		{ 8 * 8, 2 * 16, 22 * 8, 16 },
+		"-"
+	};
+
+	Text text_sync {
+		{ 8 * 8, 3 * 16, 22 * 8, 16 },
+		"-"
+	};
+
+	Text text_highs {
+		{ 7 * 8, 4 * 16, 23 * 8, 16 },
+		"-"
+	};
+
+	Text text_lows {
+		{ 7 * 8, 5 * 16, 23 * 8, 16 },
+		"-"
+	};
+
+	Text text_data {
+		{ 0 * 8, 7 * 16, 30 * 8, 32 },
+		"-"
+	};
+
+	Button button_export {
+		{ 8 * 8, 10 * 16, 14 * 8, 32 },
+		"To OOK TX"
+	};
+};
+
+class ISMAppView : public View {
+public:
+	ISMAppView(NavigationView& nav);
+	~ISMAppView();
+
+	void set_parent_rect(const Rect new_parent_rect) override;
+
+	// Prevent painting of region covered entirely by a child.
+	// TODO: Add flag to View that specifies view does not need to be cleared before painting.
+	void paint(Painter&) override { };
+
+	void focus() override;
+
+	std::string title() const override { return "ISM RX"; };
+
+private:
+	static constexpr uint32_t initial_target_frequency = 433920000;
+	static constexpr uint32_t sampling_rate = 2457600;
+	static constexpr uint32_t baseband_bandwidth = 1750000;
+
+	// app save settings
+	std::app_settings 		settings { };
+	std::app_settings::AppSettings 	app_settings { };
+
+	MessageHandlerRegistration message_handler_packet {
+		Message::ID::ISMPacket,
+		[this](Message* const p) {
+			const auto message = static_cast<const ISMPacketMessage*>(p);
+			this->on_packet(message->record);
+		}
+	};
+
+	MessageHandlerRegistration message_handler_analysis {
+		Message::ID::PulseAnalysis,
+		[this](Message* const p) {
+			const auto message = static_cast<const PulseAnalysisMessage*>(p);
+			this->on_analysis(message->analysis);
+		}
+	};
+
+	static constexpr ui::Dim header_height = 1 * 16;
+
+	NavigationView& nav_;
+
+	RSSI rssi {
+		{ 21 * 8, 0, 6 * 8, 4 },
+	};
+
+	Channel channel {
+		{ 21 * 8, 5, 6 * 8, 4 },
+	};
+
+	OptionsField options_band {
+		{ 0 * 8, 0 * 16 },
+		5,
+		{
+			{ "315.0", 315000000 },
+			{ "433.9", 433920000 },
+			{ "868.3", 868300000 },
+		}
+	};
+
+	OptionsField options_mode {
+		{ 6 * 8, 0 * 16 },
+		3,
+		{
+			{ "Dec", 0 },
+			{ "Ana", 1 },
+		}
+	};
+
+	RFAmpField field_rf_amp {
+		{ 13 * 8, 0 * 16 }
+	};
+
+	LNAGainField field_lna {
+		{ 15 * 8, 0 * 16 }
+	};
+
+	VGAGainField field_vga {
+		{ 18 * 8, 0 * 16 }
+	};
+
+	ISMRecentEntries recent { };
+	std::unique_ptr<ISMLogger> logger { };
+
+	const RecentEntriesColumns columns { {
+		{ "Protocol", 9 },
+		{ "Data", 10 },
+		{ "Bit", 3 },
+		{ "Cnt", 3 },
+	} };
+	ISMRecentEntriesView recent_entries_view { columns, recent };
+
+	PulseAnalysisView analysis_view { };
+	ism::PulseAnalysis last_analysis { };
+
+	uint32_t target_frequency_ = initial_target_frequency;
+
+	void on_packet(const ism::Record& record);
+	void on_analysis(const ism::PulseAnalysis& analysis);
+	void on_mode_changed(const bool analyze);
+	void on_export();
+
+	void on_band_changed(const uint32_t new_band_frequency);
+
+	uint32_t target_frequency() const;
+	void set_target_frequency(const uint32_t new_value);
+
+	uint32_t tuning_frequency() const;
+};
+
+} /* namespace ui */
+
+#endif/*__ISM_APP_H__*/
@@ -50,6 +50,12 @@ void POCSAGLogger::log_decoded(
 	log_file.write_entry(packet.timestamp(), text);
 }
 
+void POCSAGLogger::log_flex(const flex::Phase& phase, const flex::Page& page) {
+	log_file.write_entry(phase.timestamp,
+		"FLEX " + flex::phase_str(phase) + " " + to_string_dec_uint(page.capcode) + " " +
+		flex::page_type_str(page.type) + ": " + page.text);
+}
+
 namespace ui {
 
 void POCSAGAppView::update_freq(rf::Frequency f) {
@@ -234,6 +240,36 @@ void POCSAGAppView::on_packet(const POCSAGPacketMessage * message) {
 		logger->log_raw_data(message->packet, target_frequency());
 }
 
+void POCSAGAppView::on_flex_phases(FLEXPhaseFIFO* const fifo) {
+	while( fifo->out(flex_phase) ) {
+		flex_pages.clear();
+		flex::decode_phase(flex_phase, flex_pages);
+		for(const auto& page : flex_pages) {
+			on_flex_page(flex_phase, page);
+		}
+	}
+}
+
+void POCSAGAppView::on_flex_page(const flex::Phase& phase, const flex::Page& page) {
+	if( ignore && (page.capcode == sym_ignore.value_dec_u32()) ) {
+		return;
+	}
+
+	console.writeln(
+		"\n" + to_string_datetime(phase.timestamp, HM) +
+		" FLEX " + flex::phase_str(phase) +
+		" CAP:" + to_string_dec_uint(page.capcode) +
+		" " + flex::page_type_str(page.type)
+	);
+	if( !page.text.empty() ) {
+		console.write(page.text + (page.fragment ? "..." : ""));
+	}
+
+	if( logger && logging ) {
+		logger->log_flex(phase, page);
+	}
+}
+
 void POCSAGAppView::set_target_frequency(const uint32_t new_value) {
 	target_frequency_ = new_value;
 	receiver_model.set_tuning_frequency(new_value);
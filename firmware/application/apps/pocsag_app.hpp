@@ -31,6 +31,7 @@
 #include "app_settings.hpp"
 #include "pocsag.hpp"
 #include "pocsag_packet.hpp"
+#include "flex.hpp"
 
 class POCSAGLogger {
 public:
@@ -40,6 +41,7 @@ public:
 	
 	void log_raw_data(const pocsag::POCSAGPacket& packet, const uint32_t frequency);
 	void log_decoded(const pocsag::POCSAGPacket& packet, const std::string text);
+	void log_flex(const flex::Phase& phase, const flex::Page& page);
 
 private:
 	LogFile log_file { };
@@ -68,6 +70,8 @@ private:
 	bool ignore { true };
 	uint32_t last_address = 0xFFFFFFFF;
 	pocsag::POCSAGState pocsag_state { };
+	flex::Phase flex_phase { };
+	std::vector<flex::Page> flex_pages { };
 
 	RFAmpField field_rf_amp {
 		{ 13 * 8, 0 * 16 }
@@ -128,6 +132,8 @@ private:
 	void update_freq(rf::Frequency f);
 
 	void on_packet(const POCSAGPacketMessage * message);
+	void on_flex_phases(FLEXPhaseFIFO* const fifo);
+	void on_flex_page(const flex::Phase& phase, const flex::Page& page);
 
 	void on_headphone_volume_changed(int32_t v);
 
@@ -141,6 +147,14 @@ private:
 			this->on_packet(message);
 		}
 	};
+
+	MessageHandlerRegistration message_handler_flex {
+		Message::ID::FLEXPhase,
+		[this](Message* const p) {
+			const auto message = static_cast<const FLEXPhaseMessage*>(p);
+			this->on_flex_phases(message->fifo);
+		}
+	};
 };
 
 } /* namespace ui */
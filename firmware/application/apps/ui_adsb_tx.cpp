@@ -23,7 +23,6 @@
 #include "ui_adsb_tx.hpp"
 #include "ui_alphanum.hpp"
 
-#include "manchester.hpp"
 #include "string_format.hpp"
 #include "portapack.hpp"
 #include "baseband_api.hpp"
@@ -100,20 +99,14 @@ ADSBPositionView::ADSBPositionView(
 	};
 }
 
-void ADSBPositionView::collect_frames(const uint32_t ICAO_address, std::vector<ADSBFrame>& frame_list) {
-	if (!enabled) return;
+void ADSBPositionView::collect(AircraftConfig& aircraft) {
+	// Also the center of the random traffic, squitters or not
+	aircraft.latitude = geopos.lat();
+	aircraft.longitude = geopos.lon();
+	aircraft.altitude = geopos.altitude();
 	
-	ADSBFrame temp_frame;
-	
-	encode_frame_pos(temp_frame, ICAO_address, geopos.altitude(),
-		geopos.lat(), geopos.lon(), 0);
-	
-	frame_list.emplace_back(temp_frame);
-	
-	encode_frame_pos(temp_frame, ICAO_address, geopos.altitude(),
-		geopos.lat(), geopos.lon(), 1);
-		
-	frame_list.emplace_back(temp_frame);
+	if (enabled)
+		aircraft.squitters |= SQUITTER_POSITION;
 }
 
 ADSBCallsignView::ADSBCallsignView(
@@ -143,14 +136,12 @@ ADSBCallsignView::ADSBCallsignView(
 	};
 }
 
-void ADSBCallsignView::collect_frames(const uint32_t ICAO_address, std::vector<ADSBFrame>& frame_list) {
-	if (!enabled) return;
-	
-	ADSBFrame temp_frame;
+void ADSBCallsignView::collect(AircraftConfig& aircraft) {
+	strncpy(aircraft.callsign, callsign.c_str(), sizeof(aircraft.callsign) - 1);
+	aircraft.callsign[sizeof(aircraft.callsign) - 1] = 0;
 	
-	encode_frame_id(temp_frame, ICAO_address, callsign);
-	
-	frame_list.emplace_back(temp_frame);
+	if (enabled)
+		aircraft.squitters |= SQUITTER_IDENTITY;
 }
 
 ADSBSpeedView::ADSBSpeedView(
@@ -163,26 +154,26 @@ ADSBSpeedView::ADSBSpeedView(
 		&labels_speed,
 		&compass,
 		&field_angle,
-		&field_speed
+		&field_speed,
+		&field_v_rate
 	});
 	
 	field_angle.set_value(0);
 	field_speed.set_value(400);
+	field_v_rate.set_value(0);
 	
 	field_angle.on_change = [this](int32_t v) {
 		compass.set_value(v);
 	};
 }
 
-void ADSBSpeedView::collect_frames(const uint32_t ICAO_address, std::vector<ADSBFrame>& frame_list) {
-	if (!enabled) return;
-	
-	ADSBFrame temp_frame;
+void ADSBSpeedView::collect(AircraftConfig& aircraft) {
+	aircraft.speed = field_speed.value();
+	aircraft.heading = field_angle.value();
+	aircraft.v_rate = field_v_rate.value();
 	
-	encode_frame_velo(temp_frame, ICAO_address, field_speed.value(),
-		field_angle.value(), 0);	// TODO: v_rate
-	
-	frame_list.emplace_back(temp_frame);
+	if (enabled)
+		aircraft.squitters |= SQUITTER_VELOCITY;
 }
 
 ADSBSquawkView::ADSBSquawkView(
@@ -197,86 +188,12 @@ ADSBSquawkView::ADSBSquawkView(
 	});
 }
 
-void ADSBSquawkView::collect_frames(const uint32_t ICAO_address, std::vector<ADSBFrame>& frame_list) {
-	if (!enabled) return;
-	
-	ADSBFrame temp_frame;
-	(void)ICAO_address;
+void ADSBSquawkView::collect(AircraftConfig& aircraft) {
+	// The OCT field holds one digit per nibble, as encode_id13 expects
+	aircraft.squawk = field_squawk.value_hex_u64();
 	
-	encode_frame_squawk(temp_frame, field_squawk.value_dec_u32());
-	
-	frame_list.emplace_back(temp_frame);
-}
-
-ADSBTXThread::ADSBTXThread(
-	std::vector<ADSBFrame> frames
-) : frames_ {  std::move(frames) }
-{
-	thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 10, ADSBTXThread::static_fn, this);
-}
-
-ADSBTXThread::~ADSBTXThread() {
-	if( thread ) {
-		chThdTerminate(thread);
-		chThdWait(thread);
-		thread = nullptr;
-	}
-}
-
-msg_t ADSBTXThread::static_fn(void* arg) {
-	auto obj = static_cast<ADSBTXThread*>(arg);
-	obj->run();
-	return 0;
-}
-
-void ADSBTXThread::run() {
-	uint8_t * bin_ptr = shared_memory.bb_data.data;
-	uint8_t * raw_ptr;
-	uint32_t frame_index = 0;	//, plane_index = 0;
-	//uint32_t regen = 0;
-	//float offs = 0;
-	
-	while( !chThdShouldTerminate() ) {
-		/*if (!regen) {
-			regen = 10;
-			
-			encode_frame_id(frames[0], plane_index, "DEMO" + to_string_dec_uint(plane_index));
-			encode_frame_pos(frames[1], plane_index, 5000, plane_lats[plane_index]/8 + offs + 38.5, plane_lons[plane_index]/8 + 125.8, 0);
-			encode_frame_pos(frames[2], plane_index, 5000, plane_lats[plane_index]/8 + offs + 38.5, plane_lons[plane_index]/8 + 125.8, 1);
-			encode_frame_identity(frames[3], plane_index, 1337);
-			
-			if (plane_index == 11)
-				plane_index = 0;
-			else
-				plane_index++;
-			
-			offs += 0.001;
-		}*/
-		
-		memset(bin_ptr, 0, 256);	// 112 bits * 2 parts = 224 should be enough
-		
-		raw_ptr = frames_[frame_index].get_raw_data();
-		
-		// The preamble isn't manchester encoded
-		memcpy(bin_ptr, adsb_preamble, 16);
-		
-		// Convert to binary (1 byte per bit, faster for baseband code)
-		manchester_encode(bin_ptr + 16, raw_ptr, 112, 0);
-	
-		// Display in hex for debug
-		//text_frame.set(to_string_hex_array(frames[0].get_raw_data(), 14));
-	
-		baseband::set_adsb();
-		
-		chThdSleepMilliseconds(50);
-		
-		frame_index++;
-		if (frame_index >= frames_.size()) {
-			frame_index = 0;
-			//if (regen)
-			//	regen--;
-		}
-	}
+	if (enabled)
+		aircraft.squitters |= SQUITTER_STATUS;
 }
 
 void ADSBTxView::focus() {
@@ -293,34 +210,32 @@ ADSBTxView::~ADSBTxView() {
 	baseband::shutdown();
 }
 
-void ADSBTxView::generate_frames() {
-	const uint32_t ICAO_address = sym_icao.value_hex_u64();
-	
-	frames.clear();
+void ADSBTxView::start_tx() {
+	AircraftConfig aircraft { };
 	
-	/* This scheme kinda sucks. Each "tab"'s collect_frames method
-	 * is called to generate its related frame(s). Getting values
-	 * from each widget of each tab would be better ?
-	 * */
-	view_position.collect_frames(ICAO_address, frames);
-	view_callsign.collect_frames(ICAO_address, frames);
-	view_speed.collect_frames(ICAO_address, frames);
-	view_squawk.collect_frames(ICAO_address, frames);
+	aircraft.ICAO_address = sym_icao.value_hex_u64();
 	
-	// Show how many frames were generated
-	//text_frame.set(to_string_dec_uint(frames.size()) + " frame(s).");
-}
-
-void ADSBTxView::start_tx() {
-	generate_frames();
+	/* Each tab fills in its part of the aircraft and enables its squitter.
+	 * Encoding and scheduling are done by the baseband.
+	 */
+	view_position.collect(aircraft);
+	view_callsign.collect(aircraft);
+	view_speed.collect(aircraft);
+	view_squawk.collect(aircraft);
 	
-	transmitter_model.set_sampling_rate(4000000U);
+	// The baseband puts the frames fs/4 above the LO, away from its leakage
+	transmitter_model.set_sampling_rate(8000000U);
+	transmitter_model.set_tuning_offset(-(8000000 / 4));
 	transmitter_model.set_baseband_bandwidth(10000000);
 	transmitter_model.enable();
 	
-	baseband::set_adsb();
+	baseband::set_adsb_traffic(aircraft, field_traffic.value(), traffic_radius_nm, chTimeNow());
 	
-	tx_thread = std::make_unique<ADSBTXThread>(frames);
+	text_frame.set("-");
+}
+
+void ADSBTxView::on_tx_progress(const uint32_t progress) {
+	text_frame.set(to_string_dec_uint(progress) + " frames");
 }
 
 ADSBTxView::ADSBTxView(
@@ -333,6 +248,7 @@ ADSBTxView::ADSBTxView(
 		&tab_view,
 		&labels,
 		&sym_icao,
+		&field_traffic,
 		&view_position,
 		&view_callsign,
 		&view_speed,
@@ -349,6 +265,8 @@ ADSBTxView::ADSBTxView(
 		transmitter_model.set_tx_gain(app_settings.tx_gain);		
 	}
 
+	field_traffic.set_value(0);
+	
 	tx_view.on_edit_frequency = [this, &nav]() {
 		auto new_view = nav.push<FrequencyKeypadView>(receiver_model.tuning_frequency());
 		new_view->on_changed = [this](rf::Frequency f) {
@@ -22,6 +22,7 @@
 
 #include "ui.hpp"
 #include "adsb.hpp"
+#include "adsb_traffic.hpp"
 #include "ui_textentry.hpp"
 #include "ui_geomap.hpp"
 #include "ui_tabview.hpp"
@@ -52,7 +53,7 @@ class ADSBPositionView : public OptionTabView {
 public:
 	ADSBPositionView(NavigationView& nav, Rect parent_rect);
 	
-	void collect_frames(const uint32_t ICAO_address, std::vector<ADSBFrame>& frame_list);
+	void collect(AircraftConfig& aircraft);
 
 private:
 	GeoPos geopos {
@@ -70,7 +71,7 @@ class ADSBCallsignView : public OptionTabView {
 public:
 	ADSBCallsignView(NavigationView& nav, Rect parent_rect);
 	
-	void collect_frames(const uint32_t ICAO_address, std::vector<ADSBFrame>& frame_list);
+	void collect(AircraftConfig& aircraft);
 
 private:
 	std::string callsign = "TEST1234";
@@ -89,11 +90,12 @@ class ADSBSpeedView : public OptionTabView {
 public:
 	ADSBSpeedView(Rect parent_rect);
 	
-	void collect_frames(const uint32_t ICAO_address, std::vector<ADSBFrame>& frame_list);
+	void collect(AircraftConfig& aircraft);
 
 private:
 	Labels labels_speed {
-		{ { 1 * 8, 6 * 16 }, "Speed:    kn  Bearing:    *", Color::light_grey() }
+		{ { 1 * 8, 6 * 16 }, "Speed:    kn  Bearing:    *", Color::light_grey() },
+		{ { 1 * 8, 8 * 16 }, "V/S:       ft/min", Color::light_grey() }
 	};
 	
 	Compass compass {
@@ -107,13 +109,17 @@ private:
 	NumberField field_speed {
 		{ 8 * 8, 6 * 16 }, 3, { 0, 999 }, 5, ' '
 	};
+	
+	NumberField field_v_rate {
+		{ 6 * 8, 8 * 16 }, 5, { -6000, 6000 }, 64, ' '
+	};
 };
 
 class ADSBSquawkView : public OptionTabView {
 public:
 	ADSBSquawkView(Rect parent_rect);
 	
-	void collect_frames(const uint32_t ICAO_address, std::vector<ADSBFrame>& frame_list);
+	void collect(AircraftConfig& aircraft);
 
 private:
 	Labels labels_squawk {
@@ -127,25 +133,6 @@ private:
 	};
 };
 
-class ADSBTXThread {
-public:
-	ADSBTXThread(std::vector<ADSBFrame> frames);
-	~ADSBTXThread();
-
-	ADSBTXThread(const ADSBTXThread&) = delete;
-	ADSBTXThread(ADSBTXThread&&) = delete;
-	ADSBTXThread& operator=(const ADSBTXThread&) = delete;
-	ADSBTXThread& operator=(ADSBTXThread&&) = delete;
-
-private:
-	std::vector<ADSBFrame> frames_ { };
-	Thread* thread { nullptr };
-
-	static msg_t static_fn(void* arg);
-	
-	void run();
-};
-
 class ADSBTxView : public View {
 public:
 	ADSBTxView(NavigationView& nav);
@@ -197,10 +184,12 @@ private:
 	
 	//tx_modes tx_mode = IDLE;
 	NavigationView& nav_;
-	std::vector<ADSBFrame> frames { };
+	
+	// Random traffic is spread over this radius around the aircraft
+	static constexpr uint32_t traffic_radius_nm = 30;
 	
 	void start_tx();
-	void generate_frames();
+	void on_tx_progress(const uint32_t progress);
 	
 	Rect view_rect = { 0, 7 * 8, 240, 192 };
 	
@@ -217,7 +206,8 @@ private:
 	};
 	
 	Labels labels {
-		{ { 2 * 8, 4 * 8 }, "ICAO24:", Color::light_grey() }
+		{ { 2 * 8, 4 * 8 }, "ICAO24:", Color::light_grey() },
+		{ { 17 * 8, 4 * 8 }, "+   traffic", Color::light_grey() }
 	};
 	
 	SymField sym_icao {
@@ -226,6 +216,14 @@ private:
 		SymField::SYMFIELD_HEX
 	};
 	
+	NumberField field_traffic {
+		{ 19 * 8, 4 * 8 },
+		2,
+		{ 0, (int32_t)traffic_max },
+		1,
+		' '
+	};
+	
 	Text text_frame {
 		{ 1 * 8, 29 * 8, 14 * 8, 16 },
 		"-"
@@ -237,7 +235,13 @@ private:
 		0
 	};
 	
-	std::unique_ptr<ADSBTXThread> tx_thread { };
+	MessageHandlerRegistration message_handler_tx_progress {
+		Message::ID::TXProgress,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const TXProgressMessage*>(p);
+			this->on_tx_progress(message.progress);
+		}
+	};
 };
 
 } /* namespace ui */
@@ -29,6 +29,7 @@
 #include "baseband_api.hpp"
 #include "string_format.hpp"
 #include "portapack_persistent_memory.hpp"
+#include "portapack_shared_memory.hpp"
 
 using namespace portapack;
 using namespace modems;
@@ -125,6 +126,24 @@ AFSKRxView::AFSKRxView(NavigationView& nav) {
 	receiver_model.enable();
 }
 
+void AFSKRxView::on_block(const AFSKRxBlockMessage& message) {
+	auto& ring = shared_memory.bb_data.afsk_rx;
+	
+	// Take everything that's there, later notifications may find the ring empty
+	const uint32_t write_index = ring.write_index;
+	__DMB();		// Words up to write_index are complete
+	while (ring.read_index != write_index) {
+		on_data(ring.words[ring.read_index % ring.size], true);
+		__DMB();		// Done with the slot before handing it back
+		ring.read_index = ring.read_index + 1;
+	}
+	
+	if (message.dropped != dropped) {
+		dropped = message.dropped;
+		text_debug.set("Lost " + to_string_dec_uint(dropped));
+	}
+}
+
 void AFSKRxView::on_data(uint32_t value, bool is_data) {
 	std::string str_console = "\x1B";
 	std::string str_byte = "";
@@ -56,6 +56,7 @@ public:
 	
 private:
 	void on_data(uint32_t value, bool is_data);
+	void on_block(const AFSKRxBlockMessage& message);
 	
 	// app save settings
 	std::app_settings 		settings { }; 		
@@ -63,6 +64,7 @@ private:
 
 	uint8_t console_color { 0 };
 	uint32_t prev_value { 0 };
+	uint32_t dropped { 0 };
 	std::string str_log { "" };
 
 	RFAmpField field_rf_amp {
@@ -111,11 +113,11 @@ private:
 	
 	std::unique_ptr<AFSKLogger> logger { };
 	
-	MessageHandlerRegistration message_handler_packet {
-		Message::ID::AFSKData,
+	MessageHandlerRegistration message_handler_block {
+		Message::ID::AFSKRxBlock,
 		[this](Message* const p) {
-			const auto message = static_cast<const AFSKDataMessage*>(p);
-			this->on_data(message->value, message->is_data);
+			const auto message = static_cast<const AFSKRxBlockMessage*>(p);
+			this->on_block(*message);
 		}
 	};
 };
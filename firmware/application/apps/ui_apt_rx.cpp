@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "ui_apt_rx.hpp"
+
+#include "baseband_api.hpp"
+#include "audio.hpp"
+#include "string_format.hpp"
+#include "bmp.hpp"
+
+#include "portapack.hpp"
+
+#include <algorithm>
+
+using namespace portapack;
+
+/* APTRecorder ***********************************************************/
+
+namespace {
+
+constexpr uint32_t palette_size = 256 * 4;
+constexpr uint32_t image_data_offset = sizeof(bmp_header_t) + palette_size;
+
+} /* namespace */
+
+APTRecorder::~APTRecorder() {
+	if( lines > 0 ) {
+		write_header();
+	}
+}
+
+Optional<File::Error> APTRecorder::create(const std::filesystem::path& filename) {
+	const auto create_error = file.create(filename);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+
+	const auto header_error = write_header();
+	if( header_error.is_valid() ) {
+		return header_error;
+	}
+
+	for(size_t i=0; i<256; i++) {
+		const std::array<uint8_t, 4> gray { {
+			static_cast<uint8_t>(i), static_cast<uint8_t>(i), static_cast<uint8_t>(i), 0
+		} };
+		const auto result = file.write(gray);
+		if( result.is_error() ) {
+			return result.error();
+		}
+	}
+	return { };
+}
+
+Optional<File::Error> APTRecorder::write_line(const APTLine& line) {
+	const auto result = file.write(line.data);
+	if( result.is_error() ) {
+		return result.error();
+	}
+	lines++;
+
+	// Keep the file viewable if the recording is cut short
+	if( (lines % header_interval) == 0 ) {
+		return write_header();
+	}
+	return { };
+}
+
+Optional<File::Error> APTRecorder::write_header() {
+	const uint32_t data_size = lines * APTLine::words;
+
+	const bmp_header_t header {
+		0x4D42,							// "BM"
+		image_data_offset + data_size,
+		0, 0,
+		image_data_offset,
+		40,
+		APTLine::words,
+		static_cast<uint32_t>(-static_cast<int32_t>(lines)),	// Negative, rows are top down
+		1,
+		8,
+		0,
+		data_size,
+		2835, 2835,						// 72 DPI
+		256,
+		0
+	};
+
+	const auto end = std::max<uint64_t>(file.size(), sizeof(header));
+	const auto seek_start = file.seek(0);
+	if( seek_start.is_error() ) {
+		return seek_start.error();
+	}
+	const auto result = file.write(&header, sizeof(header));
+	if( result.is_error() ) {
+		return result.error();
+	}
+	const auto seek_end = file.seek(end);
+	if( seek_end.is_error() ) {
+		return seek_end.error();
+	}
+	return { };
+}
+
+namespace ui {
+
+/* APTImageView **********************************************************/
+
+APTImageView::APTImageView(
+	const Rect parent_rect
+) : Widget { parent_rect }
+{
+}
+
+void APTImageView::on_show() {
+	clear();
+
+	const auto screen_r = screen_rect();
+	display.scroll_set_area(screen_r.top(), screen_r.bottom());
+}
+
+void APTImageView::on_hide() {
+	display.scroll_disable();
+}
+
+void APTImageView::paint(Painter& painter) {
+	// Do nothing.
+	(void)painter;
+}
+
+void APTImageView::add_line(const APTLine& line) {
+	std::array<Color, 240> pixel_row;
+	for(size_t i=0; i<pixel_row.size(); i++) {
+		const size_t first = i * APTLine::words / pixel_row.size();
+		const size_t last = (i + 1) * APTLine::words / pixel_row.size();
+		uint32_t sum = 0;
+		for(size_t n=first; n<last; n++) {
+			sum += line.data[n];
+		}
+		const uint8_t v = sum / (last - first);
+		pixel_row[i] = Color { v, v, v };
+	}
+
+	const auto draw_y = display.scroll(1);
+
+	display.draw_pixels(
+		{ { 0, draw_y }, { pixel_row.size(), 1 } },
+		pixel_row
+	);
+}
+
+void APTImageView::clear() {
+	display.fill_rectangle(
+		screen_rect(),
+		Color::black()
+	);
+}
+
+/* APTRxView *************************************************************/
+
+APTRxView::APTRxView(NavigationView& nav) {
+	baseband::run_image(portapack::spi_flash::image_tag_apt_rx);
+
+	add_children({
+		&labels,
+		&field_frequency,
+		&field_rf_amp,
+		&field_lna,
+		&field_vga,
+		&rssi,
+		&field_volume,
+		&options_satellite,
+		&text_status,
+		&text_file,
+		&button_record,
+		&image,
+	});
+
+	// Stay on the current frequency if it's already in the weather satellite band
+	auto frequency = receiver_model.tuning_frequency();
+	if( (frequency < 137000000) || (frequency > 138000000) ) {
+		frequency = 137100000;
+	}
+	options_satellite.set_by_value(frequency);
+	options_satellite.on_change = [this](size_t, OptionsField::value_t v) {
+		this->on_frequency_changed(v);
+		field_frequency.set_value(v);
+	};
+
+	receiver_model.set_modulation(ReceiverModel::Mode::WidebandFMAudio);
+	receiver_model.set_sampling_rate(3072000);
+	receiver_model.set_baseband_bandwidth(1750000);
+	on_frequency_changed(frequency);
+	receiver_model.enable();
+
+	field_frequency.set_value(frequency);
+	field_frequency.set_step(receiver_model.frequency_step());
+	field_frequency.on_change = [this](rf::Frequency f) {
+		this->on_frequency_changed(f);
+	};
+	field_frequency.on_edit = [this, &nav]() {
+		auto new_view = nav.push<FrequencyKeypadView>(receiver_model.tuning_frequency());
+		new_view->on_changed = [this](rf::Frequency f) {
+			this->on_frequency_changed(f);
+			field_frequency.set_value(f);
+		};
+	};
+
+	field_volume.set_value((receiver_model.headphone_volume() - audio::headphone::volume_range().max).decibel() + 99);
+	field_volume.on_change = [this](int32_t v) {
+		this->on_headphone_volume_changed(v);
+	};
+
+	button_record.on_select = [this](Button&) {
+		this->toggle_recording();
+	};
+
+	audio::output::start();
+	audio::output::unmute();
+}
+
+APTRxView::~APTRxView() {
+	recorder.reset();
+
+	audio::output::stop();
+	receiver_model.disable();
+	baseband::shutdown();
+}
+
+void APTRxView::focus() {
+	options_satellite.focus();
+}
+
+void APTRxView::on_frequency_changed(const rf::Frequency f) {
+	receiver_model.set_tuning_frequency(f);
+}
+
+void APTRxView::on_headphone_volume_changed(int32_t v) {
+	const auto new_volume = volume_t::decibel(v - 99) + audio::headphone::volume_range().max;
+	receiver_model.set_headphone_volume(new_volume);
+}
+
+void APTRxView::on_lines(APTLineFIFO* const fifo) {
+	bool synced = false;
+	while( fifo->out(line) ) {
+		lines_received++;
+		if( line.synced ) {
+			lines_synced++;
+		}
+		synced = line.synced;
+
+		image.add_line(line);
+
+		if( recorder ) {
+			const auto error = recorder->write_line(line);
+			if( error.is_valid() ) {
+				recorder.reset();
+				button_record.set_text("REC");
+				text_file.set("Write error");
+			}
+		}
+	}
+	update_status(synced);
+}
+
+void APTRxView::toggle_recording() {
+	if( recorder ) {
+		recorder.reset();
+		button_record.set_text("REC");
+		return;
+	}
+
+	auto path = next_filename_stem_matching_pattern(u"APT_????");
+	if( path.empty() ) {
+		text_file.set("No free filename");
+		return;
+	}
+	path.replace_extension(u".BMP");
+
+	recorder = std::make_unique<APTRecorder>();
+	const auto error = recorder->create(path);
+	if( error.is_valid() ) {
+		recorder.reset();
+		text_file.set(error.value().what());
+		return;
+	}
+
+	button_record.set_text("STOP");
+	text_file.set(path.filename().string());
+}
+
+void APTRxView::update_status(const bool synced) {
+	text_status.set(
+		to_string_dec_uint(lines_received) + " lines " +
+		to_string_dec_uint(lines_synced * 100 / std::max<uint32_t>(lines_received, 1)) + "% " +
+		(synced ? "SYNC" : "no sync")
+	);
+	if( recorder ) {
+		text_file.set("REC " + to_string_dec_uint(recorder->line_count()) + " lines");
+	}
+}
+
+} /* namespace ui */
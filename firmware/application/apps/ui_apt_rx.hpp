@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __UI_APT_RX_H__
+#define __UI_APT_RX_H__
+
+#include "ui.hpp"
+#include "ui_widget.hpp"
+#include "ui_navigation.hpp"
+#include "ui_receiver.hpp"
+#include "ui_rssi.hpp"
+
+#include "event_m0.hpp"
+#include "message.hpp"
+#include "file.hpp"
+
+#include <memory>
+
+/* Streams APT lines to an 8 bit grayscale BMP, one file per recording. The
+ * rows are stored top down so they can be appended as they come, the height
+ * is only known (and patched in the header) when the recording stops.
+ */
+class APTRecorder {
+public:
+	~APTRecorder();
+
+	Optional<File::Error> create(const std::filesystem::path& filename);
+	Optional<File::Error> write_line(const APTLine& line);
+
+	uint32_t line_count() const {
+		return lines;
+	}
+
+private:
+	static constexpr uint32_t header_interval = 16;
+
+	File file { };
+	uint32_t lines { 0 };
+
+	Optional<File::Error> write_header();
+};
+
+namespace ui {
+
+/* Scrolling preview of both APT channels, 2080 words squeezed into 240 pixels. */
+class APTImageView : public Widget {
+public:
+	APTImageView(const Rect parent_rect);
+
+	void on_show() override;
+	void on_hide() override;
+
+	void paint(Painter& painter) override;
+
+	void add_line(const APTLine& line);
+
+private:
+	void clear();
+};
+
+class APTRxView : public View {
+public:
+	APTRxView(NavigationView& nav);
+	~APTRxView();
+
+	void focus() override;
+
+	std::string title() const override { return "APT RX"; };
+
+private:
+	APTLine line { };
+	std::unique_ptr<APTRecorder> recorder { };
+	uint32_t lines_received { 0 };
+	uint32_t lines_synced { 0 };
+
+	void on_frequency_changed(const rf::Frequency f);
+	void on_headphone_volume_changed(int32_t v);
+	void on_lines(APTLineFIFO* const fifo);
+	void toggle_recording();
+	void update_status(const bool synced);
+
+	Labels labels {
+		{ { 0 * 8, 1 * 16 }, "Sat:", Color::light_grey() },
+	};
+
+	FrequencyField field_frequency {
+		{ 0 * 8, 0 * 16 },
+	};
+
+	RFAmpField field_rf_amp {
+		{ 13 * 8, 0 * 16 }
+	};
+
+	LNAGainField field_lna {
+		{ 15 * 8, 0 * 16 }
+	};
+
+	VGAGainField field_vga {
+		{ 18 * 8, 0 * 16 }
+	};
+
+	RSSI rssi {
+		{ 21 * 8, 0, 6 * 8, 4 },
+	};
+
+	NumberField field_volume {
+		{ 28 * 8, 0 * 16 },
+		2,
+		{ 0, 99 },
+		1,
+		' ',
+	};
+
+	OptionsField options_satellite {
+		{ 5 * 8, 1 * 16 },
+		7,
+		{
+			{ "NOAA 15", 137620000 },
+			{ "NOAA 18", 137912500 },
+			{ "NOAA 19", 137100000 },
+		}
+	};
+
+	Text text_status {
+		{ 0 * 8, 2 * 16, 21 * 8, 16 },
+		"No sync"
+	};
+
+	Text text_file {
+		{ 0 * 8, 3 * 16, 21 * 8, 16 },
+		""
+	};
+
+	Button button_record {
+		{ 22 * 8, 1 * 16 + 8, 8 * 8, 32 },
+		"REC"
+	};
+
+	APTImageView image {
+		{ 0, 4 * 16, 240, 240 }
+	};
+
+	MessageHandlerRegistration message_handler_line {
+		Message::ID::APTLine,
+		[this](Message* const p) {
+			const auto message = static_cast<const APTLineMessage*>(p);
+			this->on_lines(message->fifo);
+		}
+	};
+};
+
+} /* namespace ui */
+
+#endif/*__UI_APT_RX_H__*/
@@ -30,6 +30,7 @@
 #include "bht.hpp"
 #include "bitmap.hpp"
 #include "message.hpp"
+#include "baseband_api.hpp"
 #include "transmitter_model.hpp"
 #include "encoders.hpp"
 #include "app_settings.hpp"
@@ -255,6 +256,15 @@ private:
 			this->on_tx_progress(message.progress, message.done);
 		}
 	};
+
+	MessageHandlerRegistration message_handler_fill {
+		Message::ID::RequestSignal,
+		[](const Message* const p) {
+			const auto message = static_cast<const RequestSignalMessage*>(p);
+			if (message->signal == RequestSignalMessage::Signal::FillRequest)
+				baseband::tones_fill();
+		}
+	};
 };
 
 } /* namespace ui */
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "ui_channel_power.hpp"
+
+#include "baseband_api.hpp"
+#include "string_format.hpp"
+
+#include "portapack.hpp"
+#include "portapack_persistent_memory.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace portapack;
+
+namespace ui {
+
+namespace {
+
+/* Baseband rates to pick from, the measurement runs at 1/8 of them */
+constexpr std::array<uint32_t, 8> sampling_rates { {
+	2457600, 3072000, 4000000, 5000000, 8000000, 10000000, 16000000, 20000000
+} };
+
+std::string format_db(const float db) {
+	return ((db < 0) ? "-" : " ") + to_string_decimal(std::fabs(db), 1);
+}
+
+std::string format_khz(const float hz) {
+	return to_string_decimal(hz / 1000.0f, 2) + " kHz";
+}
+
+} /* namespace */
+
+ChannelPowerView::ChannelPowerView(NavigationView& nav) {
+	baseband::run_image(portapack::spi_flash::image_tag_channel_power);
+
+	add_children({
+		&labels,
+		&field_frequency,
+		&field_rf_amp,
+		&field_lna,
+		&field_vga,
+		&rssi,
+		&field_bandwidth,
+		&field_spacing,
+		&field_adjacent,
+		&field_calibration,
+		&text_power,
+		&text_obw,
+		&text_offset,
+		&text_acpr[0],
+		&text_acpr[1],
+		&text_acpr[2],
+		&text_span,
+		&text_drift,
+		&button_learn,
+		&button_forget,
+	});
+
+	target_frequency = receiver_model.tuning_frequency();
+
+	field_frequency.set_value(target_frequency);
+	field_frequency.set_step(receiver_model.frequency_step());
+	field_frequency.on_change = [this](rf::Frequency f) {
+		this->on_target_frequency_changed(f);
+	};
+	field_frequency.on_edit = [this, &nav]() {
+		auto new_view = nav.push<FrequencyKeypadView>(target_frequency);
+		new_view->on_changed = [this](rf::Frequency f) {
+			this->on_target_frequency_changed(f);
+			this->field_frequency.set_value(f);
+		};
+	};
+
+	// The gain fields update the receiver model, the result needs them too
+	const auto set_rf_amp = field_rf_amp.on_change;
+	field_rf_amp.on_change = [this, set_rf_amp](int32_t v) {
+		set_rf_amp(v);
+		this->update_config();
+	};
+	const auto set_lna = field_lna.on_change;
+	field_lna.on_change = [this, set_lna](int32_t v) {
+		set_lna(v);
+		this->update_config();
+	};
+	const auto set_vga = field_vga.on_change;
+	field_vga.on_change = [this, set_vga](int32_t v) {
+		set_vga(v);
+		this->update_config();
+	};
+
+	field_bandwidth.set_value(16);
+	field_spacing.set_value(25);
+	field_adjacent.set_value(2);
+	field_calibration.set_value(0);
+
+	const auto on_setting_changed = [this](int32_t) {
+		this->update_config();
+	};
+	field_bandwidth.on_change = on_setting_changed;
+	field_spacing.on_change = on_setting_changed;
+	field_adjacent.on_change = on_setting_changed;
+	field_calibration.on_change = on_setting_changed;
+
+	button_learn.on_select = [this](Button&) {
+		this->on_learn();
+	};
+	button_forget.on_select = [this](Button&) {
+		drift_compensator.forget();
+		this->update_drift();
+	};
+
+	update_config();
+	update_drift();
+}
+
+ChannelPowerView::~ChannelPowerView() {
+	radio::disable();
+	baseband::shutdown();
+}
+
+void ChannelPowerView::focus() {
+	field_frequency.focus();
+}
+
+void ChannelPowerView::on_target_frequency_changed(const rf::Frequency f) {
+	target_frequency = f;
+	receiver_model.set_tuning_frequency(f);
+	update_config();
+}
+
+void ChannelPowerView::update_config() {
+	const uint32_t bandwidth = field_bandwidth.value() * 1000;
+	const uint32_t spacing = field_spacing.value() * 1000;
+	const uint32_t adjacent = field_adjacent.value();
+
+	// Everything measured has to sit in the flat part of the decimated band
+	const float span = std::max<float>(
+		adjacent * spacing + bandwidth / 2.0f,
+		std::max<float>(bandwidth, (adjacent + 0.5f) * spacing)
+	);
+	const float usable = 0.32f / 8;
+	uint32_t new_sampling_rate = sampling_rates.back();
+	for(const auto rate : sampling_rates) {
+		if( rate * usable >= span ) {
+			new_sampling_rate = rate;
+			break;
+		}
+	}
+
+	// Signal sits at fs/4, the M4 decimator shifts it to DC
+	const auto tuning_frequency = target_frequency - (new_sampling_rate / 4);
+	const uint32_t baseband_bandwidth = std::max<uint32_t>(1750000, new_sampling_rate / 2 + span * 2);
+
+	if( sampling_rate == 0 ) {
+		radio::enable({
+			tuning_frequency,
+			new_sampling_rate,
+			baseband_bandwidth,
+			rf::Direction::Receive,
+			receiver_model.rf_amp(),
+			static_cast<int8_t>(receiver_model.lna()),
+			static_cast<int8_t>(receiver_model.vga()),
+		});
+	} else {
+		if( new_sampling_rate != sampling_rate ) {
+			radio::set_baseband_rate(new_sampling_rate);
+		}
+		radio::set_baseband_filter_bandwidth(baseband_bandwidth);
+		radio::set_tuning_frequency(tuning_frequency);
+	}
+	sampling_rate = new_sampling_rate;
+
+	// The clock generator applies the correction in steps of ~31ppb, the rest
+	// shows up as a frequency offset of the channel
+	const int32_t residual_ppb = clock_manager.get_reference_ppb_residual();
+	const int32_t frequency_offset = (target_frequency * residual_ppb) / 1000000000;
+
+	const float gain_db = receiver_model.lna() + receiver_model.vga() +
+		(receiver_model.rf_amp() ? rf_amp_gain_db : 0) - field_calibration.value();
+
+	baseband::set_channel_power(
+		sampling_rate,
+		bandwidth,
+		spacing,
+		adjacent,
+		report_interval_ms,
+		frequency_offset,
+		gain_db
+	);
+
+	text_span.set("+/-" + format_khz(span) + " @" + to_string_dec_uint(sampling_rate / 8000) + "k");
+}
+
+void ChannelPowerView::on_learn() {
+	if( !has_offset ) {
+		return;
+	}
+	drift_compensator.learn(target_frequency, last_offset);
+	update_drift();
+}
+
+void ChannelPowerView::update_drift() {
+	const auto ppb = drift_compensator.drift_ppb();
+	text_drift.set(
+		"Drift " + std::string((ppb < 0) ? "-" : "+") + to_string_decimal(std::abs(ppb) / 1000.0f, 2) +
+		"ppm T" + to_string_dec_uint(drift_compensator.temperature_q4() / 16) +
+		" " + to_string_dec_uint(persistent_memory::drift_curve().count()) + " pts"
+	);
+}
+
+void ChannelPowerView::on_power(const ChannelPower& power) {
+	last_offset = power.occupied_center;
+	has_offset = true;
+	update_drift();
+
+	text_power.set(format_db(power.channel_dbm) + " dBm");
+	text_obw.set(format_khz(power.occupied_bandwidth));
+	text_offset.set(((power.occupied_center < 0) ? "-" : "+") + format_khz(std::fabs(power.occupied_center)));
+
+	for(size_t i=0; i<text_acpr.size(); i++) {
+		if( i < power.adjacent_count ) {
+			text_acpr[i].set(
+				"+/-" + to_string_dec_uint(i + 1) + "    " +
+				format_db(power.acpr_lower_dbc[i]) + "    " +
+				format_db(power.acpr_upper_dbc[i]) + " dBc"
+			);
+		} else {
+			text_acpr[i].set("");
+		}
+	}
+}
+
+} /* namespace ui */
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __UI_CHANNEL_POWER_H__
+#define __UI_CHANNEL_POWER_H__
+
+#include "ui.hpp"
+#include "ui_widget.hpp"
+#include "ui_navigation.hpp"
+#include "ui_receiver.hpp"
+#include "ui_rssi.hpp"
+
+#include "event_m0.hpp"
+#include "message.hpp"
+
+#include <array>
+
+namespace ui {
+
+/* Channel power, 99% occupied bandwidth and ACPR, for quick transmitter
+ * checks. The measurement is done on the M4 (proc_channel_power).
+ */
+class ChannelPowerView : public View {
+public:
+	ChannelPowerView(NavigationView& nav);
+	~ChannelPowerView();
+
+	void focus() override;
+
+	std::string title() const override { return "Channel power"; };
+
+private:
+	static constexpr uint32_t report_interval_ms = 200;
+	// Nominal gain of the RF amplifier, the LNA and VGA fields are in dB already
+	static constexpr int32_t rf_amp_gain_db = 11;
+
+	rf::Frequency target_frequency { };
+	uint32_t sampling_rate { 0 };
+	float last_offset { 0.0f };
+	bool has_offset { false };
+
+	void on_target_frequency_changed(const rf::Frequency f);
+	void update_config();
+	void on_power(const ChannelPower& power);
+	void on_learn();
+	void update_drift();
+
+	Labels labels {
+		{ { 0 * 8, 1 * 16 }, "BW:     kHz  Spc:     kHz", Color::light_grey() },
+		{ { 0 * 8, 2 * 16 }, "Adj:    Cal:    dB", Color::light_grey() },
+		{ { 0 * 8, 4 * 16 }, "Power:", Color::light_grey() },
+		{ { 0 * 8, 6 * 16 }, "OBW:", Color::light_grey() },
+		{ { 0 * 8, 7 * 16 }, "Offset:", Color::light_grey() },
+		{ { 0 * 8, 9 * 16 }, "ACPR    Lower    Upper", Color::light_grey() },
+		{ { 0 * 8, 14 * 16 }, "Span:", Color::light_grey() },
+	};
+
+	FrequencyField field_frequency {
+		{ 0 * 8, 0 * 16 },
+	};
+
+	RFAmpField field_rf_amp {
+		{ 13 * 8, 0 * 16 }
+	};
+
+	LNAGainField field_lna {
+		{ 15 * 8, 0 * 16 }
+	};
+
+	VGAGainField field_vga {
+		{ 18 * 8, 0 * 16 }
+	};
+
+	RSSI rssi {
+		{ 21 * 8, 0, 6 * 8, 4 },
+	};
+
+	NumberField field_bandwidth {
+		{ 4 * 8, 1 * 16 },
+		4,
+		{ 1, 2000 },
+		1,
+		' '
+	};
+
+	NumberField field_spacing {
+		{ 17 * 8, 1 * 16 },
+		4,
+		{ 1, 2000 },
+		1,
+		' '
+	};
+
+	NumberField field_adjacent {
+		{ 5 * 8, 2 * 16 },
+		1,
+		{ 0, ChannelPower::adjacent_max },
+		1,
+		' '
+	};
+
+	NumberField field_calibration {
+		{ 12 * 8, 2 * 16 },
+		3,
+		{ -99, 99 },
+		1,
+		' '
+	};
+
+	Text text_power {
+		{ 7 * 8, 4 * 16, 14 * 8, 16 },
+		"-"
+	};
+
+	Text text_obw {
+		{ 7 * 8, 6 * 16, 20 * 8, 16 },
+		"-"
+	};
+
+	Text text_offset {
+		{ 8 * 8, 7 * 16, 20 * 8, 16 },
+		"-"
+	};
+
+	std::array<Text, ChannelPower::adjacent_max> text_acpr { {
+		{ { 0 * 8, 10 * 16, 28 * 8, 16 }, "" },
+		{ { 0 * 8, 11 * 16, 28 * 8, 16 }, "" },
+		{ { 0 * 8, 12 * 16, 28 * 8, 16 }, "" },
+	} };
+
+	Text text_span {
+		{ 6 * 8, 14 * 16, 22 * 8, 16 },
+		"-"
+	};
+
+	// Tune to a carrier of known frequency (beacon, broadcast pilot) to teach
+	// the temperature drift compensation
+	Text text_drift {
+		{ 0 * 8, 15 * 16, 30 * 8, 16 },
+		""
+	};
+
+	Button button_learn {
+		{ 0 * 8, 16 * 16, 14 * 8, 32 },
+		"Learn drift"
+	};
+
+	Button button_forget {
+		{ 16 * 8, 16 * 16, 14 * 8, 32 },
+		"Forget"
+	};
+
+	MessageHandlerRegistration message_handler_power {
+		Message::ID::ChannelPower,
+		[this](Message* const p) {
+			const auto message = static_cast<const ChannelPowerMessage*>(p);
+			this->on_power(message->power);
+		}
+	};
+};
+
+} /* namespace ui */
+
+#endif/*__UI_CHANNEL_POWER_H__*/
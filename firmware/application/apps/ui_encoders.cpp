@@ -88,12 +88,28 @@ void EncodersConfigView::focus() {
 	options_enctype.focus();
 }
 
+void EncodersConfigView::set_learned(const encoder_def_t& def, const std::string& word) {
+	using option_t = std::pair<std::string, int32_t>;
+	std::vector<option_t> enc_options;
+	
+	learned_def = def;
+	learned_word = word;
+	has_learned = true;
+	
+	for (size_t i = 0; i < ENC_TYPES_COUNT; i++)
+		enc_options.emplace_back(std::make_pair(encoder_defs[i].name, i));
+	enc_options.emplace_back(std::make_pair(learned_def.name, ENC_TYPES_COUNT));
+	
+	options_enctype.set_options(enc_options);
+	options_enctype.set_selected_index(ENC_TYPES_COUNT);
+}
+
 void EncodersConfigView::on_type_change(size_t index) {
 	std::string format_string = "";
 	size_t word_length;
 	char symbol_type;
 
-	encoder_def = &encoder_defs[index];
+	encoder_def = (index < ENC_TYPES_COUNT) ? &encoder_defs[index] : &learned_def;
 
 	field_clk.set_value(encoder_def->default_speed / 1000);
 	
@@ -117,12 +133,18 @@ void EncodersConfigView::on_type_change(size_t index) {
 	
 	text_format.set(format_string);
 
+	if (encoder_def == &learned_def) {
+		for (size_t i = 0; i < learned_word.size(); i++)
+			symfield_word.set_sym(i, learned_word[i] - '0');
+	}
+
 	generate_frame();
 }
 
 void EncodersConfigView::on_show() {
-	options_enctype.set_selected_index(0);
-	on_type_change(0);
+	const size_t index = has_learned ? ENC_TYPES_COUNT : 0;
+	options_enctype.set_selected_index(index);
+	on_type_change(index);
 }
 
 void EncodersConfigView::draw_waveform() {
@@ -141,6 +163,9 @@ void EncodersConfigView::generate_frame() {
 	frame_fragments.clear();
 	
 	for (auto c : encoder_def->word_format) {
+		if (!c)
+			break;
+		
 		if (c == 'S')
 			frame_fragments += encoder_def->sync;
 		else
@@ -365,4 +390,13 @@ EncodersView::EncodersView(
 	};
 }
 
+EncodersView::EncodersView(
+	NavigationView& nav,
+	const encoder_def_t& learned_def,
+	const std::string& learned_word
+) : EncodersView(nav)
+{
+	view_config.set_learned(learned_def, learned_word);
+}
+
 } /* namespace ui */
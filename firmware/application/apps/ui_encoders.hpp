@@ -48,10 +48,16 @@ public:
 	uint32_t samples_per_bit();
 	uint32_t pause_symbols();
 	void generate_frame();
+	void set_learned(const encoder_def_t& def, const std::string& word);
 	
 	std::string frame_fragments = "0";
 
 private:
+	// Definition exported from the pulse analyzer, listed after the built-in ones
+	encoder_def_t learned_def { };
+	std::string learned_word { };
+	bool has_learned { false };
+
 	//bool abort_scan = false;
 	//uint8_t scan_count;
 	//double scan_progress;
@@ -155,6 +161,7 @@ private:
 class EncodersView : public View {
 public:
 	EncodersView(NavigationView& nav);
+	EncodersView(NavigationView& nav, const encoder_def_t& learned_def, const std::string& learned_word);
 	~EncodersView();
 	
 	void focus() override;
@@ -113,19 +113,17 @@ void FreqManBaseView::refresh_list() {
 		if (on_refresh_widgets)
 			on_refresh_widgets(false);
 	
-		menu_view.clear();
-		
-		for (size_t n = 0; n < database.size(); n++) {
-			menu_view.add_item({
-				freqman_item_string(database[n], 30),
-				ui::Color::white(),
-				nullptr,
-				[this](){
-					if (on_select_frequency)
-						on_select_frequency();
-				}
-			});
-		}
+		// Only the displayed entries are formatted, on demand
+		menu_view.set_item_provider(
+			database.size(),
+			[this](size_t index, MenuItem& item) {
+				item.text = freqman_item_string(database[index], 30);
+			},
+			[this](size_t) {
+				if (on_select_frequency)
+					on_select_frequency();
+			}
+		);
 	
 		menu_view.set_highlighted(0);	// Refresh
 	}
@@ -169,6 +169,73 @@ void GlassView::PlotMarker(rf::Frequency fpos)
     portapack::display.fill_rectangle({(int16_t)pos, 106, 1, 2}, Color::red()); //Red marker middle
 }
 
+bool GlassView::on_touch(const TouchEvent event)
+{
+    if (event.point.y() < 109) //Only on the waterfall, the fields above handle their own touches
+        return false;
+
+    switch (event.type)
+    {
+    case TouchEvent::Type::Start:
+        pan_pixels = 0;
+        zoom_pixels = 0;
+        return true;
+
+    case TouchEvent::Type::Drag:
+    case TouchEvent::Type::Swipe: //A swipe carries on for another 100ms worth of drag
+        pan_pixels += event.delta.x();
+        return true;
+
+    case TouchEvent::Type::LongPress:
+        zoom_x = event.point.x();
+        return true;
+
+    case TouchEvent::Type::Zoom:
+        zoom_pixels -= event.delta.y(); //Up zooms in
+        return true;
+
+    case TouchEvent::Type::End:
+        apply_gesture();
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void GlassView::apply_gesture()
+{
+    if (!pan_pixels && !zoom_pixels)
+        return;
+
+    //Work in MHz like the range fields
+    const int32_t span = field_frequency_max.value() - field_frequency_min.value();
+    int32_t new_span = span;
+    int32_t new_min = field_frequency_min.value();
+
+    if (zoom_pixels)
+    {
+        //64 pixels up halves the range, 64 pixels down doubles it
+        if (zoom_pixels > 0)
+            new_span = span * 64 / (64 + zoom_pixels);
+        else
+            new_span = span * (64 - zoom_pixels) / 64;
+        new_span = std::max<int32_t>(std::min<int32_t>(new_span, 7200), 24);
+
+        //Keep the frequency under the long press in place
+        new_min += (zoom_x * span - zoom_x * new_span) / 240;
+    }
+
+    new_min -= pan_pixels * new_span / 240; //Content follows the finger
+    new_min = std::max<int32_t>(std::min<int32_t>(new_min, 7200 - new_span), 0);
+
+    field_frequency_min.set_value(new_min, false);
+    field_frequency_max.set_value(new_min + new_span, false);
+    pan_pixels = 0;
+    zoom_pixels = 0;
+    on_range_changed();
+}
+
 GlassView::GlassView(
     NavigationView &nav) : nav_(nav)
 {
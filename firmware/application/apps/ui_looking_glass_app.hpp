@@ -52,6 +52,8 @@
  	    void on_hide() override;
          void focus() override;
 
+         bool on_touch(const TouchEvent event) override;
+
      private:
      	NavigationView& nav_;
 
@@ -75,6 +77,7 @@
         void txtline_process(std::string& line);
         void populate_Presets();
         void presets_Default();
+        void apply_gesture();
 
          rf::Frequency f_min { 0 }, f_max { 0 };
          rf::Frequency search_span { 0 };
@@ -88,6 +91,9 @@
          std::array<Color, 240> spectrum_row = { 0 };
          ChannelSpectrumFIFO* fifo { nullptr }; 
          uint8_t max_power = 0;
+         int32_t pan_pixels { 0 };      // Drag and swipe distance, applied on release
+         int32_t zoom_pixels { 0 };     // Dragged up after a long press to zoom in
+         int32_t zoom_x { 0 };          // Screen column kept in place while zooming
 
         Labels labels{
             {{0, 0}, "MIN:     MAX:     LNA   VGA  ", Color::light_grey()},
@@ -463,7 +463,7 @@ MicTXView::MicTXView(
 	field_rxbw.set_selected_index(2);
 
 	field_squelch.on_change = [this](int32_t v) { 
-		receiver_model.set_squelch_level(100 - v);	
+		receiver_model.set_squelch_level(v);
 	};
 	field_squelch.set_value(0);
 	receiver_model.set_squelch_level(0);
@@ -42,7 +42,7 @@ static WORKING_AREA(ookthread_wa, 256);
 
 static msg_t ookthread_fn(void * arg) {
 	uint32_t v = 0, delay = 0;
-	uint8_t * message_symbols = shared_memory.bb_data.tones_data.message;
+	uint8_t * message_symbols = baseband::tones_message();
 	uint8_t symbol;
 	MorseView * arg_c = (MorseView*)arg;
 	
@@ -116,7 +116,7 @@ bool MorseView::start_tx() {
 	update_tx_duration();
 	
 	if (!symbol_count) {
-		nav_.display_modal("Error", "Message too long,\nmust be < 256 symbols.", INFO, nullptr);
+		nav_.display_modal("Error", "Message too long,\nmust be < 1024 symbols.", INFO, nullptr);
 		return false;
 	}
 	
@@ -30,6 +30,7 @@
 #include "app_settings.hpp"
 #include "portapack.hpp"
 #include "message.hpp"
+#include "baseband_api.hpp"
 #include "volume.hpp"
 #include "audio.hpp"
 #include "morse.hpp"
@@ -189,6 +190,15 @@ private:
 			this->on_tx_progress(message.progress, message.done);
 		}
 	};
+
+	MessageHandlerRegistration message_handler_fill {
+		Message::ID::RequestSignal,
+		[](const Message* const p) {
+			const auto message = static_cast<const RequestSignalMessage*>(p);
+			if (message->signal == RequestSignalMessage::Signal::FillRequest)
+				baseband::tones_fill();
+		}
+	};
 };
 
 } /* namespace ui */
@@ -127,15 +127,15 @@ void NuoptixView::transmit(bool setup) {
 		else if (tone_code == '*')
 			tone_code = 15;
 		
-		shared_memory.bb_data.tones_data.message[c * 2] = tone_code;
-		shared_memory.bb_data.tones_data.message[c * 2 + 1] = 0xFF;		// Silence
+		baseband::tones_message()[c * 2] = tone_code;
+		baseband::tones_message()[c * 2 + 1] = 0xFF;		// Silence
 	}
 	
 	for (c = 0; c < 16; c++) {
 		baseband::set_tone(c * 2, dtmf_deltas[c][0], NUOPTIX_TONE_LENGTH);
 		baseband::set_tone(c * 2 + 1, dtmf_deltas[c][1], NUOPTIX_TONE_LENGTH);
 	}
-	shared_memory.bb_data.tones_data.silence = NUOPTIX_TONE_LENGTH;		// 49ms tone, 49ms space
+	baseband::set_tones_silence(NUOPTIX_TONE_LENGTH);		// 49ms tone, 49ms space
 	
 	audio::set_rate(audio::Rate::Hz_24000);
 	baseband::set_tones_config(transmitter_model.channel_bandwidth(), 0, 6 * 2, true, true);	
@@ -103,6 +103,15 @@ private:
 			this->on_tx_progress(message.progress, message.done);
 		}
 	};
+
+	MessageHandlerRegistration message_handler_fill {
+		Message::ID::RequestSignal,
+		[](const Message* const p) {
+			const auto message = static_cast<const RequestSignalMessage*>(p);
+			if (message->signal == RequestSignalMessage::Signal::FillRequest)
+				baseband::tones_fill();
+		}
+	};
 };
 
 } /* namespace ui */
@@ -21,8 +21,12 @@
  */
 
 #include "ui_remote.hpp"
+#include "ui_fileman.hpp"
 
 #include "baseband_api.hpp"
+#include "event_m0.hpp"
+#include "portapack.hpp"
+#include "portapack_persistent_memory.hpp"
 #include "string_format.hpp"
 
 using namespace portapack;
@@ -30,26 +34,212 @@ using namespace portapack;
 namespace ui {
 
 void RemoteView::focus() {
-	button.focus();
+	buttons[0].focus();
 }
 
-RemoteView::~RemoteView() {
-	//transmitter_model.disable();
-	//baseband::shutdown();
+void RemoteView::on_hide() {
+	stop();
+	View::on_hide();
+}
+
+void RemoteView::set_ready() {
+	if( replay_thread ) {
+		replay_thread->signal_ready();
+	} else {
+		ready_signal = true;
+	}
+}
+
+void RemoteView::update_slot(const size_t slot) {
+	const auto& clip = pool.clip(slot);
+	if( clip.size == 0 ) {
+		buttons[slot].set_text(to_string_dec_uint(slot + 1) + ": empty");
+	} else {
+		buttons[slot].set_text(clip.name.substr(0, 8) + " " + to_string_dec_uint(pool.duration_ms(slot)) + "ms");
+	}
+}
+
+void RemoteView::update_pool() {
+	// Time is what a capture has to fit in, bytes don't tell you that
+	text_pool.set("Free " + to_string_dec_uint(pool.free_ms(ClipPool::default_sample_rate)) + "ms @" +
+		to_string_dec_uint(ClipPool::default_sample_rate / 1000) + "k");
+}
+
+void RemoteView::on_slot(const size_t slot) {
+	if( check_edit.value() ) {
+		stop();
+		auto open_view = nav_.push<FileLoadView>(".C16");
+		open_view->on_changed = [this, slot](std::filesystem::path new_file_path) {
+			on_file_changed(slot, new_file_path);
+		};
+		return;
+	}
+
+	if( playing.is_valid() && (playing.value() == slot) ) {
+		stop();
+	} else if( pool.clip(slot).size ) {
+		play(slot);
+	}
 }
 
+void RemoteView::on_file_changed(const size_t slot, const std::filesystem::path& path) {
+	const auto error = pool.load(slot, path);
+	if( error.is_valid() ) {
+		if( error.value().code() == FR_NOT_ENOUGH_CORE ) {
+			text_status.set("Too long, only " + to_string_dec_uint(pool.free_ms(ClipPool::sample_rate(path))) +
+				"ms free");
+		} else {
+			text_status.set(error.value().what());
+		}
+	} else {
+		text_status.set("Slot " + to_string_dec_uint(slot + 1) + " loaded");
+	}
+	check_edit.set_value(false);
+
+	for(size_t i=0; i<buttons.size(); i++) {
+		update_slot(i);
+	}
+	update_pool();
+}
+
+void RemoteView::play(const size_t slot) {
+	stop();
+
+	const auto sample_rate = pool.clip(slot).sample_rate;
+	baseband::set_sample_rate(sample_rate * 8);
+
+	// Every buffer the baseband can still hold when the thread hits the end is
+	// silence, so stopping the stream then doesn't cut the clip short
+	replay_thread = std::make_unique<ReplayThread>(
+		pool.reader(slot, read_size * buffer_count),
+		read_size, buffer_count,
+		&ready_signal,
+		[](uint32_t return_code) {
+			ReplayThreadDoneMessage message { return_code };
+			EventDispatcher::send_message(message);
+		}
+	);
+	threads_pending++;
+	playing = slot;
+
+	radio::set_antenna_bias(portapack::get_antenna_bias());
+	radio::enable({
+		persistent_memory::tuned_frequency(),
+		sample_rate * 8,
+		baseband_bandwidth,
+		rf::Direction::Transmit,
+		rf_amp,
+		static_cast<int8_t>(receiver_model.lna()),
+		static_cast<int8_t>(receiver_model.vga())
+	});
+	text_status.set("TX slot " + to_string_dec_uint(slot + 1));
+}
+
+void RemoteView::stop() {
+	if( replay_thread ) {
+		replay_thread.reset();
+		radio::set_antenna_bias(false);
+		radio::disable();
+		text_status.set("");
+	}
+	playing = { };
+	ready_signal = false;
+}
+
+void RemoteView::handle_replay_thread_done(const uint32_t return_code) {
+	// Every thread reports once, in order, so anything but the last report
+	// comes from a thread already replaced by a later press
+	if( threads_pending ) {
+		threads_pending--;
+	}
+	if( threads_pending || (return_code == ReplayThread::TERMINATED) ) {
+		return;
+	}
+
+	// Normally the baseband's progress has already stopped the clip. When the
+	// thread ends the stream is gone, so don't leave the transmitter on.
+	stop();
+	if( return_code == ReplayThread::READ_ERROR ) {
+		text_status.set("Read error");
+	}
+}
+
+void RemoteView::on_tx_progress(const uint32_t progress) {
+	// Progress queued before the fill request still counts the previous clip
+	if( !playing.is_valid() || !ready_signal ) {
+		return;
+	}
+
+	// Progress counts C16 bytes, the pool holds C8
+	if( progress >= pool.clip(playing.value()).size * 2 ) {
+		stop();
+	}
+}
 
 RemoteView::RemoteView(
 	NavigationView& nav
-) {
+) : nav_ (nav)
+{
+	baseband::run_image(portapack::spi_flash::image_tag_replay);
+
 	add_children({
 		&labels,
-		&button
+		&field_frequency,
+		&field_rfgain,
+		&field_rfamp,
+		&text_pool,
+		&check_edit,
+		&text_status,
+		&button_exit
 	});
-	
-	button.on_select = [this, &nav](Button&) {
+
+	for(size_t n=0; n<buttons.size(); n++) {
+		buttons[n].on_select = [this](Button& button) {
+			this->on_slot(button.id);
+		};
+		buttons[n].id = n;
+		buttons[n].set_parent_rect({
+			static_cast<Coord>((n & 1) * 120 + 4),
+			static_cast<Coord>((n >> 1) * 60 + 48),
+			112, 56
+		});
+		add_child(&buttons[n]);
+		update_slot(n);
+	}
+	update_pool();
+
+	field_frequency.set_value(persistent_memory::tuned_frequency());
+	field_frequency.set_step(5000);
+	field_frequency.on_change = [this](rf::Frequency f) {
+		persistent_memory::set_tuned_frequency(f);
+	};
+	field_frequency.on_edit = [this, &nav]() {
+		auto new_view = nav.push<FrequencyKeypadView>(persistent_memory::tuned_frequency());
+		new_view->on_changed = [this](rf::Frequency f) {
+			persistent_memory::set_tuned_frequency(f);
+			this->field_frequency.set_value(f);
+		};
+	};
+
+	field_rfgain.on_change = [this](int32_t v) {
+		tx_gain = v;
+		receiver_model.set_tx_gain(tx_gain);
+	};
+	field_rfgain.set_value(tx_gain);
+
+	field_rfamp.on_change = [this](int32_t v) {
+		rf_amp = (bool)v;
+	};
+	field_rfamp.set_value(rf_amp ? 14 : 0);
+
+	button_exit.on_select = [this, &nav](Button&) {
 		nav.pop();
 	};
 }
 
+RemoteView::~RemoteView() {
+	stop();
+	baseband::shutdown();
+}
+
 } /* namespace ui */
@@ -20,45 +20,135 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#ifndef __UI_REMOTE_H__
+#define __UI_REMOTE_H__
+
 #include "ui.hpp"
-#include "ui_transmitter.hpp"
+#include "ui_widget.hpp"
+#include "ui_navigation.hpp"
+#include "ui_receiver.hpp"
 #include "transmitter_model.hpp"
+#include "replay_thread.hpp"
+#include "clip_pool.hpp"
+
+#include <array>
+#include <memory>
 
 namespace ui {
 
+/* Buttons that each replay a short capture held in RAM. The replay image
+ * stays loaded and nothing is read from the SD card once a slot is loaded,
+ * so the timing is the same every time. All slots share ClipPool's few ms of
+ * samples, and a press still starts a ReplayThread and waits for the
+ * baseband's first fill request before anything goes on air.
+ */
 class RemoteView : public View {
 public:
 	RemoteView(NavigationView& nav);
 	~RemoteView();
-	
+
+	void on_hide() override;
 	void focus() override;
-	
+
 	std::string title() const override { return "Custom remote"; };
 
 private:
-	/*enum tx_modes {
-		IDLE = 0,
-		SINGLE,
-		SCAN
+	NavigationView& nav_;
+
+	int32_t tx_gain { 35 };
+	bool rf_amp { true };
+	static constexpr uint32_t baseband_bandwidth = 2500000;
+	// Small buffers, clips are short and the tail of the last one is padded
+	const size_t read_size { 4096 };
+	const size_t buffer_count { 3 };
+
+	ClipPool pool { };
+	std::unique_ptr<ReplayThread> replay_thread { };
+	bool ready_signal { false };
+	Optional<size_t> playing { };
+	size_t threads_pending { 0 };	// Started threads whose done message hasn't arrived
+
+	void on_slot(const size_t slot);
+	void on_file_changed(const size_t slot, const std::filesystem::path& path);
+	void play(const size_t slot);
+	void stop();
+	void set_ready();
+	void handle_replay_thread_done(const uint32_t return_code);
+	void on_tx_progress(const uint32_t progress);
+	void update_slot(const size_t slot);
+	void update_pool();
+
+	Labels labels {
+		{ { 10 * 8, 0 * 16 }, "GAIN   A:", Color::light_grey() }
 	};
-	
-	tx_modes tx_mode = IDLE;
 
-	struct remote_layout_t {
-		Point position;
-		std::string text;
+	FrequencyField field_frequency {
+		{ 0 * 8, 0 * 16 },
 	};
-	
-	const std::array<remote_layout_t, 32> remote_layout { };*/
-	
-	Labels labels {
-		{ { 1 * 8, 0 }, "Work in progress...", Color::light_grey() }
+	NumberField field_rfgain {
+		{ 14 * 8, 0 * 16 },
+		2,
+		{ 0, 47 },
+		1,
+		' '
+	};
+	NumberField field_rfamp {
+		{ 19 * 8, 0 * 16 },
+		2,
+		{ 0, 14 },
+		14,
+		' '
+	};
+
+	Text text_pool {
+		{ 0 * 8, 1 * 16 + 4, 18 * 8, 16 },
+		""
+	};
+	Checkbox check_edit {
+		{ 20 * 8, 1 * 16 },
+		4,
+		"Load"
 	};
-	
-	Button button {
-		{ 60, 64, 120, 32 },
+
+	std::array<Button, ClipPool::slots_max> buttons { };
+
+	Text text_status {
+		{ 0 * 8, 15 * 16, 30 * 8, 16 },
+		"Tick Load, then pick a slot"
+	};
+
+	Button button_exit {
+		{ 160, 264, 72, 32 },
 		"Exit"
 	};
+
+	MessageHandlerRegistration message_handler_replay_thread_done {
+		Message::ID::ReplayThreadDone,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const ReplayThreadDoneMessage*>(p);
+			this->handle_replay_thread_done(message.return_code);
+		}
+	};
+
+	MessageHandlerRegistration message_handler_tx_progress {
+		Message::ID::TXProgress,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const TXProgressMessage*>(p);
+			this->on_tx_progress(message.progress);
+		}
+	};
+
+	MessageHandlerRegistration message_handler_fifo_signal {
+		Message::ID::RequestSignal,
+		[this](const Message* const p) {
+			const auto message = static_cast<const RequestSignalMessage*>(p);
+			if (message->signal == RequestSignalMessage::Signal::FillRequest) {
+				this->set_ready();
+			}
+		}
+	};
 };
 
 } /* namespace ui */
+
+#endif/*__UI_REMOTE_H__*/
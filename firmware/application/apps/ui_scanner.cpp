@@ -188,6 +188,7 @@ ScannerView::ScannerView(
 		&text_cycle,
 		&text_max,
 		&desc_cycle,
+		&text_mode,
 		&big_display,
 		&button_manual_start,
 		&button_manual_end,
@@ -324,6 +325,8 @@ ScannerView::ScannerView(
 		if ( !scan_thread->is_scanning() ) 						//for some motive, audio output gets stopped.
 			audio::output::start();								//So if scan was stopped we resume audio
 		receiver_model.enable(); 
+		if ( !scan_thread->is_scanning() )
+			set_classifier(true);								//New baseband image, classify again
 	};
 
 	button_dir.on_select = [this](Button&) {
@@ -485,10 +488,12 @@ void ScannerView::scan_pause() {
 		scan_thread->set_scanning(false); // WE STOP SCANNING
 		audio::output::start();
 		on_headphone_volume_changed(field_volume.value()); // quick fix to make sure WM8731S chips don't stay silent after pause
+		set_classifier(true);				//Find out what we stopped on
 	}
 }
 
 void ScannerView::scan_resume() {
+	set_classifier(false);
 	audio::output::stop();
 	big_display.set_style(&style_grey);		//Back to grey color
 	if (!scan_thread->is_scanning())
@@ -501,6 +506,25 @@ void ScannerView::user_resume() {
 	userpause=false;					//Resume scanning
 }
 
+void ScannerView::set_classifier(const bool enabled) {
+	if (current_mod != NFM)					//Only the NFM baseband image has the classifier
+		return;
+	baseband::set_mode_classifier(enabled, CLASSIFIER_DWELL_MS);
+	if (!enabled)
+		text_mode.set(" ");
+}
+
+void ScannerView::on_mode_classification(const classifier::Result& result) {
+	if (scan_thread->is_scanning())			//Late result from the last frequency
+		return;
+	std::string text = "MODE: " + std::string(classifier::mode_name(result.mode));
+	if (result.symbol_rate)
+		text += " " + to_string_dec_uint(result.symbol_rate) + "Bd";
+	if (result.mode != classifier::Mode::Unknown)
+		text += " " + to_string_dec_uint(result.confidence) + "%";
+	text_mode.set(text);
+}
+
 void ScannerView::on_headphone_volume_changed(int32_t v) {
 	const auto new_volume = volume_t::decibel(v - 99) + audio::headphone::volume_range().max;
 	receiver_model.set_headphone_volume(new_volume);
@@ -513,6 +537,8 @@ size_t ScannerView::change_mode(uint8_t new_mod) { //Before this, do a scan_thre
 	field_bw.on_change = [this](size_t n, OptionsField::value_t) { 
 		(void)n;  //avoid unused warning 
 	};
+	current_mod = new_mod;
+	text_mode.set(" ");
 
 	switch (new_mod) {
 	case NFM:	//bw 16k (2) default
@@ -36,6 +36,7 @@
 
 #define MAX_DB_ENTRY 500
 #define MAX_FREQ_LOCK 10 		//50ms cycles scanner locks into freq when signal detected, to verify signal is not spureous
+#define CLASSIFIER_DWELL_MS 500	//Time between mode guesses while stopped on a NFM signal
 
 namespace ui {
 
@@ -129,6 +130,8 @@ private:
 	void frequency_file_load(std::string file_name, bool stop_all_before = false);
 
 	void on_statistics_update(const ChannelStatistics& statistics);
+	void on_mode_classification(const classifier::Result& result);
+	void set_classifier(const bool enabled);
 	void on_headphone_volume_changed(int32_t v);
 	void handle_retune(uint32_t i);
 
@@ -140,6 +143,7 @@ private:
 	freqman_db database { };
 	std::string loaded_file_name;
 	uint32_t current_index { 0 };
+	uint8_t current_mod { AM };
 	bool userpause { false };
 	
 	Labels labels {
@@ -208,6 +212,10 @@ private:
 		{0, 4 * 16, 240, 16 },	   
 	};
 
+	Text text_mode {				//Digital mode guess, NFM only
+		{0, 5 * 16, 240, 16 },
+	};
+
 	BigFrequency big_display {		//Show frequency in glamour
 		{ 4, 6 * 16, 28 * 8, 52 },
 		0
@@ -300,6 +308,13 @@ private:
 		}
 	};
 	
+	MessageHandlerRegistration message_handler_classification {
+		Message::ID::ModeClassification,
+		[this](const Message* const p) {
+			this->on_mode_classification(static_cast<const ModeClassificationMessage*>(p)->result);
+		}
+	};
+
 	MessageHandlerRegistration message_handler_stats {
 		Message::ID::ChannelStatistics,
 		[this](const Message* const p) {
@@ -22,90 +22,581 @@
 
 #include "ui_script.hpp"
 
+#include "ui_fileman.hpp"
+#include "ais_app.hpp"
+#include "ert_app.hpp"
+#include "ism_app.hpp"
+#include "pocsag_app.hpp"
+#include "tpms_app.hpp"
+#include "ui_adsb_rx.hpp"
+#include "ui_afsk_rx.hpp"
+#include "ui_aprs_rx.hpp"
+#include "ui_apt_rx.hpp"
+#include "ui_sonde.hpp"
+#include "ui_sstv_rx.hpp"
+
+#include "audio.hpp"
+#include "baseband_api.hpp"
 #include "portapack.hpp"
 #include "event_m0.hpp"
-
-#include <cstring>
+#include "rtc_time.hpp"
+#include "string_format.hpp"
 
 using namespace portapack;
 
 namespace ui {
 
-void ScriptView::on_frequency_select() {
-	//button_edit_freq.focus();
+namespace {
+
+/* Apps a script can hand the radio to with "decode <name> <seconds>". Apps
+ * that live on a fixed channel tune themselves, the others start on the
+ * frequency of the last "tune".
+ */
+struct Decoder {
+	const char* name;
+	void (*push)(NavigationView& nav);
+};
+
+const std::array<Decoder, 11> decoders { {
+	{ "adsb",	[](NavigationView& nav) { nav.push<ADSBRxView>(); } },
+	{ "afsk",	[](NavigationView& nav) { nav.push<AFSKRxView>(); } },
+	{ "ais",	[](NavigationView& nav) { nav.push<AISAppView>(); } },
+	{ "aprs",	[](NavigationView& nav) { nav.push<APRSRXView>(); } },
+	{ "apt",	[](NavigationView& nav) { nav.push<APTRxView>(); } },
+	{ "ert",	[](NavigationView& nav) { nav.push<ERTAppView>(); } },
+	{ "ism",	[](NavigationView& nav) { nav.push<ISMAppView>(); } },
+	{ "pocsag",	[](NavigationView& nav) { nav.push<POCSAGAppView>(); } },
+	{ "sonde",	[](NavigationView& nav) { nav.push<SondeView>(); } },
+	{ "sstv",	[](NavigationView& nav) { nav.push<SSTVRxView>(); } },
+	{ "tpms",	[](NavigationView& nav) { nav.push<TPMSAppView>(); } },
+} };
+
+constexpr size_t script_size_max = 4096;
+
+} /* namespace */
+
+/* ScriptRadio ***********************************************************/
+
+ScriptRadio::ScriptRadio() {
+	chMtxInit(&mutex_log);
+	log_file.append("SCRIPT.TXT");
 }
 
-void ScriptView::on_edit_freq(rf::Frequency f) {
-	(void)f;
-	//frequencies[menu_view.highlighted()].value = f;
-	setup_list();
+bool ScriptRadio::request(const ScriptRequestMessage::Action action, const int64_t value) {
+	chSysLock();
+	const auto sequence = ++sequence_;
+	waiting_sequence = sequence;
+	pending = true;
+	chSysUnlock();
+
+	ScriptRequestMessage message { action, value, sequence };
+	EventDispatcher::send_message(message);
+
+	for(uint32_t t=0; pending && (t < request_timeout_ms) && !chThdShouldTerminate(); t+=10) {
+		chThdSleepMilliseconds(10);
+	}
+
+	// Give up on it in the same step the UI thread checks, so a completion
+	// can't land in between
+	chSysLock();
+	const bool timed_out = pending;
+	pending = false;
+	const bool ok = result;
+	chSysUnlock();
+
+	return !timed_out && ok;
+}
+
+bool ScriptRadio::is_waiting(const uint32_t sequence) const {
+	return pending && (sequence == waiting_sequence);
 }
 
-void ScriptView::on_edit_desc(NavigationView& nav) {
-	(void)nav;
+void ScriptRadio::complete(const uint32_t sequence, const bool ok) {
+	chSysLock();
+	if( pending && (sequence == waiting_sequence) ) {
+		result = ok;
+		pending = false;
+	}
+	chSysUnlock();
 }
 
-void ScriptView::on_delete() {
-	//frequencies.erase(frequencies.begin() + menu_view.highlighted());
+void ScriptRadio::cancel() {
+	complete(waiting_sequence, false);
+}
+
+void ScriptRadio::set_signal(const bool present) {
+	signal = present;
+}
+
+bool ScriptRadio::tune(const int64_t frequency) {
+	return request(ScriptRequestMessage::Action::Tune, frequency);
+}
+
+bool ScriptRadio::set_mode(const script::Mode mode) {
+	return request(ScriptRequestMessage::Action::Mode, static_cast<int64_t>(mode));
+}
+
+bool ScriptRadio::set_bandwidth(const size_t index) {
+	return request(ScriptRequestMessage::Action::Bandwidth, index);
+}
+
+bool ScriptRadio::set_lna(const int32_t db) {
+	return request(ScriptRequestMessage::Action::LNA, db);
+}
+
+bool ScriptRadio::set_vga(const int32_t db) {
+	return request(ScriptRequestMessage::Action::VGA, db);
+}
+
+bool ScriptRadio::set_amp(const bool enabled) {
+	return request(ScriptRequestMessage::Action::Amp, enabled);
+}
+
+bool ScriptRadio::set_squelch(const int32_t db) {
+	return request(ScriptRequestMessage::Action::Squelch, db);
+}
+
+bool ScriptRadio::start_record() {
+	return request(ScriptRequestMessage::Action::RecordStart, 0);
+}
+
+bool ScriptRadio::stop_record() {
+	return request(ScriptRequestMessage::Action::RecordStop, 0);
+}
+
+bool ScriptRadio::start_decoder(const std::string& app) {
+	for(size_t i=0; i<decoders.size(); i++) {
+		if( app == decoders[i].name ) {
+			return request(ScriptRequestMessage::Action::DecoderStart, i);
+		}
+	}
+	return false;
+}
+
+bool ScriptRadio::stop_decoder() {
+	return request(ScriptRequestMessage::Action::DecoderStop, 0);
+}
+
+bool ScriptRadio::signal_present() {
+	return signal;
+}
+
+uint32_t ScriptRadio::seconds_of_day() {
+	rtc::RTC datetime;
+	rtcGetTime(&RTCD1, &datetime);
+	return (datetime.hour() * 60 + datetime.minute()) * 60 + datetime.second();
+}
+
+void ScriptRadio::sleep_ms(const uint32_t ms) {
+	chThdSleepMilliseconds(ms);
+}
+
+bool ScriptRadio::should_stop() {
+	return chThdShouldTerminate();
+}
+
+void ScriptRadio::log(const std::string& entry) {
+	rtc::RTC datetime;
+	rtcGetTime(&RTCD1, &datetime);
+
+	chMtxLock(&mutex_log);
+	log_file.write_entry(datetime, entry);
+	chMtxUnlock();
+}
+
+/* ScriptThread **********************************************************/
+
+ScriptThread::ScriptThread(
+	const script::Program& program,
+	script::Radio& radio
+) : engine { program, radio }
+{
+	// No higher than the UI, a script that never blocks must not starve it
+	thread = chThdCreateFromHeap(NULL, 2048, NORMALPRIO, ScriptThread::static_fn, this);
+}
+
+ScriptThread::~ScriptThread() {
+	stop();
+}
+
+/* Doesn't wait, for when the thread may never get to check */
+void ScriptThread::request_stop() {
+	if( thread ) {
+		chThdTerminate(thread);
+	}
+}
+
+void ScriptThread::stop() {
+	if( thread ) {
+		chThdTerminate(thread);
+		chThdWait(thread);
+		thread = nullptr;
+	}
+}
+
+msg_t ScriptThread::static_fn(void* arg) {
+	auto obj = static_cast<ScriptThread*>(arg);
+	obj->run();
+	return 0;
+}
+
+void ScriptThread::run() {
+	status_ = engine.run();
+	done = true;
+}
+
+/* ScriptView ************************************************************/
+
+void ScriptView::on_file_changed(const std::filesystem::path& path) {
+	stop();
+	program.clear();
+
+	File file;
+	auto error = file.open(path);
+	if( error.is_valid() ) {
+		update_status("Can't open file");
+		setup_list();
+		return;
+	}
+
+	std::string source;
+	char buffer[257];
+	while( source.size() < script_size_max ) {
+		auto read_size = file.read(buffer, 256);
+		if( read_size.is_error() || (read_size.value() == 0) ) {
+			break;
+		}
+		source.append(buffer, read_size.value());
+	}
+
+	file_name = path.filename().string();
+	text_file.set(file_name);
+
+	const auto parse_error = script::parse(source, program);
+	if( parse_error.is_valid() ) {
+		program.clear();
+		update_status("Line " + to_string_dec_uint(parse_error.value().line) + ": " + parse_error.value().message);
+	} else {
+		update_status(to_string_dec_uint(program.size()) + " instructions");
+	}
 	setup_list();
 }
 
 void ScriptView::setup_list() {
-	//size_t n;
-	
 	menu_view.clear();
-	
-	/*for (n = 0; n < frequencies.size(); n++) {
-		menu_view.add_item({ freqman_item_string(frequencies[n]), ui::Color::white(), nullptr, [this](){ on_frequency_select(); } });
-	}*/
-	
-	menu_view.set_parent_rect({ 0, 0, 240, 168 });
-	menu_view.set_highlighted(menu_view.highlighted());		// Refresh
+
+	for(const auto& instruction : program) {
+		menu_view.add_item({ script::to_string(instruction), ui::Color::white(), nullptr, nullptr });
+	}
+
+	menu_view.set_parent_rect({ 0, 16, 240, 168 });
+	menu_view.set_highlighted(0);
+}
+
+void ScriptView::update_status(const std::string& status) {
+	text_status.set(status);
+}
+
+void ScriptView::start() {
+	if( program.empty() ) {
+		return;
+	}
+
+	stalled_s = 0;
+	last_heartbeat = 0;
+	restart_pending = false;
+	radio.log("start " + file_name);
+	script_thread = std::make_unique<ScriptThread>(program, radio);
+	button_run.set_text("Stop");
+	update_status("Running");
+}
+
+void ScriptView::stop() {
+	if( script_thread ) {
+		script_thread.reset();
+		radio.log("stopped");
+		update_status("Stopped");
+	}
+	restart_pending = false;
+	clean_up();
+	button_run.set_text("Run");
+}
+
+/* Leaves nothing running that the script started */
+void ScriptView::clean_up() {
+	record_view.stop();
+	if( decoder_active ) {
+		nav_.pop();
+	}
+	radio.cancel();
+	radio.set_signal(false);
+}
+
+void ScriptView::on_tick_second() {
+	if( !script_thread ) {
+		return;
+	}
+
+	if( script_thread->is_done() ) {
+		if( restart_pending ) {
+			// Killed by the watchdog, start over from the top
+			script_thread.reset();
+			radio.log("watchdog restart " + to_string_dec_uint(++restarts));
+			start();
+			return;
+		}
+
+		const auto status = script_thread->status();
+		script_thread.reset();
+		clean_up();
+		button_run.set_text("Run");
+		const bool halted = (status == script::Engine::Status::Halted);
+		radio.log(halted ? "halted" : "finished");
+		update_status(halted ? "Halted" : "Finished");
+		return;
+	}
+
+	const auto pc = script_thread->pc();
+	if( (pc < program.size()) && !decoder_active ) {
+		menu_view.set_highlighted(pc);
+	}
+
+	// The engine beats at least every 100ms, even while waiting
+	const auto heartbeat = script_thread->heartbeat();
+	if( heartbeat != last_heartbeat ) {
+		last_heartbeat = heartbeat;
+		stalled_s = 0;
+		if( !restart_pending ) {
+			update_status("Running line " + to_string_dec_uint(program[pc].line) +
+				(restarts ? " (" + to_string_dec_uint(restarts) + " restarts)" : ""));
+		}
+	} else if( (++stalled_s >= watchdog_timeout_s) && !restart_pending ) {
+		// Ask the engine to give up, free whatever it was waiting on
+		restart_pending = true;
+		update_status("Watchdog, line " + to_string_dec_uint(program[pc].line));
+		script_thread->request_stop();
+		clean_up();
+	}
+}
+
+void ScriptView::on_request(const ScriptRequestMessage& message) {
+	// The script has given up on it, don't act on it now
+	if( !radio.is_waiting(message.sequence) ) {
+		return;
+	}
+	radio.complete(message.sequence, execute_request(message));
+}
+
+/* Whatever the squelch said was about the previous channel, mode or app */
+void ScriptView::reset_signal() {
+	radio.set_signal(false);
+	// Restarts the baseband squelch closed, so a signal on the new channel
+	// opens it with a fresh event
+	if( mode_set ) {
+		receiver_model.set_squelch_level(receiver_model.squelch_level());
+	}
+}
+
+bool ScriptView::execute_request(const ScriptRequestMessage& message) {
+	switch(message.action) {
+	case ScriptRequestMessage::Action::Tune:
+		frequency = message.value;
+		receiver_model.set_tuning_frequency(frequency);
+		reset_signal();
+		return true;
+
+	case ScriptRequestMessage::Action::Mode:
+		switch(static_cast<script::Mode>(message.value)) {
+		case script::Mode::AM:	return apply_mode(ReceiverModel::Mode::AMAudio);
+		case script::Mode::NFM:	return apply_mode(ReceiverModel::Mode::NarrowbandFMAudio);
+		case script::Mode::WFM:	return apply_mode(ReceiverModel::Mode::WidebandFMAudio);
+		default:				return false;
+		}
+
+	case ScriptRequestMessage::Action::Bandwidth:
+		if( !mode_set ) {
+			return false;
+		}
+		switch(mode) {
+		case ReceiverModel::Mode::AMAudio:
+			if( message.value >= 4 ) return false;
+			receiver_model.set_am_configuration(message.value);
+			return true;
+		case ReceiverModel::Mode::NarrowbandFMAudio:
+			if( message.value >= 3 ) return false;
+			receiver_model.set_nbfm_configuration(message.value);
+			return true;
+		default:
+			if( message.value >= 1 ) return false;
+			receiver_model.set_wfm_configuration(message.value);
+			return true;
+		}
+
+	case ScriptRequestMessage::Action::LNA:
+		// Same steps as the LNA and VGA gain fields
+		if( (message.value < 0) || (message.value > 40) || (message.value % 8) ) {
+			return false;
+		}
+		receiver_model.set_lna(message.value);
+		return true;
+
+	case ScriptRequestMessage::Action::VGA:
+		if( (message.value < 0) || (message.value > 62) || (message.value % 2) ) {
+			return false;
+		}
+		receiver_model.set_vga(message.value);
+		return true;
+
+	case ScriptRequestMessage::Action::Amp:
+		receiver_model.set_rf_amp(message.value);
+		return true;
+
+	case ScriptRequestMessage::Action::Squelch:
+		if( (message.value < 0) || (message.value > 99) ) {
+			return false;
+		}
+		receiver_model.set_squelch_level(message.value);
+		return true;
+
+	case ScriptRequestMessage::Action::RecordStart:
+		if( !mode_set || decoder_active ) {
+			return false;
+		}
+		record_view.start();
+		return record_view.is_active();
+
+	case ScriptRequestMessage::Action::RecordStop:
+		record_view.stop();
+		return true;
+
+	case ScriptRequestMessage::Action::DecoderStart:
+		if( decoder_active || (message.value >= (int64_t)decoders.size()) ) {
+			return false;
+		}
+		record_view.stop();
+		receiver_model.disable();
+		baseband::shutdown();
+		mode_set = false;
+		reset_signal();
+		if( frequency ) {
+			receiver_model.set_tuning_frequency(frequency);
+		}
+		decoders[message.value].push(nav_);
+		decoder_active = true;
+		return true;
+
+	case ScriptRequestMessage::Action::DecoderStop:
+		// Already gone if someone backed out of the app by hand
+		if( decoder_active ) {
+			nav_.pop();
+		}
+		if( frequency ) {
+			receiver_model.set_tuning_frequency(frequency);
+		}
+		return apply_mode(mode);
+
+	default:
+		return false;
+	}
+}
+
+bool ScriptView::apply_mode(const ReceiverModel::Mode new_mode) {
+	audio::output::mute();
+	record_view.stop();
+	receiver_model.disable();
+	baseband::shutdown();
+	// The new image starts with its squelch closed
+	radio.set_signal(false);
+
+	size_t sampling_rate = 0;
+	switch(new_mode) {
+	case ReceiverModel::Mode::AMAudio:
+		baseband::run_image(portapack::spi_flash::image_tag_am_audio);
+		sampling_rate = 12000;
+		break;
+	case ReceiverModel::Mode::NarrowbandFMAudio:
+		baseband::run_image(portapack::spi_flash::image_tag_nfm_audio);
+		sampling_rate = 24000;
+		break;
+	case ReceiverModel::Mode::WidebandFMAudio:
+		baseband::run_image(portapack::spi_flash::image_tag_wfm_audio);
+		sampling_rate = 48000;
+		break;
+	default:
+		return false;
+	}
+
+	mode = new_mode;
+	receiver_model.set_modulation(mode);
+	receiver_model.set_sampling_rate(3072000);
+	receiver_model.set_baseband_bandwidth(1750000);
+	receiver_model.enable();
+	record_view.set_sampling_rate(sampling_rate);
+	audio::output::unmute();
+
+	mode_set = true;
+	return true;
 }
 
 void ScriptView::focus() {
-	menu_view.focus();
+	button_load.focus();
+}
+
+void ScriptView::on_show() {
+	View::on_show();
+	// Back from a decoder app, whether the script or the user closed it
+	decoder_active = false;
 }
 
 ScriptView::ScriptView(
 	NavigationView& nav
-) {
-	
+) : nav_ (nav)
+{
 	add_children({
+		&text_file,
 		&menu_view,
-		&text_edit,
-		&button_edit_freq,
-		&button_edit_desc,
-		&button_del,
+		&text_status,
+		&record_view,
+		&button_load,
+		&button_run,
 		&button_exit
 	});
-	
-	setup_list();
-	
-	button_edit_freq.on_select = [this, &nav](Button&) {
-		/*auto new_view = nav.push<FrequencyKeypadView>(frequencies[menu_view.highlighted()].value);
-		new_view->on_changed = [this](rf::Frequency f) {
-			on_edit_freq(f);
-		};*/
+
+	record_view.set_filename_date_frequency(true);
+	record_view.on_error = [this](std::string message) {
+		radio.log("record: " + message);
 	};
-	
-	button_edit_desc.on_select = [this, &nav](Button&) {
-		on_edit_desc(nav);
+
+	button_load.on_select = [this, &nav](Button&) {
+		auto open_view = nav.push<FileLoadView>(".TXT");
+		open_view->on_changed = [this](std::filesystem::path new_file_path) {
+			on_file_changed(new_file_path);
+		};
 	};
-	
-	button_del.on_select = [this, &nav](Button&) {
-		nav.push<ModalMessageView>("Confirm", "Are you sure?", YESNO,
-			[this](bool choice) {
-				if (choice) {
-					on_delete();
-				}
-			}
-		);
+
+	button_run.on_select = [this](Button&) {
+		if( script_thread ) {
+			stop();
+		} else {
+			start();
+		}
 	};
-	
+
 	button_exit.on_select = [this, &nav](Button&) {
 		nav.pop();
 	};
+
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->on_tick_second();
+	};
+}
+
+ScriptView::~ScriptView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
+	script_thread.reset();
+	record_view.stop();
+	receiver_model.disable();
+	baseband::shutdown();
 }
 
 }
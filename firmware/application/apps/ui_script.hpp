@@ -20,75 +20,215 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#ifndef __UI_SCRIPT_H__
+#define __UI_SCRIPT_H__
+
 #include "ui.hpp"
 #include "ui_widget.hpp"
 #include "ui_painter.hpp"
 #include "ui_menu.hpp"
 #include "ui_navigation.hpp"
 #include "ui_receiver.hpp"
-#include "ui_textentry.hpp"
-#include "rtc_time.hpp"
+#include "ui_record_view.hpp"
+#include "receiver_model.hpp"
+#include "script_engine.hpp"
+#include "log_file.hpp"
+#include "message.hpp"
+#include "signal.hpp"
+
+#include "ch.h"
+
+#include <memory>
 
 namespace ui {
-	
-enum script_keyword {
-	STOP = 0,
-	WAIT_N,
-	WAIT_RTC,
-	IF,
-	LOOP,
-	END,
-	TX,
-	RX
+
+/* script::Radio on the PortaPack. Called on the script thread, anything that
+ * touches the receiver or the views is handed to the UI thread and waited for.
+ */
+class ScriptRadio : public script::Radio {
+public:
+	ScriptRadio();
+
+	bool tune(const int64_t frequency) override;
+	bool set_mode(const script::Mode mode) override;
+	bool set_bandwidth(const size_t index) override;
+	bool set_lna(const int32_t db) override;
+	bool set_vga(const int32_t db) override;
+	bool set_amp(const bool enabled) override;
+	bool set_squelch(const int32_t db) override;
+	bool start_record() override;
+	bool stop_record() override;
+	bool start_decoder(const std::string& app) override;
+	bool stop_decoder() override;
+
+	bool signal_present() override;
+	uint32_t seconds_of_day() override;
+	void sleep_ms(const uint32_t ms) override;
+	bool should_stop() override;
+	void log(const std::string& entry) override;
+
+	/* UI thread side. A request that timed out is stale, its late completion
+	 * is dropped so it can't answer the next one.
+	 */
+	bool is_waiting(const uint32_t sequence) const;
+	void complete(const uint32_t sequence, const bool ok);
+	void cancel();
+	void set_signal(const bool present);
+
+private:
+	static constexpr uint32_t request_timeout_ms = 2000;
+
+	Mutex mutex_log { };
+	LogFile log_file { };
+	uint32_t sequence_ { 0 };
+	volatile uint32_t waiting_sequence { 0 };
+	volatile bool pending { false };
+	volatile bool result { false };
+	volatile bool signal { false };
+
+	bool request(const ScriptRequestMessage::Action action, const int64_t value);
 };
 
-struct script_line {
-	script_keyword keyword;
+class ScriptThread {
+public:
+	ScriptThread(
+		const script::Program& program,
+		script::Radio& radio
+	);
+	~ScriptThread();
+
+	void request_stop();
+	void stop();
+
+	bool is_done() const {
+		return done;
+	}
+
+	script::Engine::Status status() const {
+		return status_;
+	}
+
+	size_t pc() const {
+		return engine.pc();
+	}
+
+	uint32_t heartbeat() const {
+		return engine.heartbeat();
+	}
+
+	ScriptThread(const ScriptThread&) = delete;
+	ScriptThread(ScriptThread&&) = delete;
+	ScriptThread& operator=(const ScriptThread&) = delete;
+	ScriptThread& operator=(ScriptThread&&) = delete;
+
+private:
+	script::Engine engine;
+	Thread* thread { nullptr };
+	volatile bool done { false };
+	script::Engine::Status status_ { script::Engine::Status::Stopped };
+
+	static msg_t static_fn(void* arg);
+	void run();
 };
 
 class ScriptView : public View {
 public:
 	ScriptView(NavigationView& nav);
-	
+	~ScriptView();
+
 	void focus() override;
+	void on_show() override;
 
-	std::string title() const override { return "Script editor"; };
+	std::string title() const override { return "Script"; };
 
 private:
-	void on_frequency_select();
-	void on_edit_freq(rf::Frequency f);
-	void on_edit_desc(NavigationView& nav);
-	void on_delete();
+	// No heartbeat for this long and the engine is assumed stuck
+	static constexpr uint32_t watchdog_timeout_s = 10;
+
+	NavigationView& nav_;
+
+	std::string file_name { };
+	script::Program program { };
+	std::unique_ptr<ScriptThread> script_thread { };
+	ScriptRadio radio { };
+
+	ReceiverModel::Mode mode { ReceiverModel::Mode::NarrowbandFMAudio };
+	bool mode_set { false };
+	rf::Frequency frequency { 0 };
+	bool decoder_active { false };
+
+	uint32_t last_heartbeat { 0 };
+	uint32_t stalled_s { 0 };
+	uint32_t restarts { 0 };
+	bool restart_pending { false };
+
+	SignalToken signal_token_tick_second { };
+
+	void on_file_changed(const std::filesystem::path& path);
 	void setup_list();
-	
-	std::vector<script_line> script { };
+	void start();
+	void stop();
+	void clean_up();
+	void on_tick_second();
+	void on_request(const ScriptRequestMessage& message);
+	bool execute_request(const ScriptRequestMessage& message);
+	bool apply_mode(const ReceiverModel::Mode new_mode);
+	void reset_signal();
+	void update_status(const std::string& status);
+
+	Text text_file {
+		{ 0, 0, 240, 16 },
+		"No script loaded"
+	};
 
 	MenuView menu_view {
-		{ 0, 0, 240, 168 },
+		{ 0, 16, 240, 168 },
 		true
 	};
 
-	Text text_edit {
-		{ 16, 194, 5 * 8, 16 },
-		"Edit:"
+	Text text_status {
+		{ 0, 188, 240, 16 },
+		""
 	};
-	Button button_edit_freq {
-		{ 16, 194 + 16, 88, 32 },
-		"Frequency"
+
+	RecordView record_view {
+		{ 0, 208, 240, 16 },
+		u"SCR",
+		RecordView::FileType::WAV,
+		4096,
+		4
 	};
-	Button button_edit_desc {
-		{ 16, 194 + 16 + 34, 88, 32 },
-		"Description"
+
+	Button button_load {
+		{ 8, 264, 72, 32 },
+		"Load"
 	};
-	Button button_del {
-		{ 160, 192, 72, 64 },
-		"Delete"
+	Button button_run {
+		{ 84, 264, 72, 32 },
+		"Run"
 	};
-	
 	Button button_exit {
 		{ 160, 264, 72, 32 },
 		"Exit"
 	};
+
+	MessageHandlerRegistration message_handler_request {
+		Message::ID::ScriptRequest,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const ScriptRequestMessage*>(p);
+			this->on_request(message);
+		}
+	};
+
+	MessageHandlerRegistration message_handler_squelch {
+		Message::ID::SquelchEvent,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const SquelchEventMessage*>(p);
+			this->radio.set_signal(message.open);
+		}
+	};
 };
 
 } /* namespace ui */
+
+#endif/*__UI_SCRIPT_H__*/
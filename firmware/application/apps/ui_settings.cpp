@@ -30,6 +30,7 @@
 using namespace lpc43xx;
 
 #include "audio.hpp"
+#include "screen_recorder.hpp"
 #include "portapack.hpp"
 using portapack::receiver_model;
 using namespace portapack;
@@ -140,6 +141,7 @@ SetRadioView::SetRadioView(
 		add_children({
 			&labels_correction,
 			&field_ppm,
+			&check_drift,
 		});
 	}
 
@@ -160,6 +162,8 @@ SetRadioView::SetRadioView(
 
 	form_init(model);
 
+	check_drift.set_value(portapack::persistent_memory::drift_compensation());
+
 	check_clkout.set_value(portapack::persistent_memory::clkout_enabled());
 	check_clkout.on_select = [this](Checkbox&, bool v) {
 		clock_manager.enable_clock_output(v);
@@ -203,6 +207,7 @@ SetRadioView::SetRadioView(
 	button_save.on_select = [this, &nav](Button&){
 		const auto model = this->form_collect();
 		portapack::persistent_memory::set_correction_ppb(model.ppm * 1000);
+		portapack::persistent_memory::set_drift_compensation(check_drift.value());
 		portapack::persistent_memory::set_clkout_freq(model.freq);
 		clock_manager.enable_clock_output(portapack::persistent_memory::clkout_enabled());
 		nav.pop();
@@ -235,6 +240,7 @@ SetUIView::SetUIView(NavigationView& nav) {
 		&checkbox_showclock,
 		&options_clockformat,
 		&checkbox_guireturnflag,
+		&checkbox_camera_records,
 		&button_save,
 		&button_cancel
 	});
@@ -244,6 +250,7 @@ SetUIView::SetUIView(NavigationView& nav) {
 	checkbox_showsplash.set_value(persistent_memory::config_splash());
 	checkbox_showclock.set_value(!persistent_memory::hide_clock());
 	checkbox_guireturnflag.set_value(persistent_memory::show_gui_return_icon());
+	checkbox_camera_records.set_value(persistent_memory::camera_records_video());
 	
 	uint32_t backlight_timer = persistent_memory::config_backlight_timer();
 	if (backlight_timer) {
@@ -273,6 +280,9 @@ SetUIView::SetUIView(NavigationView& nav) {
 			    persistent_memory::set_clock_with_date(false);		
 		}
 
+		persistent_memory::set_camera_records_video(checkbox_camera_records.value());
+		if (!checkbox_camera_records.value()) screen_recorder::stop();		//Status bar refresh below shows the camera idle
+
 		if (checkbox_speaker.value())  audio::output::speaker_mute();		//Just mute audio if speaker is disabled
 		persistent_memory::set_config_speaker(checkbox_speaker.value());	//Store Speaker status
         	StatusRefreshMessage message { };					//Refresh status bar with/out speaker
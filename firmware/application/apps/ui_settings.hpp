@@ -190,6 +190,12 @@ private:
 		1,
 		'0',
 	};
+
+	Checkbox check_drift {
+		{ 11 * 8, 4 * 16 - 4 },
+		11,
+		"Track drift"
+	};
 	
 	Checkbox check_bias {
 		{ 28, 13 * 16 },
@@ -221,24 +227,24 @@ public:
 private:
 
 	Checkbox checkbox_disable_touchscreen {
-		{ 3 * 8, 2 * 16 },
+		{ 3 * 8, 1 * 16 },
 		20,
 		"Disable touchscreen"
 	};
 	
 	Checkbox checkbox_speaker {
-		{ 3 * 8, 4 * 16 },
+		{ 3 * 8, 3 * 16 },
 		20,
 		"Hide H1 Speaker option"
 	};
 	
 	Checkbox checkbox_bloff {
-		{ 3 * 8, 6 * 16 },
+		{ 3 * 8, 5 * 16 },
 		20,
 		"Backlight off after:"
 	};
 	OptionsField options_bloff {
-		{ 52, 7 * 16 + 8 },
+		{ 52, 6 * 16 + 8 },
 		20,
 		{
 			{ "5 seconds", 5 },
@@ -252,19 +258,19 @@ private:
 	};
 	
 	Checkbox checkbox_showsplash {
-		{ 3 * 8, 9 * 16 },
+		{ 3 * 8, 8 * 16 },
 		20,
 		"Show splash"
 	};
 	
 	Checkbox checkbox_showclock {	
-		{ 3 * 8, 11 * 16 },
+		{ 3 * 8, 10 * 16 },
 		20,
 		"Show clock with:"
 	};
 
 	OptionsField options_clockformat {
-		{ 52, 12 * 16 + 8 },
+		{ 52, 11 * 16 + 8 },
 		20,
 		{
 			{ "time only", 0 },
@@ -273,18 +279,24 @@ private:
 	};	
 
     Checkbox checkbox_guireturnflag {	
-		{ 3 * 8, 14 * 16 },
+		{ 3 * 8, 13 * 16 },
 		25,
 		"add return icon in GUI"
 	};
 	
+	Checkbox checkbox_camera_records {
+		{ 3 * 8, 15 * 16 },
+		20,
+		"Camera records video"
+	};
+
 	Button button_save {
-		{ 2 * 8, 16 * 16, 12 * 8, 32 },
+		{ 2 * 8, 16 * 16 + 8, 12 * 8, 32 },
 		"Save"
 	};
 	
 	Button button_cancel {
-		{ 16 * 8, 16 * 16, 12 * 8, 32 },
+		{ 16 * 8, 16 * 16 + 8, 12 * 8, 32 },
 		"Cancel",
 	};
 };
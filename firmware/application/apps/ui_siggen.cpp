@@ -43,11 +43,14 @@ SigGenView::~SigGenView() {
 }
 
 void SigGenView::update_config() {
-	if(checkbox_stop.value())
-		baseband::set_siggen_config(transmitter_model.channel_bandwidth(), options_shape.selected_index_value(), field_stop.value());
-	else
-		baseband::set_siggen_config(transmitter_model.channel_bandwidth(), options_shape.selected_index_value(), 0);
-	
+	baseband::set_siggen_config(
+		transmitter_model.channel_bandwidth(),
+		options_shape.selected_index_value(),
+		checkbox_stop.value() ? field_stop.value() : 0,
+		field_sweep.value(),
+		checkbox_awgn.value(),
+		field_snr.value()
+	);
 }
 
 void SigGenView::update_tone() {
@@ -93,6 +96,9 @@ SigGenView::SigGenView(
 		&checkbox_auto,
 		&checkbox_stop,
 		&field_stop,
+		&field_sweep,
+		&checkbox_awgn,
+		&field_snr,
 		&tx_view
 	});
 	
@@ -105,6 +111,23 @@ SigGenView::SigGenView(
 	text_shape.set(shape_strings[0]);
 	
 	field_stop.set_value(1);
+	field_sweep.set_value(1000);
+	field_snr.set_value(20);
+	
+	field_sweep.on_change = [this](int32_t) {
+		if (auto_update)
+			update_config();
+	};
+	
+	checkbox_awgn.on_select = [this](Checkbox&, bool) {
+		if (auto_update)
+			update_config();
+	};
+	
+	field_snr.on_change = [this](int32_t) {
+		if (auto_update)
+			update_config();
+	};
 	
 	symfield_tone.set_sym(1, 1);			// Default: 1000 Hz
 	symfield_tone.on_change = [this]() {
@@ -48,14 +48,17 @@ private:
 	void update_tone();
 	void on_tx_progress(const uint32_t progress, const bool done);
 	
-	const std::string shape_strings[7] = {
+	const std::string shape_strings[10] = {
 		"CW",
 		"Sine",
 		"Triangle",
 		"Saw up",
 		"Saw down",
 		"Square",
-		"Noise"
+		"Noise",
+		"Sweep lin",
+		"Sweep log",
+		"Two-tone"
 	};
 	
 	bool auto_update { false };
@@ -64,7 +67,9 @@ private:
 		{ { 6 * 8, 4 + 10 }, "Shape:", Color::light_grey() },
 		{ { 7 * 8, 7 * 8 }, "Tone:      Hz", Color::light_grey() },
 		{ { 22 * 8, 15 * 8 + 4 }, "s.", Color::light_grey() },
-		{ { 8 * 8, 20 * 8 }, "Modulation: FM", Color::light_grey() }
+		{ { 6 * 8, 18 * 8 + 4 }, "Sweep:      ms", Color::light_grey() },
+		{ { 17 * 8, 21 * 8 + 4 }, "SNR:    dB", Color::light_grey() },
+		{ { 8 * 8, 25 * 8 }, "Modulation: FM", Color::light_grey() }
 	};
 	
 	ImageOptionsField options_shape {
@@ -78,7 +83,10 @@ private:
 			{ &bitmap_sig_saw_up, 3 },
 			{ &bitmap_sig_saw_down, 4 },
 			{ &bitmap_sig_square, 5 },
-			{ &bitmap_sig_noise, 6 }
+			{ &bitmap_sig_noise, 6 },
+			{ &bitmap_sig_sweep_lin, 7 },
+			{ &bitmap_sig_sweep_log, 8 },
+			{ &bitmap_sig_two_tone, 9 }
 		}
 	};
 	
@@ -118,6 +126,28 @@ private:
 		' '
 	};
 	
+	NumberField field_sweep {
+		{ 13 * 8, 18 * 8 + 4 },
+		4,
+		{ 10, 9990 },
+		10,
+		' '
+	};
+	
+	Checkbox checkbox_awgn {
+		{ 5 * 8, 21 * 8 },
+		4,
+		"AWGN"
+	};
+	
+	NumberField field_snr {
+		{ 21 * 8, 21 * 8 + 4 },
+		3,
+		{ -20, 60 },
+		1,
+		' '
+	};
+	
 	TransmitterView tx_view {
 		16 * 16,
 		10000,
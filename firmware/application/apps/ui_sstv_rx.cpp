@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "ui_sstv_rx.hpp"
+
+#include "baseband_api.hpp"
+#include "audio.hpp"
+#include "string_format.hpp"
+#include "bmp.hpp"
+#include "sstv.hpp"
+
+#include "portapack.hpp"
+
+#include <algorithm>
+
+using namespace portapack;
+
+/* SSTVRecorder **********************************************************/
+
+namespace {
+
+constexpr uint32_t image_data_offset = sizeof(bmp_header_t);
+
+} /* namespace */
+
+SSTVRecorder::~SSTVRecorder() {
+	if( lines > 0 ) {
+		write_header();
+	}
+}
+
+Optional<File::Error> SSTVRecorder::create(const std::filesystem::path& filename) {
+	const auto create_error = file.create(filename);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+	return write_header();
+}
+
+Optional<File::Error> SSTVRecorder::write_line(const SSTVRxLine& line) {
+	for(size_t x=0; x<SSTVRxLine::width; x++) {
+		bgr[x * 3 + 0] = line.rgb[x * 3 + 2];
+		bgr[x * 3 + 1] = line.rgb[x * 3 + 1];
+		bgr[x * 3 + 2] = line.rgb[x * 3 + 0];
+	}
+
+	const auto seek_result = file.seek(image_data_offset + line.row * row_size);
+	if( seek_result.is_error() ) {
+		return seek_result.error();
+	}
+	const auto result = file.write(bgr);
+	if( result.is_error() ) {
+		return result.error();
+	}
+	lines = std::max<uint32_t>(lines, line.row + 1);
+
+	// Keep the file viewable if the picture is cut short
+	if( (lines % header_interval) == 0 ) {
+		return write_header();
+	}
+	return { };
+}
+
+Optional<File::Error> SSTVRecorder::write_header() {
+	const uint32_t data_size = lines * row_size;
+
+	const bmp_header_t header {
+		0x4D42,							// "BM"
+		image_data_offset + data_size,
+		0, 0,
+		image_data_offset,
+		40,
+		SSTVRxLine::width,
+		static_cast<uint32_t>(-static_cast<int32_t>(lines)),	// Negative, rows are top down
+		1,
+		24,
+		0,
+		data_size,
+		2835, 2835,						// 72 DPI
+		0,
+		0
+	};
+
+	const auto seek_result = file.seek(0);
+	if( seek_result.is_error() ) {
+		return seek_result.error();
+	}
+	const auto result = file.write(&header, sizeof(header));
+	if( result.is_error() ) {
+		return result.error();
+	}
+	return { };
+}
+
+namespace ui {
+
+/* SSTVImageView *********************************************************/
+
+SSTVImageView::SSTVImageView(
+	const Rect parent_rect
+) : Widget { parent_rect }
+{
+}
+
+void SSTVImageView::paint(Painter& painter) {
+	// Rows are drawn as they come, only clear what hasn't been received
+	if( last_y < 0 ) {
+		painter.fill_rectangle(screen_rect(), Color::black());
+	}
+}
+
+void SSTVImageView::clear() {
+	last_y = -1;
+	display.fill_rectangle(screen_rect(), Color::black());
+}
+
+void SSTVImageView::add_line(const SSTVRxLine& line) {
+	// Scaled by 3/4 both ways, which keeps the aspect ratio
+	const int32_t y = line.row * 3 / 4;
+	const auto r = screen_rect();
+	if( (y == last_y) || (y >= r.height()) ) {
+		return;
+	}
+	last_y = y;
+
+	std::array<Color, 240> pixel_row;
+	for(size_t x=0; x<pixel_row.size(); x++) {
+		const auto rgb = &line.rgb[(x * 4 / 3) * 3];
+		pixel_row[x] = Color { rgb[0], rgb[1], rgb[2] };
+	}
+
+	display.draw_pixels(
+		{ { r.left(), r.top() + y }, { static_cast<int>(pixel_row.size()), 1 } },
+		pixel_row
+	);
+}
+
+/* SSTVRxView ************************************************************/
+
+SSTVRxView::SSTVRxView(NavigationView& nav) {
+	baseband::run_image(portapack::spi_flash::image_tag_sstv_rx);
+
+	add_children({
+		&field_frequency,
+		&field_rf_amp,
+		&field_lna,
+		&field_vga,
+		&rssi,
+		&field_volume,
+		&text_status,
+		&check_save,
+		&text_file,
+		&image,
+	});
+
+	// ISS SSTV events, also the usual 2m FM calling area
+	auto frequency = receiver_model.tuning_frequency();
+	if( (frequency < 144000000) || (frequency > 146000000) ) {
+		frequency = 145800000;
+	}
+
+	receiver_model.set_modulation(ReceiverModel::Mode::NarrowbandFMAudio);
+	receiver_model.set_nbfm_configuration(2);		// 16k0, 5kHz deviation
+	receiver_model.set_sampling_rate(3072000);
+	receiver_model.set_baseband_bandwidth(1750000);
+	on_frequency_changed(frequency);
+	receiver_model.enable();
+
+	field_frequency.set_value(frequency);
+	field_frequency.set_step(receiver_model.frequency_step());
+	field_frequency.on_change = [this](rf::Frequency f) {
+		this->on_frequency_changed(f);
+	};
+	field_frequency.on_edit = [this, &nav]() {
+		auto new_view = nav.push<FrequencyKeypadView>(receiver_model.tuning_frequency());
+		new_view->on_changed = [this](rf::Frequency f) {
+			this->on_frequency_changed(f);
+			field_frequency.set_value(f);
+		};
+	};
+
+	field_volume.set_value((receiver_model.headphone_volume() - audio::headphone::volume_range().max).decibel() + 99);
+	field_volume.on_change = [this](int32_t v) {
+		this->on_headphone_volume_changed(v);
+	};
+
+	check_save.set_value(true);
+
+	audio::output::start();
+	audio::output::unmute();
+}
+
+SSTVRxView::~SSTVRxView() {
+	recorder.reset();
+
+	audio::output::stop();
+	receiver_model.disable();
+	baseband::shutdown();
+}
+
+void SSTVRxView::focus() {
+	field_frequency.focus();
+}
+
+void SSTVRxView::on_frequency_changed(const rf::Frequency f) {
+	receiver_model.set_tuning_frequency(f);
+}
+
+void SSTVRxView::on_headphone_volume_changed(int32_t v) {
+	const auto new_volume = volume_t::decibel(v - 99) + audio::headphone::volume_range().max;
+	receiver_model.set_headphone_volume(new_volume);
+}
+
+void SSTVRxView::on_lines(SSTVRxLineFIFO* const fifo) {
+	while( fifo->out(line) ) {
+		image.add_line(line);
+
+		if( recorder ) {
+			const auto error = recorder->write_line(line);
+			if( error.is_valid() ) {
+				recorder.reset();
+				text_file.set("Write error");
+			}
+		}
+	}
+}
+
+void SSTVRxView::on_status(const SSTVRxStatusMessage& message) {
+	using State = SSTVRxStatusMessage::State;
+
+	if( message.mode >= SSTV_MODES_NB ) {
+		return;
+	}
+	const auto& sstv_mode = sstv::sstv_modes[message.mode];
+
+	switch(message.state) {
+	case State::Receiving:
+		// The decoder reports row 0 once, right after the VIS code
+		if( message.row == 0 ) {
+			image.clear();
+			stop_recording();
+			if( check_save.value() ) {
+				start_recording();
+			}
+		}
+		text_status.set(
+			std::string(sstv_mode.name) + " " +
+			to_string_dec_uint(message.row) + "/" + to_string_dec_uint(sstv_mode.lines) + " " +
+			to_string_dec_int(message.clock_ppm) + "ppm"
+		);
+		break;
+
+	case State::Done:
+		stop_recording();
+		text_status.set(std::string(sstv_mode.name) + " done");
+		break;
+
+	case State::Lost:
+		stop_recording();
+		text_status.set(std::string(sstv_mode.name) + " lost sync");
+		break;
+
+	default:
+		break;
+	}
+}
+
+void SSTVRxView::start_recording() {
+	auto path = next_filename_stem_matching_pattern(u"SSTV_????");
+	if( path.empty() ) {
+		text_file.set("No free filename");
+		return;
+	}
+	path.replace_extension(u".BMP");
+
+	recorder = std::make_unique<SSTVRecorder>();
+	const auto error = recorder->create(path);
+	if( error.is_valid() ) {
+		recorder.reset();
+		text_file.set(error.value().what());
+		return;
+	}
+	text_file.set("Saving " + path.filename().string());
+}
+
+void SSTVRxView::stop_recording() {
+	if( recorder ) {
+		const auto lines = recorder->line_count();
+		recorder.reset();
+		text_file.set("Saved " + to_string_dec_uint(lines) + " rows");
+	}
+}
+
+} /* namespace ui */
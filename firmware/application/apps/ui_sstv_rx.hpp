@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __UI_SSTV_RX_H__
+#define __UI_SSTV_RX_H__
+
+#include "ui.hpp"
+#include "ui_widget.hpp"
+#include "ui_navigation.hpp"
+#include "ui_receiver.hpp"
+#include "ui_rssi.hpp"
+
+#include "event_m0.hpp"
+#include "message.hpp"
+#include "file.hpp"
+
+#include <memory>
+
+/* Writes SSTV rows to a 24 bit BMP. Rows are top down and each one is written
+ * at its own place, so a row dropped on the way leaves a black line instead
+ * of shifting the rest of the picture.
+ */
+class SSTVRecorder {
+public:
+	~SSTVRecorder();
+
+	Optional<File::Error> create(const std::filesystem::path& filename);
+	Optional<File::Error> write_line(const SSTVRxLine& line);
+
+	uint32_t line_count() const {
+		return lines;
+	}
+
+private:
+	static constexpr uint32_t header_interval = 16;
+	static constexpr uint32_t row_size = SSTVRxLine::width * 3;
+
+	File file { };
+	uint32_t lines { 0 };
+	std::array<uint8_t, row_size> bgr { };
+
+	Optional<File::Error> write_header();
+};
+
+namespace ui {
+
+/* The picture as it comes in, 320 pixels wide squeezed into 240. */
+class SSTVImageView : public Widget {
+public:
+	SSTVImageView(const Rect parent_rect);
+
+	void paint(Painter& painter) override;
+
+	void clear();
+	void add_line(const SSTVRxLine& line);
+
+private:
+	int32_t last_y { -1 };
+};
+
+class SSTVRxView : public View {
+public:
+	SSTVRxView(NavigationView& nav);
+	~SSTVRxView();
+
+	void focus() override;
+
+	std::string title() const override { return "SSTV RX"; };
+
+private:
+	SSTVRxLine line { };
+	std::unique_ptr<SSTVRecorder> recorder { };
+
+	void on_frequency_changed(const rf::Frequency f);
+	void on_headphone_volume_changed(int32_t v);
+	void on_lines(SSTVRxLineFIFO* const fifo);
+	void on_status(const SSTVRxStatusMessage& message);
+	void start_recording();
+	void stop_recording();
+
+	FrequencyField field_frequency {
+		{ 0 * 8, 0 * 16 },
+	};
+
+	RFAmpField field_rf_amp {
+		{ 13 * 8, 0 * 16 }
+	};
+
+	LNAGainField field_lna {
+		{ 15 * 8, 0 * 16 }
+	};
+
+	VGAGainField field_vga {
+		{ 18 * 8, 0 * 16 }
+	};
+
+	RSSI rssi {
+		{ 21 * 8, 0, 6 * 8, 4 },
+	};
+
+	NumberField field_volume {
+		{ 28 * 8, 0 * 16 },
+		2,
+		{ 0, 99 },
+		1,
+		' ',
+	};
+
+	Text text_status {
+		{ 0 * 8, 1 * 16, 22 * 8, 16 },
+		"Waiting for VIS"
+	};
+
+	Checkbox check_save {
+		{ 22 * 8, 1 * 16 },
+		4,
+		"Save"
+	};
+
+	Text text_file {
+		{ 0 * 8, 2 * 16, 30 * 8, 16 },
+		""
+	};
+
+	SSTVImageView image {
+		{ 0, 3 * 16 + 8, 240, 192 }
+	};
+
+	MessageHandlerRegistration message_handler_line {
+		Message::ID::SSTVRxLine,
+		[this](Message* const p) {
+			const auto message = static_cast<const SSTVRxLineMessage*>(p);
+			this->on_lines(message->fifo);
+		}
+	};
+
+	MessageHandlerRegistration message_handler_status {
+		Message::ID::SSTVRxStatus,
+		[this](Message* const p) {
+			const auto message = static_cast<const SSTVRxStatusMessage*>(p);
+			this->on_status(*message);
+		}
+	};
+};
+
+} /* namespace ui */
+
+#endif/*__UI_SSTV_RX_H__*/
@@ -131,15 +131,15 @@ void SSTVTXView::prepare_scanline() {
 	if ((!scanline_counter && tx_sstv_mode->sync_on_first) || (component == tx_sstv_mode->sync_index)) {
 		// Sync
 		scanline_buffer.start_tone.frequency = SSTV_F2D(1200);
-		scanline_buffer.start_tone.duration = tx_sstv_mode->samples_per_sync;
+		scanline_buffer.start_tone.duration = tx_sstv_mode->samples_per_sync();
 		scanline_buffer.gap_tone.frequency = SSTV_F2D(1500);
-		scanline_buffer.gap_tone.duration = tx_sstv_mode->samples_per_gap;
+		scanline_buffer.gap_tone.duration = tx_sstv_mode->samples_per_gap();
 	} else {
 		// Regular scanline
 		scanline_buffer.start_tone.duration = 0;
 		if (tx_sstv_mode->gaps) {
 			scanline_buffer.gap_tone.frequency = SSTV_F2D(1500);
-			scanline_buffer.gap_tone.duration = tx_sstv_mode->samples_per_gap;
+			scanline_buffer.gap_tone.duration = tx_sstv_mode->samples_per_gap();
 		}
 	}
 	
@@ -175,7 +175,7 @@ void SSTVTXView::start_tx() {
 	
 	baseband::set_sstv_data(
 		tx_sstv_mode->vis_code,
-		tx_sstv_mode->samples_per_pixel
+		tx_sstv_mode->samples_per_pixel()
 	);
 	
 	// Todo: Find a better way to prevent user from changing bitmap during tx
@@ -270,8 +270,10 @@ SSTVTXView::SSTVTXView(
 	options_bitmaps.set_options(bitmap_options);
 
 	// Populate mode list
-	for (c = 0; c < SSTV_MODES_NB; c++)
-		mode_options.emplace_back(sstv_modes[c].name, c);
+	for (c = 0; c < SSTV_MODES_NB; c++) {
+		if (sstv_modes[c].color_sequence != SSTV_COLOR_YUV)
+			mode_options.emplace_back(sstv_modes[c].name, c);
+	}
 	options_modes.set_options(mode_options);
 	
 	options_bitmaps.on_change = [this](size_t i, int32_t) {
@@ -280,8 +282,8 @@ SSTVTXView::SSTVTXView(
 	options_bitmaps.set_selected_index(0);	// First file
 	on_bitmap_changed(0);
 	
-	options_modes.on_change = [this](size_t i, int32_t) {
-		this->on_mode_changed(i);
+	options_modes.on_change = [this](size_t, int32_t v) {
+		this->on_mode_changed(v);
 	};
 	options_modes.set_selected_index(1);	// Scottie 2
 	on_mode_changed(1);
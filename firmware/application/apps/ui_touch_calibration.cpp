@@ -182,10 +182,10 @@ void TouchCalibrationView::on_frame_sync() {
 
 	const auto frame = get_touch_frame();
 	const auto metrics = touch::calculate_metrics(frame);
-	const auto x = metrics.x * 1024;
-	const auto y = metrics.y * 1024;
+	const auto x = metrics.x;
+	const auto y = metrics.y;
 
-	if( metrics.r < 640.0f ) {
+	if( metrics.r < 640 ) {
 		if( samples_count > 0 ) {
 			average.x = ((average.x * 7) + x) / 8;
 			average.y = ((average.y * 7) + y) / 8;
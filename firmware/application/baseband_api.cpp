@@ -31,6 +31,8 @@
 
 #include "core_control.hpp"
 
+#include <algorithm>
+
 using namespace portapack;
 
 namespace baseband {
@@ -56,7 +58,7 @@ void AMConfig::apply() const {
 	audio::set_rate(audio::Rate::Hz_12000);
 }
 
-void NBFMConfig::apply(const uint8_t squelch_level) const {
+void NBFMConfig::apply() const {
 	const NBFMConfigureMessage message {
 		decim_0,
 		decim_1,
@@ -64,8 +66,7 @@ void NBFMConfig::apply(const uint8_t squelch_level) const {
 		2,
 		deviation,
 		audio_24k_hpf_300hz_config,
-		audio_24k_deemph_300_6_config,
-		squelch_level
+		audio_24k_deemph_300_6_config
 	};
 	send_message(&message);
 	audio::set_rate(audio::Rate::Hz_24000);
@@ -84,18 +85,151 @@ void WFMConfig::apply() const {
 	audio::set_rate(audio::Rate::Hz_48000);
 }
 
+void GraphConfig::apply(const uint8_t squelch_level) const {
+	// The M4 would refuse it anyway, don't bother sending
+	if (!graph::is_valid(stages))
+		return;
+
+	const auto count = graph::stage_count(stages);
+	uint32_t audio_fs = baseband_fs;
+	for (size_t i = 0; i < count; i++)
+		audio_fs /= graph::decimation_factor(stages[i]);
+
+	const auto hpf_config = (audio_fs == 12000) ? audio_12k_hpf_300hz_config :
+							(audio_fs == 24000) ? audio_24k_hpf_300hz_config : audio_48k_hpf_30hz_config;
+	const auto deemph_config = (audio_fs == 24000) ? audio_24k_deemph_300_6_config : iir_config_passthrough;
+
+	const BasebandGraphConfigureMessage message {
+		stages,
+		baseband_fs,
+		decim_0,
+		decim_1,
+		channel,
+		hpf_config,
+		deemph_config,
+		squelch_level
+	};
+	send_message(&message);
+
+	// Packet chains leave the audio alone
+	const auto sink = stages[count - 1].kind;
+	if ((sink != graph::StageKind::AudioSinkS16) && (sink != graph::StageKind::AudioSinkF32))
+		return;
+
+	if (audio_fs == 12000)
+		audio::set_rate(audio::Rate::Hz_12000);
+	else if (audio_fs == 24000)
+		audio::set_rate(audio::Rate::Hz_24000);
+	else
+		audio::set_rate(audio::Rate::Hz_48000);
+}
+
+/* Tone sequences given as a table of tone definitions and a message of indexes
+ * into it. The message is turned into commands for the ring as the baseband
+ * asks for them, so its length isn't bound by shared memory.
+ */
+namespace {
+
+struct ToneDef {
+	uint32_t delta;
+	uint32_t duration;
+};
+
+struct ToneSequence {
+	ToneDef tone_defs[32];
+	uint32_t silence;
+	uint8_t message[tones_message_max];
+	size_t length;
+	size_t position;
+	bool dual_tone;
+};
+
+ToneSequence tone_sequence { };
+
+constexpr uint32_t tone_ramp = TONES_SAMPLERATE / 200;	// 5ms
+
+} /* namespace */
+
 void set_tone(const uint32_t index, const uint32_t delta, const uint32_t duration) {
-	shared_memory.bb_data.tones_data.tone_defs[index].delta = delta;
-	shared_memory.bb_data.tones_data.tone_defs[index].duration = duration;
+	tone_sequence.tone_defs[index].delta = delta;
+	tone_sequence.tone_defs[index].duration = duration;
+}
+
+void set_tones_silence(const uint32_t duration) {
+	tone_sequence.silence = duration;
+}
+
+uint8_t* tones_message() {
+	return tone_sequence.message;
+}
+
+bool push_tone(const ToneCommand& command) {
+	auto& ring = shared_memory.bb_data.tones;
+	const uint32_t write_index = ring.write_index;
+	
+	if (write_index - ring.read_index >= ToneRing::size)
+		return false;
+	
+	ring.commands[write_index % ToneRing::size] = command;
+	__DMB();		// Publish only after the command is written
+	ring.write_index = write_index + 1;
+	return true;
+}
+
+void close_tones() {
+	shared_memory.bb_data.tones.closed = 1;
+}
+
+void tones_fill() {
+	auto& seq = tone_sequence;
+	
+	while (seq.position < seq.length) {
+		const uint8_t digit = seq.message[seq.position];
+		ToneCommand command { };
+		
+		if (digit >= 32) {
+			command.silence = seq.silence;
+		} else if (!seq.dual_tone) {
+			command.delta_a = seq.tone_defs[digit].delta;
+			command.amplitude_a = command.delta_a ? 32767 : 0;
+			command.duration = seq.tone_defs[digit].duration;
+		} else {
+			command.delta_a = seq.tone_defs[digit << 1].delta;
+			command.delta_b = seq.tone_defs[(digit << 1) + 1].delta;
+			command.amplitude_a = 16383;
+			command.amplitude_b = 16383;
+			command.duration = seq.tone_defs[digit << 1].duration;
+		}
+		command.ramp = tone_ramp;
+		
+		if (!push_tone(command))
+			return;
+		
+		seq.position++;
+	}
+	
+	close_tones();
 }
 
 void set_tones_config(const uint32_t bw, const uint32_t pre_silence, const uint16_t tone_count,
 					const bool dual_tone, const bool audio_out) {
+	tone_sequence.length = std::min<size_t>(tone_count, tones_message_max);
+	tone_sequence.position = 0;
+	tone_sequence.dual_tone = dual_tone;
+	
+	start_tones(bw, pre_silence, audio_out);
+	tones_fill();
+}
+
+void start_tones(const uint32_t bw, const uint32_t pre_silence, const bool audio_out) {
+	// The M4 empties the ring when it takes this message, write_index just
+	// carries on from there
+	shared_memory.bb_data.tones.closed = 0;
+	
 	const TonesConfigureMessage message {
 		bw,
 		pre_silence,
-		tone_count,
-		dual_tone,
+		true,
 		audio_out
 	};
 	send_message(&message);
@@ -103,7 +237,6 @@ void set_tones_config(const uint32_t bw, const uint32_t pre_silence, const uint1
 
 void kill_tone() {
 	const TonesConfigureMessage message {
-		0,
 		0,
 		0,
 		false,
@@ -121,6 +254,10 @@ void set_sstv_data(const uint8_t vis_code, const uint32_t pixel_duration) {
 }
 
 void set_afsk(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word) {
+	// Drop leftovers (or whatever another image left in bb_data), write_index stays the M4's
+	auto& ring = shared_memory.bb_data.afsk_rx;
+	ring.read_index = ring.write_index;
+	
 	const AFSKRxConfigureMessage message {
 		baudrate,
 		word_length,
@@ -241,6 +378,52 @@ void set_pocsag() {
 	send_message(&message);
 }
 
+void set_ism(const bool analyze) {
+	const ISMConfigureMessage message { analyze };
+	send_message(&message);
+}
+
+void set_dcs(const bool gate, const uint16_t code, const bool inverted) {
+	const DCSConfigureMessage message { gate, code, inverted };
+	send_message(&message);
+}
+
+void set_cw_rx(const bool enabled, const uint32_t pitch) {
+	const CWRxConfigureMessage message { enabled, pitch };
+	send_message(&message);
+}
+
+void set_squelch(const uint8_t open_db, const uint8_t hysteresis_db, const uint16_t attack_ms, const uint16_t hang_ms) {
+	const SquelchConfigureMessage message { open_db, hysteresis_db, attack_ms, hang_ms };
+	send_message(&message);
+}
+
+void set_mode_classifier(const bool enabled, const uint32_t dwell_ms) {
+	const ModeClassifierConfigureMessage message { enabled, dwell_ms };
+	send_message(&message);
+}
+
+void set_channel_power(
+	const uint32_t sampling_rate,
+	const uint32_t channel_bandwidth,
+	const uint32_t channel_spacing,
+	const uint32_t adjacent_count,
+	const uint32_t report_interval_ms,
+	const int32_t frequency_offset,
+	const float gain_db
+) {
+	const ChannelPowerConfigureMessage message {
+		sampling_rate,
+		channel_bandwidth,
+		channel_spacing,
+		adjacent_count,
+		report_interval_ms,
+		frequency_offset,
+		gain_db
+	};
+	send_message(&message);
+}
+
 void set_adsb() {
 	const ADSBConfigureMessage message {
 		1
@@ -248,6 +431,17 @@ void set_adsb() {
 	send_message(&message);
 }
 
+void set_adsb_traffic(const adsb::AircraftConfig& aircraft, const uint32_t traffic_count,
+	const uint32_t traffic_radius_nm, const uint32_t seed) {
+	const ADSBTrafficConfigureMessage message {
+		aircraft,
+		traffic_count,
+		traffic_radius_nm,
+		seed
+	};
+	send_message(&message);
+}
+
 void set_jammer(const bool run, const jammer::JammerType type, const uint32_t speed) {
 	const JammerConfigureMessage message {
 		run, 
@@ -278,9 +472,12 @@ void set_siggen_tone(const uint32_t tone) {
 	send_message(&message);
 }
 
-void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration) {
+void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration,
+	const uint32_t sweep_period_ms, const bool awgn, const int32_t snr_db) {
 	const SigGenConfigMessage message {
-		bw, shape, duration * TONES_SAMPLERATE
+		bw, shape, duration * TONES_SAMPLERATE,
+		sweep_period_ms * (TONES_SAMPLERATE / 1000),
+		awgn, snr_db
 	};
 	send_message(&message);
 }
@@ -26,6 +26,7 @@
 #include "message.hpp"
 #include "pocsag_packet.hpp"
 #include "jammer.hpp"
+#include "portapack_shared_memory.hpp"
 
 #include "dsp_fir_taps.hpp"
 
@@ -48,16 +49,38 @@ struct NBFMConfig {
 	const fir_taps_real<32> channel;
 	const size_t deviation;
 
-	void apply(const uint8_t squelch_level) const;
+	void apply() const;
 };
 
 struct WFMConfig {
 	void apply() const;
 };
 
+/* Chain for the baseband graph image (image_tag_graph). Filter taps are only
+ * used by the stages that need them. baseband_fs must match the sampling rate
+ * set on the receiver model.
+ */
+struct GraphConfig {
+	const graph::stages_t stages;
+	const uint32_t baseband_fs;
+	const fir_taps_real<24> decim_0;
+	const fir_taps_real<32> decim_1;
+	const fir_taps_real<32> channel;
+
+	void apply(const uint8_t squelch_level) const;
+};
+
+constexpr size_t tones_message_max = 1024;
+
 void set_tone(const uint32_t index, const uint32_t delta, const uint32_t duration);
+void set_tones_silence(const uint32_t duration);
+uint8_t* tones_message();
 void set_tones_config(const uint32_t bw, const uint32_t pre_silence, const uint16_t tone_count,
 					const bool dual_tone, const bool audio_out);
+void tones_fill();
+void start_tones(const uint32_t bw, const uint32_t pre_silence, const bool audio_out);
+bool push_tone(const ToneCommand& command);
+void close_tones();
 void kill_tone();
 void set_sstv_data(const uint8_t vis_code, const uint32_t pixel_duration);
 void set_audiotx_config(const uint32_t divider, const float deviation_hz, const float audio_gain,
@@ -80,12 +103,29 @@ void set_ook_data(const uint32_t stream_length, const uint32_t samples_per_bit,
 void set_fsk_data(const uint32_t stream_length, const uint32_t samples_per_bit, const uint32_t shift,
 					const uint32_t progress_notice);
 void set_pocsag();
+void set_ism(const bool analyze);
+void set_dcs(const bool gate, const uint16_t code, const bool inverted);
+void set_cw_rx(const bool enabled, const uint32_t pitch);
+void set_squelch(const uint8_t open_db, const uint8_t hysteresis_db, const uint16_t attack_ms, const uint16_t hang_ms);
+void set_mode_classifier(const bool enabled, const uint32_t dwell_ms);
+void set_channel_power(
+	const uint32_t sampling_rate,
+	const uint32_t channel_bandwidth,
+	const uint32_t channel_spacing,
+	const uint32_t adjacent_count,
+	const uint32_t report_interval_ms,
+	const int32_t frequency_offset,
+	const float gain_db
+);
 void set_adsb();
+void set_adsb_traffic(const adsb::AircraftConfig& aircraft, const uint32_t traffic_count,
+	const uint32_t traffic_radius_nm, const uint32_t seed);
 void set_jammer(const bool run, const jammer::JammerType type, const uint32_t speed);
 void set_rds_data(const uint16_t message_length);
 void set_spectrum(const size_t sampling_rate, const size_t trigger);
 void set_siggen_tone(const uint32_t tone);
-void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration);
+void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration,
+	const uint32_t sweep_period_ms, const bool awgn, const int32_t snr_db);
 void request_beep();
 
 void run_image(const portapack::spi_flash::image_tag_t image_tag);
@@ -2275,6 +2275,82 @@ static constexpr Bitmap bitmap_sig_square {
 	{ 32, 32 }, bitmap_sig_square_data
 };
 
+static constexpr uint8_t bitmap_sig_sweep_lin_data[] = {
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x06, 0x00, 0x00, 0xC0, 
+	0x1C, 0x00, 0x38, 0xC0, 
+	0x30, 0x00, 0x6C, 0x60, 
+	0x60, 0x00, 0x6C, 0x60, 
+	0xC0, 0x00, 0xCC, 0x30, 
+	0xC0, 0x00, 0xC6, 0x30, 
+	0x80, 0x01, 0xC6, 0x30, 
+	0x00, 0x03, 0xC6, 0x30, 
+	0x00, 0x03, 0x83, 0x31, 
+	0x00, 0x03, 0x83, 0x19, 
+	0x00, 0x06, 0x83, 0x19, 
+	0x00, 0x8C, 0x01, 0x1B, 
+	0x00, 0xCC, 0x00, 0x1B, 
+	0x00, 0xD8, 0x00, 0x0F, 
+	0x00, 0x70, 0x00, 0x0E, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+};
+static constexpr Bitmap bitmap_sig_sweep_lin {
+	{ 32, 32 }, bitmap_sig_sweep_lin_data
+};
+
+static constexpr uint8_t bitmap_sig_sweep_log_data[] = {
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x06, 0x00, 0x00, 0x00, 
+	0x7C, 0x00, 0xE0, 0x30, 
+	0xC0, 0x00, 0xF0, 0x30, 
+	0x80, 0x01, 0xF0, 0x70, 
+	0x00, 0x03, 0xB0, 0x79, 
+	0x00, 0x06, 0x98, 0x79, 
+	0x00, 0x0C, 0x98, 0x79, 
+	0x00, 0x0C, 0x98, 0x79, 
+	0x00, 0x0C, 0x0C, 0x7B, 
+	0x00, 0x18, 0x0C, 0xDB, 
+	0x00, 0x30, 0x0C, 0xCF, 
+	0x00, 0x30, 0x0C, 0xCF, 
+	0x00, 0x60, 0x06, 0xCF, 
+	0x00, 0xC0, 0x06, 0xCE, 
+	0x00, 0xC0, 0x03, 0x06, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+};
+static constexpr Bitmap bitmap_sig_sweep_log {
+	{ 32, 32 }, bitmap_sig_sweep_log_data
+};
+
 static constexpr uint8_t bitmap_sig_tri_data[] = {
 	0x00, 0x00, 0x00, 0x00, 
 	0x00, 0x00, 0x00, 0x00, 
@@ -2313,6 +2389,44 @@ static constexpr Bitmap bitmap_sig_tri {
 	{ 32, 32 }, bitmap_sig_tri_data
 };
 
+static constexpr uint8_t bitmap_sig_two_tone_data[] = {
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0x00, 0x06, 0x30, 0x00, 
+	0xFE, 0xFF, 0xFF, 0x7F, 
+	0xFE, 0xFF, 0xFF, 0x7F, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 
+};
+static constexpr Bitmap bitmap_sig_two_tone {
+	{ 32, 32 }, bitmap_sig_two_tone_data
+};
+
 static constexpr uint8_t bitmap_stop_data[] = {
 	0xFF, 0xFF, 
 	0xFF, 0xFF, 
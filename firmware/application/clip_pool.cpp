@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "clip_pool.hpp"
+
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+/* Same metadata the Replay app reads: "sample_rate=" in a .TXT next to the capture */
+uint32_t ClipPool::sample_rate(std::filesystem::path path) {
+	File info_file;
+	path.replace_extension(u".TXT");
+	if( info_file.open(path).is_valid() ) {
+		return default_sample_rate;
+	}
+
+	char file_data[257] { };
+	auto read_size = info_file.read(file_data, 256);
+	if( read_size.is_error() ) {
+		return default_sample_rate;
+	}
+
+	auto pos = strstr(file_data, "sample_rate=");
+	if( !pos ) {
+		return default_sample_rate;
+	}
+	const auto rate = strtoll(pos + 12, nullptr, 10);
+	return (rate > 0) ? rate : default_sample_rate;
+}
+
+File::Result<File::Size> MemoryReader::read(void* const buffer, const File::Size bytes) {
+	auto p = static_cast<int16_t*>(buffer);
+	const size_t count = std::min<size_t>(bytes / sizeof(int16_t), size + tail - position);
+	const size_t clip_count = (position < size) ? std::min(count, size - position) : 0;
+
+	// Same scaling ReplayProcessor undoes on the way to C8
+	for(size_t i=0; i<clip_count; i++) {
+		p[i] = data[position + i] << 8;
+	}
+	// The tail, and whatever ReplayThread prefills past the end, is silence
+	std::fill(&p[clip_count], &p[bytes / sizeof(int16_t)], 0);
+
+	position += count;
+	return { static_cast<File::Size>(count * sizeof(int16_t)) };
+}
+
+ClipPool::ClipPool() : pool { std::make_unique<int8_t[]>(pool_size) }
+{
+}
+
+Optional<File::Error> ClipPool::load(const size_t slot, const std::filesystem::path& path) {
+	if( slot >= slots_max ) {
+		return { File::Error { FR_INVALID_PARAMETER } };
+	}
+
+	File file;
+	auto open_error = file.open(path);
+	if( open_error.is_valid() ) {
+		return open_error;
+	}
+
+	// Whole C16 samples only, stored at half the size
+	const size_t needed = (file.size() / 4) * 2;
+	if( needed == 0 ) {
+		return { File::Error { FR_INVALID_OBJECT } };
+	}
+	clear(slot);
+	if( needed > (pool_size - used_) ) {
+		return { File::Error { FR_NOT_ENOUGH_CORE } };
+	}
+
+	auto dst = &pool[used_];
+	std::array<int16_t, 256> block;
+	size_t loaded = 0;
+	while( loaded < needed ) {
+		const size_t count = std::min(block.size(), needed - loaded);
+		auto read_size = file.read(block.data(), count * sizeof(int16_t));
+		if( read_size.is_error() ) {
+			return read_size.error();
+		}
+		const size_t got = read_size.value() / sizeof(int16_t);
+		if( got == 0 ) {
+			break;
+		}
+		for(size_t i=0; i<got; i++) {
+			dst[loaded + i] = block[i] >> 8;
+		}
+		loaded += got;
+	}
+
+	auto& clip = clips[slot];
+	clip.name = path.stem().string();
+	clip.sample_rate = sample_rate(path);
+	clip.offset = used_;
+	clip.size = loaded;
+	used_ += loaded;
+
+	return { };
+}
+
+void ClipPool::clear(const size_t slot) {
+	if( (slot >= slots_max) || (clips[slot].size == 0) ) {
+		return;
+	}
+
+	// Keep the pool packed so the free space is always at the end
+	const auto removed = clips[slot];
+	std::memmove(&pool[removed.offset], &pool[removed.offset + removed.size], used_ - (removed.offset + removed.size));
+	for(auto& clip : clips) {
+		if( clip.offset > removed.offset ) {
+			clip.offset -= removed.size;
+		}
+	}
+	used_ -= removed.size;
+	clips[slot] = { };
+}
+
+uint32_t ClipPool::duration_ms(const size_t slot) const {
+	const auto& clip = clips[slot];
+	if( clip.sample_rate == 0 ) {
+		return 0;
+	}
+	return (uint64_t(clip.size / 2) * 1000) / clip.sample_rate;
+}
+
+uint32_t ClipPool::free_ms(const uint32_t sample_rate) const {
+	if( sample_rate == 0 ) {
+		return 0;
+	}
+	return (uint64_t((pool_size - used_) / 2) * 1000) / sample_rate;
+}
+
+std::unique_ptr<stream::Reader> ClipPool::reader(const size_t slot, const size_t tail_bytes) const {
+	const auto& clip = clips[slot];
+	return std::make_unique<MemoryReader>(&pool[clip.offset], clip.size, tail_bytes);
+}
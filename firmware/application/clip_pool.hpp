@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __CLIP_POOL_H__
+#define __CLIP_POOL_H__
+
+#include "io.hpp"
+#include "file.hpp"
+#include "optional.hpp"
+#include "utility.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <memory>
+#include <string>
+
+/* Reads a clip out of RAM. Stored as C8, handed out as C16 like the capture
+ * files it came from, followed by tail_bytes of silence before the end of
+ * the stream.
+ */
+class MemoryReader : public stream::Reader {
+public:
+	MemoryReader(
+		const int8_t* const data,
+		const size_t size,
+		const size_t tail_bytes
+	) : data { data },
+		size { size },
+		tail { tail_bytes / sizeof(int16_t) }
+	{
+	}
+
+	File::Result<File::Size> read(void* const buffer, const File::Size bytes) override;
+
+private:
+	const int8_t* const data;
+	const size_t size;
+	const size_t tail;
+	size_t position { 0 };
+};
+
+/* Short IQ clips preloaded from the SD card into one fixed block of RAM, so a
+ * replay can start the moment it's triggered and never waits on the card.
+ * The M0 only has 64 KiB in all and no spare region to borrow, so the pool
+ * holds 8192 samples: 16ms at 500kHz, longer only for slower captures.
+ */
+class ClipPool {
+public:
+	static constexpr size_t pool_size = 16_KiB;
+	static constexpr uint32_t default_sample_rate = 500000;
+	static constexpr size_t slots_max = 6;
+
+	struct Clip {
+		std::string name { };
+		uint32_t sample_rate { 0 };
+		size_t offset { 0 };
+		size_t size { 0 };		// Bytes of C8, 0 = empty slot
+	};
+
+	ClipPool();
+
+	/* Loads a C16 capture (and the sample rate from its .TXT) into a slot,
+	 * replacing what was there.
+	 */
+	Optional<File::Error> load(const size_t slot, const std::filesystem::path& path);
+	void clear(const size_t slot);
+
+	const Clip& clip(const size_t slot) const {
+		return clips[slot];
+	}
+
+	size_t used() const {
+		return used_;
+	}
+
+	/* Milliseconds of clip a slot holds */
+	uint32_t duration_ms(const size_t slot) const;
+
+	/* Milliseconds of clip that still fit, at a given sample rate */
+	uint32_t free_ms(const uint32_t sample_rate) const;
+
+	/* From the .TXT next to a capture, as the Replay app reads it */
+	static uint32_t sample_rate(std::filesystem::path path);
+
+	/* The silent tail lets the consumer drain whatever it has queued before it
+	 * sees the end of the stream.
+	 */
+	std::unique_ptr<stream::Reader> reader(const size_t slot, const size_t tail_bytes) const;
+
+private:
+	std::unique_ptr<int8_t[]> pool;
+	std::array<Clip, slots_max> clips { };
+	size_t used_ { 0 };
+};
+
+#endif/*__CLIP_POOL_H__*/
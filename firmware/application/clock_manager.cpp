@@ -368,20 +368,36 @@ void ClockManager::set_reference_ppb(const int32_t ppb) {
 	 * It is assumed an external clock coming in to PLLB is sufficiently accurate as to not need adjustment.
 	 * TODO: Revisit the above policy. It may be good to allow adjustment of the external reference too.
 	 */
+	/* The fractional part b/c of the feedback divider is a * ppb / 1e9. With
+	 * c = 1e6 one step of b is 1000 / a = 31.25ppb, fine enough to track
+	 * drift without visible jumps. Only the PLL feedback is rewritten, the
+	 * PLL is not reset, so the output slews to the new frequency.
+	 */
 	constexpr uint32_t pll_multiplier = si5351_pll_xtal_25m.a;
-	constexpr uint32_t denominator = 1000000 / pll_multiplier;
-	const uint32_t new_a = (ppb >= 0) ? pll_multiplier : (pll_multiplier - 1);
-	const uint32_t new_b = (ppb >= 0) ? (ppb / 1000) : (denominator + (ppb / 1000));
-	const uint32_t new_c = (ppb == 0) ? 1 : denominator;
+	constexpr uint32_t denominator = 1000000;
+	const int32_t steps = (static_cast<int64_t>(ppb) * pll_multiplier) / 1000;
+	const uint32_t new_a = (steps >= 0) ? pll_multiplier : (pll_multiplier - 1);
+	const uint32_t new_b = (steps >= 0) ? steps : (denominator + steps);
 
 	const si5351::PLL pll {
 		.f_in = si5351_inputs.f_xtal,
 		.a = new_a,
 		.b = new_b,
-		.c = new_c,
+		.c = denominator,
 	};
 	const auto pll_a_reg = pll.reg(0);
 	clock_generator.write(pll_a_reg);
+
+	reference_ppb = ppb;
+	reference_ppb_applied = (steps * 1000) / static_cast<int32_t>(pll_multiplier);
+}
+
+int32_t ClockManager::get_reference_ppb() const {
+	return reference_ppb;
+}
+
+int32_t ClockManager::get_reference_ppb_residual() const {
+	return reference_ppb - reference_ppb_applied;
 }
 
 void ClockManager::start_frequency_monitor_measurement(const cgu::CLK_SEL clk_sel) {
@@ -74,6 +74,9 @@ public:
 	void set_sampling_frequency(const uint32_t frequency);
 
 	void set_reference_ppb(const int32_t ppb);
+	int32_t get_reference_ppb() const;
+	/* Part of the requested correction the PLL can't resolve */
+	int32_t get_reference_ppb_residual() const;
 
 	uint32_t get_frequency_monitor_measurement_in_hertz();
 
@@ -85,6 +88,8 @@ private:
 	I2C& i2c0;
 	si5351::Si5351& clock_generator;
 	Reference reference;
+	int32_t reference_ppb { 0 };
+	int32_t reference_ppb_applied { 0 };
 
 	void set_gp_clkin_to_clkin_direct();
 
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "drift_compensator.hpp"
+
+#include "portapack.hpp"
+#include "portapack_persistent_memory.hpp"
+#include "radio.hpp"
+
+#include <algorithm>
+
+using namespace portapack;
+
+void DriftCompensator::second_tick() {
+	// The MAX2837 sensor reads garbage while the radio is idle. A new sample is
+	// only trusted if the radio ran for the whole second it was taken in.
+	const bool radio_enabled = radio::is_enabled();
+	const bool sample_valid = radio_enabled && radio_was_enabled;
+	radio_was_enabled = radio_enabled;
+	update_temperature(sample_valid);
+
+	// Nothing to do on an external or TCXO reference, the correction isn't applied there
+	if( clock_manager.get_reference().source != ClockManager::ReferenceSource::Xtal ) {
+		return;
+	}
+
+	// Hold the curve's correction while idle, nothing is tuned anyway
+	if( radio_enabled ) {
+		int32_t target = 0;
+		if( has_temperature && persistent_memory::drift_compensation() ) {
+			target = persistent_memory::drift_curve().correction_ppb(temperature);
+		}
+		applied += std::max(-slew_ppb, std::min(target - applied, slew_ppb));
+	}
+
+	// Also catches the static correction being changed in the settings
+	const int32_t reference_ppb = persistent_memory::correction_ppb() + applied;
+	if( reference_ppb != clock_manager.get_reference_ppb() ) {
+		clock_manager.set_reference_ppb(reference_ppb);
+	}
+}
+
+void DriftCompensator::learn(const rf::Frequency frequency, const int32_t offset_hz) {
+	if( !has_temperature || !radio::is_enabled() || (frequency <= 0) ) {
+		return;
+	}
+
+	// A carrier seen above its frequency means the reference runs slow
+	const int32_t residual_ppb = (static_cast<int64_t>(offset_hz) * 1000000000) / frequency;
+
+	auto curve = persistent_memory::drift_curve();
+	curve.learn(temperature, applied + residual_ppb);
+	persistent_memory::set_drift_curve(curve);
+}
+
+void DriftCompensator::forget() {
+	auto curve = persistent_memory::drift_curve();
+	curve.clear();
+	persistent_memory::set_drift_curve(curve);
+}
+
+void DriftCompensator::update_temperature(const bool sample_valid) {
+	const auto count = temperature_logger.sample_count();
+	if( (count == 0) || (count == samples_seen) ) {
+		return;
+	}
+	samples_seen = count;
+	if( !sample_valid ) {
+		return;
+	}
+
+	const int32_t sample_q4 = temperature_logger.latest() * 16;
+	if( !has_temperature ) {
+		temperature = sample_q4;
+		has_temperature = true;
+	} else {
+		temperature += (sample_q4 - temperature) >> filter_shift;
+	}
+}
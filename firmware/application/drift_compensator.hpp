@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DRIFT_COMPENSATOR_H__
+#define __DRIFT_COMPENSATOR_H__
+
+#include <cstdint>
+#include <cstddef>
+
+#include "rf_path.hpp"
+
+/* Adds the learned temperature curve (see drift_curve.hpp) to the static
+ * frequency correction and applies the sum to the clock generator PLL. The
+ * LO, the baseband clock and every NCO run off that reference, so they all
+ * follow without a retune. The applied value slews a little each second so
+ * narrowband decoders can track it.
+ */
+class DriftCompensator {
+public:
+	void second_tick();
+
+	/* A carrier known to be exactly at frequency was measured offset_hz away
+	 * from it. Records the correction that would have cancelled the offset.
+	 */
+	void learn(const rf::Frequency frequency, const int32_t offset_hz);
+	void forget();
+
+	/* Filtered MAX2837 sensor code, Q4 */
+	int32_t temperature_q4() const {
+		return temperature;
+	}
+
+	/* Part of the reference correction currently coming from the curve */
+	int32_t drift_ppb() const {
+		return applied;
+	}
+
+private:
+	static constexpr int32_t slew_ppb = 50;			// Per second
+	static constexpr int32_t filter_shift = 3;		// Sensor IIR, one sample every 5s
+
+	bool radio_was_enabled { false };
+	bool has_temperature { false };
+	int32_t temperature { 0 };
+	size_t samples_seen { 0 };
+	int32_t applied { 0 };
+
+	void update_temperature(const bool sample_valid);
+};
+
+#endif/*__DRIFT_COMPENSATOR_H__*/
@@ -25,6 +25,7 @@
 #include "portapack_persistent_memory.hpp"
 
 #include "sd_card.hpp"
+#include "screen_recorder.hpp"
 #include "rtc_time.hpp"
 
 #include "message.hpp"
@@ -225,6 +226,7 @@ void EventDispatcher::handle_rtc_tick() {
 	sd_card::poll_inserted();
 
 	portapack::temperature_logger.second_tick();
+	portapack::drift_compensator.second_tick();
 	
 	uint32_t backlight_timer = portapack::persistent_memory::config_backlight_timer();
 	if (backlight_timer) {
@@ -283,6 +285,7 @@ void EventDispatcher::handle_lcd_frame_sync() {
 	DisplayFrameSyncMessage message;
 	message_map.send(&message);
 	painter.paint_widget_tree(top_widget);
+	screen_recorder::on_frame_sync();
 
 	portapack::backlight()->on();
 }
@@ -22,6 +22,8 @@
 
 #include "file.hpp"
 
+#include "sd_card.hpp"
+
 #include <algorithm>
 #include <locale>
 #include <codecvt>
@@ -159,15 +161,91 @@ static std::filesystem::path increment_filename_stem_ordinal(std::filesystem::pa
 	return t;
 }
 
+/* Last ordinal handed out per filename stem pattern. A pattern costs one
+ * directory scan the first time it is used, later names are derived from the
+ * cached one, so allocating a name doesn't depend on how many files the
+ * directory holds. Everything is dropped when the card status changes (it may
+ * have been written elsewhere) and when a file is renamed on the device. Files
+ * can still show up behind the cache's back, so each name handed out is checked
+ * and a collision triggers a rescan.
+ */
+struct FilenameOrdinal {
+	std::filesystem::path pattern;
+	std::filesystem::path last;		// Empty if no file matched the pattern
+};
+
+static std::array<FilenameOrdinal, 8> filename_ordinals { };
+static size_t filename_ordinals_next { 0 };
+static bool filename_ordinals_subscribed { false };
+
+static void invalidate_filename_ordinals() {
+	for(auto& entry : filename_ordinals) {
+		entry = { };
+	}
+}
+
+static FilenameOrdinal& filename_ordinal(const std::filesystem::path& stem_pattern) {
+	if( !filename_ordinals_subscribed ) {
+		sd_card::status_signal += [](const sd_card::Status) {
+			invalidate_filename_ordinals();
+		};
+		filename_ordinals_subscribed = true;
+	}
+
+	for(auto& entry : filename_ordinals) {
+		if( !entry.pattern.empty() && (entry.pattern.native() == stem_pattern.native()) ) {
+			return entry;
+		}
+	}
+
+	auto& entry = filename_ordinals[filename_ordinals_next];
+	filename_ordinals_next = (filename_ordinals_next + 1) % filename_ordinals.size();
+
+	auto pattern = stem_pattern;
+	entry.pattern = stem_pattern;
+	entry.last = find_last_file_matching_pattern(pattern.replace_extension(u".*")).replace_extension();
+	return entry;
+}
+
+/* Any file with this stem, whatever the extension the caller adds */
+static bool filename_stem_in_use(std::filesystem::path stem) {
+	for(const auto& entry : std::filesystem::directory_iterator(u"", stem.replace_extension(u".*"))) {
+		if( std::filesystem::is_regular_file(entry.status()) ) {
+			return true;
+		}
+	}
+	return false;
+}
+
 std::filesystem::path next_filename_stem_matching_pattern(std::filesystem::path filename_pattern) {
-	const auto next_filename = find_last_file_matching_pattern(filename_pattern.replace_extension(u".*"));
-	if( next_filename.empty() ) {
-		auto pattern_s = filename_pattern.replace_extension().native();
-		std::replace(std::begin(pattern_s), std::end(pattern_s), '?', '0');
-		return pattern_s;
-	} else {
-		return increment_filename_stem_ordinal(next_filename);
+	auto& entry = filename_ordinal(filename_pattern.replace_extension());
+
+	// File::create() truncates, a stale ordinal would overwrite a file. After a
+	// rescan the next name can only be taken if something is writing meanwhile.
+	for(size_t attempt=0; attempt<2; attempt++) {
+		std::filesystem::path next_filename;
+		if( entry.last.empty() ) {
+			auto pattern_s = filename_pattern.native();
+			std::replace(std::begin(pattern_s), std::end(pattern_s), '?', '0');
+			next_filename = pattern_s;
+		} else {
+			next_filename = increment_filename_stem_ordinal(entry.last);
+		}
+
+		if( next_filename.empty() ) {
+			return { };
+		}
+		if( !filename_stem_in_use(next_filename) ) {
+			// Assume the caller creates it, a name that ends up unused only leaves a gap
+			entry.last = next_filename;
+			return next_filename;
+		}
+
+		auto pattern = filename_pattern;
+		entry.last = find_last_file_matching_pattern(pattern.replace_extension(u".*")).replace_extension();
 	}
+
+	return { };
 }
 
 std::vector<std::filesystem::path> scan_root_files(const std::filesystem::path& directory,
@@ -202,6 +280,8 @@ uint32_t delete_file(const std::filesystem::path& file_path) {
 }
 
 uint32_t rename_file(const std::filesystem::path& file_path, const std::filesystem::path& new_name) {
+	// The new name may match a pattern with a higher ordinal than the cached one
+	invalidate_filename_ordinals();
 	return f_rename(reinterpret_cast<const TCHAR*>(file_path.c_str()), reinterpret_cast<const TCHAR*>(new_name.c_str()));
 }
 
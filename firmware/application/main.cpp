@@ -54,7 +54,6 @@
 //TODO: Make play button larger in Replay
 //TODO: Add default headphones volume setting in Audio settings
 //TODO: Put LNA and VGA controls in Soundboard
-//TODO: Make CTCSS display only when squelch is opened
 //TODO: DCS decoder
 //TODO: Increase resolution of audio FFT view ? Currently 48k/(256/2) (375Hz) because of the use of real values (half of FFT output)
 //TODO: Move Touchtunes remote to Custom remote
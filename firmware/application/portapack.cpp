@@ -87,6 +87,7 @@ ReceiverModel receiver_model;
 TransmitterModel transmitter_model;
 
 TemperatureLogger temperature_logger;
+DriftCompensator drift_compensator;
 
 bool antenna_bias { false };
 uint32_t bl_tick_counter { 0 };
@@ -22,6 +22,7 @@
 
 #include "bht.hpp"
 #include "portapack_persistent_memory.hpp"
+#include "baseband_api.hpp"
 
 size_t gen_message_ep(uint8_t city_code, size_t family_code_ep, uint32_t relay_number, uint32_t relay_state) {
 	size_t c;
@@ -79,7 +80,7 @@ std::string gen_message_xy(const std::string& ascii_code) {
 	}
 	
 	// Copy for baseband
-	memcpy(shared_memory.bb_data.tones_data.message, ccir_message, XY_TONE_COUNT);
+	memcpy(baseband::tones_message(), ccir_message, XY_TONE_COUNT);
 	
 	// Return as text for display
 	return local_code;
@@ -134,7 +135,7 @@ std::string gen_message_xy(size_t header_code_a, size_t header_code_b, size_t ci
 		if (ccir_message[c] == ccir_message[c - 1]) ccir_message[c] = 0xE;
 	
 	// Copy for baseband
-	memcpy(shared_memory.bb_data.tones_data.message, ccir_message, XY_TONE_COUNT);
+	memcpy(baseband::tones_message(), ccir_message, XY_TONE_COUNT);
 	
 	// Return as text for display
 	return ccir_to_ascii(ccir_message);
@@ -24,6 +24,8 @@
 #include "ui_navigation.hpp"
 #include "encoders.hpp"
 
+#include <algorithm>
+
 using namespace portapack;
 
 namespace encoders {
@@ -84,4 +86,104 @@ void bitstream_append(size_t& bitstream_length, uint32_t bit_count, uint32_t bit
 	bitstream[bitstream_length >> 3] = byte;
 }
 	
+static uint32_t to_fragments(const uint32_t width_us, const uint32_t fragment_us) {
+	return std::max<uint32_t>((width_us + fragment_us / 2) / fragment_us, 1);
+}
+
+LearnResult make_encoder_def(const ism::PulseAnalysis& analysis, encoder_def_t& def) {
+	std::string zero, one, sync;
+	uint32_t fragment_us;
+	uint32_t sync_pulse = 0;
+	
+	if (!analysis.valid || (analysis.modulation != ism::Modulation::OOK))
+		return LearnResult::NoTiming;
+	
+	switch (analysis.coding) {
+		case ism::Coding::PWM: {
+			// Short pulse = 1, long pulse = 0, constant period
+			fragment_us = analysis.short_us;
+			const uint32_t ratio = std::min<uint32_t>(to_fragments(analysis.long_us, fragment_us), 9);
+			zero = std::string(ratio, '1') + "0";
+			one = "1" + std::string(ratio, '0');
+			sync_pulse = 1;
+			break;
+		}
+		
+		case ism::Coding::PPM: {
+			// Constant pulse, short gap = 0, long gap = 1
+			fragment_us = std::min(analysis.pulse_us, analysis.short_us);
+			sync_pulse = to_fragments(analysis.pulse_us, fragment_us);
+			zero = std::string(sync_pulse, '1') + std::string(to_fragments(analysis.short_us, fragment_us), '0');
+			one = std::string(sync_pulse, '1') + std::string(to_fragments(analysis.long_us, fragment_us), '0');
+			break;
+		}
+		
+		case ism::Coding::Manchester:
+			fragment_us = analysis.short_us;
+			zero = "01";
+			one = "10";
+			break;
+		
+		case ism::Coding::NRZ:
+			fragment_us = analysis.short_us;
+			zero = "0";
+			one = "1";
+			break;
+		
+		default:
+			return LearnResult::NoTiming;
+	}
+	
+	if ((fragment_us == 0) || (zero.size() >= sizeof(def.bit_format[0])) || (one.size() >= sizeof(def.bit_format[0])))
+		return LearnResult::NoTiming;
+	
+	// Row gap, preceded by the pulse that ends the last symbol
+	if (analysis.sync_us) {
+		sync = std::string(sync_pulse, '1') + std::string(to_fragments(analysis.sync_us, fragment_us), '0');
+		if (sync.size() >= sizeof(def.sync))
+			return LearnResult::SyncTooLong;
+	}
+	
+	// Word must fit the config view's format text (24 chars) and waveform buffer
+	const size_t symbol_fragments = std::max(zero.size(), one.size());
+	const size_t word_length = std::min({
+		analysis.record.bit_count(),
+		(size_t)24,
+		(550 - sync.size()) / symbol_fragments
+	});
+	if (word_length == 0)
+		return LearnResult::NoTiming;
+	
+	// Pick a clock around 100kHz so the Clk field (in kHz) keeps the timing accurate
+	const uint32_t clk_per_fragment = std::max<uint32_t>((fragment_us + 5) / 10, 1);
+	
+	memset(&def, 0, sizeof(def));
+	strcpy(def.name, "Learned");
+	strcpy(def.address_symbols, "01");
+	strcpy(def.data_symbols, "01");
+	def.clk_per_symbol = clk_per_fragment * symbol_fragments;
+	def.clk_per_fragment = clk_per_fragment;
+	strcpy(def.bit_format[0], zero.c_str());
+	strcpy(def.bit_format[1], one.c_str());
+	def.word_length = word_length;
+	memset(def.word_format, 'D', word_length);
+	if (!sync.empty())
+		def.word_format[word_length] = 'S';
+	strcpy(def.sync, sync.c_str());
+	def.default_speed = (uint64_t)clk_per_fragment * 1000000 / fragment_us;
+	def.repeat_min = 4;
+	def.pause_symbols = sync.empty() ? 10 : 0;
+	
+	return LearnResult::Ok;
+}
+
+std::string make_word(const ism::Record& record, const encoder_def_t& def) {
+	std::string word;
+	
+	for (size_t i = 0; i < def.word_length; i++)
+		word += record[i] ? '1' : '0';
+	
+	return word;
+}
+	
 } /* namespace encoders */
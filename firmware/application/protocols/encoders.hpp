@@ -27,6 +27,8 @@
 #ifndef __ENCODERS_H__
 #define __ENCODERS_H__
 
+#include "ism_packet.hpp"
+
 namespace encoders {
 	
 	#define ENC_TYPES_COUNT 14
@@ -52,6 +54,18 @@ namespace encoders {
 		uint16_t pause_symbols;					// Length of pause between repeats in symbols
 	};
 
+	enum class LearnResult {
+		Ok,
+		NoTiming,		// Not an analysis an OOK encoder can express
+		SyncTooLong,	// Row gap doesn't fit the sync field, truncating it would change the waveform
+	};
+
+	// Builds a definition from pulse analyzer results
+	LearnResult make_encoder_def(const ism::PulseAnalysis& analysis, encoder_def_t& def);
+
+	// Symbol string ("0110...") for the word of a definition built above
+	std::string make_word(const ism::Record& record, const encoder_def_t& def);
+
 	// Warning ! If this is changed, make sure that ENCODER_UM3750 is still valid !
 	constexpr encoder_def_t encoder_defs[ENC_TYPES_COUNT] = {
 		// PT2260-R2
@@ -95,6 +95,7 @@ static max5864::MAX5864 baseband_codec { ssp1_target_max5864 };
 static baseband::CPLD baseband_cpld;
 
 static rf::Direction direction { rf::Direction::Receive };
+static bool enabled { false };
 
 void init() {
 	rf_path.init();
@@ -120,6 +121,7 @@ void set_direction(const rf::Direction new_direction) {
 	}
 	
 	direction = new_direction;
+	enabled = true;
 	
 	second_if.set_mode((direction == rf::Direction::Transmit) ? max2837::Mode::Transmit : max2837::Mode::Receive);
 	rf_path.set_direction(direction);
@@ -198,12 +200,17 @@ void disable() {
 	
 	led_rx.off();
 	led_tx.off();
+	enabled = false;
 }
 
 void enable(Configuration configuration) {
 	configure(configuration);
 }
 
+bool is_enabled() {
+	return enabled;
+}
+
 void configure(Configuration configuration) {
 	set_tuning_frequency(configuration.tuning_frequency);
 	set_rf_amp(configuration.rf_amp);
@@ -55,6 +55,9 @@ void enable(Configuration configuration);
 void configure(Configuration configuration);
 void disable();
 
+/* Receiving or transmitting, from set_direction() until disable() */
+bool is_enabled();
+
 namespace debug {
 
 namespace first_if {
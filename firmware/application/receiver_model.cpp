@@ -42,7 +42,7 @@ static constexpr std::array<baseband::AMConfig, 4> am_configs { {
 	{ taps_6k0_dsb_channel, AMConfigureMessage::Modulation::DSB },
 	{ taps_2k8_usb_channel, AMConfigureMessage::Modulation::SSB },
 	{ taps_2k8_lsb_channel, AMConfigureMessage::Modulation::SSB },	
-	{ taps_0k7_usb_channel, AMConfigureMessage::Modulation::SSB },
+	{ taps_0k7_usb_channel, AMConfigureMessage::Modulation::SSB },	// CW, tone centered on cw_pitch
 } };
 
 static constexpr std::array<baseband::NBFMConfig, 3> nbfm_configs { {
@@ -150,13 +150,19 @@ void ReceiverModel::set_headphone_volume(volume_t v) {
 	update_headphone_volume();
 }
 
+size_t ReceiverModel::squelch_index() const {
+	// Non-audio modes have no squelch, they share the NFM setting
+	const size_t index = toUType(modulation());
+	return (index < squelch_levels.size()) ? index : toUType(Mode::NarrowbandFMAudio);
+}
+
 uint8_t ReceiverModel::squelch_level() const {
-	return squelch_level_;
+	return squelch_levels[squelch_index()];
 }
 
 void ReceiverModel::set_squelch_level(uint8_t v) {
-	squelch_level_ = v;
-	update_modulation();
+	squelch_levels[squelch_index()] = v;
+	update_squelch();
 }
 
 void ReceiverModel::enable() {
@@ -285,6 +291,20 @@ void ReceiverModel::update_modulation() {
 
 	case Mode::SpectrumAnalysis:
 	case Mode::Capture:
+		return;
+	}
+	update_squelch();
+}
+
+void ReceiverModel::update_squelch() {
+	switch(modulation()) {
+	case Mode::AMAudio:
+	case Mode::NarrowbandFMAudio:
+	case Mode::WidebandFMAudio:
+		baseband::set_squelch(squelch_level(), squelch_hysteresis_db, squelch_attack_ms, squelch_hang_ms);
+		break;
+
+	default:
 		break;
 	}
 }
@@ -295,6 +315,11 @@ size_t ReceiverModel::am_configuration() const {
 
 void ReceiverModel::update_am_configuration() {
 	am_configs[am_config_index].apply();
+	baseband::set_cw_rx(am_cw(), cw_pitch);
+}
+
+bool ReceiverModel::am_cw() const {
+	return am_config_index == am_config_cw;
 }
 
 size_t ReceiverModel::nbfm_configuration() const {
@@ -302,7 +327,7 @@ size_t ReceiverModel::nbfm_configuration() const {
 }
 
 void ReceiverModel::update_nbfm_configuration() {
-	nbfm_configs[nbfm_config_index].apply(squelch_level_);
+	nbfm_configs[nbfm_config_index].apply();
 }
 
 size_t ReceiverModel::wfm_configuration() const {
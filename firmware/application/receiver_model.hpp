@@ -24,6 +24,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <array>
 
 #include "message.hpp"
 #include "rf_path.hpp"
@@ -72,6 +73,9 @@ public:
 	volume_t headphone_volume() const;
 	void set_headphone_volume(volume_t v);
 	
+	/* SNR in dB over the noise floor to open the squelch, 0 for always open.
+	 * Kept per analog mode, broadcast AM and WFM default to open.
+	 */
 	uint8_t squelch_level() const;
 	void set_squelch_level(uint8_t v);
 
@@ -80,6 +84,8 @@ public:
 
 	size_t am_configuration() const;
 	void set_am_configuration(const size_t n);
+	/* The narrow CW filter also runs the Morse decoder */
+	bool am_cw() const;
 
 	size_t nbfm_configuration() const;
 	void set_nbfm_configuration(const size_t n);
@@ -88,6 +94,12 @@ public:
 	void set_wfm_configuration(const size_t n);
 
 private:
+	static constexpr size_t am_config_cw = 3;
+	static constexpr uint32_t cw_pitch = 700;
+	static constexpr uint8_t squelch_hysteresis_db = 3;
+	static constexpr uint16_t squelch_attack_ms = 20;
+	static constexpr uint16_t squelch_hang_ms = 400;
+
 	rf::Frequency frequency_step_ { 25000 };
 	bool enabled_ { false };
 	bool rf_amp_ { false };
@@ -101,7 +113,7 @@ private:
 	size_t nbfm_config_index = 0;
 	size_t wfm_config_index = 0;
 	volume_t headphone_volume_ { -43.0_dB };
-	uint8_t squelch_level_ { 80 };
+	std::array<uint8_t, 3> squelch_levels { 0, 10, 0 };	// AM, NFM, WFM
 
 	int32_t tuning_offset();
 
@@ -116,6 +128,8 @@ private:
 	void update_headphone_volume();
 
 	void update_modulation();
+	void update_squelch();
+	size_t squelch_index() const;
 	void update_am_configuration();
 	void update_nbfm_configuration();
 	void update_wfm_configuration();
@@ -60,6 +60,13 @@ ReplayThread::~ReplayThread() {
 	}
 }
 
+void ReplayThread::signal_ready() {
+	*ready_sig = true;
+	if( thread ) {
+		chEvtSignal(thread, EVT_MASK_READY);
+	}
+}
+
 msg_t ReplayThread::static_fn(void* arg) {
 	auto obj = static_cast<ReplayThread*>(arg);
 	const auto return_code = obj->run();
@@ -78,7 +85,10 @@ uint32_t ReplayThread::run() {
 	// Wait for FIFOs to be allocated in baseband
 	// Wait for ui_replay_view to tell us that the buffers are ready (awful :( )
 	while (!(*ready_sig)) {
-		chThdSleep(100);
+		if( chThdShouldTerminate() ) {
+			return TERMINATED;
+		}
+		chEvtWaitAnyTimeout(EVT_MASK_READY, 100);
 	};
 	
 	// While empty buffers fifo is not empty...
@@ -54,6 +54,11 @@ public:
 		return config;
 	};
 
+	/* Sets the ready flag and wakes the thread, so the prefill starts now
+	 * rather than on its next poll.
+	 */
+	void signal_ready();
+
 	enum replaythread_return {
 		READ_ERROR = 0,
 		END_OF_FILE,
@@ -67,6 +72,8 @@ private:
 	std::function<void(uint32_t return_code)> terminate_callback;
 	Thread* thread { nullptr };
 
+	static constexpr eventmask_t EVT_MASK_READY = EVENT_MASK(0);
+
 	static msg_t static_fn(void* arg);
 
 	uint32_t run();
@@ -25,7 +25,7 @@
 #include "portapack_shared_memory.hpp"
 
 uint32_t RFM69::gen_frame(std::vector<uint8_t>& payload) {
-	CRC<16> crc { 0x1021, 0x1D0F, 0xFFFF };
+	CRC<16, 0x1021> crc { 0x1D0F, 0xFFFF };
 	std::vector<uint8_t> frame { };
 	uint8_t byte_out = 0;
 	
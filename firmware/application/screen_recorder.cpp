@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "screen_recorder.hpp"
+
+#include "portapack.hpp"
+
+#include <memory>
+
+namespace {
+
+constexpr uint32_t hash_basis = 2166136261U;
+constexpr uint32_t hash_prime = 16777619U;
+
+constexpr uint8_t version = 1;
+constexpr uint8_t pixel_format_rgb565 = 1;
+
+void put_u16(uint8_t* const p, const uint16_t v) {
+	p[0] = (v >> 0) & 0xff;
+	p[1] = (v >> 8) & 0xff;
+}
+
+void put_u32(uint8_t* const p, const uint32_t v) {
+	put_u16(&p[0], (v >>  0) & 0xffff);
+	put_u16(&p[2], (v >> 16) & 0xffff);
+}
+
+} /* namespace */
+
+Optional<File::Error> ScreenRecorder::create(
+	const std::filesystem::path& filename
+) {
+	const auto create_error = file.create(filename);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+
+	std::array<uint8_t, 12> header { { 'P', 'P', 'S', 'R', version, pixel_format_rgb565 } };
+	put_u16(&header[6], width);
+	put_u16(&header[8], height);
+	write(header.data(), header.size());
+
+	start_time = chTimeNow();
+	last_time = start_time - MS2ST(frame_interval_ms);
+	return { };
+}
+
+void ScreenRecorder::update() {
+	const auto now = chTimeNow();
+	if( (now - last_time) < MS2ST(frame_interval_ms) ) {
+		return;
+	}
+	last_time = now;
+
+	const auto rect_count = scan();
+	if( rect_count > 0 ) {
+		write_frame((now - start_time) * 1000 / CH_FREQUENCY, rect_count);
+	}
+}
+
+/* Hashes every tile of the screen and flags the ones that changed since the
+ * last frame. Returns the number of rectangles (runs of changed tiles).
+ */
+size_t ScreenRecorder::scan() {
+	std::array<uint32_t, tiles_x> running;
+	size_t rect_count = 0;
+
+	for(size_t ty=0; ty<tiles_y; ty++) {
+		running.fill(hash_basis);
+
+		for(int y=0; y<tile_size; y++) {
+			portapack::display.read_pixels({ 0, static_cast<int>(ty * tile_size) + y, width, 1 }, row);
+
+			const ui::ColorRGB888* pixel = row.data();
+			for(auto& h : running) {
+				for(int x=0; x<tile_size; x++, pixel++) {
+					h = (h ^ ((pixel->r << 16) | (pixel->g << 8) | pixel->b)) * hash_prime;
+				}
+			}
+		}
+
+		uint16_t changed = 0;
+		for(size_t tx=0; tx<tiles_x; tx++) {
+			auto& stored = tile_hashes[ty * tiles_x + tx];
+			if( first || (running[tx] != stored) ) {
+				changed |= 1 << tx;
+			}
+			stored = running[tx];
+		}
+
+		dirty[ty] = changed;
+		// One rectangle per run of set bits
+		rect_count += __builtin_popcount(changed & ~(changed << 1));
+	}
+
+	first = false;
+	return rect_count;
+}
+
+void ScreenRecorder::write_frame(const uint32_t time, const size_t rect_count) {
+	const auto header_offset = file_size;
+
+	std::array<uint8_t, 12> header { };
+	put_u32(&header[0], time);
+	put_u16(&header[4], rect_count);
+	write(header.data(), header.size());
+
+	payload_size = 0;
+	deflate.reset();
+
+	for(size_t ty=0; ty<tiles_y; ty++) {
+		const auto changed = dirty[ty];
+		size_t tx = 0;
+		while( tx < tiles_x ) {
+			if( changed & (1 << tx) ) {
+				const auto start = tx;
+				while( (tx < tiles_x) && (changed & (1 << tx)) ) {
+					tx++;
+				}
+				write_rect({
+					static_cast<int>(start * tile_size), static_cast<int>(ty * tile_size),
+					static_cast<int>((tx - start) * tile_size), tile_size
+				});
+			} else {
+				tx++;
+			}
+		}
+	}
+
+	deflate.finish();
+
+	// Patch the payload length now that it is known
+	std::array<uint8_t, 4> length;
+	put_u32(length.data(), payload_size);
+	file.seek(header_offset + 8);
+	file.write(length);
+	file.seek(file_size);
+
+	frames++;
+}
+
+void ScreenRecorder::write_rect(const ui::Rect r) {
+	std::array<uint8_t, 8> header;
+	put_u16(&header[0], r.left());
+	put_u16(&header[2], r.top());
+	put_u16(&header[4], r.width());
+	put_u16(&header[6], r.height());
+	deflate.write(header.data(), header.size());
+
+	const size_t count = r.width();
+	for(int y=r.top(); y<r.bottom(); y++) {
+		portapack::display.read_pixels({ 0, y, width, 1 }, row);
+		for(size_t i=0; i<count; i++) {
+			const auto& c = row[r.left() + i];
+			row_565[i] = ((c.r & 0xf8) << 8) | ((c.g & 0xfc) << 3) | (c.b >> 3);
+		}
+		deflate.write(row_565.data(), count * sizeof(uint16_t));
+	}
+}
+
+void ScreenRecorder::write(const void* const p, const size_t count) {
+	file.write(p, count);
+	file_size += count;
+}
+
+namespace screen_recorder {
+
+static std::unique_ptr<ScreenRecorder> recorder { };
+
+Optional<File::Error> start(const std::filesystem::path& filename) {
+	auto new_recorder = std::make_unique<ScreenRecorder>();
+	const auto create_error = new_recorder->create(filename);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+	recorder = std::move(new_recorder);
+	return { };
+}
+
+void stop() {
+	recorder.reset();
+}
+
+bool active() {
+	return recorder != nullptr;
+}
+
+void on_frame_sync() {
+	if( recorder ) {
+		recorder->update();
+	}
+}
+
+} /* namespace screen_recorder */
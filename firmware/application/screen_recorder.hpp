@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SCREEN_RECORDER_H__
+#define __SCREEN_RECORDER_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "ch.h"
+
+#include "ui.hpp"
+#include "file.hpp"
+#include "deflate.hpp"
+
+/* Records the LCD as a sequence of changed rectangles. The screen is split in
+ * 16x16 tiles that are hashed while the screen is read back; runs of changed
+ * tiles are read again and stored as RGB565, deflated one frame at a time.
+ * tools/scr2video.py turns a recording into a video.
+ *
+ * File layout, all little endian:
+ *   header   "PPSR", u8 version, u8 pixel format (1 = RGB565), u16 width, u16 height, u16 reserved
+ *   frame    u32 time (ms since start), u16 rect count, u16 reserved, u32 payload bytes, payload
+ *   payload  raw deflate stream of rects: u16 x, u16 y, u16 w, u16 h, then w * h pixels
+ */
+class ScreenRecorder {
+public:
+	static constexpr systime_t frame_interval_ms = 200;
+
+	Optional<File::Error> create(const std::filesystem::path& filename);
+
+	/* Appends a frame if the interval has passed and anything changed. */
+	void update();
+
+	uint32_t frame_count() const {
+		return frames;
+	}
+
+private:
+	static constexpr int width { 240 };
+	static constexpr int height { 320 };
+	static constexpr int tile_size { 16 };
+	static constexpr size_t tiles_x { width / tile_size };
+	static constexpr size_t tiles_y { height / tile_size };
+
+	File file { };
+	uint32_t file_size { 0 };
+	uint32_t payload_size { 0 };
+	systime_t start_time { 0 };
+	systime_t last_time { 0 };
+	uint32_t frames { 0 };
+	bool first { true };
+
+	std::array<uint32_t, tiles_x * tiles_y> tile_hashes { };
+	std::array<uint16_t, tiles_y> dirty { };
+	std::array<ui::ColorRGB888, width> row { };
+	std::array<uint16_t, width> row_565 { };
+	Deflate deflate { [this](const uint8_t* const p, const size_t count) {
+		this->write(p, count);
+		this->payload_size += count;
+	} };
+
+	size_t scan();
+	void write_frame(const uint32_t time, const size_t rect_count);
+	void write_rect(const ui::Rect r);
+	void write(const void* const p, const size_t count);
+};
+
+/* Single recording shared by the status bar (start/stop) and the event loop,
+ * which calls on_frame_sync() once the widget tree has been painted.
+ */
+namespace screen_recorder {
+
+Optional<File::Error> start(const std::filesystem::path& filename);
+void stop();
+bool active();
+void on_frame_sync();
+
+} /* namespace screen_recorder */
+
+#endif/*__SCREEN_RECORDER_H__*/
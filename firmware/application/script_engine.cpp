@@ -0,0 +1,478 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "script_engine.hpp"
+
+#include <cstdlib>
+#include <cctype>
+#include <array>
+
+namespace script {
+
+namespace {
+
+struct Keyword {
+	const char* name;
+	Op op;
+};
+
+constexpr std::array<Keyword, 16> keywords { {
+	{ "tune", Op::Tune },
+	{ "mode", Op::Mode },
+	{ "bw", Op::Bandwidth },
+	{ "lna", Op::LNA },
+	{ "vga", Op::VGA },
+	{ "amp", Op::Amp },
+	{ "squelch", Op::Squelch },
+	{ "wait", Op::Wait },
+	{ "until", Op::Until },
+	{ "signal", Op::Signal },
+	{ "record", Op::Record },
+	{ "decode", Op::Decode },
+	{ "loop", Op::Loop },
+	{ "end", Op::End },
+	{ "log", Op::Log },
+	{ "stop", Op::Stop },
+} };
+
+constexpr std::array<const char*, 3> mode_names { { "am", "nfm", "wfm" } };
+
+constexpr uint32_t seconds_per_day = 24 * 60 * 60;
+
+std::vector<std::string> split(const std::string& line) {
+	std::vector<std::string> tokens;
+	std::string token;
+	for(const auto c : line) {
+		if( std::isspace(static_cast<unsigned char>(c)) ) {
+			if( !token.empty() ) {
+				tokens.push_back(token);
+				token.clear();
+			}
+		} else {
+			token += c;
+		}
+	}
+	if( !token.empty() ) {
+		tokens.push_back(token);
+	}
+	return tokens;
+}
+
+std::string lower(std::string s) {
+	for(auto& c : s) {
+		c = std::tolower(static_cast<unsigned char>(c));
+	}
+	return s;
+}
+
+/* Not std::to_string, newlib doesn't have it and frequencies need 64 bits */
+std::string to_dec(int64_t n) {
+	if( n < 0 ) {
+		return "-" + to_dec(-n);
+	}
+	std::string s;
+	do {
+		s.insert(s.begin(), '0' + (n % 10));
+		n /= 10;
+	} while( n );
+	return s;
+}
+
+bool parse_int(const std::string& s, int64_t& value) {
+	if( s.empty() ) {
+		return false;
+	}
+	char* end = nullptr;
+	value = std::strtoll(s.c_str(), &end, 10);
+	return (*end == 0);
+}
+
+/* HH:MM to seconds since midnight */
+bool parse_time(const std::string& s, int64_t& value) {
+	const auto colon = s.find(':');
+	if( colon == std::string::npos ) {
+		return false;
+	}
+	int64_t hours, minutes;
+	if( !parse_int(s.substr(0, colon), hours) || !parse_int(s.substr(colon + 1), minutes) ) {
+		return false;
+	}
+	if( (hours < 0) || (hours > 23) || (minutes < 0) || (minutes > 59) ) {
+		return false;
+	}
+	value = (hours * 60 + minutes) * 60;
+	return true;
+}
+
+/* The text after the keyword, as typed */
+std::string rest_of_line(const std::string& line, const std::string& keyword) {
+	auto start = line.find(keyword) + keyword.size();
+	while( (start < line.size()) && std::isspace(static_cast<unsigned char>(line[start])) ) {
+		start++;
+	}
+	return line.substr(start);
+}
+
+} /* namespace */
+
+Optional<ParseError> parse(const std::string& source, Program& program) {
+	program.clear();
+	std::vector<size_t> open_loops;
+
+	size_t line_number = 0;
+	size_t start = 0;
+	while( start < source.size() ) {
+		auto end = source.find('\n', start);
+		if( end == std::string::npos ) {
+			end = source.size();
+		}
+		std::string line = source.substr(start, end - start);
+		start = end + 1;
+		line_number++;
+
+		const auto comment = line.find('#');
+		if( comment != std::string::npos ) {
+			line.erase(comment);
+		}
+		const auto tokens = split(line);
+		if( tokens.empty() ) {
+			continue;
+		}
+
+		const auto keyword = lower(tokens[0]);
+		const Keyword* match = nullptr;
+		for(const auto& k : keywords) {
+			if( keyword == k.name ) {
+				match = &k;
+				break;
+			}
+		}
+		if( !match ) {
+			return ParseError { line_number, "unknown '" + tokens[0] + "'" };
+		}
+
+		Instruction instruction { match->op, 0, 0, static_cast<uint16_t>(line_number), { } };
+		const size_t args = tokens.size() - 1;
+		bool ok = true;
+
+		switch(instruction.op) {
+		case Op::Tune:
+			ok = (args == 1) && parse_int(tokens[1], instruction.value) && (instruction.value > 0);
+			break;
+
+		case Op::Mode:
+			ok = false;
+			if( args == 1 ) {
+				const auto name = lower(tokens[1]);
+				for(size_t i=0; i<mode_names.size(); i++) {
+					if( name == mode_names[i] ) {
+						instruction.value = i;
+						ok = true;
+					}
+				}
+			}
+			break;
+
+		case Op::Bandwidth:
+		case Op::Wait:
+		case Op::Signal:
+		case Op::Record:
+			ok = (args == 1) && parse_int(tokens[1], instruction.value) && (instruction.value >= 0);
+			break;
+
+		case Op::LNA:
+		case Op::VGA:
+		case Op::Squelch:
+			ok = (args == 1) && parse_int(tokens[1], instruction.value);
+			break;
+
+		case Op::Amp:
+			ok = (args == 1) && ((lower(tokens[1]) == "on") || (lower(tokens[1]) == "off"));
+			instruction.value = ok && (lower(tokens[1]) == "on");
+			break;
+
+		case Op::Until:
+			ok = (args == 1) && parse_time(tokens[1], instruction.value);
+			break;
+
+		case Op::Decode:
+			{
+				int64_t seconds = 0;
+				ok = (args == 2) && parse_int(tokens[2], seconds) && (seconds > 0);
+				instruction.text = lower(tokens[1]);
+				instruction.duration = seconds;
+			}
+			break;
+
+		case Op::Loop:
+			instruction.value = loop_forever;
+			ok = (args == 0) || ((args == 1) && parse_int(tokens[1], instruction.value) && (instruction.value >= 0));
+			if( ok && (open_loops.size() >= loops_max) ) {
+				return ParseError { line_number, "loops nested too deep" };
+			}
+			open_loops.push_back(program.size());
+			break;
+
+		case Op::End:
+			ok = (args == 0);
+			if( open_loops.empty() ) {
+				return ParseError { line_number, "end without loop" };
+			}
+			if( !program.empty() && (program.back().op == Op::Signal) ) {
+				return ParseError { program.back().line, "nothing for 'signal' to skip before 'end'" };
+			}
+			instruction.value = open_loops.back();
+			program[open_loops.back()].duration = program.size();
+			open_loops.pop_back();
+			break;
+
+		case Op::Log:
+			instruction.text = rest_of_line(line, tokens[0]);
+			break;
+
+		case Op::Stop:
+			ok = (args == 0);
+			break;
+		}
+
+		if( !ok ) {
+			return ParseError { line_number, "bad arguments to '" + keyword + "'" };
+		}
+		program.push_back(instruction);
+	}
+
+	if( !open_loops.empty() ) {
+		return ParseError { program[open_loops.back()].line, "loop without end" };
+	}
+	if( program.empty() ) {
+		return ParseError { line_number, "nothing to run" };
+	}
+	return { };
+}
+
+std::string to_string(const Instruction& instruction) {
+	std::string s;
+	for(const auto& k : keywords) {
+		if( k.op == instruction.op ) {
+			s = k.name;
+		}
+	}
+
+	switch(instruction.op) {
+	case Op::Mode:
+		return s + " " + mode_names[instruction.value];
+
+	case Op::Amp:
+		return s + (instruction.value ? " on" : " off");
+
+	case Op::Until:
+		{
+			const auto minutes = instruction.value / 60;
+			const auto mm = to_dec(minutes % 60);
+			return s + " " + to_dec(minutes / 60) + ":" + ((mm.size() < 2) ? "0" : "") + mm;
+		}
+
+	case Op::Decode:
+		return s + " " + instruction.text + " " + to_dec(instruction.duration);
+
+	case Op::Loop:
+		return (instruction.value == loop_forever) ? s : (s + " " + to_dec(instruction.value));
+
+	case Op::End:
+	case Op::Stop:
+		return s;
+
+	case Op::Log:
+		return s + " " + instruction.text;
+
+	default:
+		return s + " " + to_dec(instruction.value);
+	}
+}
+
+Engine::Status Engine::run() {
+	while( pc_ < program.size() ) {
+		if( radio.should_stop() ) {
+			return Status::Stopped;
+		}
+		heartbeat_++;
+
+		const auto& instruction = program[pc_];
+		size_t next = pc_ + 1;
+		if( !execute(instruction, next) ) {
+			return radio.should_stop() ? Status::Stopped : Status::Halted;
+		}
+		pc_ = next;
+	}
+	return Status::Finished;
+}
+
+/* Returns false to end the run. */
+bool Engine::execute(const Instruction& instruction, size_t& next) {
+	switch(instruction.op) {
+	case Op::Tune:
+		check(radio.tune(instruction.value), instruction);
+		break;
+
+	case Op::Mode:
+		check(radio.set_mode(static_cast<Mode>(instruction.value)), instruction);
+		break;
+
+	case Op::Bandwidth:
+		check(radio.set_bandwidth(instruction.value), instruction);
+		break;
+
+	case Op::LNA:
+		check(radio.set_lna(instruction.value), instruction);
+		break;
+
+	case Op::VGA:
+		check(radio.set_vga(instruction.value), instruction);
+		break;
+
+	case Op::Amp:
+		check(radio.set_amp(instruction.value), instruction);
+		break;
+
+	case Op::Squelch:
+		check(radio.set_squelch(instruction.value), instruction);
+		break;
+
+	case Op::Wait:
+		return sleep(instruction.value);
+
+	case Op::Until:
+		return sleep((instruction.value + seconds_per_day - radio.seconds_of_day() % seconds_per_day) % seconds_per_day);
+
+	case Op::Signal:
+		if( !wait_for_signal(instruction.value) ) {
+			if( radio.should_stop() ) {
+				return false;
+			}
+			// Nothing heard, skip whatever was meant to act on the signal. That
+			// is a whole loop if one comes next, parse() made sure it's no end.
+			if( (pc_ + 1 < program.size()) && (program[pc_ + 1].op == Op::Loop) ) {
+				next = program[pc_ + 1].duration + 1;
+			} else {
+				next = pc_ + 2;
+			}
+			radio.log(to_dec(instruction.line) + ": no signal");
+		} else {
+			radio.log(to_dec(instruction.line) + ": signal");
+		}
+		break;
+
+	case Op::Record:
+		{
+			const bool started = radio.start_record();
+			check(started, instruction);
+			const bool completed = sleep(instruction.value);
+			if( started ) {
+				radio.stop_record();
+			}
+			return completed;
+		}
+
+	case Op::Decode:
+		{
+			const bool started = radio.start_decoder(instruction.text);
+			check(started, instruction);
+			if( !started ) {
+				break;
+			}
+			const bool completed = sleep(instruction.duration);
+			radio.stop_decoder();
+			return completed;
+		}
+
+	case Op::Loop:
+		if( instruction.value == 0 ) {
+			// Zero times, carry on after the matching end
+			next = instruction.duration + 1;
+		} else {
+			loops.push_back({ pc_, (instruction.value == loop_forever) ? 0 : static_cast<uint32_t>(instruction.value) });
+		}
+		break;
+
+	case Op::End:
+		if( !loops.empty() ) {
+			auto& frame = loops.back();
+			if( (frame.remaining == 0) || (--frame.remaining > 0) ) {
+				next = frame.start + 1;
+				// Every pass sleeps a poll, a loop of instructions that take no
+				// time would otherwise never let the UI run
+				if( radio.should_stop() ) {
+					return false;
+				}
+				radio.sleep_ms(poll_ms);
+				heartbeat_++;
+			} else {
+				loops.pop_back();
+			}
+		}
+		break;
+
+	case Op::Log:
+		radio.log(to_dec(instruction.line) + ": " + instruction.text);
+		break;
+
+	case Op::Stop:
+		return false;
+	}
+
+	return true;
+}
+
+/* Returns false if asked to stop before the time was up. */
+bool Engine::sleep(const uint32_t seconds) {
+	const uint32_t polls = seconds * (1000 / poll_ms);
+	for(uint32_t i=0; i<polls; i++) {
+		if( radio.should_stop() ) {
+			return false;
+		}
+		radio.sleep_ms(poll_ms);
+		heartbeat_++;
+	}
+	return true;
+}
+
+/* Returns true as soon as the squelch opens. */
+bool Engine::wait_for_signal(const uint32_t seconds) {
+	const uint32_t polls = seconds * (1000 / poll_ms);
+	for(uint32_t i=0; i<polls; i++) {
+		if( radio.signal_present() ) {
+			return true;
+		}
+		if( radio.should_stop() ) {
+			return false;
+		}
+		radio.sleep_ms(poll_ms);
+		heartbeat_++;
+	}
+	return radio.signal_present();
+}
+
+void Engine::check(const bool ok, const Instruction& instruction) {
+	radio.log(to_dec(instruction.line) + ": " + to_string(instruction) + (ok ? "" : " FAILED"));
+}
+
+} /* namespace script */
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SCRIPT_ENGINE_H__
+#define __SCRIPT_ENGINE_H__
+
+#include "optional.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* Unattended RX tasks, read from a small text file on the SD card. One
+ * instruction per line, '#' starts a comment:
+ *
+ * tune <Hz>					set the receive frequency
+ * mode am|nfm|wfm				load the demodulator
+ * bw <index>					bandwidth option of the current mode
+ * lna <dB> / vga <dB> / amp on|off
+ * squelch <dB>					squelch opening SNR
+ * wait <s>						sleep
+ * until <HH:MM>				sleep until the RTC reaches a time of day
+ * signal <s>					wait for the squelch to open, skip the next
+ *								instruction (or loop) if it doesn't within <s>.
+ *								Not allowed right before an end. AM and WFM
+ *								start with the squelch off, set one first.
+ * record <s>					record audio to the SD card
+ * decode <app> <s>				run a decoder app, its own logging applies
+ * loop [n] ... end				repeat n times (0 skips), forever if n is omitted.
+ *								Each pass takes at least 100ms.
+ * log <text>					add a line to the run log
+ * stop							end the script
+ *
+ * The engine only talks to the hardware through Radio, so it can be run
+ * against a simulated radio on a host build.
+ */
+
+namespace script {
+
+enum class Op : uint8_t {
+	Tune,
+	Mode,
+	Bandwidth,
+	LNA,
+	VGA,
+	Amp,
+	Squelch,
+	Wait,
+	Until,
+	Signal,
+	Record,
+	Decode,
+	Loop,
+	End,
+	Log,
+	Stop,
+};
+
+enum class Mode : uint8_t {
+	AM,
+	NFM,
+	WFM,
+};
+
+struct Instruction {
+	Op op;
+	int64_t value;		// Frequency, dB, seconds, loop count or jump target
+	uint32_t duration;	// Seconds for decode, index of the matching end for loop
+	uint16_t line;		// Source line, for the log
+	std::string text;	// App name or log text
+};
+
+using Program = std::vector<Instruction>;
+
+constexpr size_t loops_max = 4;
+constexpr int64_t loop_forever = -1;
+
+struct ParseError {
+	size_t line;
+	std::string message;
+};
+
+Optional<ParseError> parse(const std::string& source, Program& program);
+
+std::string to_string(const Instruction& instruction);
+
+class Radio {
+public:
+	virtual ~Radio() = default;
+
+	/* Each returns false if the request could not be carried out. */
+	virtual bool tune(const int64_t frequency) = 0;
+	virtual bool set_mode(const Mode mode) = 0;
+	virtual bool set_bandwidth(const size_t index) = 0;
+	virtual bool set_lna(const int32_t db) = 0;
+	virtual bool set_vga(const int32_t db) = 0;
+	virtual bool set_amp(const bool enabled) = 0;
+	virtual bool set_squelch(const int32_t db) = 0;
+	virtual bool start_record() = 0;
+	virtual bool stop_record() = 0;
+	virtual bool start_decoder(const std::string& app) = 0;
+	virtual bool stop_decoder() = 0;
+
+	virtual bool signal_present() = 0;
+	virtual uint32_t seconds_of_day() = 0;
+	virtual void sleep_ms(const uint32_t ms) = 0;
+	virtual bool should_stop() = 0;
+	virtual void log(const std::string& entry) = 0;
+};
+
+class Engine {
+public:
+	enum class Status : uint8_t {
+		Finished,		// Ran off the end of the program
+		Halted,			// Reached a stop instruction
+		Stopped,		// Asked to stop from outside
+	};
+
+	Engine(
+		const Program& program,
+		Radio& radio
+	) : program { program },
+		radio { radio }
+	{
+	}
+
+	/* Runs from the current instruction until the script ends. */
+	Status run();
+
+	size_t pc() const {
+		return pc_;
+	}
+
+	/* Moves on every instruction and every poll of a wait, a watchdog can
+	 * tell a long wait from a hung radio call.
+	 */
+	uint32_t heartbeat() const {
+		return heartbeat_;
+	}
+
+private:
+	static constexpr uint32_t poll_ms = 100;
+
+	struct Frame {
+		size_t start;
+		uint32_t remaining;		// 0 = forever
+	};
+
+	const Program& program;
+	Radio& radio;
+	size_t pc_ { 0 };
+	volatile uint32_t heartbeat_ { 0 };
+	std::vector<Frame> loops { };
+
+	bool execute(const Instruction& instruction, size_t& next);
+	bool sleep(const uint32_t seconds);
+	bool wait_for_signal(const uint32_t seconds);
+	void check(const bool ok, const Instruction& instruction);
+};
+
+} /* namespace script */
+
+#endif/*__SCRIPT_ENGINE_H__*/
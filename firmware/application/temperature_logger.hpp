@@ -38,6 +38,16 @@ public:
 	
 	std::vector<sample_t> history() const;
 
+	/* Most recent sample, only meaningful once size() > 0 */
+	sample_t latest() const {
+		return samples.back();
+	}
+
+	/* Samples taken since power up, unlike size() this keeps counting */
+	size_t sample_count() const {
+		return samples_count;
+	}
+
 private:
 	std::array<sample_t, 128> samples { };
 
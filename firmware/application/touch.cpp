@@ -26,37 +26,41 @@ using namespace portapack;
 
 #include "utility.hpp"
 
+#include <cstdlib>
+
 namespace touch {
 
 Metrics calculate_metrics(const Frame& frame) {
-	/* TODO: Yikes! M0 doesn't have floating point, so this code is
-	 * expensive! On the other hand, it seems to be working well (and
-	 * fast *enough*?), so maybe leave it alone at least for now.
-	 */
-
-	const auto x_max = frame.x.xp;
-	const auto x_min = frame.x.xn;
-	const auto x_range = x_max - x_min;
-	const float x_position = (frame.x.yp + frame.x.yn) * 0.5f;
-	const float x_norm = (x_position - x_min) / x_range;
-
-	const auto y_max = frame.y.yn;
-	const auto y_min = frame.y.yp;
-	const auto y_range = y_max - y_min;
-	const float y_position = (frame.y.xp + frame.y.xn) * 0.5f;
-	const float y_norm = (y_position - y_min) / y_range;
-
-	const auto z_max = frame.pressure.yp;
-	const auto z_min = frame.pressure.xn;
-	const auto z_range = z_max - z_min;
-	const auto z1_position = frame.pressure.xp;
-	const float z1_norm = float(z1_position - z_min) / z_range;
-	const auto z2_position = frame.pressure.yn;
-	const float z2_norm = float(z2_position - z_min) / z_range;
-
-	const float r_x_plate = 330.0f;
-	//const float r_y_plate = 600.0f;
-	const float r_touch = r_x_plate * x_norm * (z2_norm / z1_norm - 1.0f);
+	constexpr int32_t r_x_plate = 330;
+	//constexpr int32_t r_y_plate = 600;
+	constexpr int32_t r_open = INT32_MAX;
+
+	const int32_t x_max = frame.x.xp;
+	const int32_t x_min = frame.x.xn;
+	const int32_t x_range = x_max - x_min;
+	const int32_t y_max = frame.y.yn;
+	const int32_t y_min = frame.y.yp;
+	const int32_t y_range = y_max - y_min;
+	if( (x_range <= 0) || (y_range <= 0) ) {
+		return { 0, 0, r_open };
+	}
+
+	// Position is the average of both plate ends, so << (bits - 1).
+	const int32_t x_sum = frame.x.yp + frame.x.yn;
+	const int32_t x_norm = ((x_sum << (metrics_frac_bits - 1)) - (x_min << metrics_frac_bits)) / x_range;
+	const int32_t y_sum = frame.y.xp + frame.y.xn;
+	const int32_t y_norm = ((y_sum << (metrics_frac_bits - 1)) - (y_min << metrics_frac_bits)) / y_range;
+
+	// r = r_x_plate * x * (z2 / z1 - 1), the z range cancels out of the ratio.
+	const int32_t z_min = frame.pressure.xn;
+	const int32_t z1 = frame.pressure.xp - z_min;
+	const int32_t z2 = frame.pressure.yn - z_min;
+	if( z1 <= 0 ) {
+		return { x_norm, y_norm, r_open };
+	}
+	const int32_t x_clipped = std::min<int32_t>(std::max<int32_t>(x_norm, 0), 1 << metrics_frac_bits);
+	const int32_t z_delta = std::min<int32_t>(std::max<int32_t>(z2 - z1, -sample_max), sample_max);
+	const int32_t r_touch = (r_x_plate * x_clipped * z_delta) / (z1 << metrics_frac_bits);
 
 	return {
 		.x = x_norm,
@@ -85,31 +89,29 @@ const Calibration default_calibration() {
 };
 
 void Manager::feed(const Frame& frame) {
-	// touch_debounce.feed(touch_raw);
 	const auto touch_raw = frame.touch;
-	//const auto touch_stable = touch_debounce.state();
-	const auto touch_stable = frame.touch;
 	bool touch_pressure = false;
 
 	// Only feed coordinate averaging if there's a touch.
-	// TODO: Separate threshold to gate coordinates for filtering?
 	if( touch_raw ) {
 		const auto metrics = calculate_metrics(frame);
 
-		// TODO: Add touch pressure hysteresis?
-		touch_pressure = (metrics.r < r_touch_threshold);
+		const auto r_threshold = (state == State::TouchDetected) ? r_release_threshold : r_press_threshold;
+		touch_pressure = (metrics.r < r_threshold);
 		if( touch_pressure ) {
-			filter_x.feed(metrics.x * 1024);
-			filter_y.feed(metrics.y * 1024);
+			filter_x.feed(std::max<int32_t>(metrics.x, 0));
+			filter_y.feed(std::max<int32_t>(metrics.y, 0));
 		}
-	} else {
+	} else if( state == State::NoTouch ) {
+		// Kept through the release debounce, so a touch that comes back within
+		// it carries on from a full filter instead of a mostly empty one
 		filter_x.reset();
 		filter_y.reset();
 	}
 
 	switch(state) {
 	case State::NoTouch:
-		if( touch_stable && touch_pressure && !persistent_memory::disable_touchscreen()) {
+		if( touch_pressure && !persistent_memory::disable_touchscreen()) {
 			if( point_stable() ) {
 				state = State::TouchDetected;
 				touch_started();
@@ -118,10 +120,15 @@ void Manager::feed(const Frame& frame) {
 		break;
 
 	case State::TouchDetected:
-		if( touch_stable && touch_pressure ) {
+		if( touch_pressure ) {
+			release_count = 0;
 			touch_moved();
-		} else {
+		} else if( ++release_count >= release_count_threshold ) {
+			// A few frames without pressure before ending, so a noisy sample
+			// doesn't split a drag in two.
 			state = State::NoTouch;
+			filter_x.reset();
+			filter_y.reset();
 			touch_ended();
 		}
 		break;
@@ -132,6 +139,79 @@ void Manager::feed(const Frame& frame) {
 	}
 }
 
+void Manager::touch_started() {
+	point = filtered_point();
+	origin = point;
+	last = point;
+	frames = 0;
+	release_count = 0;
+	velocity_x = 0;
+	velocity_y = 0;
+	gesture = Gesture::Tap;
+	fire_event(ui::TouchEvent::Type::Start);
+}
+
+void Manager::touch_moved() {
+	const auto previous = point;
+	point = filtered_point();
+	frames++;
+
+	// Single pole smoothing, Q4 pixels per frame
+	velocity_x += (((point.x() - previous.x()) << velocity_frac_bits) - velocity_x) >> 2;
+	velocity_y += (((point.y() - previous.y()) << velocity_frac_bits) - velocity_y) >> 2;
+
+	fire_event(ui::TouchEvent::Type::Move);
+
+	const auto travel = point - origin;
+	const bool outside_slop = (std::abs(travel.x()) > slop_pixels) || (std::abs(travel.y()) > slop_pixels);
+	const auto delta = point - last;
+	const bool moved = (delta.x() != 0) || (delta.y() != 0);
+
+	switch(gesture) {
+	case Gesture::Tap:
+		if( outside_slop ) {
+			gesture = Gesture::Drag;
+			last = point;
+			fire_event(ui::TouchEvent::Type::Drag, delta);
+		} else if( frames >= long_press_frames ) {
+			gesture = Gesture::Held;
+			fire_event(ui::TouchEvent::Type::LongPress);
+		}
+		break;
+
+	case Gesture::Held:
+		if( outside_slop ) {
+			gesture = Gesture::Zoom;
+			last = point;
+			fire_event(ui::TouchEvent::Type::Zoom, delta);
+		}
+		break;
+
+	case Gesture::Drag:
+	case Gesture::Zoom:
+		if( moved ) {
+			last = point;
+			fire_event((gesture == Gesture::Drag) ? ui::TouchEvent::Type::Drag : ui::TouchEvent::Type::Zoom, delta);
+		}
+		break;
+	}
+}
+
+void Manager::touch_ended() {
+	if( gesture == Gesture::Drag ) {
+		const auto speed = std::max(std::abs(velocity_x), std::abs(velocity_y));
+		if( speed >= swipe_velocity ) {
+			constexpr int32_t frames_per_100ms = 100000 / frame_period_us;
+			fire_event(ui::TouchEvent::Type::Swipe, {
+				(velocity_x * frames_per_100ms) >> velocity_frac_bits,
+				(velocity_y * frames_per_100ms) >> velocity_frac_bits
+			});
+		}
+	}
+	// End at the last point touched, the filters are already flushed.
+	fire_event(ui::TouchEvent::Type::End);
+}
+
 ui::Point Manager::filtered_point() const {
 	return persistent_memory::touch_calibration().translate({ filter_x.value(), filter_y.value() });
 }
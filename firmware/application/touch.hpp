@@ -106,10 +106,15 @@ struct Frame {
 	bool touch { false };
 };
 
+constexpr size_t metrics_frac_bits = 10;
+
+/* x and y are normalized to the panel in Q10 (0 to 1024), r is the touch
+ * resistance in ohms. Computed in integer, the M0 has no FPU.
+ */
 struct Metrics {
-	const float x;
-	const float y;
-	const float r;
+	const int32_t x;
+	const int32_t y;
+	const int32_t r;
 };
 
 Metrics calculate_metrics(const Frame& frame);
@@ -212,18 +217,45 @@ private:
 		TouchDetected,
 	};
 
-	static constexpr float r_touch_threshold = 640;
+	enum class Gesture {
+		Tap,
+		Drag,
+		Held,
+		Zoom,
+	};
+
+	/* A touch frame is completed every third 1kHz control timer tick */
+	static constexpr uint32_t frame_period_us = 3000;
+
+	// Pressure hysteresis: a touch must get firmer than r_press_threshold to
+	// start, and softer than r_release_threshold to end.
+	static constexpr int32_t r_press_threshold = 640;
+	static constexpr int32_t r_release_threshold = 800;
 	static constexpr size_t touch_count_threshold { 3 };
+	static constexpr size_t release_count_threshold { 3 };
 	static constexpr uint32_t touch_stable_bound { 8 };
 
+	static constexpr int32_t slop_pixels = 8;
+	static constexpr uint32_t long_press_frames = 500000 / frame_period_us;
+	// Velocity is tracked in Q4 pixels per frame. 0.5 pixels/ms to swipe.
+	static constexpr int32_t velocity_frac_bits = 4;
+	static constexpr int32_t swipe_velocity = (frame_period_us << velocity_frac_bits) / 2000;
+
 	// Ensure filter length is equal or less than touch_count_threshold,
 	// or coordinates from the last touch will be in the initial averages.
 	Filter<touch_count_threshold> filter_x { };
 	Filter<touch_count_threshold> filter_y { };
 
-	//Debounce touch_debounce;
-
 	State state { State::NoTouch };
+	size_t release_count { 0 };
+
+	Gesture gesture { Gesture::Tap };
+	uint32_t frames { 0 };
+	ui::Point point { };
+	ui::Point origin { };
+	ui::Point last { };
+	int32_t velocity_x { 0 };
+	int32_t velocity_y { 0 };
 
 	bool point_stable() const {
 		return filter_x.stable(touch_stable_bound)
@@ -232,21 +264,13 @@ private:
 
 	ui::Point filtered_point() const;
 
-	void touch_started() {
-		fire_event(ui::TouchEvent::Type::Start);
-	}
-
-	void touch_moved() {
-		fire_event(ui::TouchEvent::Type::Move);
-	}
-
-	void touch_ended() {
-		fire_event(ui::TouchEvent::Type::End);
-	}
+	void touch_started();
+	void touch_moved();
+	void touch_ended();
 
-	void fire_event(ui::TouchEvent::Type type) {
+	void fire_event(ui::TouchEvent::Type type, const ui::Point delta = { }) {
 		if( on_event ) {
-			on_event({ filtered_point(), type });
+			on_event({ point, type, delta });
 		}
 	}
 };
@@ -44,6 +44,11 @@ void TransmitterModel::set_tuning_frequency(rf::Frequency f) {
 	update_tuning_frequency();
 }
 
+void TransmitterModel::set_tuning_offset(int32_t offset) {
+	tuning_offset_ = offset;
+	update_tuning_frequency();
+}
+
 void TransmitterModel::set_antenna_bias() {
 	update_antenna_bias();
 }
@@ -138,6 +143,7 @@ void TransmitterModel::enable() {
 
 void TransmitterModel::disable() {
 	enabled_ = false;
+	tuning_offset_ = 0;
 	radio::set_antenna_bias(false);
 
 	// TODO: Responsibility for enabling/disabling the radio is muddy.
@@ -149,7 +155,7 @@ void TransmitterModel::disable() {
 }
 
 void TransmitterModel::update_tuning_frequency() {
-	radio::set_tuning_frequency(persistent_memory::tuned_frequency());
+	radio::set_tuning_frequency(persistent_memory::tuned_frequency() + tuning_offset_);
 }
 
 void TransmitterModel::update_antenna_bias() {
@@ -38,6 +38,11 @@ public:
 	rf::Frequency tuning_frequency() const;
 	void set_tuning_frequency(rf::Frequency f);
 
+	/* Radio tuned this far from tuning_frequency(), for basebands that shift
+	 * their signal away from DC. Cleared by disable().
+	 */
+	void set_tuning_offset(int32_t offset);
+
 	void set_antenna_bias();
 	
 	bool rf_amp() const;
@@ -73,6 +78,7 @@ private:
 	int32_t vga_gain_db_ { 8 };
 	int32_t tx_gain_db_ { 47 };
 	uint32_t sampling_rate_ { 3072000 };
+	int32_t tuning_offset_ { 0 };
 	SignalToken signal_token_tick_second { };
 
 	void update_tuning_frequency();
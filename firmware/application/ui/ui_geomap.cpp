@@ -175,15 +175,37 @@ void GeoMap::paint(Painter& painter) {
 }
 
 bool GeoMap::on_touch(const TouchEvent event) {
-	if ((event.type == TouchEvent::Type::Start) && (mode_ == PROMPT)) {
+	// Display mode keeps the tracked position centered
+	if ((mode_ != PROMPT) || !on_move)
+		return false;
+	
+	switch (event.type) {
+	case TouchEvent::Type::Start:
 		set_highlighted(true);
-		if (on_move) {
+		dragged = false;
+		return true;
+	
+	case TouchEvent::Type::Drag:
+	case TouchEvent::Type::Swipe:
+		// Map follows the finger, a swipe carries on for another 100ms worth
+		dragged = true;
+		pan(-event.delta);
+		return true;
+	
+	case TouchEvent::Type::End:
+		if (!dragged) {
 			Point p = event.point - screen_rect().center();
 			on_move(p.x() / 2.0 * lon_ratio, p.y() / 2.0 * lat_ratio);
-			return true;
 		}
+		return true;
+	
+	default:
+		return false;
 	}
-	return false;
+}
+
+void GeoMap::pan(const Point delta) {
+	on_move(delta.x() * lon_ratio, delta.y() * lat_ratio);
 }
 
 void GeoMap::move(const float lon, const float lat) {
@@ -135,6 +135,7 @@ public:
 
 private:
 	void draw_bearing(const Point origin, const uint16_t angle, uint32_t size, const Color color);
+	void pan(const Point delta);
 	
 	GeoMapMode mode_ { };
 	File map_file { };
@@ -147,6 +148,7 @@ private:
 	float lon_ { };
 	uint16_t angle_ { };
 	std::string tag_ { };
+	bool dragged { false };
 };
 
 class GeoMapView : public View {
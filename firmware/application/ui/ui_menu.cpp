@@ -44,9 +44,13 @@ void MenuItemView::unhighlight() {
 void MenuItemView::paint(Painter& painter) {
 	Coord offset_x { };
 	
-	if (!item) return;
-	
 	const auto r = screen_rect();
+	
+	if (!item) {
+		// Past the end of a shrunk list, don't leave the old row behind
+		painter.fill_rectangle(r, style().background);
+		return;
+	}
 
 	const auto paint_style = (highlighted() && (parent()->has_focus() || keep_highlight)) ? style().invert() : style();
 
@@ -163,6 +167,44 @@ void MenuView::clear() {
 	}
 	
 	menu_items.clear();
+	
+	item_provider = nullptr;
+	on_select_index = nullptr;
+	provided_items.clear();
+	provided_count = 0;
+}
+
+void MenuView::set_item_provider(
+	const size_t count,
+	item_provider_t provider,
+	std::function<void(size_t index)> on_select
+) {
+	clear();
+	
+	item_provider = provider;
+	on_select_index = on_select;
+	provided_count = count;
+	
+	// A new list starts at the top
+	offset = 0;
+	highlighted_item = 0;
+	
+	update_items();
+}
+
+void MenuView::set_item_count(const size_t count) {
+	provided_count = count;
+	
+	if (highlighted_item >= count)
+		highlighted_item = count ? count - 1 : 0;
+	if (offset > highlighted_item)
+		offset = highlighted_item;
+	
+	update_items();
+}
+
+size_t MenuView::item_count() const {
+	return item_provider ? provided_count : menu_items.size();
 }
 
 void MenuView::add_item(MenuItem new_item) {
@@ -179,18 +221,34 @@ void MenuView::add_items(std::initializer_list<MenuItem> new_items) {
 
 void MenuView::update_items() {
 	size_t i = 0;
+	const size_t count = item_count();
 	
-	if (menu_items.size() > displayed_max + offset) {
+	if (count > displayed_max + offset) {
 		more = true;
 		blink = true;
 	} else
 		more = false;
 	
+	if (item_provider)
+		provided_items.resize(menu_item_views.size());
+	
 	for (auto item : menu_item_views) {
-		if (i >= menu_items.size()) break;
+		if (i + offset >= count) {
+			item->set_item(nullptr);
+			item->set_dirty();
+			i++;
+			continue;
+		}
 		
 		// Assign item data to MenuItemViews according to offset
-		item->set_item(&menu_items[i + offset]);
+		if (item_provider) {
+			auto& provided_item = provided_items[i];
+			provided_item = { "", Color::white(), nullptr, nullptr };
+			item_provider(i + offset, provided_item);
+			item->set_item(&provided_item);
+		} else {
+			item->set_item(&menu_items[i + offset]);
+		}
 		item->set_dirty();
 		
 		if (highlighted_item == (i + offset)) {
@@ -207,13 +265,13 @@ MenuItemView* MenuView::item_view(size_t index) const {
 }
 
 bool MenuView::set_highlighted(int32_t new_value) {
-	int32_t item_count = (int32_t)menu_items.size();
+	int32_t count = (int32_t)item_count();
 	
-	if (new_value < 0)
+	if ((new_value < 0) || !count)
 		return false;
 	
-	if (new_value >= item_count)
-		new_value = item_count - 1;
+	if (new_value >= count)
+		new_value = count - 1;
 	
 	if (((uint32_t)new_value > offset) && ((new_value - offset) >= displayed_max)) {
 		// Shift MenuView up
@@ -261,8 +319,14 @@ bool MenuView::on_key(const KeyEvent key) {
 
 	case KeyEvent::Select:
 	case KeyEvent::Right:
-		if( menu_items[highlighted_item].on_select ) {
-			menu_items[highlighted_item].on_select();
+		if( item_provider ) {
+			if( on_select_index && (highlighted_item < provided_count) ) {
+				on_select_index(highlighted_item);
+			}
+		} else if( highlighted_item < menu_items.size() ) {
+			if( menu_items[highlighted_item].on_select ) {
+				menu_items[highlighted_item].on_select();
+			}
 		}
 		return true;
 
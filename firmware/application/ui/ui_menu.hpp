@@ -84,6 +84,20 @@ public:
 	void add_items(std::initializer_list<MenuItem> new_items);
 	void clear();
 	
+	/* Data source mode: instead of holding every item, only the displayed ones
+	 * are fetched from item_provider by index. The MenuItem::on_select of
+	 * provided items is ignored, on_select_index is called instead.
+	 */
+	using item_provider_t = std::function<void(size_t index, MenuItem& item)>;
+	
+	void set_item_provider(
+		const size_t count,
+		item_provider_t provider,
+		std::function<void(size_t index)> on_select
+	);
+	void set_item_count(const size_t count);
+	size_t item_count() const;
+	
 	MenuItemView* item_view(size_t index) const;
 
 	bool set_highlighted(int32_t new_value);
@@ -105,6 +119,12 @@ private:
 	std::vector<MenuItem> menu_items { };
 	std::vector<MenuItemView*> menu_item_views { };
 	
+	// Data source mode
+	item_provider_t item_provider { nullptr };
+	std::function<void(size_t index)> on_select_index { nullptr };
+	std::vector<MenuItem> provided_items { };	// One per MenuItemView
+	size_t provided_count { 0 };
+	
 	Image arrow_more {
 		{ 228, 320 - 8, 8, 8 },
 		&bitmap_more,
@@ -232,21 +232,14 @@ void FrequencyScale::on_blur() {
 }
 
 bool FrequencyScale::on_encoder(const EncoderEvent delta) {
-	cursor_position += delta;
-	
-	cursor_position = std::min<int32_t>(cursor_position, 119);
-	cursor_position = std::max<int32_t>(cursor_position, -120);
-	
-	set_dirty();
-	
+	set_cursor_position(cursor_position + delta);
 	return true;
 }
 
 bool FrequencyScale::on_key(const KeyEvent key) {
 	if( key == KeyEvent::Select ) {
 		if( on_select ) {
-			on_select((cursor_position * spectrum_sampling_rate) / 240);
-			cursor_position = 0;
+			select_cursor();
 			return true;
 		}
 	}
@@ -254,6 +247,21 @@ bool FrequencyScale::on_key(const KeyEvent key) {
 	return false;
 }
 
+void FrequencyScale::set_cursor_position(const int32_t position) {
+	cursor_position = std::min<int32_t>(position, 119);
+	cursor_position = std::max<int32_t>(cursor_position, -120);
+	
+	set_dirty();
+}
+
+void FrequencyScale::select_cursor() {
+	if( on_select ) {
+		on_select((cursor_position * spectrum_sampling_rate) / 240);
+	}
+	cursor_position = 0;
+	set_dirty();
+}
+
 void FrequencyScale::on_tick_second() {
 	set_dirty();
 	_blink = !_blink;
@@ -327,6 +335,45 @@ WaterfallWidget::WaterfallWidget(const bool cursor) {
 	};
 }
 
+bool WaterfallWidget::on_touch(const TouchEvent event) {
+	// Only with a cursor, so a tap can't retune apps that didn't ask for it
+	if( !frequency_scale.focusable() ) {
+		return false;
+	}
+
+	const auto position = event.point.x() - screen_rect().left() - 120;
+
+	switch(event.type) {
+	case TouchEvent::Type::Start:
+		// The cursor is only drawn while focused
+		frequency_scale.focus();
+		frequency_scale.set_cursor_position(position);
+		return true;
+
+	case TouchEvent::Type::Drag:
+		frequency_scale.set_cursor_position(position);
+		return true;
+
+	case TouchEvent::Type::LongPress:
+		frequency_scale.select_cursor();
+		return true;
+
+	case TouchEvent::Type::Swipe:
+		// Swiping left drags higher frequencies into view
+		if( std::abs(event.delta.x()) > std::abs(event.delta.y()) ) {
+			frequency_scale.set_cursor_position((event.delta.x() < 0) ? 119 : -120);
+			frequency_scale.select_cursor();
+		}
+		return true;
+
+	case TouchEvent::Type::End:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
 void WaterfallWidget::on_show() {
 	baseband::spectrum_streaming_start();
 }
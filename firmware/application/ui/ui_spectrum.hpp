@@ -81,6 +81,9 @@ public:
 	bool on_encoder(const EncoderEvent delta) override;
 	bool on_key(const KeyEvent key) override;
 
+	void set_cursor_position(const int32_t position);
+	void select_cursor();
+
 	void set_spectrum_sampling_rate(const int new_sampling_rate);
 	void set_channel_filter(const int low_frequency, const int high_frequency, const int transition);
 
@@ -140,6 +143,8 @@ public:
 
 	void paint(Painter& painter) override;
 
+	bool on_touch(const TouchEvent event) override;
+
 private:
 	void update_widgets_rect();
 	
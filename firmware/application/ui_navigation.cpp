@@ -38,7 +38,9 @@
 #include "ui_btle_rx.hpp"
 #include "ui_nrf_rx.hpp"
 #include "ui_aprs_tx.hpp"
+#include "ui_apt_rx.hpp"
 #include "ui_bht_tx.hpp"
+#include "ui_channel_power.hpp"
 #include "ui_coasterp.hpp"
 #include "ui_debug.hpp"
 #include "ui_encoders.hpp"
@@ -56,11 +58,13 @@
 #include "ui_rds.hpp"
 #include "ui_remote.hpp"
 #include "ui_scanner.hpp"
+#include "ui_script.hpp"
 #include "ui_search.hpp"
 #include "ui_sd_wipe.hpp"
 #include "ui_settings.hpp"
 #include "ui_siggen.hpp"
 #include "ui_sonde.hpp"
+#include "ui_sstv_rx.hpp"
 #include "ui_sstvtx.hpp"
 //#include "ui_test.hpp"
 #include "ui_tone_search.hpp"
@@ -74,6 +78,7 @@
 #include "analog_tv_app.hpp"
 #include "capture_app.hpp"
 #include "ert_app.hpp"
+#include "ism_app.hpp"
 #include "lge_app.hpp"
 #include "pocsag_app.hpp"
 #include "replay_app.hpp"
@@ -85,6 +90,7 @@
 #include "ui_looking_glass_app.hpp"
 #include "file.hpp"
 #include "png_writer.hpp"
+#include "screen_recorder.hpp"
 
 using portapack::receiver_model;
 using portapack::transmitter_model;
@@ -204,6 +210,8 @@ void SystemStatusView::refresh() {
 	} else {
 		button_clock_status.set_foreground(ui::Color::light_grey());
 	}
+
+	button_camera.set_foreground(screen_recorder::active() ? ui::Color::red() : ui::Color::white());
 	
 	set_dirty();
 }
@@ -294,13 +302,18 @@ void SystemStatusView::on_bias_tee() {
 }*/
 
 void SystemStatusView::on_camera() {
+	if( portapack::persistent_memory::camera_records_video() ) {
+		on_record();
+		return;
+	}
+
 	auto path = next_filename_stem_matching_pattern(u"SCR_????");
 	if( path.empty() ) {
 		return;
 	}
 
-	PNGWriter png;
-	auto create_error = png.create(path.replace_extension(u".PNG"));
+	auto png = std::make_unique<PNGWriter>();
+	auto create_error = png->create(path.replace_extension(u".PNG"));
 	if( create_error.is_valid() ) {
 		return;
 	}
@@ -308,8 +321,20 @@ void SystemStatusView::on_camera() {
 	for(int i = 0; i < 320; i++) {
 		std::array<ColorRGB888, 240> row;
 		portapack::display.read_pixels({ 0, i, 240, 1 }, row);
-		png.write_scanline(row);
+		png->write_scanline(row);
+	}
+}
+
+void SystemStatusView::on_record() {
+	if( screen_recorder::active() ) {
+		screen_recorder::stop();
+	} else {
+		auto path = next_filename_stem_matching_pattern(u"REC_????");
+		if( !path.empty() ) {
+			screen_recorder::start(path.replace_extension(u".PSR"));
+		}
 	}
+	refresh();
 }
 
 void SystemStatusView::on_clk() {
@@ -478,15 +503,17 @@ ReceiversMenuView::ReceiversMenuView(NavigationView& nav) {
 		{ "Audio", 		ui::Color::green(),		&bitmap_icon_speaker,	[&nav](){ nav.push<AnalogAudioView>(); } },
 		{ "Analog TV", 	ui::Color::yellow(),	&bitmap_icon_sstv,		[&nav](){ nav.push<AnalogTvView>(); } },
 		{ "ERT Meter", 	ui::Color::green(), 	&bitmap_icon_ert,		[&nav](){ nav.push<ERTAppView>(); } },
+		{ "ISM", 		ui::Color::yellow(),	&bitmap_icon_remote,	[&nav](){ nav.push<ISMAppView>(); } },
 		{ "POCSAG", 	ui::Color::green(),		&bitmap_icon_pocsag,	[&nav](){ nav.push<POCSAGAppView>(); } },
 		{ "Radiosnde", 	ui::Color::green(),		&bitmap_icon_sonde,		[&nav](){ nav.push<SondeView>(); } },
 		{ "TPMS Cars", 	ui::Color::green(),		&bitmap_icon_tpms,		[&nav](){ nav.push<TPMSAppView>(); } },
-		{ "APRS", 		ui::Color::green(),		&bitmap_icon_aprs,		[&nav](){ nav.push<APRSRXView>(); } }
+		{ "APRS", 		ui::Color::green(),		&bitmap_icon_aprs,		[&nav](){ nav.push<APRSRXView>(); } },
+		{ "NOAA APT", 	ui::Color::yellow(),	&bitmap_icon_sstv,		[&nav](){ nav.push<APTRxView>(); } },
+		{ "SSTV", 		ui::Color::yellow(),	&bitmap_icon_sstv,		[&nav](){ nav.push<SSTVRxView>(); } }
 		/*
 		{ "DMR", 		ui::Color::dark_grey(),	&bitmap_icon_dmr,		[&nav](){ nav.push<NotImplementedView>(); } },
 		{ "SIGFOX", 	ui::Color::dark_grey(),	&bitmap_icon_fox,		[&nav](){ nav.push<NotImplementedView>(); } }, // SIGFRXView
 		{ "LoRa", 		ui::Color::dark_grey(),	&bitmap_icon_lora,		[&nav](){ nav.push<NotImplementedView>(); } },
-		{ "SSTV", 		ui::Color::dark_grey(), &bitmap_icon_sstv,		[&nav](){ nav.push<NotImplementedView>(); } },
 		{ "TETRA", 		ui::Color::dark_grey(),	&bitmap_icon_tetra,		[&nav](){ nav.push<NotImplementedView>(); } },*/
 	} );
 
@@ -518,7 +545,7 @@ TransmittersMenuView::TransmittersMenuView(NavigationView& nav) {
 		{ "SSTV", 			ui::Color::green(), 	&bitmap_icon_sstv,		[&nav](){ nav.push<SSTVTXView>(); } },
 		{ "TEDI/LCR",		ui::Color::yellow(), 	&bitmap_icon_lcr,		[&nav](){ nav.push<LCRView>(); } },
 		{ "TouchTune",		ui::Color::yellow(),	&bitmap_icon_remote,	[&nav](){ nav.push<TouchTunesView>(); } },
-		//{ "Remote",			ui::Color::dark_grey(),	&bitmap_icon_remote,	[&nav](){ nav.push<RemoteView>(); } },
+		{ "Remote",			ui::Color::yellow(),	&bitmap_icon_remote,	[&nav](){ nav.push<RemoteView>(); } },
 	});
 }
 
@@ -535,8 +562,10 @@ UtilitiesMenuView::UtilitiesMenuView(NavigationView& nav) {
 		{ "File manager", 	ui::Color::yellow(),	&bitmap_icon_dir,			[&nav](){ nav.push<FileManagerView>(); } },
 		//{ "Notepad",		ui::Color::dark_grey(),	&bitmap_icon_notepad,		[&nav](){ nav.push<NotImplementedView>(); } },
 		{ "Signal gen", 	ui::Color::green(), 	&bitmap_icon_cwgen,			[&nav](){ nav.push<SigGenView>(); } },
+		{ "Channel power",	ui::Color::green(),		&bitmap_icon_search,		[&nav](){ nav.push<ChannelPowerView>(); } },
 		//{ "Tone search",	ui::Color::dark_grey(), nullptr,					[&nav](){ nav.push<ToneSearchView>(); } },
 		{ "WAV viewer",	ui::Color::yellow(),	&bitmap_icon_soundboard,	[&nav](){ nav.push<ViewWavView>(); } },
+		{ "Script",			ui::Color::yellow(),	&bitmap_icon_notepad,		[&nav](){ nav.push<ScriptView>(); } },
 		{ "Antenna length",	ui::Color::green(),		&bitmap_icon_tools_antenna,	[&nav](){ nav.push<WhipCalcView>(); } },
 		{ "Wipe SD Card",	ui::Color::red(),		&bitmap_icon_tools_wipesd,	[&nav](){ nav.push<WipeSDView>(); } },
 	});
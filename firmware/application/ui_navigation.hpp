@@ -192,6 +192,7 @@ namespace ui
 		void on_bias_tee();
 		// void on_textentry();
 		void on_camera();
+		void on_record();
 		void on_title();
 		void refresh();
 		void on_clk();
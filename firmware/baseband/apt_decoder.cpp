@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "apt_decoder.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+/* Sync A is seven 1040Hz cycles, sync B seven 832Hz pulses, both 39 words
+ * including the leading (and for A, trailing) black.
+ */
+constexpr char sync_a[] = "000011001100110011001100110011000000000";
+constexpr char sync_b[] = "000011100111001110011100111001110011100";
+
+/* Pearson correlation of the words against a 0/1 pattern, independent of the
+ * contrast and brightness of the signal.
+ */
+float correlate(const uint8_t* const words, const char* const pattern, const size_t length) {
+	float sum_x = 0;
+	float sum_xx = 0;
+	float sum_xp = 0;
+	size_t ones = 0;
+	for(size_t i=0; i<length; i++) {
+		const float x = words[i];
+		sum_x += x;
+		sum_xx += x * x;
+		if( pattern[i] == '1' ) {
+			sum_xp += x;
+			ones++;
+		}
+	}
+
+	const float n = length;
+	const float var_x = sum_xx - sum_x * sum_x / n;
+	const float var_p = ones - ones * ones / n;
+	if( var_x <= 1.0f ) {
+		return 0;
+	}
+	return (sum_xp - sum_x * ones / n) / std::sqrt(var_x * var_p);
+}
+
+} /* namespace */
+
+APTDecoder::APTDecoder() {
+	for(size_t i=0; i<carrier_period; i++) {
+		const float phase = 2.0f * pi * i / carrier_period;
+		cos_table[i] = std::cos(phase);
+		sin_table[i] = std::sin(phase);
+	}
+}
+
+void APTDecoder::reset() {
+	dc = 0;
+	history_i.fill(0);
+	history_q.fill(0);
+	sum_i = 0;
+	sum_q = 0;
+	boxcar_index = 0;
+	resampler_phase = 0;
+	magnitude_prev = 0;
+	magnitude_mean = 1;
+	words_in = 0;
+	line_start = APTLine::words;
+	locked = false;
+	misses = 0;
+	best_score = -1.0f;
+	level_low = 0;
+	level_high = 255;
+	line.number = 0;
+}
+
+bool APTDecoder::demodulate(const int16_t sample) {
+	const float x = sample - dc;
+	dc += x * (1.0f / 1024.0f);
+
+	const float i = x * cos_table[carrier_phase];
+	const float q = x * sin_table[carrier_phase];
+	carrier_phase = (carrier_phase + 1) % carrier_period;
+
+	sum_i += i - history_i[boxcar_index];
+	sum_q += q - history_q[boxcar_index];
+	history_i[boxcar_index] = i;
+	history_q[boxcar_index] = q;
+	if( ++boxcar_index >= boxcar_length ) {
+		boxcar_index = 0;
+		// Start over from the exact sums, so rounding can't build up during a pass
+		sum_i = 0;
+		sum_q = 0;
+		for(size_t n=0; n<boxcar_length; n++) {
+			sum_i += history_i[n];
+			sum_q += history_q[n];
+		}
+	}
+
+	const float magnitude = std::sqrt(sum_i * sum_i + sum_q * sum_q);
+
+	resampler_phase += word_rate;
+	if( resampler_phase < sampling_rate ) {
+		magnitude_prev = magnitude;
+		return false;
+	}
+	resampler_phase -= sampling_rate;
+
+	// The word falls between the previous and this sample
+	const float frac = float(resampler_phase) / word_rate;
+	const float value = magnitude - frac * (magnitude - magnitude_prev);
+	magnitude_prev = magnitude;
+
+	// Slow AGC, about 2s, puts the average at 100 with room for the whites
+	magnitude_mean += (value - magnitude_mean) * (1.0f / 8192.0f);
+	const float scaled = value * 100.0f / std::max(magnitude_mean, 1.0f);
+	word = std::min(scaled, 255.0f);
+	return true;
+}
+
+bool APTDecoder::on_word() {
+	ring[words_in & (ring_words - 1)] = word;
+	words_in++;
+
+	if( words_in >= sync_delay ) {
+		const uint32_t candidate = words_in - sync_delay;
+
+		if( locked ) {
+			if( (candidate + track_window >= line_start) && (candidate <= line_start + track_window) ) {
+				const auto score = sync_score(candidate);
+				if( score > best_score ) {
+					best_score = score;
+					best_start = candidate;
+				}
+				if( candidate == line_start + track_window ) {
+					on_sync_decision();
+				}
+			}
+		} else {
+			const auto score = sync_score(candidate);
+			if( score > best_score ) {
+				best_score = score;
+				best_start = candidate;
+			}
+			if( candidate == line_start ) {
+				on_sync_decision();
+			}
+		}
+	}
+
+	if( words_in >= line_start + APTLine::words ) {
+		emit_line();
+		line_start += APTLine::words;
+		return true;
+	}
+	return false;
+}
+
+float APTDecoder::sync_score(const uint32_t start) const {
+	std::array<uint8_t, sync_length> words_a;
+	std::array<uint8_t, sync_length> words_b;
+	for(size_t i=0; i<sync_length; i++) {
+		words_a[i] = at(start + i);
+		words_b[i] = at(start + channel_words + i);
+	}
+	return (correlate(words_a.data(), sync_a, sync_length) + correlate(words_b.data(), sync_b, sync_length)) * 0.5f;
+}
+
+void APTDecoder::on_sync_decision() {
+	if( locked ) {
+		if( best_score >= track_score ) {
+			line_start = best_start;
+			misses = 0;
+		} else if( ++misses > misses_max ) {
+			locked = false;
+		}
+	} else if( best_score >= acquire_score ) {
+		locked = true;
+		misses = 0;
+		// The search covered the line before line_start, that one is gone already
+		if( best_start != line_start ) {
+			line_start = best_start + APTLine::words;
+		}
+	}
+	best_score = -1.0f;
+}
+
+void APTDecoder::emit_line() {
+	line.synced = locked && (misses == 0);
+
+	if( line.synced ) {
+		// Sync A swings between black and white, follow it slowly
+		float high = 0;
+		float low = 0;
+		size_t highs = 0;
+		for(size_t i=0; i<sync_length; i++) {
+			if( sync_a[i] == '1' ) {
+				high += at(line_start + i);
+				highs++;
+			} else {
+				low += at(line_start + i);
+			}
+		}
+		high /= highs;
+		low /= (sync_length - highs);
+		if( high > low + 16.0f ) {
+			level_high += (high - level_high) * 0.25f;
+			level_low += (low - level_low) * 0.25f;
+		}
+	}
+
+	const float gain = 255.0f / std::max(level_high - level_low, 16.0f);
+	for(size_t i=0; i<APTLine::words; i++) {
+		const float v = (at(line_start + i) - level_low) * gain;
+		line.data[i] = std::max(0.0f, std::min(v, 255.0f));
+	}
+	line.number++;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __APT_DECODER_H__
+#define __APT_DECODER_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* NOAA APT from FM demodulated audio at 48kHz. The 2400Hz subcarrier is
+ * mixed to DC (fs is exactly 20 carrier periods), its envelope resampled to
+ * the 4160Hz word rate and kept in a ring of two lines. Line starts are found
+ * by correlating against both sync patterns, first over a whole line, then
+ * in a narrow window around the expected start once locked.
+ */
+class APTDecoder {
+public:
+	APTDecoder();
+
+	/* Calls handler with every complete line, about twice a second. */
+	template<typename LineHandler>
+	void execute(const buffer_s16_t& src, LineHandler handler) {
+		for(size_t i=0; i<src.count; i++) {
+			if( demodulate(src.p[i]) ) {
+				if( on_word() ) {
+					handler(line);
+				}
+			}
+		}
+	}
+
+	void reset();
+
+private:
+	static constexpr uint32_t sampling_rate = 48000;
+	static constexpr uint32_t word_rate = 4160;
+	static constexpr size_t carrier_period = 20;
+	static constexpr size_t boxcar_length = 10;		// Nulls the 4800Hz mixing product
+	static constexpr size_t sync_length = 39;
+	static constexpr size_t channel_words = APTLine::words / 2;
+	// Candidate line start whose sync B just completed
+	static constexpr size_t sync_delay = channel_words + sync_length;
+	static constexpr size_t ring_words = 4096;
+	static constexpr int32_t track_window = 2;
+	static constexpr float acquire_score = 0.5f;
+	static constexpr float track_score = 0.3f;
+	static constexpr size_t misses_max = 4;
+
+	static_assert(sampling_rate == carrier_period * 2400, "Mixer table needs whole carrier periods");
+	static_assert(ring_words >= APTLine::words + sync_delay, "Ring must hold a line and the sync search");
+
+	std::array<float, carrier_period> cos_table { };
+	std::array<float, carrier_period> sin_table { };
+	size_t carrier_phase { 0 };
+
+	float dc { 0 };
+	std::array<float, boxcar_length> history_i { };
+	std::array<float, boxcar_length> history_q { };
+	float sum_i { 0 };
+	float sum_q { 0 };
+	size_t boxcar_index { 0 };
+
+	uint32_t resampler_phase { 0 };
+	float magnitude_prev { 0 };
+	float magnitude_mean { 1 };
+	uint8_t word { 0 };
+
+	std::array<uint8_t, ring_words> ring { };
+	uint32_t words_in { 0 };
+
+	uint32_t line_start { APTLine::words };
+	bool locked { false };
+	size_t misses { 0 };
+	float best_score { -1.0f };
+	uint32_t best_start { 0 };
+
+	float level_low { 0 };
+	float level_high { 255 };
+
+	APTLine line { };
+
+	bool demodulate(const int16_t sample);
+	bool on_word();
+	float sync_score(const uint32_t start) const;
+	void on_sync_decision();
+	void emit_line();
+
+	uint8_t at(const uint32_t index) const {
+		return ring[index & (ring_words - 1)];
+	}
+};
+
+#endif/*__APT_DECODER_H__*/
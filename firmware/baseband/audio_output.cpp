@@ -83,7 +83,7 @@ void AudioOutput::on_block(
 		deemph.execute_in_place(audio);
 
 		audio_present_history = (audio_present_history << 1) | (audio_present_now ? 1 : 0);
-		audio_present = (audio_present_history != 0);
+		audio_present = (audio_present_history != 0) && gate_open && squelch_open;
 		
 		if( !audio_present ) {
 			for(size_t i=0; i<audio.count; i++) {
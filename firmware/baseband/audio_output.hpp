@@ -54,6 +54,16 @@ public:
 	
 	bool is_squelched();
 
+	/* Mutes on top of the noise squelch, for coded squelch */
+	void set_gate(const bool open) {
+		gate_open = open;
+	}
+
+	/* State of the processor's carrier squelch, see Squelch */
+	void set_squelch_open(const bool open) {
+		squelch_open = open;
+	}
+
 private:
 	static constexpr float k = 32768.0f;
 	static constexpr float ki = 1.0f / k;
@@ -71,6 +81,8 @@ private:
 	uint64_t audio_present_history = 0;
 	
 	bool audio_present = false;
+	bool gate_open = true;
+	bool squelch_open = true;
 	bool do_processing = true;
 
 	void on_block(const buffer_f32_t& audio);
@@ -36,6 +36,11 @@ public:
 
 	virtual void on_message(const Message* const) { };
 
+	/* Runs in the event loop thread after EVT_MASK_DEFERRED is flagged, for
+	 * work too slow to do in execute() (e.g. decoding a captured frame).
+	 */
+	virtual void on_deferred() { };
+
 protected:
 	void feed_channel_stats(const buffer_c16_t& channel);
 
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "channel_power.hpp"
+
+#include "dsp_fft.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+/* Fraction of the power kept out of the occupied bandwidth, split between
+ * the two sides.
+ */
+constexpr float obw_excluded = 0.01f;
+
+float to_db(const float power) {
+	return 10.0f * log10f(std::max(power, 1e-20f));
+}
+
+} /* namespace */
+
+void ChannelPowerMeter::configure(const ChannelPowerConfigureMessage& message, const uint32_t sampling_rate) {
+	float window_sum_squares = 0.0f;
+	for(size_t n=0; n<window.size(); n++) {
+		window[n] = 0.5f - 0.5f * cosf(2.0f * pi * n / fft_size);
+		window_sum_squares += window[n] * window[n];
+	}
+	// Parseval: the sum of |X|^2 is N times the windowed sample energy
+	window_power = window_sum_squares * fft_size;
+
+	bin_width = static_cast<float>(sampling_rate) / fft_size;
+	channel_center = message.frequency_offset;
+	channel_bandwidth = message.channel_bandwidth;
+	channel_spacing = message.channel_spacing;
+	gain_db = message.gain_db;
+
+	// Only measure adjacent channels that fit in the passband
+	const float usable = sampling_rate * usable_bandwidth;
+	adjacent_count = 0;
+	while( (adjacent_count < std::min<size_t>(message.adjacent_count, ChannelPower::adjacent_max)) &&
+		   (std::abs(channel_center) + (adjacent_count + 1) * channel_spacing + channel_bandwidth / 2 <= usable) ) {
+		adjacent_count++;
+	}
+
+	power.fill(0.0f);
+	frames = 0;
+}
+
+void ChannelPowerMeter::add_frame(const frame_t& frame) {
+	for(size_t n=0; n<fft_size; n++) {
+		const float w = window[n] * (1.0f / 32768.0f);
+		fft[n] = { frame[n].real() * w, frame[n].imag() * w };
+	}
+	fft_swap_in_place(fft);
+	fft_c_preswapped(fft, 0, 8);
+
+	for(size_t k=0; k<fft_size; k++) {
+		power[k] += std::norm(fft[k]);
+	}
+	frames++;
+}
+
+/* Bins are indexed in ascending frequency, -fs/2 first */
+float ChannelPowerMeter::bin_frequency(const size_t index) const {
+	return (static_cast<int32_t>(index) - static_cast<int32_t>(fft_size / 2)) * bin_width;
+}
+
+float ChannelPowerMeter::bin_power(const size_t index) const {
+	return power[(index + fft_size / 2) & (fft_size - 1)];
+}
+
+/* Fraction of the bin that falls inside [low, high) */
+float ChannelPowerMeter::overlap(const size_t index, const float low, const float high) const {
+	const float f = bin_frequency(index);
+	const float bin_low = std::max(low, f - bin_width / 2);
+	const float bin_high = std::min(high, f + bin_width / 2);
+	return std::max(bin_high - bin_low, 0.0f) / bin_width;
+}
+
+float ChannelPowerMeter::band_power(const float low, const float high) const {
+	float sum = 0.0f;
+	for(size_t i=0; i<fft_size; i++) {
+		sum += bin_power(i) * overlap(i, low, high);
+	}
+	return sum;
+}
+
+void ChannelPowerMeter::occupied_bandwidth(const float low, const float high, ChannelPower& result) const {
+	const float total = band_power(low, high);
+	const float target = total * obw_excluded / 2;
+	if( total <= 0.0f ) {
+		return;
+	}
+
+	float lower = low;
+	float sum = 0.0f;
+	for(size_t i=0; i<fft_size; i++) {
+		const float fraction = overlap(i, low, high);
+		const float p = bin_power(i) * fraction;
+		if( (p > 0.0f) && (sum + p >= target) ) {
+			const float bin_low = std::max(low, bin_frequency(i) - bin_width / 2);
+			lower = bin_low + (target - sum) / p * fraction * bin_width;
+			break;
+		}
+		sum += p;
+	}
+
+	float upper = high;
+	sum = 0.0f;
+	for(size_t i=fft_size; i>0; i--) {
+		const float fraction = overlap(i - 1, low, high);
+		const float p = bin_power(i - 1) * fraction;
+		if( (p > 0.0f) && (sum + p >= target) ) {
+			const float bin_high = std::min(high, bin_frequency(i - 1) + bin_width / 2);
+			upper = bin_high - (target - sum) / p * fraction * bin_width;
+			break;
+		}
+		sum += p;
+	}
+
+	result.occupied_bandwidth = std::max(upper - lower, 0.0f);
+	result.occupied_center = (upper + lower) / 2;
+}
+
+ChannelPower ChannelPowerMeter::result() {
+	ChannelPower result;
+	result.frames = frames;
+	result.adjacent_count = adjacent_count;
+
+	if( frames > 0 ) {
+		const float scale = 1.0f / (window_power * frames);
+		const float half_bw = channel_bandwidth / 2;
+
+		const float channel = band_power(channel_center - half_bw, channel_center + half_bw);
+		result.channel_dbm = to_db(channel * scale) - gain_db;
+
+		for(size_t n=0; n<adjacent_count; n++) {
+			const float offset = (n + 1) * channel_spacing;
+			const float lower = band_power(channel_center - offset - half_bw, channel_center - offset + half_bw);
+			const float upper = band_power(channel_center + offset - half_bw, channel_center + offset + half_bw);
+			result.acpr_lower_dbc[n] = to_db(lower) - to_db(channel);
+			result.acpr_upper_dbc[n] = to_db(upper) - to_db(channel);
+		}
+
+		// Measure the OBW over the channel and its neighbours, like a span on an analyzer
+		const float span = std::max(channel_bandwidth, (adjacent_count + 0.5f) * channel_spacing);
+		occupied_bandwidth(channel_center - span, channel_center + span, result);
+	}
+
+	power.fill(0.0f);
+	frames = 0;
+	return result;
+}
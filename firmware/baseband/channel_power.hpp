@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CHANNEL_POWER_H__
+#define __CHANNEL_POWER_H__
+
+#include "dsp_types.hpp"
+#include "complex.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <complex>
+
+/* Averages Hann-windowed FFT frames as linear power, then integrates the
+ * power over the channel masks. Frames and results are handled in the event
+ * loop thread, the baseband thread only decimates and copies samples.
+ *
+ * Input is the decimated channel (complex16_t, full scale 32768), at the
+ * sampling rate given to configure().
+ */
+class ChannelPowerMeter {
+public:
+	static constexpr size_t fft_size = 256;
+
+	/* Flat part of the decimation filters' passband, as a fraction of the
+	 * decimated sampling rate
+	 */
+	static constexpr float usable_bandwidth = 0.32f;
+
+	using frame_t = std::array<complex16_t, fft_size>;
+
+	void configure(const ChannelPowerConfigureMessage& message, const uint32_t sampling_rate);
+
+	void add_frame(const frame_t& frame);
+
+	bool ready() const {
+		return frames > 0;
+	}
+
+	/* Computes the result from the frames averaged so far and starts over */
+	ChannelPower result();
+
+private:
+	std::array<std::complex<float>, fft_size> fft { };
+	std::array<float, fft_size> power { };
+	std::array<float, fft_size> window { };
+	float window_power { 1.0f };
+	size_t frames { 0 };
+
+	float bin_width { 1.0f };
+	float channel_center { 0.0f };
+	float channel_bandwidth { 0.0f };
+	float channel_spacing { 0.0f };
+	size_t adjacent_count { 0 };
+	float gain_db { 0.0f };
+
+	float bin_frequency(const size_t index) const;
+	float bin_power(const size_t index) const;
+	float overlap(const size_t index, const float low, const float high) const;
+
+	float band_power(const float low, const float high) const;
+	void occupied_bandwidth(const float low, const float high, ChannelPower& result) const;
+};
+
+#endif/*__CHANNEL_POWER_H__*/
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "cw_decoder.hpp"
+
+#include "complex.hpp"
+#include "morse.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+
+void CWDecoder::configure(const CWRxConfigureMessage& message, const uint32_t sampling_rate) {
+	block_samples = sampling_rate * block_ms / 1000;
+	coefficient = 2.0f * std::cos(2.0f * pi * message.pitch / sampling_rate);
+	s1 = 0;
+	s2 = 0;
+	block_count = 0;
+	status_count = 0;
+
+	signal_level = 0;
+	noise_level = 0;
+	noise_spread = 0;
+	seed_count = 0;
+	key = false;
+	acquired = 0;
+	last_mark = 0;
+	run = 0;
+	pending = 0;
+	committed = true;
+	char_sent = true;
+	word_sent = true;
+	code_length = 0;
+
+	enabled = message.enabled;
+}
+
+char CWDecoder::on_block() {
+	const float power = s1 * s1 + s2 * s2 - coefficient * s1 * s2;
+	s1 = 0;
+	s2 = 0;
+	block_count = 0;
+
+	const bool level = slice(std::sqrt(std::max(power, 0.0f)) / block_samples);
+	const size_t glitch = std::max<size_t>(2, dit * 0.3f);
+
+	if( level != key ) {
+		key = level;
+		if( committed ) {
+			pending = run;
+			run = 1;
+			committed = false;
+		} else {
+			// The run that just ended was too short, the one before carries on
+			run = pending + run + 1;
+			committed = true;
+		}
+		return 0;
+	}
+
+	run++;
+	if( !committed && (run >= glitch) ) {
+		committed = true;
+		if( key ) {
+			on_space(pending);
+		} else {
+			on_mark(pending);
+		}
+	}
+
+	// Letter gaps are 3 dits and word gaps 7, split half way from the next shorter
+	if( !key && committed ) {
+		if( !char_sent && (run >= 2 * dit) ) {
+			const auto character = flush();
+			char_sent = (code_length == 0);
+			return character;
+		}
+		if( !word_sent && (run >= 5 * dit) ) {
+			word_sent = true;
+			return ' ';
+		}
+	}
+	return 0;
+}
+
+bool CWDecoder::slice(const float magnitude) {
+	// Plain average of the first blocks, nothing to compare the tone to yet
+	if( seed_count < seed_blocks ) {
+		seed_count++;
+		noise_level += (magnitude - noise_level) / seed_count;
+		noise_spread += (std::abs(magnitude - noise_level) - noise_spread) / seed_count;
+		signal_level = noise_level;
+		return false;
+	}
+
+	// The signal level jumps up to each element and sags slowly, so it
+	// survives word gaps. The noise level and its spread are averaged from
+	// blocks well clear of the tone, the edges of elements would lift them.
+	// While keyed the noise barely moves, so it survives long dahs.
+	if( magnitude > signal_level ) {
+		signal_level += (magnitude - signal_level) * 0.5f;
+	} else {
+		signal_level += (magnitude - signal_level) * 0.005f;
+	}
+	const float gate = noise_spread * gate_spreads;
+	if( key ) {
+		noise_level += (magnitude - noise_level) * 0.0005f;
+	} else if( magnitude < noise_level + gate ) {
+		noise_level += (magnitude - noise_level) * 0.05f;
+		noise_spread += (std::abs(magnitude - noise_level) - noise_spread) * 0.05f;
+	}
+
+	// Nothing keyed until the tone stands out of the noise
+	if( signal_level < noise_level + gate ) {
+		return false;
+	}
+
+	// Half way between noise and tone, never close enough to the noise for
+	// its peaks to key
+	const float span = signal_level - noise_level;
+	const float threshold = key
+		? noise_level + std::max(span * 0.4f, gate * 0.5f)
+		: noise_level + std::max(span * 0.6f, gate);
+	return magnitude > threshold;
+}
+
+void CWDecoder::on_mark(const size_t length) {
+	if( code_length < code_max ) {
+		marks[code_length] = std::min<size_t>(length, UINT16_MAX);
+	}
+	code_length++;
+	char_sent = false;
+	word_sent = false;
+
+	if( acquired < acquire_elements ) {
+		acquire(length);
+		last_mark = length;
+		return;
+	}
+
+	// A mark 2-5x the previous one is a dah after a dit, and the other way
+	// round. That holds whatever the current estimate, so it pulls the speed
+	// in quickly when the operator changes.
+	if( (length > 2 * last_mark) && (length < 5 * last_mark) ) {
+		learn(length / 3.0f, 0.5f);
+		learn(last_mark, 0.5f);
+	} else if( (2 * length < last_mark) && (5 * length > last_mark) ) {
+		learn(length, 0.5f);
+		learn(last_mark / 3.0f, 0.5f);
+	}
+	last_mark = length;
+
+	// A held key (tuning up, a long dash) says nothing about the speed
+	if( length < 7 * dit ) {
+		learn((length >= 2 * dit) ? (length / 3.0f) : length, 0.25f);
+	}
+}
+
+void CWDecoder::on_space(const size_t length) {
+	if( (code_length > 0) && (code_length < code_max) ) {
+		gaps[code_length] = std::min<size_t>(length, UINT16_MAX);
+	}
+
+	// The silence before the first mark says nothing
+	if( acquired == 0 ) {
+		return;
+	}
+	if( acquired < acquire_elements ) {
+		acquire(length);
+		return;
+	}
+
+	// Only gaps inside a character are one dit, the others are judged live
+	if( length < 2 * dit ) {
+		learn(length, 0.25f);
+	}
+}
+
+void CWDecoder::acquire(const float length) {
+	// Any character with two elements has a one dit gap, and gaps between
+	// characters are longer, so the shortest element seen is the dit
+	if( acquired == 0 ) {
+		dit = dit_max;
+	}
+	acquired++;
+	dit = std::min(std::max(std::min(dit, length), dit_min), dit_max);
+}
+
+void CWDecoder::learn(const float length, const float weight) {
+	dit = std::min(std::max(dit + (length - dit) * weight, dit_min), dit_max);
+}
+
+char CWDecoder::flush() {
+	if( code_length == 0 ) {
+		return 0;
+	}
+
+	// Told apart with the speed as known now, which may have been learnt
+	// from the end of the character. A gap that turns out to be between
+	// characters splits off the first one, the rest goes out next block.
+	const auto stored = std::min(code_length, code_max);
+	size_t length = stored;
+	for(size_t i=1; i<stored; i++) {
+		if( gaps[i] >= 2 * dit ) {
+			length = i;
+			break;
+		}
+	}
+
+	if( length == stored ) {
+		const auto character = (code_length <= code_max) ? lookup(length) : '*';
+		code_length = 0;
+		return character;
+	}
+
+	const auto character = lookup(length);
+	for(size_t i=length; i<stored; i++) {
+		marks[i - length] = marks[i];
+		gaps[i - length] = gaps[i];
+	}
+	// Elements past the stored ones were lost, the rest still can't be read
+	code_length = (code_length > code_max)
+		? std::max(code_length - length, code_max + 1)
+		: code_length - length;
+	return character;
+}
+
+char CWDecoder::lookup(const size_t length) const {
+	uint16_t pattern = 0;
+	for(size_t i=0; i<length; i++) {
+		if( marks[i] >= 2 * dit ) {
+			pattern |= 0x8000 >> i;
+		}
+	}
+
+	// Table entries are the elements MSB first (1 = dah), size in the low bits
+	const uint16_t mask = 0xffff << (16 - length);
+	for(size_t i=0; i<std::size(morse::morse_ITU); i++) {
+		const auto entry = morse::morse_ITU[i];
+		if( entry && ((entry & 7) == length) && ((entry & mask) == pattern) ) {
+			return '!' + i;
+		}
+	}
+	return '*';
+}
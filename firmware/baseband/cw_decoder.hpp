@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __CW_DECODER_H__
+#define __CW_DECODER_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Morse receiver working on demodulated SSB audio. A Goertzel filter at the
+ * pitch gives the tone envelope every 4 ms, which is sliced against levels
+ * tracking the keyed signal and the noise between elements. Nothing keys
+ * until the noise has been measured, and the tone must then stand out of the
+ * noise by a few times its own spread. The dit length follows the operator,
+ * taken from the shortest of the first elements and then learnt from both
+ * dits/dahs and the gaps inside characters, so no speed needs to be set.
+ */
+class CWDecoder {
+public:
+	void configure(const CWRxConfigureMessage& message, const uint32_t sampling_rate);
+
+	/* Calls handler with a CWRxMessage for every character, and with a status
+	 * update about four times a second.
+	 */
+	template<typename MessageHandler>
+	void execute(const buffer_f32_t& src, MessageHandler handler) {
+		if( !enabled ) {
+			return;
+		}
+		for(size_t i=0; i<src.count; i++) {
+			const float s0 = src.p[i] + coefficient * s1 - s2;
+			s2 = s1;
+			s1 = s0;
+			if( ++block_count >= block_samples ) {
+				const auto character = on_block();
+				if( character ) {
+					handler(CWRxMessage { character, wpm(), key });
+				}
+				if( ++status_count >= status_blocks ) {
+					status_count = 0;
+					handler(CWRxMessage { 0, wpm(), key });
+				}
+			}
+		}
+	}
+
+private:
+	static constexpr uint32_t block_ms = 4;
+	static constexpr size_t status_blocks = 256 / block_ms;
+	// 5 to 40 WPM (PARIS timing, dit = 1200 ms / WPM), with some margin
+	static constexpr float dit_min = 25.0f / block_ms;
+	static constexpr float dit_max = 300.0f / block_ms;
+	static constexpr size_t code_max = 7;
+	// Noise measured before anything may key
+	static constexpr size_t seed_blocks = 64;
+	// Key down above the noise by this many spreads, and up again below half of it
+	static constexpr float gate_spreads = 4.0f;
+	// Elements timed before the speed is only tracked
+	static constexpr size_t acquire_elements = 8;
+
+	bool enabled { false };
+	size_t block_samples { 48 };
+	float coefficient { 0 };
+	float s1 { 0 };
+	float s2 { 0 };
+	size_t block_count { 0 };
+	size_t status_count { 0 };
+
+	// Envelope slicer
+	float signal_level { 0 };
+	float noise_level { 0 };
+	float noise_spread { 0 };
+	size_t seed_count { 0 };
+	bool key { false };
+
+	// Runs of key down/up, in blocks. A run is only acted on once the one
+	// after it is longer than a glitch, shorter ones are merged back.
+	size_t run { 0 };
+	size_t pending { 0 };
+	bool committed { true };
+	bool char_sent { true };
+	bool word_sent { true };
+
+	float dit { 60.0f / block_ms };		// 20 WPM until the first elements
+	size_t acquired { 0 };
+	size_t last_mark { 0 };
+	// Marks of the current character and the gaps before them, only told
+	// apart when it ends
+	std::array<uint16_t, code_max> marks { };
+	std::array<uint16_t, code_max> gaps { };
+	size_t code_length { 0 };
+
+	char on_block();
+	bool slice(const float magnitude);
+	void on_mark(const size_t length);
+	void on_space(const size_t length);
+	void acquire(const float length);
+	void learn(const float length, const float weight);
+	char flush();
+	char lookup(const size_t length) const;
+
+	uint8_t wpm() const {
+		return static_cast<uint8_t>(1200.0f / (dit * block_ms) + 0.5f);
+	}
+};
+
+#endif/*__CW_DECODER_H__*/
@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dcs_decoder.hpp"
+
+#include "complex.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+
+void DCSDecoder::configure(const DCSConfigureMessage& message, const uint32_t sampling_rate) {
+	gate = message.gate;
+
+	const auto word = dcs::codeword(message.code) ^ (message.inverted ? dcs::word_mask : 0);
+	for(size_t i=0; i<target_rotations.size(); i++) {
+		target_rotations[i] = dcs::rotate(word, i);
+	}
+	for(size_t i=0; i<error_syndromes.size(); i++) {
+		error_syndromes[i] = dcs::syndrome(1UL << i);
+	}
+
+	// ~200 Hz low-pass leaves the NRZ shape, the mean over ~250 ms is the slicer level
+	lpf_alpha = 1.0f - std::exp(-2.0f * pi * 200.0f / sampling_rate);
+	dc_alpha = 4.0f / sampling_rate;
+	phase_inc = (uint64_t(dcs::bit_rate_x10) << 32) / (uint64_t(sampling_rate) * 10);
+	half_bit_samples = (sampling_rate * 10) / (dcs::bit_rate_x10 * 2);
+
+	shift = 0;
+	bit_count = 0;
+	target_run = 0;
+	gate_hold = 0;
+	half_bit_edges = 0;
+	candidates.fill({ 0, false, 0 });
+	reported_code = 0;
+	reported_gate = !gate;
+	configured = true;
+}
+
+bool DCSDecoder::on_sample(const float sample) {
+	lpf += (sample - lpf) * lpf_alpha;
+	dc += (lpf - dc) * dc_alpha;
+
+	// Crossings closer than a quarter bit are ripple around the slicing level
+	samples_since_edge++;
+	const bool new_level = (lpf > dc);
+	if( (new_level != level) && (samples_since_edge > half_bit_samples / 2) ) {
+		level = new_level;
+		on_edge();
+	}
+
+	// Bits are sampled half way between the edges the clock locks to
+	const uint32_t prev_phase = phase;
+	phase += phase_inc;
+	if( (prev_phase < 0x80000000U) && (phase >= 0x80000000U) ) {
+		return on_bit(level);
+	}
+	return false;
+}
+
+void DCSDecoder::on_edge() {
+	const auto d = samples_since_edge;
+	samples_since_edge = 0;
+
+	// Phase wraps at the bit boundary, pull it towards the edge
+	phase -= static_cast<int32_t>(phase) / 8;
+
+	if( (d > half_bit_samples * 3 / 4) && (d < half_bit_samples * 5 / 4) ) {
+		// Data never has edges half a bit apart, the turn-off tone does
+		if( ++half_bit_edges >= turn_off_edges ) {
+			gate_hold = 0;
+		}
+	} else {
+		half_bit_edges = 0;
+	}
+}
+
+bool DCSDecoder::on_bit(const bool bit) {
+	// LSB first: the oldest bit ends up at bit 0
+	shift = ((shift >> 1) | (bit ? (1UL << (dcs::word_bits - 1)) : 0)) & dcs::word_mask;
+	bit_count++;
+
+	if( gate_hold > 0 ) {
+		gate_hold--;
+	}
+
+	if( gate && (half_bit_edges < turn_off_edges) ) {
+		const bool match = std::any_of(target_rotations.begin(), target_rotations.end(),
+			[this](const uint32_t rotation) {
+				return __builtin_popcountl(shift ^ rotation) <= 2;
+			}
+		);
+		// Every window of a repeated codeword is one of its rotations. Open after
+		// a whole word of matching windows, then stay open on any match.
+		target_run = match ? (target_run + 1) : 0;
+		if( (match && (gate_hold > 0)) || (target_run >= dcs::word_bits) ) {
+			gate_hold = gate_hold_words * dcs::word_bits;
+		}
+	}
+
+	decode(shift, false);
+	decode(shift ^ dcs::word_mask, true);
+
+	return (bit_count % (report_words * dcs::word_bits)) == 0;
+}
+
+void DCSDecoder::decode(uint32_t word, const bool inverted) {
+	const auto s = dcs::syndrome(word);
+	if( s != 0 ) {
+		const auto error = std::find(error_syndromes.begin(), error_syndromes.end(), s);
+		if( error == error_syndromes.end() ) {
+			return;
+		}
+		word ^= 1UL << std::distance(error_syndromes.begin(), error);
+	}
+
+	// Other rotations are codewords too, only the one starting on the marker counts
+	if( (word & dcs::marker_mask) != dcs::marker ) {
+		return;
+	}
+	const uint16_t code = word & dcs::code_mask;
+	if( dcs::is_standard(code) ) {
+		tally(code, inverted);
+	}
+}
+
+void DCSDecoder::tally(const uint16_t code, const bool inverted) {
+	Candidate* weakest = &candidates[0];
+	for(auto& c : candidates) {
+		if( (c.hits > 0) && (c.code == code) && (c.inverted == inverted) ) {
+			c.hits++;
+			return;
+		}
+		if( c.hits < weakest->hits ) {
+			weakest = &c;
+		}
+	}
+	if( weakest->hits <= 1 ) {
+		*weakest = { code, inverted, 1 };
+	}
+}
+
+DCSMessage DCSDecoder::report() {
+	// Aliases (other standard codes in a rotation of the word, like 023N and
+	// 047I) tie. Report the normal polarity one, then the lowest code.
+	const auto better = [](const Candidate& a, const Candidate& b) {
+		if( a.hits != b.hits ) {
+			return a.hits > b.hits;
+		}
+		if( a.inverted != b.inverted ) {
+			return !a.inverted;
+		}
+		return a.code < b.code;
+	};
+	const Candidate* best = nullptr;
+	for(const auto& c : candidates) {
+		if( (c.hits > 0) && (!best || better(c, *best)) ) {
+			best = &c;
+		}
+	}
+
+	DCSMessage message { 0, false, 0, audio_enabled() };
+	if( best ) {
+		message.code = best->code;
+		message.inverted = best->inverted;
+		message.confidence = std::min<size_t>(100, best->hits * 100 / report_words);
+	}
+	candidates.fill({ 0, false, 0 });
+
+	reported_code = message.code;
+	reported_gate = message.gate_open;
+	return message;
+}
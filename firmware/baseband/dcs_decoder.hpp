@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DCS_DECODER_H__
+#define __DCS_DECODER_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+#include "dcs_codes.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* DCS receiver working on the sub-audio band of the FM demodulator output.
+ * Every bit, the last 23 bits are syndrome-decoded (both polarities, one bit
+ * of error correction) to find whatever code is on the air, and correlated
+ * against the 23 rotations of the selected code to drive the audio gate.
+ */
+class DCSDecoder {
+public:
+	void configure(const DCSConfigureMessage& message, const uint32_t sampling_rate);
+
+	/* Calls handler with a DCSMessage about every four words */
+	template<typename ReportHandler>
+	void execute(const buffer_f32_t& src, ReportHandler handler) {
+		if( !configured ) {
+			return;
+		}
+		for(size_t i=0; i<src.count; i++) {
+			if( on_sample(src.p[i]) ) {
+				const auto previous_code = reported_code;
+				const auto previous_gate = reported_gate;
+				const auto message = report();
+				// Nothing to say while there's no DCS and the gate stays put
+				if( message.code || previous_code || (message.gate_open != previous_gate) ) {
+					handler(message);
+				}
+			}
+		}
+	}
+
+	/* False while gating on a code that isn't being received */
+	bool audio_enabled() const {
+		return !gate || (gate_hold > 0);
+	}
+
+private:
+	static constexpr size_t report_words = 4;
+	static constexpr size_t candidates_max = 4;
+	// Words the gate stays open after the last match, bridges short fades
+	static constexpr size_t gate_hold_words = 3;
+	// Half-bit edges in a row taken as the 134.4 Hz turn-off tone (~90 ms)
+	static constexpr size_t turn_off_edges = 24;
+
+	struct Candidate {
+		uint16_t code;
+		bool inverted;
+		uint8_t hits;
+	};
+
+	bool configured { false };
+	bool gate { false };
+	std::array<uint32_t, dcs::word_bits> target_rotations { };
+	std::array<uint16_t, dcs::word_bits> error_syndromes { };
+
+	// Slicer and bit clock
+	float lpf_alpha { 0 };
+	float dc_alpha { 0 };
+	float lpf { 0 };
+	float dc { 0 };
+	bool level { false };
+	uint32_t phase { 0 };
+	uint32_t phase_inc { 0 };
+	uint32_t half_bit_samples { 0 };
+	uint32_t samples_since_edge { 0 };
+	size_t half_bit_edges { 0 };
+
+	uint32_t shift { 0 };
+	size_t bit_count { 0 };
+	size_t target_run { 0 };
+	size_t gate_hold { 0 };
+
+	std::array<Candidate, candidates_max> candidates { };
+	uint16_t reported_code { 0 };
+	bool reported_gate { true };
+
+	bool on_sample(const float sample);
+	void on_edge();
+	bool on_bit(const bool bit);
+	void decode(uint32_t word, const bool inverted);
+	void tally(const uint16_t code, const bool inverted);
+	DCSMessage report();
+};
+
+#endif/*__DCS_DECODER_H__*/
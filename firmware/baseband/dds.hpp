@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DDS_H__
+#define __DDS_H__
+
+#include "sine_table.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace dds {
+
+constexpr size_t sine_table_q15_size = sine_table_f32_period + 1;
+
+constexpr std::array<int16_t, sine_table_q15_size> make_sine_table_q15() {
+	std::array<int16_t, sine_table_q15_size> table { };
+	for(size_t i=0; i<table.size(); i++) {
+		const float v = sine_table_f32[i] * 32767.0f;
+		table[i] = static_cast<int16_t>((v >= 0) ? (v + 0.5f) : (v - 0.5f));
+	}
+	return table;
+}
+
+constexpr auto sine_table_q15 = make_sine_table_q15();
+
+/* Q15 sine of a 32-bit phase. The top 8 bits index the table and the next 16
+ * interpolate linearly, which puts phase truncation spurs around -80dBc,
+ * below what the 8-bit DAC can resolve.
+ */
+inline int32_t sine_q15(const uint32_t phase) {
+	const uint32_t index = phase >> 24;
+	const int32_t frac = (phase >> 8) & 0xffff;
+	const int32_t p0 = sine_table_q15[index];
+	const int32_t p1 = sine_table_q15[index + 1];
+	return p0 + (((p1 - p0) * frac) >> 16);
+}
+
+inline int32_t cosine_q15(const uint32_t phase) {
+	return sine_q15(phase + 0x40000000);
+}
+
+/* Marsaglia xorshift32, never returns 0 if not seeded with 0 */
+class Random {
+public:
+	constexpr Random(const uint32_t seed) : state { seed ? seed : 0x54df0119 } { }
+
+	uint32_t operator()() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	/* Approximately Gaussian (Irwin-Hall, sum of 4 uniforms). Zero mean,
+	 * standard deviation gaussian_sigma, bounded to +/-3.46 sigma.
+	 */
+	int32_t gaussian() {
+		const uint32_t a = (*this)();
+		const uint32_t b = (*this)();
+		return	static_cast<int16_t>(a) + static_cast<int16_t>(a >> 16) +
+				static_cast<int16_t>(b) + static_cast<int16_t>(b >> 16);
+	}
+
+	static constexpr float gaussian_sigma = 37837.2f;	// 2 * 65536 / sqrt(12)
+	static constexpr float gaussian_peak = 3.464f;		// In sigmas
+
+private:
+	uint32_t state;
+};
+
+} /* namespace dds */
+
+#endif/*__DDS_H__*/
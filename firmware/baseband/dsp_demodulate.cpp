@@ -27,6 +27,8 @@
 
 #include <hal.h>
 
+#include <array>
+
 namespace dsp {
 namespace demodulate {
 
@@ -84,11 +86,124 @@ static inline float angle_precise(const complex32_t t) {
 	return atan2f(t.imag(), t.real());
 }
 
-buffer_f32_t FM::execute(
+/* atan(i / 128) for i = 0..128 in 1/262144ths of a turn. Last entry repeated so
+ * the interpolation never reads past the end.
+ */
+static constexpr std::array<uint16_t, 130> atan_table { {
+	    0,   326,   652,   978,  1303,  1629,  1954,  2279,  2604,  2929,  3253,  3577,
+	 3900,  4223,  4545,  4867,  5188,  5509,  5829,  6148,  6467,  6784,  7101,  7418,
+	 7733,  8047,  8361,  8673,  8985,  9296,  9605,  9914, 10221, 10527, 10832, 11136,
+	11439, 11740, 12040, 12339, 12637, 12933, 13228, 13522, 13814, 14105, 14394, 14682,
+	14968, 15253, 15537, 15819, 16100, 16379, 16656, 16932, 17206, 17479, 17750, 18020,
+	18288, 18554, 18819, 19083, 19344, 19604, 19862, 20119, 20374, 20627, 20879, 21129,
+	21378, 21624, 21870, 22113, 22355, 22595, 22834, 23070, 23306, 23539, 23771, 24001,
+	24230, 24457, 24682, 24906, 25128, 25349, 25568, 25785, 26001, 26215, 26427, 26638,
+	26848, 27056, 27262, 27467, 27670, 27871, 28072, 28270, 28467, 28663, 28857, 29050,
+	29241, 29430, 29619, 29805, 29991, 30175, 30357, 30538, 30718, 30896, 31073, 31248,
+	31423, 31595, 31767, 31937, 32106, 32273, 32439, 32604, 32768, 32768,
+} };
+
+/* Four quadrant arctangent in 1/262144ths of a turn: octant folding, one
+ * integer divide and a linearly interpolated table lookup.
+ */
+static inline int32_t angle_table(const complex32_t t) {
+	const int32_t x = t.real();
+	const int32_t y = t.imag();
+	const uint32_t ax = (x < 0) ? (0U - static_cast<uint32_t>(x)) : x;
+	const uint32_t ay = (y < 0) ? (0U - static_cast<uint32_t>(y)) : y;
+	const bool swap = (ay > ax);
+	uint32_t num = swap ? ax : ay;
+	uint32_t den = swap ? ay : ax;
+	if( den == 0 ) {
+		return 0;
+	}
+
+	// Keep num << 16 inside 32 bits
+	const uint32_t lz = __CLZ(den);
+	if( lz < 17 ) {
+		num >>= (17 - lz);
+		den >>= (17 - lz);
+	}
+	const uint32_t r = (num << 16) / den;
+	const uint32_t i = r >> 9;
+	const int32_t t0 = atan_table[i];
+	const int32_t t1 = atan_table[i + 1];
+	int32_t a = t0 + (((t1 - t0) * static_cast<int32_t>(r & 511)) >> 9);
+
+	if( swap ) {
+		a = 65536 - a;
+	}
+	if( x < 0 ) {
+		a = 131072 - a;
+	}
+	return (y < 0) ? -a : a;
+}
+
+/* fxpt_atan2() wants 16 bit inputs, it returns 1/65536ths of a turn. */
+static inline int32_t angle_polynomial(const complex32_t t) {
+	const int32_t x = t.real();
+	const int32_t y = t.imag();
+	const uint32_t ax = (x < 0) ? (0U - static_cast<uint32_t>(x)) : x;
+	const uint32_t ay = (y < 0) ? (0U - static_cast<uint32_t>(y)) : y;
+	const uint32_t m = ax | ay;
+	const uint32_t lz = __CLZ(m);
+	const uint32_t shift = (lz < 17) ? (17 - lz) : 0;
+	return static_cast<int16_t>(fxpt_atan2(y >> shift, x >> shift));
+}
+
+/* Im(s1 * conj(s0)) = |s0| |s1| sin(delta theta), normalized by the mean power
+ * of the two samples. The +1 keeps silence from dividing by zero.
+ */
+static inline float angle_cross_product(const complex32_t t, const uint32_t s0, const uint32_t s1) {
+	const float power = static_cast<float>(__SMUAD(s0, s0)) + static_cast<float>(__SMUAD(s1, s1));
+	return static_cast<float>(t.imag()) * 2.0f / (power + 1.0f);
+}
+
+/* Each Angle returns delta theta in its own units, radians_per_unit scales it to
+ * radians.
+ */
+struct AnglePrecise {
+	static constexpr float radians_per_unit = 1.0f;
+	static float execute(const complex32_t t, const uint32_t, const uint32_t) {
+		return angle_precise(t);
+	}
+};
+
+struct AngleRational {
+	static constexpr float radians_per_unit = 1.0f;
+	static float execute(const complex32_t t, const uint32_t, const uint32_t) {
+		return angle_approx_0deg27(t);
+	}
+};
+
+struct AngleTable {
+	static constexpr float radians_per_unit = 2.0f * pi / 262144.0f;
+	static float execute(const complex32_t t, const uint32_t, const uint32_t) {
+		return angle_table(t);
+	}
+};
+
+struct AnglePolynomial {
+	static constexpr float radians_per_unit = 2.0f * pi / 65536.0f;
+	static float execute(const complex32_t t, const uint32_t, const uint32_t) {
+		return angle_polynomial(t);
+	}
+};
+
+struct AngleCrossProduct {
+	static constexpr float radians_per_unit = 1.0f;
+	static float execute(const complex32_t t, const uint32_t s0, const uint32_t s1) {
+		return angle_cross_product(t, s0, s1);
+	}
+};
+
+template<typename Angle>
+buffer_f32_t FM::execute_f32(
 	const buffer_c16_t& src,
 	const buffer_f32_t& dst
 ) {
 	auto z = z_;
+	const float k = kf * Angle::radians_per_unit;
 
 	const void* src_p = src.p;
 	const auto src_end = &src.p[src.count];
@@ -98,20 +213,22 @@ buffer_f32_t FM::execute(
 		const auto s1 = *__SIMD32(src_p)++;
 		const auto t0 = multiply_conjugate_s16_s32(s0, z);
 		const auto t1 = multiply_conjugate_s16_s32(s1, s0);
+		*(dst_p++) = Angle::execute(t0, z, s0) * k;
+		*(dst_p++) = Angle::execute(t1, s0, s1) * k;
 		z = s1;
-		*(dst_p++) = angle_precise(t0) * kf;
-		*(dst_p++) = angle_precise(t1) * kf;
 	}
 	z_ = z;
 
 	return { dst.p, src.count, src.sampling_rate };
 }
 
-buffer_s16_t FM::execute(
+template<typename Angle>
+buffer_s16_t FM::execute_s16(
 	const buffer_c16_t& src,
 	const buffer_s16_t& dst
 ) {
 	auto z = z_;
+	const float k = ks16 * Angle::radians_per_unit;
 
 	const void* src_p = src.p;
 	const auto src_end = &src.p[src.count];
@@ -121,23 +238,53 @@ buffer_s16_t FM::execute(
 		const auto s1 = *__SIMD32(src_p)++;
 		const auto t0 = multiply_conjugate_s16_s32(s0, z);
 		const auto t1 = multiply_conjugate_s16_s32(s1, s0);
-		z = s1;
-		const int32_t theta0_int = angle_approx_0deg27(t0) * ks16;
+		const int32_t theta0_int = Angle::execute(t0, z, s0) * k;
 		const int32_t theta0_sat = __SSAT(theta0_int, 16);
-		const int32_t theta1_int = angle_approx_0deg27(t1) * ks16;
+		const int32_t theta1_int = Angle::execute(t1, s0, s1) * k;
 		const int32_t theta1_sat = __SSAT(theta1_int, 16);
 		*__SIMD32(dst_p)++ = __PKHBT(
 			theta0_sat,
 			theta1_sat,
 			16
 		);
+		z = s1;
 	}
 	z_ = z;
 
 	return { dst.p, src.count, src.sampling_rate };
 }
 
-void FM::configure(const float sampling_rate, const float deviation_hz) {
+buffer_f32_t FM::execute(
+	const buffer_c16_t& src,
+	const buffer_f32_t& dst
+) {
+	switch(discriminator_) {
+	case Discriminator::Precise:		return execute_f32<AnglePrecise>(src, dst);
+	case Discriminator::Rational:		return execute_f32<AngleRational>(src, dst);
+	case Discriminator::Polynomial:		return execute_f32<AnglePolynomial>(src, dst);
+	case Discriminator::CrossProduct:	return execute_f32<AngleCrossProduct>(src, dst);
+	default:							return execute_f32<AngleTable>(src, dst);
+	}
+}
+
+buffer_s16_t FM::execute(
+	const buffer_c16_t& src,
+	const buffer_s16_t& dst
+) {
+	switch(discriminator_) {
+	case Discriminator::Precise:		return execute_s16<AnglePrecise>(src, dst);
+	case Discriminator::Rational:		return execute_s16<AngleRational>(src, dst);
+	case Discriminator::Polynomial:		return execute_s16<AnglePolynomial>(src, dst);
+	case Discriminator::CrossProduct:	return execute_s16<AngleCrossProduct>(src, dst);
+	default:							return execute_s16<AngleTable>(src, dst);
+	}
+}
+
+void FM::configure(
+	const float sampling_rate,
+	const float deviation_hz,
+	const Discriminator discriminator
+) {
 	/*
 	 * angle: -pi to pi. output range: -32768 to 32767.
 	 * Maximum delta-theta (output of atan2) at maximum deviation frequency:
@@ -145,6 +292,7 @@ void FM::configure(const float sampling_rate, const float deviation_hz) {
 	 */
 	kf = static_cast<float>(1.0f / (2.0 * pi * deviation_hz / sampling_rate));
 	ks16 = 32767.0f * kf;
+	discriminator_ = discriminator;
 }
 
 }
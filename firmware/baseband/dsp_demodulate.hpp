@@ -49,6 +49,27 @@ private:
 	static constexpr float k = 1.0f / 32768.0f;
 };
 
+/* Phase discriminators for FM. SINAD of the s16 output for a 1kHz tone at
+ * full deviation from a -6dBFS carrier, cost relative to Precise (host build):
+ *
+ *                WFM 75k@384k   NFM 5k@24k   cost
+ * Precise           89dB           93dB      1.0   atan2f()
+ * Rational          18dB           14dB      0.2   x/(1+0.28x^2), only holds to +-45 degrees
+ * Table             86dB           94dB      0.5   one integer divide, 129 entry LUT
+ * Polynomial        52dB           53dB      0.6   fxpt_atan2()
+ * CrossProduct      23dB           22dB      0.15  sin(delta theta), no arctangent
+ *
+ * CrossProduct is only linear while the phase step per sample is small (35dB
+ * at 2.5k@24k), it suits slicers that only look at the sign.
+ */
+enum class Discriminator : uint8_t {
+	Precise,
+	Rational,
+	Table,
+	Polynomial,
+	CrossProduct,
+};
+
 class FM {
 public:
 	buffer_f32_t execute(
@@ -61,12 +82,23 @@ public:
 		const buffer_s16_t& dst
 	);
 
-	void configure(const float sampling_rate, const float deviation_hz);
+	void configure(
+		const float sampling_rate,
+		const float deviation_hz,
+		const Discriminator discriminator = Discriminator::Table
+	);
 
 private:
 	complex16_t::rep_type z_ { 0 };
+	Discriminator discriminator_ { Discriminator::Table };
 	float kf { 0 };
 	float ks16 { 0 };
+
+	template<typename Angle>
+	buffer_f32_t execute_f32(const buffer_c16_t& src, const buffer_f32_t& dst);
+
+	template<typename Angle>
+	buffer_s16_t execute_s16(const buffer_c16_t& src, const buffer_s16_t& dst);
 };
 
 } /* namespace demodulate */
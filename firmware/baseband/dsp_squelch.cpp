@@ -21,27 +21,35 @@
 
 #include "dsp_squelch.hpp"
 
+#include "utility.hpp"
+
 #include <cstdint>
 #include <array>
+#include <cmath>
+#include <algorithm>
+#include <limits>
 
 bool FMSquelch::execute(const buffer_f32_t& audio) {
 	if( threshold_squared == 0.0f ) {
 		return true;
 	}
 
-	// TODO: No hard-coded array size.
+	// Filtered N samples at a time, blocks of any size fit the scratch buffer
 	std::array<float, N> squelch_energy_buffer;
-	const buffer_f32_t squelch_energy {
-		squelch_energy_buffer.data(),
-		squelch_energy_buffer.size()
-	};
-	non_audio_hpf.execute(audio, squelch_energy);
-
 	float non_audio_max_squared = 0;
-	for(const auto sample : squelch_energy_buffer) {
-		const float sample_squared = sample * sample;
-		if( sample_squared > non_audio_max_squared ) {
-			non_audio_max_squared = sample_squared;
+	for(size_t offset=0; offset<audio.count; offset+=N) {
+		const size_t count = std::min(N, audio.count - offset);
+		const buffer_f32_t squelch_energy {
+			squelch_energy_buffer.data(),
+			count
+		};
+		non_audio_hpf.execute(buffer_f32_t { &audio.p[offset], count, audio.sampling_rate }, squelch_energy);
+
+		for(size_t i=0; i<count; i++) {
+			const float sample_squared = squelch_energy_buffer[i] * squelch_energy_buffer[i];
+			if( sample_squared > non_audio_max_squared ) {
+				non_audio_max_squared = sample_squared;
+			}
 		}
 	}
 
@@ -51,3 +59,117 @@ bool FMSquelch::execute(const buffer_f32_t& audio) {
 void FMSquelch::set_threshold(const float new_value) {
 	threshold_squared = new_value * new_value;
 }
+
+void Squelch::configure(const SquelchConfigureMessage& message) {
+	open_db = message.open_db;
+	close_db = open_db - message.hysteresis_db;
+	attack_blocks = message.attack_ms / block_ms;
+	hang_blocks = message.hang_ms / block_ms;
+	reset();
+}
+
+void Squelch::set_sampling_rate(const uint32_t sampling_rate) {
+	this->sampling_rate = sampling_rate;
+	reset();
+}
+
+void Squelch::reset() {
+	block_samples = std::max<size_t>(sampling_rate * block_ms / 1000, 1);
+	block_count = 0;
+	block_power = 0;
+	block_power_squared = 0;
+	settle_count = 0;
+	windows_valid = 0;
+	window_index = 0;
+	window_count = 0;
+	window_min = std::numeric_limits<float>::max();
+	floor_valid = false;
+	snr_db = 0;
+	attack_count = 0;
+	hang_count = 0;
+	open = (open_db == 0);
+}
+
+void Squelch::track_floor() {
+	window_min = std::min(window_min, level);
+	if( ++window_count >= window_blocks ) {
+		minima[window_index] = window_min;
+		window_index = (window_index + 1) % windows;
+		windows_valid = std::min(windows_valid + 1, windows);
+		window_min = std::numeric_limits<float>::max();
+		window_count = 0;
+	}
+
+	if( windows_valid ) {
+		float minimum = window_min;
+		for(size_t i=0; i<windows_valid; i++) {
+			minimum = std::min(minimum, minima[i]);
+		}
+		floor = minimum * minimum_bias;
+		floor_valid = true;
+	}
+}
+
+void Squelch::estimate_floor() {
+	// For a carrier of power C in noise N, E[p^2] / E[p]^2 is 1 + 2u - u^2
+	// with u = N / (C + N): 1 for the carrier alone, 2 for noise alone. Only
+	// a channel of zeros has no square, it's taken as noise.
+	const float ratio = (level_squared > 0) ? (level_squared / (level * level)) : 2.0f;
+	const float u = 1.0f - std::sqrt(std::max(2.0f - ratio, 0.0f));
+	floor = level * std::max(u, 1e-6f);
+	floor_valid = true;
+}
+
+bool Squelch::on_block() {
+	// Well under the quantization noise, keeps the logs finite
+	constexpr float full_scale = 32768.0f * 32768.0f;
+	const float power = std::max(block_power / (block_samples * full_scale), 1e-12f);
+	const float power_squared = block_power_squared / (block_samples * full_scale * full_scale);
+	block_count = 0;
+	block_power = 0;
+	block_power_squared = 0;
+
+	// The first blocks after a reset still hold the filters' startup, don't
+	// let them into the minima
+	if( settle_count < settle_blocks ) {
+		settle_count++;
+		level = power;
+		level_squared = power_squared;
+		return false;
+	}
+	level += (power - level) * level_gain;
+	level_squared += (power_squared - level_squared) * level_gain;
+
+	if( kind == Kind::FM ) {
+		estimate_floor();
+	} else if( !open || (open_db == 0) ) {
+		track_floor();
+	}
+	if( !floor_valid ) {
+		return false;
+	}
+
+	floor_db = mag2_to_dbv_norm(floor);
+	snr_db = mag2_to_dbv_norm(level) - floor_db;
+
+	if( open_db == 0 ) {
+		return false;
+	}
+
+	if( !open ) {
+		attack_count = (snr_db >= open_db) ? (attack_count + 1) : 0;
+		if( attack_count > attack_blocks ) {
+			open = true;
+			hang_count = 0;
+			return true;
+		}
+	} else {
+		hang_count = (snr_db < close_db) ? (hang_count + 1) : 0;
+		if( hang_count > hang_blocks ) {
+			open = false;
+			attack_count = 0;
+			return true;
+		}
+	}
+	return false;
+}
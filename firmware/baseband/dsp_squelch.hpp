@@ -25,9 +25,11 @@
 #include "buffer.hpp"
 #include "dsp_iir.hpp"
 #include "dsp_iir_config.hpp"
+#include "message.hpp"
 
 #include <cstdint>
 #include <cstddef>
+#include <array>
 
 class FMSquelch {
 public:
@@ -42,4 +44,103 @@ private:
 	IIRBiquadFilter non_audio_hpf { non_audio_hpf_config };
 };
 
+/* Carrier squelch on channel SNR, the same for every analog demodulator.
+ *
+ * FM has a constant envelope, so the SNR comes straight from how much the
+ * channel power fluctuates: not at all for a clean carrier, as much as
+ * Gaussian noise for none (M2M4 estimate). That needs no history and opens on
+ * a carrier that was there before the reset.
+ *
+ * AM's envelope is the modulation, its SNR is the channel power against a
+ * noise floor. The floor is the minimum of the smoothed channel power over
+ * the last couple of seconds spent closed, and is frozen while open so a long
+ * transmission can't raise it and close itself. Until the first window of
+ * minima is in, there is no floor and the squelch stays closed.
+ *
+ * Squelch opens once the SNR stayed over the open threshold for the attack
+ * time, and closes once it stayed under the lower close threshold for the
+ * hang time.
+ */
+class Squelch {
+public:
+	enum class Kind {
+		AM,
+		FM,
+	};
+
+	Squelch(
+		const Kind kind = Kind::AM
+	) : kind { kind }
+	{
+	}
+
+	void configure(const SquelchConfigureMessage& message);
+	void set_sampling_rate(const uint32_t sampling_rate);
+
+	/* Calls handler with a SquelchEventMessage when the squelch opens or closes. */
+	template<typename EventHandler>
+	void execute(const buffer_c16_t& src, EventHandler handler) {
+		for(size_t i=0; i<src.count; i++) {
+			const int32_t re = src.p[i].real();
+			const int32_t im = src.p[i].imag();
+			const float power = float(re * re + im * im);
+			block_power += power;
+			block_power_squared += power * power;
+			if( ++block_count >= block_samples ) {
+				if( on_block() ) {
+					handler(SquelchEventMessage { open, int16_t(snr_db), int16_t(floor_db) });
+				}
+			}
+		}
+	}
+
+	bool is_open() const {
+		return open;
+	}
+
+private:
+	static constexpr uint32_t block_ms = 5;
+	static constexpr float level_gain = 0.25f;				// 20ms
+	static constexpr size_t settle_blocks = 8;				// Filters refilling after a reset
+	static constexpr size_t window_blocks = 100;			// 500ms
+	static constexpr size_t windows = 4;
+	// The minimum of the smoothed noise power sits about 1dB under its mean
+	static constexpr float minimum_bias = 1.25f;
+
+	float open_db { 0 };
+	float close_db { 0 };
+	size_t attack_blocks { 0 };
+	size_t hang_blocks { 0 };
+
+	const Kind kind;
+	uint32_t sampling_rate { 24000 };
+	size_t block_samples { 120 };
+	size_t block_count { 0 };
+	float block_power { 0 };
+	float block_power_squared { 0 };
+
+	size_t settle_count { 0 };
+	float level { 0 };
+	float level_squared { 0 };		// Smoothed square of the power, for FM
+
+	std::array<float, windows> minima { };
+	size_t windows_valid { 0 };
+	size_t window_index { 0 };
+	size_t window_count { 0 };
+	float window_min { 0 };
+
+	bool floor_valid { false };
+	float floor { 0 };
+	float snr_db { 0 };
+	float floor_db { 0 };
+	size_t attack_count { 0 };
+	size_t hang_count { 0 };
+	bool open { true };
+
+	void reset();
+	bool on_block();
+	void track_floor();
+	void estimate_floor();
+};
+
 #endif/*__DSP_SQUELCH_H__*/
@@ -86,6 +86,10 @@ void EventDispatcher::dispatch(const eventmask_t events) {
 	if( events & EVT_MASK_SPECTRUM ) {
 		handle_spectrum();
 	}
+
+	if( events & EVT_MASK_DEFERRED ) {
+		handle_deferred();
+	}
 }
 
 void EventDispatcher::handle_baseband_queue() {
@@ -120,3 +124,7 @@ void EventDispatcher::handle_spectrum() {
 	const UpdateSpectrumMessage message;
 	baseband_processor->on_message(&message);
 }
+
+void EventDispatcher::handle_deferred() {
+	baseband_processor->on_deferred();
+}
@@ -33,6 +33,7 @@
 
 constexpr auto EVT_MASK_BASEBAND = EVENT_MASK(0);
 constexpr auto EVT_MASK_SPECTRUM = EVENT_MASK(1);
+constexpr auto EVT_MASK_DEFERRED = EVENT_MASK(2);
 
 class EventDispatcher {
 public:
@@ -67,6 +68,7 @@ private:
 	void on_message_default(const Message* const message);
 
 	void handle_spectrum();
+	void handle_deferred();
 };
 
 #endif/*__EVENT_M4_H__*/
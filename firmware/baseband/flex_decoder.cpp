@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "flex_decoder.hpp"
+
+#include <cmath>
+
+/* Sync codes from multimon-ng and PDW. Each is sent as code, marker, ~code. */
+const std::array<FLEXDecoder::Mode, 5> FLEXDecoder::modes { {
+	{ 0x870C, 1600, 2 },		// 1600bps
+	{ 0xB068, 1600, 4 },		// 3200bps
+	{ 0x7B18, 3200, 2 },		// 3200bps
+	{ 0xDEA0, 3200, 4 },		// 6400bps
+	{ 0x4C7C, 3200, 4 },		// 6400bps
+} };
+
+void FLEXDecoder::reset() {
+	state = State::Sync1;
+	set_symbol_rate(sync_rate);
+	clock_phase = 0;
+	previous = 0;
+	dc = 0;
+	level = 0;
+	sync_bits = 0;
+	mode = nullptr;
+}
+
+bool FLEXDecoder::process(const float sample) {
+	const float x = sample - dc;
+
+	// Zero crossings should fall on a whole clock phase
+	if( (x >= 0) != (previous >= 0) ) {
+		const float fraction = previous / (previous - x);
+		float error = clock_phase - (1.0f - fraction) * clock_step;
+		error -= std::round(error);
+		clock_phase -= error * ((state == State::Sync1) ? clock_gain_acquire : clock_gain_track);
+	}
+	previous = x;
+
+	clock_phase += clock_step;
+
+	bool frame_done = false;
+	if( (clock_phase >= 0.5f) && !sampled ) {
+		sampled = true;
+		frame_done = on_symbol(x);
+	}
+	if( clock_phase >= 1.0f ) {
+		clock_phase -= 1.0f;
+		sampled = false;
+	}
+	return frame_done;
+}
+
+bool FLEXDecoder::on_symbol(const float value) {
+	switch(state) {
+	case State::Sync1:
+		// Bit sync is alternating outer symbols, good for both
+		dc += value * average_gain;
+		level += (std::fabs(value) - level) * average_gain;
+		on_sync_bit(value > 0);
+		break;
+
+	case State::FIW:
+		if( ++symbol_count > fiw_dotting ) {
+			const bool bit = (value > 0) != inverted;
+			fiw = (fiw >> 1) | (bit ? 0x80000000U : 0);
+		}
+		if( symbol_count == fiw_dotting + fiw_bits ) {
+			set_symbol_rate(mode->symbol_rate);
+			state = State::Sync2;
+			symbol_count = 0;
+			symbols_expected = mode->symbol_rate * sync2_ms / 1000;
+		}
+		break;
+
+	case State::Sync2:
+		if( ++symbol_count >= symbols_expected ) {
+			start_data();
+		}
+		break;
+
+	case State::Data:
+		add_data(value);
+		if( ++symbol_count >= symbols_expected ) {
+			set_symbol_rate(sync_rate);
+			state = State::Sync1;
+			sync_bits = 0;
+			return true;
+		}
+		break;
+
+	default:
+		break;
+	}
+	return false;
+}
+
+void FLEXDecoder::on_sync_bit(const bool bit) {
+	sync_bits = (sync_bits << 1) | (bit ? 1 : 0);
+
+	for(const auto& m : modes) {
+		const uint64_t expected = (uint64_t(m.code) << 48) | (sync_marker << 16) | uint16_t(~m.code);
+		const size_t errors = __builtin_popcountll(sync_bits ^ expected);
+		// Inverted if the receiver's spectrum is
+		if( (errors <= sync_errors_max) || (errors >= 64 - sync_errors_max) ) {
+			inverted = (errors > sync_errors_max);
+			mode = &m;
+			state = State::FIW;
+			symbol_count = 0;
+			fiw = 0;
+			return;
+		}
+	}
+}
+
+void FLEXDecoder::set_symbol_rate(const uint32_t rate) {
+	// The first symbol at the new rate starts where the current one ends,
+	// which may be more than a new symbol away
+	const float ratio = rate / (clock_step * sampling_rate);
+	clock_phase = -(1.0f - clock_phase) * ratio;
+	clock_step = float(rate) / sampling_rate;
+	sampled = false;
+}
+
+bool FLEXDecoder::phase_used(const flex::PhaseID id) const {
+	if( !mode ) {
+		return false;
+	}
+	const bool lsb_phase = (id == flex::PHASE_B) || (id == flex::PHASE_D);
+	const bool odd_phase = (id == flex::PHASE_C) || (id == flex::PHASE_D);
+	return (!lsb_phase || (mode->levels == 4)) && (!odd_phase || (mode->symbol_rate == 3200));
+}
+
+void FLEXDecoder::start_data() {
+	state = State::Data;
+	symbol_count = 0;
+	symbols_expected = mode->symbol_rate * data_ms / 1000;
+	bit_index = 0;
+	odd_symbol = false;
+
+	const auto now = Timestamp::now();
+	for(size_t i=0; i<phases.size(); i++) {
+		auto& phase = phases[i];
+		phase.timestamp = now;
+		phase.fiw = fiw;
+		phase.symbol_rate = mode->symbol_rate;
+		phase.levels = mode->levels;
+		phase.id = static_cast<flex::PhaseID>(i);
+		phase.words.fill(0);
+	}
+}
+
+void FLEXDecoder::add_data(const float value) {
+	// Gray coded: the MSB is the sign, the LSB is set on the inner levels
+	const bool msb = (value > 0) != inverted;
+	const bool lsb = std::fabs(value) < level * inner_threshold;
+
+	// Bit n of each of the 8 codewords of a block is sent in a row
+	const size_t index = ((bit_index >> 8) << 3) | (bit_index & 7);
+	const size_t group = odd_symbol ? flex::PHASE_C : flex::PHASE_A;
+
+	auto& word_msb = phases[group].words[index];
+	word_msb = (word_msb >> 1) | (msb ? 0x80000000U : 0);
+	if( mode->levels == 4 ) {
+		auto& word_lsb = phases[group + 1].words[index];
+		word_lsb = (word_lsb >> 1) | (lsb ? 0x80000000U : 0);
+	}
+
+	if( mode->symbol_rate == 3200 ) {
+		odd_symbol = !odd_symbol;
+		if( !odd_symbol ) {
+			bit_index++;
+		}
+	} else {
+		bit_index++;
+	}
+}
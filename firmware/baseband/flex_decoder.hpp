@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __FLEX_DECODER_H__
+#define __FLEX_DECODER_H__
+
+#include "dsp_types.hpp"
+#include "flex_packet.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* FLEX frames from FM demodulated audio at 24kHz, up to error correction.
+ *
+ * Sync 1 and the frame information word are always 1600 baud 2-FSK, the sync
+ * code tells the rate (1600 or 3200 baud) and levels (2 or 4) of the rest.
+ * Symbols are sliced at the middle of a clock kept in step with the zero
+ * crossings, 4-FSK at 2/3 of the outer deviation learned during sync. Data
+ * bits are de-interleaved into up to four phases: the MSB of a symbol goes to
+ * A (or C), the LSB to B (or D), and at 3200 baud symbols alternate between
+ * A/B and C/D.
+ */
+class FLEXDecoder {
+public:
+	static constexpr uint32_t sampling_rate = 24000;
+
+	/* Calls handler with every phase of a frame, once it's complete. */
+	template<typename PhaseHandler>
+	void execute(const buffer_f32_t& src, PhaseHandler handler) {
+		for(size_t i=0; i<src.count; i++) {
+			if( process(src.p[i]) ) {
+				for(const auto& phase : phases) {
+					if( phase_used(phase.id) ) {
+						handler(phase);
+					}
+				}
+			}
+		}
+	}
+
+	void reset();
+
+private:
+	static constexpr uint32_t sync_rate = 1600;
+	static constexpr uint64_t sync_marker = 0xA6C6AAAA;
+	static constexpr size_t sync_errors_max = 2;
+	static constexpr size_t fiw_dotting = 16;
+	static constexpr size_t fiw_bits = 32;
+	static constexpr uint32_t sync2_ms = 25;
+	static constexpr uint32_t data_ms = 1760;
+	// Between the inner (1.6kHz) and outer (4.8kHz) deviation
+	static constexpr float inner_threshold = 2.0f / 3.0f;
+	static constexpr float clock_gain_acquire = 0.2f;
+	static constexpr float clock_gain_track = 0.05f;
+	static constexpr float average_gain = 1.0f / 32;
+
+	enum class State {
+		Sync1,
+		FIW,
+		Sync2,
+		Data,
+	};
+
+	struct Mode {
+		uint16_t code;
+		uint16_t symbol_rate;
+		uint8_t levels;
+	};
+
+	static const std::array<Mode, 5> modes;
+
+	State state { State::Sync1 };
+
+	// Symbol clock, in symbols. Sampled half way, wraps at the next symbol.
+	float clock_phase { 0 };
+	bool sampled { false };
+	float clock_step { float(sync_rate) / sampling_rate };
+	float previous { 0 };
+
+	float dc { 0 };
+	float level { 0 };			// Outer deviation, from the 2-FSK sync
+
+	uint64_t sync_bits { 0 };
+	bool inverted { false };
+	const Mode* mode { nullptr };
+	uint32_t fiw { 0 };
+	size_t symbol_count { 0 };
+	size_t symbols_expected { 0 };
+	size_t bit_index { 0 };
+	bool odd_symbol { false };
+
+	std::array<flex::Phase, 4> phases { };
+
+	bool process(const float sample);
+	bool phase_used(const flex::PhaseID id) const;
+	bool on_symbol(const float value);
+	void on_sync_bit(const bool bit);
+	void set_symbol_rate(const uint32_t rate);
+	void start_data();
+	void add_data(const float value);
+};
+
+#endif/*__FLEX_DECODER_H__*/
@@ -0,0 +1,477 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "graph_runtime.hpp"
+
+#include "dsp_decimate.hpp"
+#include "dsp_demodulate.hpp"
+#include "channel_stats_collector.hpp"
+#include "matched_filter.hpp"
+#include "clock_recovery.hpp"
+#include "symbol_coding.hpp"
+#include "packet_builder.hpp"
+#include "baseband_packet.hpp"
+
+#include "portapack_shared_memory.hpp"
+
+namespace baseband {
+namespace graph {
+
+namespace {
+
+template<typename T>
+Buffer make_buffer(const ::buffer_t<T>& buffer, const SampleType type) {
+	return { type, buffer.p, buffer.count, buffer.sampling_rate };
+}
+
+template<typename T>
+::buffer_t<T> dst_as(void* const dst, const size_t dst_bytes) {
+	return { reinterpret_cast<T*>(dst), dst_bytes / sizeof(T) };
+}
+
+/* Front end decimators ***************************************************/
+
+template<typename Decimator>
+class C8DecimatorStage : public Stage {
+public:
+	C8DecimatorStage(const fir_taps_real<24>& taps) {
+		decimator.configure(taps.taps, 33554432);
+	}
+
+	Buffer execute(const Buffer& src, void* const dst, const size_t dst_bytes) override {
+		const auto out = decimator.execute(src.as<complex8_t>(), dst_as<complex16_t>(dst, dst_bytes));
+		return make_buffer(out, SampleType::C16);
+	}
+
+private:
+	Decimator decimator { };
+};
+
+class Decim1By8Stage : public Stage {
+public:
+	Decim1By8Stage(const fir_taps_real<32>& taps) {
+		decimator.configure(taps.taps, 131072);
+	}
+
+	Buffer execute(const Buffer& src, void* const dst, const size_t dst_bytes) override {
+		const auto out = decimator.execute(src.as<complex16_t>(), dst_as<complex16_t>(dst, dst_bytes));
+		return make_buffer(out, SampleType::C16);
+	}
+
+private:
+	dsp::decimate::FIRC16xR16x32Decim8 decimator { };
+};
+
+class ChannelFilterStage : public Stage {
+public:
+	ChannelFilterStage(const fir_taps_real<32>& taps, const size_t decimation) {
+		filter.configure(taps.taps, decimation);
+	}
+
+	Buffer execute(const Buffer& src, void* const dst, const size_t dst_bytes) override {
+		const auto out = filter.execute(src.as<complex16_t>(), dst_as<complex16_t>(dst, dst_bytes));
+		return make_buffer(out, SampleType::C16);
+	}
+
+private:
+	dsp::decimate::FIRAndDecimateComplex filter { };
+};
+
+/* Taps *******************************************************************/
+
+class ChannelStatsStage : public Stage {
+public:
+	Buffer execute(const Buffer& src, void* const, const size_t) override {
+		channel_stats.feed(
+			src.as<complex16_t>(),
+			[](const ChannelStatistics& statistics) {
+				const ChannelStatisticsMessage channel_stats_message { statistics };
+				shared_memory.application_queue.push(channel_stats_message);
+			}
+		);
+		return src;
+	}
+
+private:
+	ChannelStatsCollector channel_stats { };
+};
+
+class ChannelSpectrumStage : public Stage {
+public:
+	ChannelSpectrumStage(
+		SpectrumCollector& collector,
+		const fir_taps_real<32>& channel_taps,
+		const uint32_t input_fs
+	) : collector(collector),
+		filter_low_f(channel_taps.low_frequency_normalized * input_fs),
+		filter_high_f(channel_taps.high_frequency_normalized * input_fs),
+		filter_transition(channel_taps.transition_normalized * input_fs)
+	{
+		collector.set_decimation_factor(1);
+	}
+
+	Buffer execute(const Buffer& src, void* const, const size_t) override {
+		collector.feed(src.as<complex16_t>(), filter_low_f, filter_high_f, filter_transition);
+		return src;
+	}
+
+private:
+	SpectrumCollector& collector;
+	const int32_t filter_low_f;
+	const int32_t filter_high_f;
+	const int32_t filter_transition;
+};
+
+class SquelchStage : public Stage {
+public:
+	SquelchStage(
+		Squelch& squelch,
+		AudioOutput& audio_output,
+		const uint32_t input_fs
+	) : squelch(squelch),
+		audio_output(audio_output)
+	{
+		squelch.set_sampling_rate(input_fs);
+	}
+
+	Buffer execute(const Buffer& src, void* const, const size_t) override {
+		squelch.execute(src.as<complex16_t>(), [](const SquelchEventMessage& message) {
+			shared_memory.application_queue.push(message);
+		});
+		audio_output.set_squelch_open(squelch.is_open());
+		return src;
+	}
+
+private:
+	Squelch& squelch;
+	AudioOutput& audio_output;
+};
+
+/* Demodulators ***********************************************************/
+
+class DemodFMStage : public Stage {
+public:
+	DemodFMStage(const uint32_t input_fs, const int32_t deviation) {
+		demod.configure(input_fs, deviation);
+	}
+
+	Buffer execute(const Buffer& src, void* const dst, const size_t dst_bytes) override {
+		const auto out = demod.execute(src.as<complex16_t>(), dst_as<int16_t>(dst, dst_bytes));
+		return make_buffer(out, SampleType::S16);
+	}
+
+private:
+	dsp::demodulate::FM demod { };
+};
+
+class DemodAMStage : public Stage {
+public:
+	Buffer execute(const Buffer& src, void* const dst, const size_t dst_bytes) override {
+		const auto out = demod.execute(src.as<complex16_t>(), dst_as<float>(dst, dst_bytes));
+		return make_buffer(out, SampleType::F32);
+	}
+
+private:
+	dsp::demodulate::AM demod { };
+};
+
+/* Symbol slicers *********************************************************/
+
+/* Matched filter taps one symbol long, tuned to the upper tone of a 2FSK
+ * signal with a modulation index of 0.5 (deviation = fs / (4 * samples per symbol)).
+ */
+class FSKTaps {
+public:
+	static constexpr size_t taps_max = 16;
+
+	FSKTaps(const size_t samples_per_symbol) : count { samples_per_symbol } {
+		const float phase_increment = 2.0f * pi / (4 * samples_per_symbol);
+		for(size_t i=0; i<count; i++) {
+			taps[i] = std::polar(1.0f / count, phase_increment * i);
+		}
+	}
+
+	const std::complex<float>* data() const {
+		return taps.data();
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+private:
+	std::array<std::complex<float>, taps_max> taps { };
+	const size_t count;
+};
+
+class SliceFSKStage : public Stage {
+public:
+	/* The matched filter decimates to two samples per symbol for the clock
+	 * recovery, so the input needs an even number of them.
+	 */
+	static bool fits(const uint32_t input_fs, const int32_t symbol_rate) {
+		if( symbol_rate <= 0 ) {
+			return false;
+		}
+		const auto samples_per_symbol = input_fs / symbol_rate;
+		return (samples_per_symbol * symbol_rate == input_fs) &&
+			(samples_per_symbol >= 2) && ((samples_per_symbol & 1) == 0) &&
+			(samples_per_symbol <= FSKTaps::taps_max);
+	}
+
+	SliceFSKStage(
+		const uint32_t input_fs,
+		const uint32_t symbol_rate
+	) : symbol_rate { symbol_rate },
+		mf { FSKTaps { input_fs / symbol_rate }, (input_fs / symbol_rate) / 2 },
+		clock_recovery {
+			static_cast<float>(symbol_rate * 2), static_cast<float>(symbol_rate), { 0.0555f },
+			[this](const float symbol) { this->consume_symbol(symbol); }
+		}
+	{
+	}
+
+	Buffer execute(const Buffer& src, void* const dst, const size_t dst_bytes) override {
+		const auto in = src.as<complex16_t>();
+		out = reinterpret_cast<uint8_t*>(dst);
+		out_max = dst_bytes;
+		out_count = 0;
+
+		for(size_t i=0; i<in.count; i++) {
+			if( mf.execute_once(in.p[i]) ) {
+				clock_recovery(mf.get_output());
+			}
+		}
+
+		return { SampleType::Bits, dst, out_count, symbol_rate };
+	}
+
+private:
+	const uint32_t symbol_rate;
+	dsp::matched_filter::MatchedFilter mf;
+	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery;
+
+	uint8_t* out { nullptr };
+	size_t out_max { 0 };
+	size_t out_count { 0 };
+
+	void consume_symbol(const float symbol) {
+		if( out_count < out_max ) {
+			out[out_count++] = (symbol >= 0.0f) ? 1 : 0;
+		}
+	}
+};
+
+class DecodeNRZIStage : public Stage {
+public:
+	Buffer execute(const Buffer& src, void* const, const size_t) override {
+		const auto bits = src.as<uint8_t>();
+		for(size_t i=0; i<bits.count; i++) {
+			bits.p[i] = nrzi_decode(bits.p[i]);
+		}
+		return src;
+	}
+
+private:
+	symbol_coding::NRZIDecoder nrzi_decode { };
+};
+
+/* Sinks ******************************************************************/
+
+template<typename T>
+class AudioSinkStage : public Stage {
+public:
+	AudioSinkStage(AudioOutput& audio_output) : audio_output(audio_output) { }
+
+	Buffer execute(const Buffer& src, void* const, const size_t) override {
+		audio_output.write(src.as<T>());
+		return { SampleType::None, nullptr, 0, src.sampling_rate };
+	}
+
+private:
+	AudioOutput& audio_output;
+};
+
+class PacketHDLCStage : public Stage {
+public:
+	static bool supports(const int32_t kind) {
+		return kind == static_cast<int32_t>(PacketKind::AIS);
+	}
+
+	PacketHDLCStage(
+		const PacketKind kind
+	) : packet_builder {
+			// AIS training sequence ahead of the flag
+			{ 0b0101010101111110, 16, 1 },
+			{ 0b111110, 6 },
+			{ 0b01111110, 8 },
+			[kind](const baseband::Packet& packet) {
+				post_packet(kind, packet);
+			}
+		}
+	{
+	}
+
+	Buffer execute(const Buffer& src, void* const, const size_t) override {
+		const auto bits = src.as<uint8_t>();
+		for(size_t i=0; i<bits.count; i++) {
+			packet_builder.execute(bits.p[i]);
+		}
+		return { SampleType::None, nullptr, 0, src.sampling_rate };
+	}
+
+private:
+	PacketBuilder<BitPattern, BitPattern, BitPattern> packet_builder;
+
+	static void post_packet(const PacketKind kind, const baseband::Packet& packet) {
+		switch(kind) {
+		case PacketKind::AIS: {
+				const AISPacketMessage message { packet };
+				shared_memory.application_queue.push(message);
+			}
+			break;
+		}
+	}
+};
+
+} /* namespace */
+
+/* Runtime ****************************************************************/
+
+Runtime::Runtime(
+	const Context& context
+) : context(context)
+{
+}
+
+void Runtime::reset() {
+	// execute() runs on the baseband thread and can preempt us, take the chain
+	// away from it before freeing the stages
+	count_ = 0;
+	__DMB();
+	for(auto& stage : stages) {
+		stage.reset();
+	}
+}
+
+bool Runtime::configure(const BasebandGraphConfigureMessage& message, const uint32_t baseband_fs) {
+	reset();
+
+	if( !is_valid(message.stages) ) {
+		return false;
+	}
+
+	context.audio_output.configure(message.audio_hpf_config, message.audio_deemph_config, (float)message.squelch_level / 100.0);
+
+	const auto count = stage_count(message.stages);
+	uint32_t fs = baseband_fs;
+	for(size_t i=0; i<count; i++) {
+		const auto& config = message.stages[i];
+		stages[i] = make_stage(config, message, fs);
+		if( !stages[i] ) {
+			reset();
+			return false;
+		}
+		fs /= decimation_factor(config);
+	}
+
+	// Publish only once every stage is in place
+	__DMB();
+	count_ = count;
+	return true;
+}
+
+std::unique_ptr<Stage> Runtime::make_stage(
+	const StageConfig& config,
+	const BasebandGraphConfigureMessage& message,
+	const uint32_t input_fs
+) {
+	switch(config.kind) {
+	case StageKind::Decim0By4:
+		return std::make_unique<C8DecimatorStage<dsp::decimate::FIRC8xR16x24FS4Decim4>>(message.decim_0_filter);
+
+	case StageKind::Decim0By8:
+		return std::make_unique<C8DecimatorStage<dsp::decimate::FIRC8xR16x24FS4Decim8>>(message.decim_0_filter);
+
+	case StageKind::Decim1By8:
+		return std::make_unique<Decim1By8Stage>(message.decim_1_filter);
+
+	case StageKind::ChannelFilter:
+		return std::make_unique<ChannelFilterStage>(message.channel_filter, config.param);
+
+	case StageKind::ChannelStats:
+		return std::make_unique<ChannelStatsStage>();
+
+	case StageKind::ChannelSpectrum:
+		return std::make_unique<ChannelSpectrumStage>(context.channel_spectrum, message.channel_filter, input_fs);
+
+	case StageKind::Squelch:
+		return std::make_unique<SquelchStage>(context.squelch, context.audio_output, input_fs);
+
+	case StageKind::DemodFM:
+		return std::make_unique<DemodFMStage>(input_fs, config.param);
+
+	case StageKind::DemodAM:
+		return std::make_unique<DemodAMStage>();
+
+	case StageKind::SliceFSK:
+		if( !SliceFSKStage::fits(input_fs, config.param) ) {
+			return nullptr;
+		}
+		return std::make_unique<SliceFSKStage>(input_fs, config.param);
+
+	case StageKind::DecodeNRZI:
+		return std::make_unique<DecodeNRZIStage>();
+
+	case StageKind::PacketHDLC:
+		if( !PacketHDLCStage::supports(config.param) ) {
+			return nullptr;
+		}
+		return std::make_unique<PacketHDLCStage>(static_cast<PacketKind>(config.param));
+
+	case StageKind::AudioSinkS16:
+		return std::make_unique<AudioSinkStage<int16_t>>(context.audio_output);
+
+	case StageKind::AudioSinkF32:
+		return std::make_unique<AudioSinkStage<float>>(context.audio_output);
+
+	default:
+		return nullptr;
+	}
+}
+
+void Runtime::execute(const buffer_c8_t& buffer) {
+	Buffer current = make_buffer(buffer, SampleType::C8);
+	size_t half = 0;
+
+	for(size_t i=0; i<count_; i++) {
+		void* const dst = arena.half(half);
+		current = stages[i]->execute(current, dst, ScratchArena::half_bytes);
+
+		// Pass-through stages leave the data where it was, don't swap halves
+		if( current.p == dst ) {
+			half++;
+		}
+	}
+}
+
+} /* namespace graph */
+} /* namespace baseband */
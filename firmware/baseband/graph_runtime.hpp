@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GRAPH_RUNTIME_H__
+#define __GRAPH_RUNTIME_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+#include "baseband_graph.hpp"
+
+#include "audio_output.hpp"
+#include "spectrum_collector.hpp"
+#include "dsp_squelch.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <memory>
+
+namespace baseband {
+namespace graph {
+
+/* Untyped view of a stage's output, tagged with its sample type. */
+struct Buffer {
+	SampleType type;
+	void* p;
+	size_t count;
+	uint32_t sampling_rate;
+
+	template<typename T>
+	::buffer_t<T> as() const {
+		return { reinterpret_cast<T*>(p), count, sampling_rate };
+	}
+};
+
+/* Scratch memory shared by every stage of the graph. Stages write into
+ * alternating halves, so each stage reads what the previous one wrote and
+ * nothing is allocated per stage.
+ */
+class ScratchArena {
+public:
+	static constexpr size_t half_bytes = 512 * sizeof(complex16_t);
+
+	void* half(const size_t index) {
+		return halves[index & 1].data();
+	}
+
+private:
+	alignas(8) std::array<std::array<uint8_t, half_bytes>, 2> halves { };
+};
+
+/* Services owned by the processor that sinks and taps feed into. */
+struct Context {
+	AudioOutput& audio_output;
+	SpectrumCollector& channel_spectrum;
+	Squelch& squelch;
+};
+
+class Stage {
+public:
+	virtual ~Stage() = default;
+
+	/* Returns src unchanged for pass-through stages, otherwise a buffer in
+	 * dst. Sinks return a buffer of type None.
+	 */
+	virtual Buffer execute(const Buffer& src, void* const dst, const size_t dst_bytes) = 0;
+};
+
+class Runtime {
+public:
+	Runtime(const Context& context);
+
+	/* Builds the stages described by the message. Returns false (and leaves the
+	 * graph empty) if the chain does not type-check.
+	 */
+	bool configure(const BasebandGraphConfigureMessage& message, const uint32_t baseband_fs);
+	void reset();
+
+	void execute(const buffer_c8_t& buffer);
+
+	bool configured() const {
+		return count_ > 0;
+	}
+
+private:
+	Context context;
+	ScratchArena arena { };
+	std::array<std::unique_ptr<Stage>, stages_max> stages { };
+	size_t count_ { 0 };
+
+	std::unique_ptr<Stage> make_stage(
+		const StageConfig& config,
+		const BasebandGraphConfigureMessage& message,
+		const uint32_t input_fs
+	);
+};
+
+} /* namespace graph */
+} /* namespace baseband */
+
+#endif/*__GRAPH_RUNTIME_H__*/
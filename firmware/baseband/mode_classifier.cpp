@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "mode_classifier.hpp"
+
+#include "complex.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+using classifier::Mode;
+
+/* Sync words as sent, first symbol in the most significant bits. The DMR and
+ * dPMR data syncs are the voice ones inverted, the polarity check finds them.
+ */
+const std::array<ModeClassifier::SyncWord, 12> ModeClassifier::sync_words { {
+	{ Mode::DMR,    4800, SyncKind::Dibits, 48, 3, 0x755FD7DF75F7 },	// BS sourced voice
+	{ Mode::DMR,    4800, SyncKind::Dibits, 48, 3, 0x7F7D5DD57DFD },	// MS sourced voice
+	{ Mode::P25,    4800, SyncKind::Dibits, 48, 3, 0x5575F5FF77FF },
+	{ Mode::NXDN,   4800, SyncKind::Dibits, 20, 0, 0xCDF59 },			// NXDN96 frame sync
+	{ Mode::NXDN,   2400, SyncKind::Dibits, 20, 0, 0xCDF59 },			// NXDN48
+	{ Mode::dPMR,   2400, SyncKind::Dibits, 48, 3, 0x57FF5F75D577 },	// FS1, header
+	{ Mode::DSTAR,  4800, SyncKind::Bits,   24, 1, 0xAAB468 },			// Slow data sync, 0x552D16 LSB first
+	{ Mode::POCSAG,  512, SyncKind::Bits,   32, 2, 0x7CD215D8 },
+	{ Mode::POCSAG, 1200, SyncKind::Bits,   32, 2, 0x7CD215D8 },
+	{ Mode::POCSAG, 2400, SyncKind::Bits,   32, 2, 0x7CD215D8 },
+	{ Mode::AIS,    9600, SyncKind::NRZI,   24, 1, 0x55557E },			// End of training, HDLC flag
+	{ Mode::AIS,    9600, SyncKind::NRZI,   24, 1, 0xAAAA7E },
+} };
+
+// Lowest first, a clock also locks on multiples of the symbol rate
+const std::array<uint16_t, ModeClassifier::lanes_count> ModeClassifier::symbol_rates { {
+	512, 1200, 2400, 4800, 9600
+} };
+
+void ModeClassifier::configure(const ModeClassifierConfigureMessage& message, const uint32_t sampling_rate) {
+	this->sampling_rate = sampling_rate;
+	dwell_samples = std::max<size_t>(uint64_t(sampling_rate) * message.dwell_ms / 1000, 1);
+	dc_gain = 10.0f / sampling_rate;
+
+	reset();
+	enabled = message.enabled;
+}
+
+void ModeClassifier::reset() {
+	dwell_count = 0;
+	dc = 0;
+	count = 0;
+	sum = 0;
+	square_sum = 0;
+	difference_sum = 0;
+	previous = 0;
+
+	value_previous = 0;
+	crossing_last = 0;
+	intervals = 0;
+	mark_intervals = 0;
+	space_intervals = 0;
+	long_intervals = 0;
+
+	for(size_t i=0; i<lanes.size(); i++) {
+		lanes[i] = Lane { };
+		lanes[i].symbol_rate = symbol_rates[i];
+		lanes[i].clock_step = float(symbol_rates[i]) / sampling_rate;
+	}
+	sync_hits.fill(0);
+	sync_rates.fill(0);
+}
+
+void ModeClassifier::feed(const float sample) {
+	count++;
+	sum += sample;
+	square_sum += sample * sample;
+	const float difference = sample - previous;
+	difference_sum += difference * difference;
+	previous = sample;
+
+	// Frequency offset of the transmitter
+	dc += (sample - dc) * dc_gain;
+	const float value = sample - dc;
+
+	if( (value >= 0) != (value_previous >= 0) ) {
+		on_crossing(count - value / (value - value_previous));
+	}
+	value_previous = value;
+
+	for(auto& lane : lanes) {
+		feed_lane(lane, value);
+	}
+}
+
+void ModeClassifier::on_crossing(const float time) {
+	const float interval = time - crossing_last;
+	crossing_last = time;
+
+	const float mark = float(sampling_rate) / (2 * 1200);
+	const float space = float(sampling_rate) / (2 * 2200);
+	intervals++;
+	if( std::fabs(interval - mark) < mark * 0.15f ) {
+		mark_intervals++;
+	} else if( std::fabs(interval - space) < space * 0.15f ) {
+		space_intervals++;
+	} else if( interval > mark * 1.2f ) {
+		long_intervals++;
+	}
+}
+
+void ModeClassifier::feed_lane(Lane& lane, const float value) {
+	// Zero crossings should fall on a whole clock phase
+	if( (value >= 0) != (lane.previous >= 0) ) {
+		const float fraction = lane.previous / (lane.previous - value);
+		float error = lane.clock_phase - (1.0f - fraction) * lane.clock_step;
+		error -= std::round(error);
+		lane.clock_phase -= error * clock_gain;
+		lane.error_sum += std::fabs(error);
+		lane.crossings++;
+	}
+	lane.previous = value;
+
+	lane.clock_phase += lane.clock_step;
+	if( (lane.clock_phase >= 0.5f) && !lane.sampled ) {
+		lane.sampled = true;
+		on_symbol(lane, value);
+	}
+	if( lane.clock_phase >= 1.0f ) {
+		lane.clock_phase -= 1.0f;
+		lane.sampled = false;
+	}
+}
+
+void ModeClassifier::on_symbol(Lane& lane, const float value) {
+	const float magnitude = std::fabs(value);
+	lane.level += (magnitude - lane.level) * level_gain;
+	lane.symbols++;
+	lane.abs_sum += magnitude;
+	lane.square_sum += magnitude * magnitude;
+
+	// With equally likely levels of 1 and 3, the average sits between them
+	const bool negative = (value < 0);
+	const bool outer = (magnitude > lane.level);
+	if( negative != lane.negative ) {
+		lane.runs++;
+		if( lane.run == 1 ) {
+			lane.short_runs++;
+		}
+		lane.run = 0;
+	}
+	lane.run++;
+
+	lane.nrzi = (lane.nrzi << 1) | ((negative == lane.negative) ? 1 : 0);
+	lane.negative = negative;
+	lane.bits = (lane.bits << 1) | (negative ? 1 : 0);
+	lane.dibits = (lane.dibits << 2) | (negative ? 2 : 0) | (outer ? 1 : 0);
+
+	// A clock at twice the rate sees every symbol twice and never a short run,
+	// don't let it find sync words in the repeats
+	if( (lane.symbols < symbols_min) || (lane.runs < runs_min) ) {
+		return;
+	}
+	const float short_ratio = float(lane.short_runs) / lane.runs;
+	if( (short_ratio < 0.2f) || (short_ratio > 0.85f) ) {
+		return;
+	}
+	// All outer symbols slice to the same dibits as 2 levels
+	const bool four_level = (spread(lane) > spread_4fsk_min);
+
+	for(const auto& sync : sync_words) {
+		if( sync.symbol_rate != lane.symbol_rate ) {
+			continue;
+		}
+		if( (sync.kind == SyncKind::Dibits) != four_level && (sync.kind != SyncKind::NRZI) ) {
+			continue;
+		}
+
+		const uint64_t mask = (1ULL << sync.length) - 1;
+		uint64_t shift = 0;
+		uint64_t inverse = 0;
+		switch(sync.kind) {
+		case SyncKind::Bits:
+			shift = lane.bits;
+			inverse = mask;
+			break;
+
+		case SyncKind::Dibits:
+			shift = lane.dibits;
+			inverse = 0xAAAAAAAAAAAAAAAAULL & mask;		// Sign bits only
+			break;
+
+		case SyncKind::NRZI:
+		default:
+			shift = lane.nrzi;
+			break;
+		}
+
+		const uint64_t difference = (shift ^ sync.pattern) & mask;
+		if( (size_t(__builtin_popcountll(difference)) <= sync.errors_max) ||
+			(inverse && (size_t(__builtin_popcountll(difference ^ inverse)) <= sync.errors_max)) ) {
+			sync_hits[size_t(sync.mode)]++;
+			sync_rates[size_t(sync.mode)] = sync.symbol_rate;
+		}
+	}
+}
+
+float ModeClassifier::spread(const Lane& lane) {
+	const float mean = lane.abs_sum / lane.symbols;
+	return (mean > 0) ? (lane.square_sum / lane.symbols) / (mean * mean) : 1.0f;
+}
+
+classifier::Result ModeClassifier::classify() const {
+	// A sync word settles it
+	const auto best_sync = std::max_element(sync_hits.begin(), sync_hits.end());
+	if( *best_sync > 0 ) {
+		const auto index = std::distance(sync_hits.begin(), best_sync);
+		return {
+			Mode(index),
+			uint8_t(std::min(99, 60 + 10 * *best_sync)),
+			sync_rates[index]
+		};
+	}
+
+	// Both tones and nothing slower, 4800 baud symbols are also 5 and 10 samples
+	if( intervals >= crossings_min ) {
+		const float mark = float(mark_intervals) / intervals;
+		const float space = float(space_intervals) / intervals;
+		const float slow = float(long_intervals) / intervals;
+		if( (mark + space > 0.7f) && (std::min(mark, space) > 0.15f) && (slow < 0.05f) ) {
+			return { Mode::APRS, uint8_t(std::min(95.0f, (mark + space) * 100.0f)), 1200 };
+		}
+	}
+
+	// Symbols with some data in them, not a tone or a dotting preamble
+	for(const auto& lane : lanes) {
+		if( (lane.crossings < crossings_min) || (lane.runs == 0) ) {
+			continue;
+		}
+		const float quality = 1.0f - 4.0f * lane.error_sum / lane.crossings;
+		const float short_ratio = float(lane.short_runs) / lane.runs;
+		if( (quality < clock_quality_min) || (short_ratio < 0.2f) || (short_ratio > 0.85f) ) {
+			continue;
+		}
+		return {
+			(spread(lane) > spread_4fsk_min) ? Mode::FSK4 : Mode::FSK2,
+			uint8_t(quality * 90.0f),
+			lane.symbol_rate
+		};
+	}
+
+	if( count == 0 ) {
+		return { };
+	}
+	const float mean = sum / count;
+	const float variance = std::max(square_sum / count - mean * mean, 1.0f);
+	const float rms = std::sqrt(variance);
+	if( rms < carrier_rms_max ) {
+		return { Mode::Carrier, uint8_t(90.0f - 40.0f * rms / carrier_rms_max), 0 };
+	}
+
+	// 1 for white noise, voice changes slowly at this rate
+	const float roughness = difference_sum / count / (2.0f * variance);
+	if( roughness < voice_roughness_max ) {
+		return { Mode::AnalogFM, uint8_t(std::max(20.0f, 95.0f * (1.0f - roughness / voice_roughness_max))), 0 };
+	}
+	return { };
+}
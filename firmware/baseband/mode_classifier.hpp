@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __MODE_CLASSIFIER_H__
+#define __MODE_CLASSIFIER_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+#include "mode_classification.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Guesses the mode of a channel from its FM demodulated audio, for the
+ * scanner to label what it stopped on.
+ *
+ * A symbol clock per common rate is kept in step with the zero crossings, as
+ * in the FLEX decoder. Crossings that keep falling on a clock edge mean there
+ * are symbols at that rate, and the symbols sliced at mid-clock (4-level at
+ * the average deviation) are matched against the sync words of known
+ * protocols, which settles the mode. Bell 202 tones give away APRS, by the
+ * length of half cycles. Without
+ * either, the spread and smoothness of the discriminator output tell voice
+ * from an unmodulated carrier and from noise.
+ *
+ * Evidence builds up from the time it's enabled, a result is sent every dwell.
+ */
+class ModeClassifier {
+public:
+	void configure(const ModeClassifierConfigureMessage& message, const uint32_t sampling_rate);
+
+	/* Deviation at full scale of the demodulated audio. */
+	void set_deviation(const float deviation_hz) {
+		scale = deviation_hz / 32768.0f;
+	}
+
+	template<typename MessageHandler>
+	void execute(const buffer_s16_t& src, MessageHandler handler) {
+		if( !enabled ) {
+			return;
+		}
+		for(size_t i=0; i<src.count; i++) {
+			feed(src.p[i] * scale);
+			if( ++dwell_count >= dwell_samples ) {
+				dwell_count = 0;
+				handler(ModeClassificationMessage { classify() });
+			}
+		}
+	}
+
+private:
+	static constexpr size_t lanes_count = 5;
+	static constexpr float clock_gain = 0.05f;
+	static constexpr float level_gain = 1.0f / 64;
+	static constexpr uint32_t crossings_min = 200;
+	static constexpr uint32_t symbols_min = 64;		// Before trusting the slicer level
+	static constexpr uint32_t runs_min = 32;
+	static constexpr float clock_quality_min = 0.35f;
+	// Mean square over squared mean at mid-symbol: 1 for 2 levels, 1.25 for 4
+	static constexpr float spread_4fsk_min = 1.12f;
+	static constexpr float carrier_rms_max = 300.0f;	// Hz
+	static constexpr float voice_roughness_max = 0.3f;
+
+	enum class SyncKind : uint8_t {
+		Bits,		// Sign of each symbol, polarity unknown
+		Dibits,		// 4-FSK, +3 = 01, +1 = 00, -1 = 10, -3 = 11, polarity unknown
+		NRZI,		// 1 = no change, polarity doesn't matter
+	};
+
+	struct SyncWord {
+		classifier::Mode mode;
+		uint16_t symbol_rate;
+		SyncKind kind;
+		uint8_t length;			// In bits
+		uint8_t errors_max;
+		uint64_t pattern;
+	};
+
+	static const std::array<SyncWord, 12> sync_words;
+	static const std::array<uint16_t, lanes_count> symbol_rates;
+
+	/* Symbol clock and slicer for one rate. */
+	struct Lane {
+		uint16_t symbol_rate { 0 };
+		float clock_step { 0 };
+		float clock_phase { 0 };	// In symbols, sampled half way
+		bool sampled { false };
+		float previous { 0 };
+		float level { 0 };			// Average |deviation| at mid-symbol
+		bool negative { false };
+
+		uint64_t bits { 0 };
+		uint64_t dibits { 0 };
+		uint64_t nrzi { 0 };
+
+		uint32_t crossings { 0 };
+		float error_sum { 0 };		// |Crossing - clock edge|, in symbols
+		uint32_t symbols { 0 };
+		float abs_sum { 0 };
+		float square_sum { 0 };
+		uint32_t runs { 0 };
+		uint32_t short_runs { 0 };	// Sign changed after a single symbol
+		size_t run { 0 };
+	};
+
+	bool enabled { false };
+	uint32_t sampling_rate { 24000 };
+	float scale { 5000.0f / 32768.0f };
+	size_t dwell_samples { 12000 };
+	size_t dwell_count { 0 };
+
+	float dc { 0 };
+	float dc_gain { 1.0f / 2400 };
+
+	// Whole signal
+	uint32_t count { 0 };
+	float sum { 0 };
+	float square_sum { 0 };
+	float difference_sum { 0 };		// Sample to sample change, squared
+	float previous { 0 };
+
+	// Bell 202, half cycles between zero crossings, in samples
+	float value_previous { 0 };
+	float crossing_last { 0 };
+	uint32_t intervals { 0 };
+	uint32_t mark_intervals { 0 };		// 1200Hz
+	uint32_t space_intervals { 0 };		// 2200Hz
+	uint32_t long_intervals { 0 };		// Below 1kHz, never in AFSK
+
+	std::array<Lane, lanes_count> lanes { };
+	std::array<uint16_t, size_t(classifier::Mode::APRS) + 1> sync_hits { };
+	std::array<uint16_t, size_t(classifier::Mode::APRS) + 1> sync_rates { };
+
+	void reset();
+	void feed(const float sample);
+	void on_crossing(const float time);
+	void feed_lane(Lane& lane, const float value);
+	void on_symbol(Lane& lane, const float value);
+	classifier::Result classify() const;
+
+	static float spread(const Lane& lane);
+};
+
+#endif/*__MODE_CLASSIFIER_H__*/
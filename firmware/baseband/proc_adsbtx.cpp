@@ -22,48 +22,100 @@
 
 #include "proc_adsbtx.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
 
-void ADSBTXProcessor::execute(const buffer_c8_t& buffer) {
+// Test this with ./dump1090 --freq 434000000 --gain 20
+// Or ./dump1090 --freq 434000000 --gain 20 --interactive --net --net-http-port 8080 --net-beast
+
+bool ADSBTXProcessor::chip(const size_t index) const {
+	if (index < preamble_chips)
+		return adsb::adsb_preamble[index];
 	
-	// This is called at 4M/2048 = 1953Hz
-	// One pulse = 500ns = 2 samples
-	// One bit = 2 pulses = 1us = 4 samples
-	// Test this with ./dump1090 --freq 434000000 --gain 20
-	// Or ./dump1090 --freq 434000000 --gain 20 --interactive --net --net-http-port 8080 --net-beast
+	// PPM: a 1 is a pulse in the first half of the bit, a 0 in the second
+	const size_t bit = (index - preamble_chips) >> 1;
+	const bool second_half = (index - preamble_chips) & 1;
+	const bool value = (frame.get_raw_data()[bit >> 3] >> (7 - (bit & 7))) & 1;
+	return value != second_half;
+}
+
+void ADSBTXProcessor::render_frame(std::array<int8_t, frame_samples>& samples) const {
+	int32_t level_1 = 0;
+	int32_t level_2 = 0;
 	
-	if (!configured) return;
+	for (size_t n = 0; n < frame_samples; n++) {
+		const size_t index = n / samples_per_chip;
+		const int32_t level = ((index < frame_chips) && chip(index)) ? 127 : 0;
+		
+		// [1 2 1] smoothing rounds the pulse edges, keeping the spectrum tight
+		// without smearing the 0.5us chips
+		samples[n] = (level + (level_1 << 1) + level_2) >> 2;
+		level_2 = level_1;
+		level_1 = level;
+	}
+}
 
+void ADSBTXProcessor::execute(const buffer_c8_t& buffer) {
+	
+	// This is called at 8M/2048 = 3906Hz
+	// One chip = 500ns = 4 samples
+	// One bit = 2 chips = 1us = 8 samples
+	
 	for (size_t i = 0; i < buffer.count; i++) {
-		if (bit_pos >= (240 << 1)) {
-			configured = false;
-			cur_bit = 0;
-		} else {
-			cur_bit = shared_memory.bb_data.data[bit_pos >> 1];
-			bit_pos++;
+		int8_t level = 0;
+		
+		if (sample_index < frame_samples) {
+			level = frames[playing][sample_index];
+			if (++sample_index == frame_samples)
+				gap = gap_samples;
+		} else if (gap) {
+			gap--;
+		} else if (pending) {
+			playing ^= 1;
+			pending = false;
+			sample_index = 0;
+			frames_sent++;
 		}
 		
-		if (cur_bit) {
-			// Crude AM
-			buffer.p[i] = am_lut[phase & 3];
-			phase++;
-		} else {
-			buffer.p[i] = { 0, 0 };
+		// Shifted up by fs/4 (the M0 tunes that much lower), so the LO leakage
+		// at DC lands on the first null of the frame spectrum, not its peak
+		switch (now & 3) {
+			case 0:		buffer.p[i] = { level, 0 };									break;
+			case 1:		buffer.p[i] = { 0, level };									break;
+			case 2:		buffer.p[i] = { static_cast<int8_t>(-level), 0 };			break;
+			default:	buffer.p[i] = { 0, static_cast<int8_t>(-level) };			break;
 		}
+		
+		now++;
+	}
+	
+	// Queue the next frame due. At one per 0.25ms buffer that's well within
+	// the squitter jitter.
+	if (configured && !pending && generator.next_frame(now, frame)) {
+		render_frame(frames[playing ^ 1]);
+		pending = true;
+	}
+	
+	if (configured && (static_cast<int32_t>(now - progress_due) >= 0)) {
+		progress_due = now + baseband_fs;
+		txprogress_message.progress = frames_sent;
+		txprogress_message.done = false;
+		shared_memory.application_queue.push(txprogress_message);
 	}
 }
 
+void ADSBTXProcessor::configure(const ADSBTrafficConfigureMessage& message) {
+	generator.configure(message, baseband_fs, now);
+	configured = (generator.count() > 0);
+	pending = false;
+	frames_sent = 0;
+	progress_due = now;
+}
+
 void ADSBTXProcessor::on_message(const Message* const p) {
-	const auto message = *reinterpret_cast<const ADSBConfigureMessage*>(p);
-	
-	if (message.id == Message::ID::ADSBConfigure) {
-		bit_pos = 0;
-		phase = 0;
-		configured = true;
-	}
+	if (p->id == Message::ID::ADSBTrafficConfigure)
+		configure(*reinterpret_cast<const ADSBTrafficConfigureMessage*>(p));
 }
 
 int main() {
@@ -26,6 +26,10 @@
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 
+#include "traffic_generator.hpp"
+
+#include <array>
+
 class ADSBTXProcessor : public BasebandProcessor {
 public:
 	void execute(const buffer_c8_t& buffer) override;
@@ -33,22 +37,40 @@ public:
 	void on_message(const Message* const p) override;
 
 private:
+	static constexpr uint32_t baseband_fs = 8000000;
+	static constexpr size_t samples_per_chip = 4;		// 0.5us
+	static constexpr size_t preamble_chips = 16;
+	static constexpr size_t frame_chips = preamble_chips + (112 * 2);
+	static constexpr size_t frame_samples = frame_chips * samples_per_chip + 2;	// Smoothing tail
+	static constexpr size_t gap_samples = 64;			// 8us of silence between frames
+	
 	bool configured = false;
 	
-	BasebandThread baseband_thread { 4000000, this, NORMALPRIO + 20, baseband::Direction::Transmit };
+	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 	
-	const complex8_t am_lut[4] = {
-		{ 127, 0 },
-		{ 0, 127 },
-		{ -127, 0 },
-		{ 0, -127 }		
-	};
+	adsb::TrafficGenerator generator { };
+	adsb::ADSBFrame frame { };
 	
-    uint32_t bit_pos { 0 };
-    uint32_t cur_bit { 0 };
-	uint32_t phase { 0 };
+	/* Envelopes of the frame being sent and of the next one. Frames are
+	 * encoded and rendered between buffers, the sample loop only copies and
+	 * shifts them.
+	 */
+	std::array<std::array<int8_t, frame_samples>, 2> frames { };
+	size_t playing { 0 };
+	bool pending { false };
+	size_t sample_index { frame_samples };
+	
+	uint32_t now { 0 };
+	size_t gap { 0 };
+	
+	uint32_t frames_sent { 0 };
+	uint32_t progress_due { 0 };
 	
 	TXProgressMessage txprogress_message { };
+	
+	bool chip(const size_t index) const;
+	void render_frame(std::array<int8_t, frame_samples>& samples) const;
+	void configure(const ADSBTrafficConfigureMessage& message);
 };
 
 #endif
@@ -25,6 +25,8 @@
 
 #include "event_m4.hpp"
 
+#include <algorithm>
+
 void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 	// This is called at 3072000 / 2048 = 1500Hz
 
@@ -63,7 +65,7 @@ void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 		
 		// Slice
 		sample_bits <<= 1;
-		sample_bits |= (sample_filtered < -20) ? 1 : 0;
+		sample_bits |= (sample_filtered < slice_level(sample_filtered)) ? 1 : 0;
 		
 		// Check for "clean" transition: either 0011 or 1100
 		if ((((sample_bits >> 2) ^ sample_bits) & 3) == 3) {
@@ -90,19 +92,13 @@ void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 				if (triggered) {
 					if (bit_counter == word_length) {
 						bit_counter = 0;
-						
-						data_message.is_data = true;
-						data_message.value = word_bits & word_mask;
-						shared_memory.application_queue.push(data_message);
+						push_word(word_bits & word_mask);
 					}
 				} else {
 					if ((word_bits & word_mask) == trigger_value) {
 						triggered = !triggered;
 						bit_counter = 0;
-						
-						data_message.is_data = true;
-						data_message.value = trigger_value;
-						shared_memory.application_queue.push(data_message);
+						push_word(trigger_value);
 					}
 				}
 				
@@ -114,6 +110,10 @@ void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 						// Got start bit
 						state = RECEIVE;
 						bit_counter = 0;
+						idle_bits = 0;
+					} else if ((++idle_bits == word_length + 2) && block_count) {
+						// Line idle for a whole word, that was the end of a frame
+						notify(true);
 					}
 				} else if (state == WAIT_STOP) {
 					if (sample_bits & 1) {
@@ -130,15 +130,60 @@ void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 				if (bit_counter == word_length) {
 					bit_counter = 0;
 					state = WAIT_STOP;
-					
-					data_message.is_data = true;
-					data_message.value = word_bits;
-					shared_memory.application_queue.push(data_message);
+					push_word(word_bits & word_mask);
 				}
 				
 			}
 		}
 	}
+	
+	if (block_count && (++flush_timer >= flush_buffers))
+		notify(false);
+}
+
+int32_t AFSKRxProcessor::slice_level(const int32_t sample) {
+	// Levels are kept with 8 fractional bits so the slow release doesn't round to 0
+	const int32_t x = sample * 256;
+	
+	// Fast attack, slow release (~170ms at 24kHz) so idle mark doesn't pull
+	// the level onto itself between characters
+	if (x > level_high)
+		level_high += (x - level_high) / 4;
+	else
+		level_high -= (level_high - level_low) / 4096;
+	
+	if (x < level_low)
+		level_low += (x - level_low) / 4;
+	else
+		level_low += (level_high - level_low) / 4096;
+	
+	return (level_high + level_low) / 512;
+}
+
+void AFSKRxProcessor::push_word(const uint32_t value) {
+	auto& ring = shared_memory.bb_data.afsk_rx;
+	
+	if ((ring.write_index - ring.read_index) < ring.size) {
+		ring.words[ring.write_index % ring.size] = value;
+		__DMB();		// Publish only once the word is in place
+		ring.write_index = ring.write_index + 1;
+	} else {
+		ring.dropped = ring.dropped + 1;
+	}
+	
+	if (++block_count >= block_words)
+		notify(false);
+}
+
+void AFSKRxProcessor::notify(const bool frame_end) {
+	block_message.count = block_count;
+	block_message.dropped = shared_memory.bb_data.afsk_rx.dropped;
+	block_message.frame_end = frame_end;
+	// The M0 drains the whole ring on any notification, a lost one costs nothing
+	shared_memory.application_queue.push(block_message);
+	
+	block_count = 0;
+	flush_timer = 0;
 }
 
 void AFSKRxProcessor::on_message(const Message* const message) {
@@ -171,10 +216,19 @@ void AFSKRxProcessor::configure(const AFSKRxConfigureMessage& message) {
 	phase = 0;
 	
 	trigger_word = message.trigger_word;
-	word_length = message.word_length;
+	// Ring entries are 16 bits
+	word_length = std::min<uint32_t>(message.word_length, 16);
 	trigger_value = message.trigger_value;
 	word_mask = (1 << word_length) - 1;
 	
+	// The M0 empties the ring before sending this, the indexes aren't ours to reset
+	shared_memory.bb_data.afsk_rx.dropped = 0;
+	block_count = 0;
+	flush_timer = 0;
+	idle_bits = 0;
+	level_high = 0;
+	level_low = 0;
+	
 	// Delay line
 	delay_line_index = 0;
 	
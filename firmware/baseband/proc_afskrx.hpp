@@ -45,6 +45,10 @@ private:
 	static constexpr size_t baseband_fs = 3072000;
 	static constexpr size_t audio_fs = baseband_fs / 8 / 8 / 2;
 	
+	// Words per notification, and the longest a partial block waits (in buffers of 1/1500s)
+	static constexpr uint32_t block_words = 16;
+	static constexpr uint32_t flush_buffers = 150;
+	
 	size_t samples_per_bit { };
 	
 	enum State {
@@ -89,6 +93,13 @@ private:
 	uint32_t word_mask { };
 	uint32_t trigger_value { };
 	
+	// Slicing level halfway between the tracked mark and space levels
+	int32_t level_high { 0 }, level_low { 0 };
+	
+	uint32_t block_count { 0 };
+	uint32_t flush_timer { 0 };
+	uint32_t idle_bits { 0 };
+	
 	bool configured { false };
 	bool wait_start { };
 	bool bit_value { };
@@ -96,8 +107,11 @@ private:
 	bool triggered { };
 	
 	void configure(const AFSKRxConfigureMessage& message);
+	int32_t slice_level(const int32_t sample);
+	void push_word(const uint32_t value);
+	void notify(const bool frame_end);
 	
-	AFSKDataMessage data_message { false, 0 };
+	AFSKRxBlockMessage block_message { 0, 0, false };
 };
 
 #endif/*__PROC_TPMS_H__*/
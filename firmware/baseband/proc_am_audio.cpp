@@ -25,6 +25,8 @@
 
 #include "event_m4.hpp"
 
+#include "portapack_shared_memory.hpp"
+
 #include <array>
 
 void NarrowbandAMAudio::execute(const buffer_c8_t& buffer) {
@@ -43,7 +45,15 @@ void NarrowbandAMAudio::execute(const buffer_c8_t& buffer) {
 	// TODO: Feed channel_stats post-decimation data?
 	feed_channel_stats(channel_out);
 
+	squelch.execute(channel_out, [](const SquelchEventMessage& message) {
+		shared_memory.application_queue.push(message);
+	});
+	audio_output.set_squelch_open(squelch.is_open());
+
 	auto audio = demodulate(channel_out);
+	cw_decoder.execute(audio, [](const CWRxMessage& message) {
+		shared_memory.application_queue.push(message);
+	});
 	audio_compressor.execute_in_place(audio);
 	audio_output.write(audio);
 }
@@ -67,9 +77,17 @@ void NarrowbandAMAudio::on_message(const Message* const message) {
 		configure(*reinterpret_cast<const AMConfigureMessage*>(message));
 		break;
 
+	case Message::ID::SquelchConfigure:
+		squelch.configure(*reinterpret_cast<const SquelchConfigureMessage*>(message));
+		break;
+
 	case Message::ID::CaptureConfig:
 		capture_config(*reinterpret_cast<const CaptureConfigMessage*>(message));
 		break;
+
+	case Message::ID::CWRxConfigure:
+		cw_decoder.configure(*reinterpret_cast<const CWRxConfigureMessage*>(message), audio_fs);
+		break;
 		
 	default:
 		break;
@@ -87,7 +105,7 @@ void NarrowbandAMAudio::configure(const AMConfigureMessage& message) {
 	constexpr size_t decim_2_output_fs = decim_2_input_fs / decim_2_decimation_factor;
 
 	constexpr size_t channel_filter_input_fs = decim_2_output_fs;
-	//const size_t channel_filter_output_fs = channel_filter_input_fs / channel_filter_decimation_factor;
+	constexpr size_t channel_filter_output_fs = channel_filter_input_fs / channel_filter_decimation_factor;
 
 	decim_0.configure(message.decim_0_filter.taps, 33554432);
 	decim_1.configure(message.decim_1_filter.taps, 131072);
@@ -99,6 +117,7 @@ void NarrowbandAMAudio::configure(const AMConfigureMessage& message) {
 	channel_spectrum.set_decimation_factor(1.0f);
 	modulation_ssb = (message.modulation == AMConfigureMessage::Modulation::SSB);
 	audio_output.configure(message.audio_hpf_config);
+	squelch.set_sampling_rate(channel_filter_output_fs);
 
 	configured = true;
 }
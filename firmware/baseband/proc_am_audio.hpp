@@ -29,6 +29,7 @@
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
 #include "audio_compressor.hpp"
+#include "cw_decoder.hpp"
 
 #include "audio_output.hpp"
 #include "spectrum_collector.hpp"
@@ -45,6 +46,8 @@ private:
 	static constexpr size_t baseband_fs = 3072000;
 	static constexpr size_t decim_2_decimation_factor = 4;
 	static constexpr size_t channel_filter_decimation_factor = 1;
+	// Decim 0 and 1 both divide by 8
+	static constexpr size_t audio_fs = baseband_fs / 8 / 8 / decim_2_decimation_factor / channel_filter_decimation_factor;
 
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
@@ -71,8 +74,10 @@ private:
 	bool modulation_ssb = false;
 	dsp::demodulate::AM demod_am { };
 	dsp::demodulate::SSB demod_ssb { };
+	CWDecoder cw_decoder { };
 	FeedForwardCompressor audio_compressor { };
 	AudioOutput audio_output { };
+	Squelch squelch { };
 
 	SpectrumCollector channel_spectrum { };
 
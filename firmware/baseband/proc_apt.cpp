@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "proc_apt.hpp"
+
+#include "portapack_shared_memory.hpp"
+#include "event_m4.hpp"
+
+#include <cstdint>
+
+void APTProcessor::execute(const buffer_c8_t& buffer) {
+	if( !configured ) {
+		return;
+	}
+
+	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+	const auto channel = decim_1.execute(decim_0_out, dst_buffer);
+
+	feed_channel_stats(channel);
+
+	/* 384kHz complex<int16_t>[256]
+	 * -> FM demodulation, 17kHz deviation
+	 * -> 384kHz int16_t[256] */
+	auto audio_oversampled = demod.execute(channel, work_audio_buffer);
+	auto audio_4fs = audio_dec_1.execute(audio_oversampled, work_audio_buffer);
+	auto audio_2fs = audio_dec_2.execute(audio_4fs, work_audio_buffer);
+
+	/* 96kHz int16_t[64]
+	 * -> FIR filter, <15kHz (0.156fs) pass, >19kHz (0.198fs) stop, gain of 1
+	 * -> 48kHz int16_t[32] */
+	auto audio = audio_filter.execute(audio_2fs, work_audio_buffer);
+
+	decoder.execute(audio, [this](const APTLine& line) {
+		this->on_line(line);
+	});
+
+	audio_output.write(audio);
+}
+
+void APTProcessor::on_line(const APTLine& line) {
+	// If the M0 fell behind, drop the line rather than block the baseband
+	if( lines.in(line) ) {
+		const APTLineMessage message { &lines };
+		shared_memory.application_queue.push(message);
+	}
+}
+
+void APTProcessor::on_message(const Message* const message) {
+	switch(message->id) {
+	case Message::ID::WFMConfigure:
+		configure(*reinterpret_cast<const WFMConfigureMessage*>(message));
+		break;
+
+	default:
+		break;
+	}
+}
+
+void APTProcessor::configure(const WFMConfigureMessage& message) {
+	constexpr size_t decim_0_input_fs = baseband_fs;
+	constexpr size_t decim_0_output_fs = decim_0_input_fs / decim_0.decimation_factor;
+
+	constexpr size_t decim_1_input_fs = decim_0_output_fs;
+	constexpr size_t decim_1_output_fs = decim_1_input_fs / decim_1.decimation_factor;
+
+	constexpr size_t demod_input_fs = decim_1_output_fs;
+
+	decim_0.configure(message.decim_0_filter.taps, 33554432);
+	decim_1.configure(message.decim_1_filter.taps, 131072);
+	// The receiver model sends broadcast deviation, APT only uses +/-17kHz
+	demod.configure(demod_input_fs, deviation);
+	audio_filter.configure(message.audio_filter.taps);
+	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config);
+
+	decoder.reset();
+
+	configured = true;
+}
+
+int main() {
+	EventDispatcher event_dispatcher { std::make_unique<APTProcessor>() };
+	event_dispatcher.run();
+	return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __PROC_APT_H__
+#define __PROC_APT_H__
+
+#include "baseband_processor.hpp"
+#include "baseband_thread.hpp"
+#include "rssi_thread.hpp"
+
+#include "dsp_types.hpp"
+#include "dsp_decimate.hpp"
+#include "dsp_demodulate.hpp"
+
+#include "audio_output.hpp"
+#include "apt_decoder.hpp"
+
+#include "fifo.hpp"
+#include "message.hpp"
+
+/* Same front end as wideband FM down to 48kHz audio, with the deviation of
+ * the 137MHz weather satellites. The audio goes both to the headphones and
+ * the APT decoder, lines are handed to the M0 through a FIFO as they're only
+ * complete every half second and too big for a message.
+ */
+class APTProcessor : public BasebandProcessor {
+public:
+	void execute(const buffer_c8_t& buffer) override;
+
+	void on_message(const Message* const message) override;
+
+private:
+	static constexpr size_t baseband_fs = 3072000;
+	static constexpr int32_t deviation = 17000;
+
+	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
+	RSSIThread rssi_thread { NORMALPRIO + 10 };
+
+	std::array<complex16_t, 512> dst { };
+	const buffer_c16_t dst_buffer {
+		dst.data(),
+		dst.size()
+	};
+	// work_audio_buffer and dst_buffer use the same data pointer
+	const buffer_s16_t work_audio_buffer {
+		(int16_t*)dst.data(),
+		sizeof(dst) / sizeof(int16_t)
+	};
+
+	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
+	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
+
+	dsp::demodulate::FM demod { };
+	dsp::decimate::DecimateBy2CIC4Real audio_dec_1 { };
+	dsp::decimate::DecimateBy2CIC4Real audio_dec_2 { };
+	dsp::decimate::FIR64AndDecimateBy2Real audio_filter { };
+
+	AudioOutput audio_output { };
+
+	APTDecoder decoder { };
+	APTLine lines_data[1 << APTLineMessage::fifo_k] { };
+	APTLineFIFO lines { lines_data, APTLineMessage::fifo_k };
+
+	bool configured { false };
+	void configure(const WFMConfigureMessage& message);
+	void on_line(const APTLine& line);
+};
+
+#endif/*__PROC_APT_H__*/
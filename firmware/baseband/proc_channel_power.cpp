@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "proc_channel_power.hpp"
+
+#include "dsp_fir_taps.hpp"
+
+#include "event_m4.hpp"
+
+#include "portapack_shared_memory.hpp"
+
+#include <algorithm>
+
+ChannelPowerProcessor::ChannelPowerProcessor() {
+	decim_0.configure(taps_200k_decim_0.taps, 33554432);
+	decim_1.configure(taps_200k_decim_1.taps, 131072);
+}
+
+void ChannelPowerProcessor::execute(const buffer_c8_t& buffer) {
+	if( !configured ) {
+		return;
+	}
+
+	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+	const auto decimator_out = decim_1.execute(decim_0_out, dst_buffer);
+
+	/* fs / 8, 256 samples */
+	if( !frame_pending && (decimator_out.count >= frame.size()) ) {
+		std::copy(&decimator_out.p[0], &decimator_out.p[frame.size()], frame.begin());
+		frame_pending = true;
+		EventDispatcher::events_flag(EVT_MASK_DEFERRED);
+	}
+
+	// Report on sample time, so the rate doesn't depend on the M4 load
+	samples_since_report += buffer.count;
+	if( samples_since_report >= report_samples ) {
+		samples_since_report = 0;
+		report_pending = true;
+		EventDispatcher::events_flag(EVT_MASK_DEFERRED);
+	}
+}
+
+void ChannelPowerProcessor::on_message(const Message* const message) {
+	if( message->id == Message::ID::ChannelPowerConfigure ) {
+		configure(*reinterpret_cast<const ChannelPowerConfigureMessage*>(message));
+	}
+}
+
+void ChannelPowerProcessor::configure(const ChannelPowerConfigureMessage& message) {
+	configured = false;
+
+	baseband_fs = message.sampling_rate;
+	baseband_thread.set_sampling_rate(baseband_fs);
+
+	meter.configure(message, baseband_fs / 8);
+	report_samples = uint64_t(baseband_fs) * message.report_interval_ms / 1000;
+	samples_since_report = 0;
+	report_pending = false;
+	frame_pending = false;
+
+	configured = true;
+}
+
+void ChannelPowerProcessor::on_deferred() {
+	if( frame_pending ) {
+		meter.add_frame(frame);
+		frame_pending = false;
+	}
+
+	if( report_pending && meter.ready() ) {
+		const ChannelPowerMessage message { meter.result() };
+		shared_memory.application_queue.push(message);
+		report_pending = false;
+	}
+}
+
+int main() {
+	EventDispatcher event_dispatcher { std::make_unique<ChannelPowerProcessor>() };
+	event_dispatcher.run();
+	return 0;
+}
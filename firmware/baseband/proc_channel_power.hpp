@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PROC_CHANNEL_POWER_H__
+#define __PROC_CHANNEL_POWER_H__
+
+#include "baseband_processor.hpp"
+#include "baseband_thread.hpp"
+#include "rssi_thread.hpp"
+
+#include "dsp_decimate.hpp"
+#include "channel_power.hpp"
+
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+class ChannelPowerProcessor : public BasebandProcessor {
+public:
+	ChannelPowerProcessor();
+
+	void execute(const buffer_c8_t& buffer) override;
+
+	void on_message(const Message* const message) override;
+	void on_deferred() override;
+
+private:
+	size_t baseband_fs = 2457600;
+
+	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
+	RSSIThread rssi_thread { NORMALPRIO + 10 };
+
+	std::array<complex16_t, 512> dst { };
+	const buffer_c16_t dst_buffer {
+		dst.data(),
+		dst.size()
+	};
+
+	/* Same chain as capture: fs/4 shifted to DC, decimated by 8, flat over
+	 * +/-0.32 of the output rate whatever the baseband rate.
+	 */
+	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
+	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
+
+	ChannelPowerMeter meter { };
+
+	/* One frame at a time is handed to the event loop; buffers arriving while
+	 * it's busy are skipped, which only lowers the number of averages.
+	 */
+	ChannelPowerMeter::frame_t frame { };
+	volatile bool frame_pending { false };
+	volatile bool report_pending { false };
+
+	bool configured { false };
+	size_t report_samples { 0 };
+	size_t samples_since_report { 0 };
+
+	void configure(const ChannelPowerConfigureMessage& message);
+};
+
+#endif/*__PROC_CHANNEL_POWER_H__*/
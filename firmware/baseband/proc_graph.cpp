@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "proc_graph.hpp"
+
+#include "event_m4.hpp"
+
+void GraphProcessor::execute(const buffer_c8_t& buffer) {
+	if( !graph.configured() ) {
+		return;
+	}
+
+	graph.execute(buffer);
+}
+
+void GraphProcessor::on_message(const Message* const message) {
+	switch(message->id) {
+	case Message::ID::UpdateSpectrum:
+	case Message::ID::SpectrumStreamingConfig:
+		channel_spectrum.on_message(message);
+		break;
+
+	case Message::ID::BasebandGraphConfigure:
+		configure(*reinterpret_cast<const BasebandGraphConfigureMessage*>(message));
+		break;
+
+	case Message::ID::SquelchConfigure:
+		squelch.configure(*reinterpret_cast<const SquelchConfigureMessage*>(message));
+		break;
+
+	case Message::ID::CaptureConfig:
+		capture_config(*reinterpret_cast<const CaptureConfigMessage*>(message));
+		break;
+
+	default:
+		break;
+	}
+}
+
+void GraphProcessor::configure(const BasebandGraphConfigureMessage& message) {
+	// The M0 sets the radio to the rate the chain was designed for
+	baseband_thread.set_sampling_rate(message.baseband_fs);
+
+	// An invalid chain leaves the graph empty, execute() then does nothing
+	graph.configure(message, message.baseband_fs);
+}
+
+void GraphProcessor::capture_config(const CaptureConfigMessage& message) {
+	if( message.config ) {
+		audio_output.set_stream(std::make_unique<StreamInput>(message.config));
+	} else {
+		audio_output.set_stream(nullptr);
+	}
+}
+
+int main() {
+	EventDispatcher event_dispatcher { std::make_unique<GraphProcessor>() };
+	event_dispatcher.run();
+	return 0;
+}
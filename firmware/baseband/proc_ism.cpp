@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "proc_ism.hpp"
+
+#include "dsp_fir_taps.hpp"
+#include "pulse_slicer.hpp"
+
+#include "event_m4.hpp"
+
+#include "portapack_shared_memory.hpp"
+
+ISMProcessor::ISMProcessor() {
+	decim_0.configure(taps_200k_decim_0.taps, 33554432);
+	decim_1.configure(taps_200k_decim_1.taps, 131072);
+}
+
+void ISMProcessor::execute(const buffer_c8_t& buffer) {
+	/* 2.4576MHz, 2048 samples */
+
+	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+	const auto decimator_out = decim_1.execute(decim_0_out, dst_buffer);
+
+	/* 307.2kHz, 256 samples */
+	feed_channel_stats(decimator_out);
+
+	pulse_detector.execute(decimator_out, [this](const ism::PulseTrain& train) {
+		this->on_train(train);
+	});
+}
+
+void ISMProcessor::on_train(const ism::PulseTrain& train) {
+	if( deferred_pending ) {
+		return;
+	}
+
+	deferred_train.modulation = train.modulation;
+	deferred_train.sampling_rate = train.sampling_rate;
+	deferred_train.count = train.count;
+	std::copy(&train.pulses[0], &train.pulses[train.count], &deferred_train.pulses[0]);
+
+	deferred_pending = true;
+	EventDispatcher::events_flag(EVT_MASK_DEFERRED);
+}
+
+void ISMProcessor::on_message(const Message* const message) {
+	if( message->id == Message::ID::ISMConfigure ) {
+		configure(*reinterpret_cast<const ISMConfigureMessage*>(message));
+	}
+}
+
+void ISMProcessor::configure(const ISMConfigureMessage& message) {
+	analyze = message.analyze;
+	analyzer.reset();
+}
+
+void ISMProcessor::on_deferred() {
+	if( !deferred_pending ) {
+		return;
+	}
+
+	if( analyze ) {
+		const PulseAnalysisMessage message { analyzer.feed(deferred_train) };
+		shared_memory.application_queue.push(message);
+	} else {
+		decode(deferred_train);
+	}
+
+	deferred_pending = false;
+}
+
+void ISMProcessor::decode(const ism::PulseTrain& train) {
+	for(size_t i=0; i<ism::protocols.size(); i++) {
+		if( ism::slice(train, ism::protocols[i], record) ) {
+			record.protocol = i;
+			record.set_timestamp(Timestamp::now());
+			const ISMPacketMessage message { record };
+			shared_memory.application_queue.push(message);
+			break;
+		}
+	}
+}
+
+int main() {
+	EventDispatcher event_dispatcher { std::make_unique<ISMProcessor>() };
+	event_dispatcher.run();
+	return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PROC_ISM_H__
+#define __PROC_ISM_H__
+
+#include "baseband_processor.hpp"
+#include "baseband_thread.hpp"
+#include "rssi_thread.hpp"
+
+#include "dsp_decimate.hpp"
+#include "pulse_detector.hpp"
+#include "pulse_analyzer.hpp"
+
+#include "ism_packet.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Generic ISM band (315/433/868MHz) sensor and remote decoder. Pulse trains
+ * are collected in the baseband thread and sliced against the protocol table
+ * in the event loop, so decoding can take longer than one buffer.
+ */
+class ISMProcessor : public BasebandProcessor {
+public:
+	ISMProcessor();
+
+	void execute(const buffer_c8_t& buffer) override;
+	void on_message(const Message* const message) override;
+	void on_deferred() override;
+
+private:
+	static constexpr size_t baseband_fs = 2457600;
+	static constexpr uint32_t channel_fs = 307200;
+	static constexpr uint32_t reset_us = 20000;
+
+	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
+	RSSIThread rssi_thread { NORMALPRIO + 10 };
+
+	std::array<complex16_t, 512> dst { };
+	const buffer_c16_t dst_buffer {
+		dst.data(),
+		dst.size()
+	};
+
+	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
+	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
+
+	PulseDetector pulse_detector { channel_fs, reset_us };
+
+	/* Single slot hand-off to the event loop. Trains arriving while the slot
+	 * is still being decoded are dropped.
+	 */
+	ism::PulseTrain deferred_train { };
+	volatile bool deferred_pending { false };
+
+	ism::Record record { };
+
+	/* Analyzer mode: histogram every train instead of decoding */
+	bool analyze { false };
+	ism::PulseAnalyzer analyzer { };
+
+	void configure(const ISMConfigureMessage& message);
+	void decode(const ism::PulseTrain& train);
+
+	void on_train(const ism::PulseTrain& train);
+};
+
+#endif/*__PROC_ISM_H__*/
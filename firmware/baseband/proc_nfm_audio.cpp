@@ -45,10 +45,18 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
 
 	feed_channel_stats(channel_out);
 
+	squelch.execute(channel_out, [](const SquelchEventMessage& message) {
+		shared_memory.application_queue.push(message);
+	});
+	audio_output.set_squelch_open(squelch.is_open());
+
 	if (!pitch_rssi_enabled) {
 		// Normal mode, output demodulated audio
 		auto audio = demod.execute(channel_out, audio_buffer);
-		audio_output.write(audio);
+
+		mode_classifier.execute(audio, [](const ModeClassificationMessage& message) {
+			shared_memory.application_queue.push(message);
+		});
 		
 		if (ctcss_detect_enabled) {
 			/* 24kHz int16_t[16]
@@ -62,6 +70,15 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
 				audio_f[i] = audio_ctcss.p[i] * ki;
 			}
 			
+			// DCS goes down to DC, decode it before the high-pass
+			dcs.execute(
+				buffer_f32_t { audio_f.data(), audio_ctcss.count, ctcss_fs },
+				[](const DCSMessage& message) {
+					shared_memory.application_queue.push(message);
+				}
+			);
+			audio_output.set_gate(dcs.audio_enabled());
+			
 			hpf.execute_in_place(buffer_f32_t {
 				audio_f.data(),
 				audio_ctcss.count,
@@ -87,6 +104,8 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
 				z_acc = 0;
 			}
 		}
+		
+		audio_output.write(audio);
 	} else {
 		// Direction-finding mode; output tone with pitch related to RSSI
 		for (size_t c = 0; c < 16; c++) {
@@ -116,6 +135,10 @@ void NarrowbandFMAudio::on_message(const Message* const message) {
 		configure(*reinterpret_cast<const NBFMConfigureMessage*>(message));
 		break;
 
+	case Message::ID::SquelchConfigure:
+		squelch.configure(*reinterpret_cast<const SquelchConfigureMessage*>(message));
+		break;
+
 	case Message::ID::CaptureConfig:
 		capture_config(*reinterpret_cast<const CaptureConfigMessage*>(message));
 		break;
@@ -123,6 +146,14 @@ void NarrowbandFMAudio::on_message(const Message* const message) {
 	case Message::ID::PitchRSSIConfigure:
 		pitch_rssi_config(*reinterpret_cast<const PitchRSSIConfigureMessage*>(message));
 		break;
+	
+	case Message::ID::DCSConfigure:
+		dcs.configure(*reinterpret_cast<const DCSConfigureMessage*>(message), ctcss_fs);
+		break;
+
+	case Message::ID::ModeClassifierConfigure:
+		mode_classifier.configure(*reinterpret_cast<const ModeClassifierConfigureMessage*>(message), audio_fs);
+		break;
 		
 	default:
 		break;
@@ -145,11 +176,13 @@ void NarrowbandFMAudio::configure(const NBFMConfigureMessage& message) {
 	decim_1.configure(message.decim_1_filter.taps, 131072);
 	channel_filter.configure(message.channel_filter.taps, message.channel_decimation);
 	demod.configure(demod_input_fs, message.deviation);
+	mode_classifier.set_deviation(message.deviation);
 	channel_filter_low_f = message.channel_filter.low_frequency_normalized * channel_filter_input_fs;
 	channel_filter_high_f = message.channel_filter.high_frequency_normalized * channel_filter_input_fs;
 	channel_filter_transition = message.channel_filter.transition_normalized * channel_filter_input_fs;
 	channel_spectrum.set_decimation_factor(1.0f);
-	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config, (float)message.squelch_level / 100.0);
+	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config);
+	squelch.set_sampling_rate(channel_filter_output_fs);
 	
 	hpf.configure(audio_24k_hpf_30hz_config);
 	ctcss_filter.configure(taps_64_lp_025_025.taps);
@@ -33,6 +33,8 @@
 
 #include "audio_output.hpp"
 #include "spectrum_collector.hpp"
+#include "dcs_decoder.hpp"
+#include "mode_classifier.hpp"
 
 #include <cstdint>
 
@@ -77,13 +79,19 @@ private:
 	int32_t channel_filter_high_f = 0;
 	int32_t channel_filter_transition = 0;
 	
-	// For CTCSS decoding
+	// For CTCSS and DCS decoding
+	static constexpr uint32_t ctcss_fs = 12000;
 	dsp::decimate::FIR64AndDecimateBy2Real ctcss_filter { };
 	IIRBiquadFilter hpf { };
+	DCSDecoder dcs { };
+
+	static constexpr uint32_t audio_fs = 24000;
+	ModeClassifier mode_classifier { };
 
 	dsp::demodulate::FM demod { };
 
 	AudioOutput audio_output { };
+	Squelch squelch { Squelch::Kind::FM };
 
 	SpectrumCollector channel_spectrum { };
 	
@@ -48,6 +48,17 @@ void POCSAGProcessor::execute(const buffer_c8_t& buffer) {
 	processDemodulatedSamples(audio.p, 16);
 	extractFrames();
 
+	flex_decoder.execute(audio, [this](const flex::Phase& phase) {
+		this->on_flex_phase(phase);
+	});
+}
+
+void POCSAGProcessor::on_flex_phase(const flex::Phase& phase) {
+	// If the M0 fell behind, drop the phase rather than block the baseband
+	if( flex_phases.in(phase) ) {
+		const FLEXPhaseMessage message { &flex_phases };
+		shared_memory.application_queue.push(message);
+	}
 }
 
 // ====================================================================
@@ -103,6 +114,7 @@ void POCSAGProcessor::configure() {
 
 	// Set up the frame extraction, limits of baud
 	setFrameExtractParams(demod_input_fs, 4000, 300, 32);
+	flex_decoder.reset();
 
 	// Mark the class as ready to accept data
 	configured = true;
@@ -33,6 +33,7 @@
 #include "dsp_demodulate.hpp"
 
 #include "pocsag_packet.hpp"
+#include "flex_decoder.hpp"
 
 #include "pocsag.hpp"
 #include "message.hpp"
@@ -171,7 +172,13 @@ private:
 	bool configured = false;
 	pocsag::POCSAGPacket packet { };
 
+	// FLEX runs on the same smoothed audio, a frame is too big for a message
+	FLEXDecoder flex_decoder { };
+	flex::Phase flex_phases_data[1 << FLEXPhaseMessage::fifo_k] { };
+	FLEXPhaseFIFO flex_phases { flex_phases_data, FLEXPhaseMessage::fifo_k };
+
 	void configure();
+	void on_flex_phase(const flex::Phase& phase);
 
 	// ----------------------------------------
 	// Frame extractraction methods and members
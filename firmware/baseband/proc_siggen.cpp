@@ -22,95 +22,220 @@
 
 #include "proc_siggen.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
+#include <cmath>
+#include <algorithm>
 
-void SigGenProcessor::execute(const buffer_c8_t& buffer) {
-	if (!configured) return;
-	
+complex8_t SigGenProcessor::carrier(const uint32_t carrier_phase) const {
+	const int32_t re = (dds::cosine_q15(carrier_phase) * amplitude + (1 << 22)) >> 23;
+	const int32_t im = (dds::sine_q15(carrier_phase) * amplitude + (1 << 22)) >> 23;
+	return { static_cast<int8_t>(re), static_cast<int8_t>(im) };
+}
+
+void SigGenProcessor::kernel_cw(const buffer_c8_t& buffer) {
+	const complex8_t value { static_cast<int8_t>((amplitude + 128) >> 8), 0 };
+	std::fill(buffer.p, buffer.p + buffer.count, value);
+}
+
+template<typename Waveform>
+void SigGenProcessor::kernel_fm(const buffer_c8_t& buffer, Waveform waveform) {
 	for (size_t i = 0; i < buffer.count; i++) {
+		// Modulating sample in Q15, full scale is fm_delta
+		const int32_t sample = waveform(tone_phase);
+		tone_phase += tone_delta;
 		
-		if (!sample_count && auto_off) {
-			configured = false;
-			txprogress_message.done = true;
-			shared_memory.application_queue.push(txprogress_message);
-		} else
-			sample_count--;
+		buffer.p[i] = carrier(phase);
+		phase += static_cast<uint32_t>((static_cast<int64_t>(sample) * fm_delta) >> 15);
+	}
+}
+
+uint32_t SigGenProcessor::sweep_delta() const {
+	if (shape == SweepLinear)
+		return static_cast<uint32_t>((sweep_start_q16 + sweep_step_q16 * sweep_pos) >> 16);
+	else
+		return static_cast<uint32_t>(sweep_log_start * expf(sweep_log_rate * sweep_pos));
+}
+
+void SigGenProcessor::kernel_sweep(const buffer_c8_t& buffer) {
+	// The frequency is updated every sweep_block samples, the phase stays continuous
+	for (size_t i = 0; i < buffer.count; i += sweep_block) {
+		const uint32_t delta = sweep_delta();
+		const size_t end = std::min(i + sweep_block, buffer.count);
 		
-		if (tone_shape == 0) {
-			// CW
-			re = 127;
-			im = 0;
-		} else {
-			
-			if (tone_shape == 1) {
-				// Sine
-				sample = (sine_table_i8[(tone_phase & 0xFF000000) >> 24]);
-			} else if (tone_shape == 2) {
-				// Tri
-				int8_t a = (tone_phase & 0xFF000000) >> 24;
-				sample = (a & 0x80) ? ((a << 1) ^ 0xFF) - 0x80 : (a << 1) + 0x80;
-			} else if (tone_shape == 3) {
-				// Saw up
-				sample = ((tone_phase & 0xFF000000) >> 24);
-			} else if (tone_shape == 4) {
-				// Saw down
-				sample = ((tone_phase & 0xFF000000) >> 24) ^ 0xFF;
-			} else if (tone_shape == 5) {
-				// Square
-				sample = (((tone_phase & 0xFF000000) >> 24) & 0x80) ? 127 : -128;
-			} else if (tone_shape == 6) {
-				// Noise
-				sample = (lfsr & 0xFF000000) >> 24;
-				feedback = ((lfsr >> 31) ^ (lfsr >> 29) ^ (lfsr >> 15) ^ (lfsr >> 11)) & 1;
-				lfsr = (lfsr << 1) | feedback;
-				if (!lfsr) lfsr = 0x1337;				// Shouldn't do this :(
-			}
-			
-			tone_phase += tone_delta;
-			
-			// Do FM
-			delta = sample * fm_delta;
-			
+		for (size_t j = i; j < end; j++) {
+			buffer.p[j] = carrier(phase);
 			phase += delta;
-			sphase = phase + (64 << 24);
+		}
+		
+		sweep_pos += end - i;
+		if (sweep_pos >= sweep_period)
+			sweep_pos = 0;
+	}
+}
 
-			re = (sine_table_i8[(sphase & 0xFF000000) >> 24]);
-			im = (sine_table_i8[(phase & 0xFF000000) >> 24]);
+void SigGenProcessor::kernel_two_tone(const buffer_c8_t& buffer) {
+	// Two tones of half amplitude, tone_delta apart and centered on the carrier
+	const uint32_t half_delta = tone_delta >> 1;
+	
+	for (size_t i = 0; i < buffer.count; i++) {
+		const int32_t re = ((dds::cosine_q15(phase) + dds::cosine_q15(phase_b)) * amplitude + (1 << 23)) >> 24;
+		const int32_t im = ((dds::sine_q15(phase) + dds::sine_q15(phase_b)) * amplitude + (1 << 23)) >> 24;
+		buffer.p[i] = { static_cast<int8_t>(re), static_cast<int8_t>(im) };
+		
+		phase += half_delta;
+		phase_b -= half_delta;
+	}
+}
+
+void SigGenProcessor::add_noise(const buffer_c8_t& buffer) {
+	for (size_t i = 0; i < buffer.count; i++) {
+		const int32_t noise_re = (static_cast<int64_t>(random.gaussian()) * noise_gain) >> 24;
+		const int32_t noise_im = (static_cast<int64_t>(random.gaussian()) * noise_gain) >> 24;
+		
+		// The signal is scaled down so that this never clips, clamp anyway
+		const int32_t re = buffer.p[i].real() + ((noise_re + 128) >> 8);
+		const int32_t im = buffer.p[i].imag() + ((noise_im + 128) >> 8);
+		buffer.p[i] = {
+			static_cast<int8_t>(std::max<int32_t>(std::min<int32_t>(re, 127), -127)),
+			static_cast<int8_t>(std::max<int32_t>(std::min<int32_t>(im, 127), -127))
+		};
+	}
+}
+
+void SigGenProcessor::execute(const buffer_c8_t& buffer) {
+	if (!configured) return;
+	
+	bool done = false;
+	size_t count = buffer.count;
+	
+	if (auto_off) {
+		if (sample_count <= count) {
+			count = sample_count;
+			done = true;
 		}
+		sample_count -= count;
+	}
+	
+	const buffer_c8_t block { buffer.p, count, buffer.sampling_rate };
+	
+	// One kernel per block, no per-sample branching on the shape
+	switch (shape) {
+		case Sine:
+			kernel_fm(block, [](const uint32_t p) { return dds::sine_q15(p); });
+			break;
+		
+		case Triangle:
+			kernel_fm(block, [](const uint32_t p) {
+				const int32_t u = p >> 15;
+				return (u < 65536) ? (u - 32768) : (98303 - u);
+			});
+			break;
+		
+		case SawUp:
+			kernel_fm(block, [](const uint32_t p) { return static_cast<int32_t>(p >> 16) - 32768; });
+			break;
+		
+		case SawDown:
+			kernel_fm(block, [](const uint32_t p) { return 32767 - static_cast<int32_t>(p >> 16); });
+			break;
+		
+		case Square:
+			kernel_fm(block, [](const uint32_t p) { return (p & 0x80000000) ? 32767 : -32767; });
+			break;
+		
+		case Noise:
+			kernel_fm(block, [this](const uint32_t) { return static_cast<int16_t>(random()); });
+			break;
+		
+		case SweepLinear:
+		case SweepLog:
+			kernel_sweep(block);
+			break;
+		
+		case TwoTone:
+			kernel_two_tone(block);
+			break;
+		
+		case CW:
+		default:
+			kernel_cw(block);
+			break;
+	}
+	
+	if (awgn)
+		add_noise(block);
+	
+	if (done) {
+		std::fill(buffer.p + count, buffer.p + buffer.count, complex8_t { 0, 0 });
+		configured = false;
+		txprogress_message.done = true;
+		shared_memory.application_queue.push(txprogress_message);
+	}
+}
 
-		buffer.p[i] = {re, im};
+void SigGenProcessor::setup_sweep() {
+	constexpr float delta_per_hz = 4294967296.0f / baseband_fs;
+	const int64_t span = static_cast<int64_t>(bw * delta_per_hz);
+	
+	// Linear: across the channel, -bw/2 to +bw/2
+	sweep_start_q16 = -(span / 2) * 65536;
+	sweep_step_q16 = (span * 65536) / sweep_period;
+	
+	// Log: from the tone frequency to bw above the carrier, either way
+	sweep_log_start = std::max(tone_delta, static_cast<uint32_t>(delta_per_hz));
+	sweep_log_rate = logf(std::max<float>(span, delta_per_hz) / sweep_log_start) / sweep_period;
+	
+	sweep_pos = 0;
+}
+
+void SigGenProcessor::configure(const SigGenConfigMessage& message) {
+	if (message.duration) {
+		sample_count = message.duration;
+		auto_off = true;
+	} else
+		auto_off = false;
+	
+	bw = message.bw;
+	fm_delta = bw * (4294967296.0f / baseband_fs);
+	shape = message.shape;
+	sweep_period = std::max<uint32_t>(message.sweep_period, 1);
+	setup_sweep();
+	
+	awgn = message.awgn;
+	if (awgn) {
+		// Noise per component for the set SNR, relative to the peak envelope. The
+		// signal is backed off so that signal + noise peaks fit in 8 bits.
+		const float signal_power = (shape == TwoTone) ? 0.5f : 1.0f;
+		const float ratio = sqrtf(signal_power / (2.0f * powf(10.0f, message.snr_db / 10.0f)));
+		const float peak = 127.0f / (1.0f + dds::Random::gaussian_peak * ratio);
+		amplitude = peak * 256.0f;
+		noise_gain = ratio * peak * 256.0f / dds::Random::gaussian_sigma * 16777216.0f;
+	} else {
+		amplitude = 127 << 8;
+		noise_gain = 0;
 	}
-};
+	
+	txprogress_message.done = false;
+	configured = true;
+}
 
 void SigGenProcessor::on_message(const Message* const msg) {
-	const auto message = *reinterpret_cast<const SigGenConfigMessage*>(msg);
-	
 	switch(msg->id) {
-		case Message::ID::SigGenConfig:
+		case Message::ID::SigGenConfig: {
+			const auto& message = *reinterpret_cast<const SigGenConfigMessage*>(msg);
 			if (!message.bw) {
 				configured = false;
 				return;
 			}
-			
-			if (message.duration) {
-				sample_count = message.duration;
-				auto_off = true;
-			} else
-				auto_off = false;
-			
-			fm_delta = message.bw * (0xFFFFFFULL / 1536000);
-			tone_shape = message.shape;
-			
-			lfsr = 0x54DF0119;
-
-			configured = true;
+			configure(message);
 			break;
+		}
 		
 		case Message::ID::SigGenTone:
 			tone_delta = reinterpret_cast<const SigGenToneMessage*>(msg)->tone_delta;
+			setup_sweep();
 			break;
 
 		default:
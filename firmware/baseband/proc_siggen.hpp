@@ -26,6 +26,7 @@
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 #include "portapack_shared_memory.hpp"
+#include "dds.hpp"
 
 class SigGenProcessor : public BasebandProcessor {
 public:
@@ -34,19 +35,64 @@ public:
 	void on_message(const Message* const msg) override;
 
 private:
+	// Same order as the shapes in SigGenView
+	enum Shape : uint32_t {
+		CW = 0,
+		Sine,
+		Triangle,
+		SawUp,
+		SawDown,
+		Square,
+		Noise,
+		SweepLinear,
+		SweepLog,
+		TwoTone
+	};
+	
+	static constexpr uint32_t baseband_fs = 1536000;
+	static constexpr size_t sweep_block = 16;	// Samples per sweep frequency update
+	
 	bool configured { false };
 	
-	BasebandThread baseband_thread { 1536000, this, NORMALPRIO + 20, baseband::Direction::Transmit };
+	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
+	
+	uint32_t shape { CW };
+	uint32_t tone_delta { 0 };
+	uint32_t fm_delta { 0 };
+	uint32_t sample_count { 0 };
+	bool auto_off { false };
+	uint32_t tone_phase { 0 };
+	uint32_t phase { 0 };
+	uint32_t phase_b { 0 };
+	
+	int32_t amplitude { 127 << 8 };		// Q8
 	
-	uint32_t tone_delta { 0 }, fm_delta { };
-	uint32_t lfsr { }, feedback { }, tone_shape { };
-    uint32_t sample_count { 0 };
-    bool auto_off { };
-	uint32_t tone_phase { 0 }, phase { 0 }, delta { 0 }, sphase { 0 };
-	int8_t sample { 0 };
-	int8_t re { 0 }, im { 0 };
+	uint32_t bw { 0 };
+	uint32_t sweep_pos { 0 };
+	uint32_t sweep_period { 1 };
+	int64_t sweep_start_q16 { 0 };
+	int64_t sweep_step_q16 { 0 };
+	float sweep_log_start { 0 };
+	float sweep_log_rate { 0 };
+	
+	bool awgn { false };
+	int32_t noise_gain { 0 };			// Q24, Gaussian units to Q8 output
+	dds::Random random { 0 };
 	
 	TXProgressMessage txprogress_message { };
+	
+	complex8_t carrier(const uint32_t carrier_phase) const;
+	
+	void kernel_cw(const buffer_c8_t& buffer);
+	template<typename Waveform>
+	void kernel_fm(const buffer_c8_t& buffer, Waveform waveform);
+	void kernel_sweep(const buffer_c8_t& buffer);
+	void kernel_two_tone(const buffer_c8_t& buffer);
+	void add_noise(const buffer_c8_t& buffer);
+	
+	uint32_t sweep_delta() const;
+	void setup_sweep();
+	void configure(const SigGenConfigMessage& message);
 };
 
 #endif
@@ -75,7 +75,7 @@
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 #include "rssi_thread.hpp"
-#include "proc_ais.hpp"
+#include "ais_baseband.hpp"
 
 #include "channel_decimator.hpp"
 #include "matched_filter.hpp"
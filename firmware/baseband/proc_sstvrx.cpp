@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "proc_sstvrx.hpp"
+
+#include "portapack_shared_memory.hpp"
+#include "event_m4.hpp"
+
+#include <cstdint>
+
+void SSTVRxProcessor::execute(const buffer_c8_t& buffer) {
+	if( !configured ) {
+		return;
+	}
+
+	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
+	const auto channel_out = channel_filter.execute(decim_1_out, dst_buffer);
+
+	feed_channel_stats(channel_out);
+
+	auto audio = demod.execute(channel_out, audio_buffer);
+
+	decoder.execute(audio,
+		[this](const SSTVRxLine& line) {
+			this->on_line(line);
+		},
+		[](const SSTVRxStatusMessage& message) {
+			shared_memory.application_queue.push(message);
+		}
+	);
+
+	audio_output.write(audio);
+}
+
+void SSTVRxProcessor::on_line(const SSTVRxLine& line) {
+	// If the M0 fell behind, drop the row rather than block the baseband
+	if( lines.in(line) ) {
+		const SSTVRxLineMessage message { &lines };
+		shared_memory.application_queue.push(message);
+	}
+}
+
+void SSTVRxProcessor::on_message(const Message* const message) {
+	switch(message->id) {
+	case Message::ID::NBFMConfigure:
+		configure(*reinterpret_cast<const NBFMConfigureMessage*>(message));
+		break;
+
+	default:
+		break;
+	}
+}
+
+void SSTVRxProcessor::configure(const NBFMConfigureMessage& message) {
+	constexpr size_t decim_0_input_fs = baseband_fs;
+	constexpr size_t decim_0_output_fs = decim_0_input_fs / decim_0.decimation_factor;
+
+	constexpr size_t decim_1_input_fs = decim_0_output_fs;
+	constexpr size_t decim_1_output_fs = decim_1_input_fs / decim_1.decimation_factor;
+
+	constexpr size_t channel_filter_input_fs = decim_1_output_fs;
+	const size_t channel_filter_output_fs = channel_filter_input_fs / message.channel_decimation;
+
+	const size_t demod_input_fs = channel_filter_output_fs;
+
+	decim_0.configure(message.decim_0_filter.taps, 33554432);
+	decim_1.configure(message.decim_1_filter.taps, 131072);
+	channel_filter.configure(message.channel_filter.taps, message.channel_decimation);
+	demod.configure(demod_input_fs, message.deviation);
+	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config);
+
+	decoder.reset();
+
+	configured = true;
+}
+
+int main() {
+	EventDispatcher event_dispatcher { std::make_unique<SSTVRxProcessor>() };
+	event_dispatcher.run();
+	return 0;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
  *
  * This file is part of PortaPack.
  *
@@ -19,37 +19,36 @@
  * Boston, MA 02110-1301, USA.
  */
 
-#ifndef __PROC_AIS_H__
-#define __PROC_AIS_H__
+
+#ifndef __PROC_SSTVRX_H__
+#define __PROC_SSTVRX_H__
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 #include "rssi_thread.hpp"
 
-#include "channel_decimator.hpp"
-#include "matched_filter.hpp"
+#include "dsp_types.hpp"
+#include "dsp_decimate.hpp"
+#include "dsp_demodulate.hpp"
 
-#include "clock_recovery.hpp"
-#include "symbol_coding.hpp"
-#include "packet_builder.hpp"
-#include "baseband_packet.hpp"
+#include "audio_output.hpp"
+#include "sstv_decoder.hpp"
 
+#include "fifo.hpp"
 #include "message.hpp"
 
-#include <cstdint>
-#include <cstddef>
-#include <bitset>
-
-#include "ais_baseband.hpp"
-
-class AISProcessor : public BasebandProcessor {
+/* Narrowband FM down to 24kHz audio, which goes to the headphones and the
+ * SSTV decoder. Rows are too big for a message, they go to the M0 through a
+ * FIFO.
+ */
+class SSTVRxProcessor : public BasebandProcessor {
 public:
-	AISProcessor();
-
 	void execute(const buffer_c8_t& buffer) override;
 
+	void on_message(const Message* const message) override;
+
 private:
-	static constexpr size_t baseband_fs = 2457600;
+	static constexpr size_t baseband_fs = 3072000;
 
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
@@ -59,27 +58,26 @@ private:
 		dst.data(),
 		dst.size()
 	};
+	std::array<float, 32> audio { };
+	const buffer_f32_t audio_buffer {
+		audio.data(),
+		audio.size()
+	};
 
 	dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };
 	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
-	dsp::matched_filter::MatchedFilter mf { baseband::ais::square_taps_38k4_1t_p, 2 };
+	dsp::decimate::FIRAndDecimateComplex channel_filter { };
+	dsp::demodulate::FM demod { };
 
-	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery {
-		19200, 9600, { 0.0555f },
-		[this](const float symbol) { this->consume_symbol(symbol); }
-	};
-	symbol_coding::NRZIDecoder nrzi_decode { };
-	PacketBuilder<BitPattern, BitPattern, BitPattern> packet_builder {
-		{ 0b0101010101111110, 16, 1 },
-		{ 0b111110, 6 },
-		{ 0b01111110, 8 },
-		[this](const baseband::Packet& packet) {
-			this->payload_handler(packet);
-		}
-	};
+	AudioOutput audio_output { };
+
+	SSTVDecoder decoder { };
+	SSTVRxLine lines_data[1 << SSTVRxLineMessage::fifo_k] { };
+	SSTVRxLineFIFO lines { lines_data, SSTVRxLineMessage::fifo_k };
 
-	void consume_symbol(const float symbol);
-	void payload_handler(const baseband::Packet& packet);
+	bool configured { false };
+	void configure(const NBFMConfigureMessage& message);
+	void on_line(const SSTVRxLine& line);
 };
 
-#endif/*__PROC_AIS_H__*/
+#endif/*__PROC_SSTVRX_H__*/
@@ -21,136 +21,189 @@
  */
 
 #include "proc_tones.hpp"
-#include "sine_table_int8.hpp"
+#include "dds.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
+#include <algorithm>
+
+bool TonesProcessor::is_silent(const ToneCommand& c) const {
+	return !c.duration || (!c.amplitude_a && !c.amplitude_b);
+}
+
+bool TonesProcessor::next_command() {
+	auto& ring = shared_memory.bb_data.tones;
+	const uint32_t read_index = ring.read_index;
+	const uint32_t write_index = ring.write_index;
+	
+	if (read_index == write_index)
+		return false;
+	
+	__DMB();		// Commands up to write_index are complete
+	command = ring.commands[read_index % ToneRing::size];
+	__DMB();		// Done with the slot before handing it back
+	ring.read_index = read_index + 1;
+	
+	if (is_silent(command)) {
+		tone_count = 0;
+		silence_count = command.duration + command.silence;
+	} else {
+		tone_count = command.duration;
+		silence_count = command.silence;
+		
+		// Ramp down only if silence follows. If the next command isn't there yet
+		// it's an underrun, that's silence too.
+		const bool next_silent = (read_index + 1 == write_index) ||
+			is_silent(ring.commands[(read_index + 1) % ToneRing::size]);
+		ramp_out = command.silence || next_silent;
+		
+		ramp_in = silent;
+		silent = false;
+		ramp_length = std::min(command.ramp, command.duration / 2);
+		ramp_delta = ramp_length ? (0x80000000U / ramp_length) : 0;
+	}
+	
+	// Ask for more while there's still half of the ring to play
+	const uint32_t level = write_index - (read_index + 1);
+	if ((level <= ToneRing::size / 2) && !ring.closed && !fill_requested) {
+		fill_requested = true;
+		shared_memory.application_queue.push(sig_message);
+	}
+	
+	return true;
+}
+
+int32_t TonesProcessor::ramp_gain() const {
+	// Raised cosine at the ends of the tone, Q15
+	const uint32_t position = command.duration - tone_count;
+	uint32_t ramp_position = ramp_length;
+	
+	if (ramp_in && (position < ramp_length))
+		ramp_position = position;
+	else if (ramp_out && (tone_count <= ramp_length))
+		ramp_position = tone_count;
+	
+	if (ramp_position >= ramp_length)
+		return 32768;
+	
+	return (32768 - dds::cosine_q15(ramp_position * ramp_delta)) >> 1;
+}
+
+void TonesProcessor::report_progress(const bool done) {
+	txprogress_message.progress = commands_done;
+	txprogress_message.done = done;
+	shared_memory.application_queue.push(txprogress_message);
+	progress_count = 0;
+}
 
 // This is called at 1536000/2048 = 750Hz
 void TonesProcessor::execute(const buffer_c8_t& buffer) {
 	
 	if (!configured) return;
 	
-	ai = 0;
+	const uint32_t write_index = shared_memory.bb_data.tones.write_index;
+	if (fill_requested && ((write_index - shared_memory.bb_data.tones.read_index) > ToneRing::size / 2))
+		fill_requested = false;
 	
 	for (size_t i = 0; i < buffer.count; i++) {
+		int32_t tone_sample = 0;	// Q15
 		
-		// Tone generation at full samplerate
-		if (silence_count) {
-			// Just occupy channel with carrier
-			silence_count--;
-			if (!silence_count) {
-				sample_count = 0;
-				tone_a_phase = 0;
-				tone_b_phase = 0;
-			}
-			tone_sample = 0;
-			re = 0;
-			im = 0;
-		} else {
-			if (!sample_count) {
-				digit = shared_memory.bb_data.tones_data.message[digit_pos];
-				if (digit_pos >= message_length) {
-					configured = false;
-					txprogress_message.done = true;
-					shared_memory.application_queue.push(txprogress_message);
-					return;
-				} else {
-					txprogress_message.progress = digit_pos;	// Inform UI about progress
-					txprogress_message.done = false;
-					shared_memory.application_queue.push(txprogress_message);
-				}
-				
-				digit_pos++;
-				
-				if (digit >= 32) {	//  || (tone_deltas[digit] == 0)
-					sample_count = shared_memory.bb_data.tones_data.silence;
-				} else {
-					if (!dual_tone) {
-						tone_a_delta = tone_deltas[digit];
-					} else {
-						tone_a_delta = tone_deltas[digit << 1];
-						tone_b_delta = tone_deltas[(digit << 1) + 1];
-					}
-					sample_count = tone_durations[digit];
-				}
-			} else {
-				sample_count--;
+		if (!tone_count && !silence_count) {
+			if (active) {
+				active = false;
+				commands_done++;
 			}
 			
-			// Ugly
-			if ((digit >= 32) || (tone_deltas[digit] == 0)) {
-				tone_sample = 0;
-			} else {
-				if (!dual_tone) {
-					tone_sample = (sine_table_i8[(tone_a_phase & 0xFF000000U) >> 24]);
-					tone_a_phase += tone_a_delta;
-				} else {
-					tone_sample = sine_table_i8[(tone_a_phase & 0xFF000000U) >> 24] >> 1;
-					tone_sample += sine_table_i8[(tone_b_phase & 0xFF000000U) >> 24] >> 1;
-					
-					tone_a_phase += tone_a_delta;
-					tone_b_phase += tone_b_delta;
-				}
+			if (next_command()) {
+				active = true;
+			} else if (shared_memory.bb_data.tones.closed) {
+				std::fill(buffer.p + i, buffer.p + buffer.count, complex8_t { 0, 0 });
+				configured = false;
+				report_progress(true);
+				return;
 			}
+			// Else underrun, send carrier until the M0 catches up
+		}
 		
-			// FM
-			delta = tone_sample * fm_delta;
+		if (tone_count) {
+			const int32_t a = (dds::sine_q15(tone_a_phase) * command.amplitude_a) >> 15;
+			const int32_t b = (dds::sine_q15(tone_b_phase) * command.amplitude_b) >> 15;
+			tone_sample = ((a + b) * ramp_gain()) >> 15;
 			
-			phase += delta;
-			sphase = phase + (64 << 24);
-
-			re = (sine_table_i8[(sphase & 0xFF000000U) >> 24]);
-			im = (sine_table_i8[(phase & 0xFF000000U) >> 24]);
+			tone_a_phase += command.delta_a;
+			tone_b_phase += command.delta_b;
+			
+			if (!--tone_count)
+				silent = (silence_count != 0) || ramp_out;
+		} else if (silence_count) {
+			silence_count--;
+			silent = true;
+		} else {
+			silent = true;
 		}
 		
-		// Headphone output sample generation: 1536000/24000 = 64
+		// FM
+		phase += static_cast<uint32_t>((static_cast<int64_t>(tone_sample) * fm_delta) >> 15);
+		buffer.p[i] = {
+			static_cast<int8_t>((dds::cosine_q15(phase) * 127) >> 15),
+			static_cast<int8_t>((dds::sine_q15(phase) * 127) >> 15)
+		};
+		
+		// Headphone output, boxcar averaged down to 24kHz
 		if (audio_out) {
-			if (!as) {
-				as = 64;
-				audio_buffer.p[ai++] = tone_sample * 128;
-			} else {
-				as--;
+			audio_sum += tone_sample;
+			if (++audio_count == audio_decimation) {
+				audio_buffer.p[audio_index++] = audio_sum / static_cast<int32_t>(audio_decimation);
+				audio_sum = 0;
+				audio_count = 0;
 			}
 		}
-		
-		buffer.p[i] = {re, im};
 	}
 	
-	if (audio_out) audio_output.write(audio_buffer);
+	if (audio_out && (audio_index == audio.size())) {
+		audio_output.write(audio_buffer);
+		audio_index = 0;
+	}
+	
+	progress_count += buffer.count;
+	if ((progress_count >= progress_interval) && (commands_done != txprogress_message.progress))
+		report_progress(false);
 }
 
 void TonesProcessor::on_message(const Message* const p) {
 	const auto message = *reinterpret_cast<const TonesConfigureMessage*>(p);
 	if (message.id == Message::ID::TonesConfigure) {
-		message_length = message.tone_count;
-		
-		if (message_length) {
+		if (message.run) {
+			// Drop what's left of a previous sequence. The baseband thread is
+			// waiting for a buffer while this runs, so it can't be mid command.
+			auto& ring = shared_memory.bb_data.tones;
+			ring.read_index = ring.write_index;
+			
 			silence_count = message.pre_silence;		// In samples
-			for (uint8_t c = 0; c < 32; c++) {
-				tone_deltas[c] = shared_memory.bb_data.tones_data.tone_defs[c].delta;
-				tone_durations[c] = shared_memory.bb_data.tones_data.tone_defs[c].duration;
-			}
-			fm_delta = message.fm_delta * (0xFFFFFFULL / 1536000);
+			tone_count = 0;
+			fm_delta = message.fm_delta * fm_delta_scale;
 			audio_out = message.audio_out;
-			dual_tone = message.dual_tone;
 			
 			if (audio_out) audio_output.configure(false);
 			
+			active = false;
+			silent = true;
+			commands_done = 0;
+			progress_count = 0;
+			fill_requested = false;
 			txprogress_message.done = false;
 			txprogress_message.progress = 0;
 			
-			digit_pos = 0;
-			sample_count = 0;
 			tone_a_phase = 0;
 			tone_b_phase = 0;
-			as = 0;
+			audio_sum = 0;
+			audio_count = 0;
+			audio_index = 0;
 			
 			configured = true;
 		} else {
 			configured = false;
-			txprogress_message.done = true;
-			shared_memory.application_queue.push(txprogress_message);
+			report_progress(true);
 		}
 	}
 }
@@ -35,35 +35,54 @@ public:
 	void on_message(const Message* const p) override;
 
 private:
+	static constexpr uint32_t baseband_fs = 1536000;
+	static constexpr size_t audio_decimation = 64;					// 24kHz monitor
+	static constexpr uint32_t progress_interval = baseband_fs / 20;	// Max UI updates rate
+	// Phase step per unit of fm_delta at full scale, as the int8 synthesis had
+	// it: about 0.45Hz of deviation per unit. The callers' bandwidths rely on it.
+	static constexpr uint32_t fm_delta_scale = 127 * (0xFFFFFF / baseband_fs);
+	
 	bool configured = false;
 	
-	BasebandThread baseband_thread { 1536000, this, NORMALPRIO + 20, baseband::Direction::Transmit };
+	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 	
-	std::array<int16_t, 32> audio { };		// 2048/64
+	std::array<int16_t, 2048 / audio_decimation> audio { };
 	const buffer_s16_t audio_buffer {
 		(int16_t*)audio.data(),
 		sizeof(audio) / sizeof(int16_t)
 	};
-
-	uint32_t tone_deltas[32];
-	uint32_t tone_durations[32];
 	
-	bool audio_out { false };
-	bool dual_tone { false };
-	uint32_t fm_delta { 0 };
+	ToneCommand command { };
+	bool active { false };			// command is being sent
+	bool silent { true };			// Last thing sent was silence, next tone ramps in
+	bool ramp_in { false };
+	bool ramp_out { false };
+	uint32_t tone_count { 0 };		// Samples of tone left
+	uint32_t silence_count { 0 };
+	uint32_t ramp_length { 0 };
+	uint32_t ramp_delta { 0 };
+	
 	uint32_t tone_a_phase { 0 }, tone_b_phase { 0 };
-	uint32_t tone_a_delta { 0 }, tone_b_delta { 0 };
-    uint8_t digit_pos { 0 };
-    uint8_t digit { 0 };
-    uint32_t silence_count { 0 }, sample_count { 0 };
-    uint32_t message_length { 0 };
-	uint32_t phase { 0 }, sphase { 0 };
-	int32_t tone_sample { 0 }, delta { 0 };
-	int8_t re { 0 }, im { 0 };
-	uint8_t as { 0 }, ai { 0 };
+	uint32_t fm_delta { 0 };
+	uint32_t phase { 0 };
+	
+	bool audio_out { false };
+	int32_t audio_sum { 0 };
+	size_t audio_count { 0 };
+	size_t audio_index { 0 };
+	
+	uint32_t commands_done { 0 };
+	uint32_t progress_count { 0 };
+	bool fill_requested { false };
 	
 	TXProgressMessage txprogress_message { };
+	RequestSignalMessage sig_message { RequestSignalMessage::Signal::FillRequest };
 	AudioOutput audio_output { };
+	
+	bool next_command();
+	bool is_silent(const ToneCommand& c) const;
+	int32_t ramp_gain() const;
+	void report_progress(const bool done);
 };
 
 #endif
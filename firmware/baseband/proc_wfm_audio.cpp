@@ -40,6 +40,11 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 	// TODO: Feed channel_stats post-decimation data?
 	feed_channel_stats(channel);
 
+	squelch.execute(channel, [](const SquelchEventMessage& message) {
+		shared_memory.application_queue.push(message);
+	});
+	audio_output.set_squelch_open(squelch.is_open());
+
 	spectrum_samples += channel.count;
 	if( spectrum_samples >= spectrum_interval_samples ) {
 		spectrum_samples -= spectrum_interval_samples;
@@ -81,29 +86,31 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 	
 	switch (audio_spectrum_state) {
 		case FEED:
-			// Convert audio to "complex" just so the FFT can be done :/
-			for (size_t i = 0; i < 64; i++) {
-				complex_audio[i] = { (int16_t)(work_audio_buffer.p[i] / 32), (int16_t)0 };
-			}
 			audio_spectrum_decimator.feed(
-				complex_audio_buffer,
-				[this](const buffer_c16_t& data) {
+				audio_2fs,
+				[this](const buffer_s16_t& data) {
 					this->post_message(data);
 				}
 			);
 			break;
 		case FFT:
 			// Spread the FFT workload in time to avoid making the audio skip
-			// "8" comes from the log2() of the size of audio_spectrum: log2(256) = 8
-			if (fft_step < 8) {
+			// "7" comes from the log2() of the size of audio_spectrum: log2(128) = 7
+			// The real FFT split step takes one more slot, about the cost of a stage
+			if (fft_step < 7) {
 				fft_c_preswapped(audio_spectrum, fft_step, fft_step + 1);
 				fft_step++;
+			} else if (fft_step == 7) {
+				fft_r_split(audio_spectrum);
+				fft_step++;
 			} else {
 				const size_t spectrum_end = spectrum.db.size();
 				for(size_t i=0; i<spectrum_end; i++) {
 					//const auto corrected_sample = spectrum_window_hamming_3(audio_spectrum, i);
-					const auto corrected_sample = audio_spectrum[i];
-					const auto mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
+					// Bin 0 also carries the Nyquist bin in its imaginary part
+					const auto corrected_sample = (i == 0) ? std::complex<float> { audio_spectrum[0].real(), 0.0f } : audio_spectrum[i];
+					// Audio used to be scaled down by 32 before the FFT, keep the same display level
+					const auto mag2 = magnitude_squared(corrected_sample * (1.0f / (32768.0f * 32.0f)));
 					const float db = mag2_to_dbv_norm(mag2);
 					constexpr float mag_scale = 5.0f;
 					const unsigned int v = (db * mag_scale) + 255.0f;
@@ -128,9 +135,9 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 	
 }
 
-void WidebandFMAudio::post_message(const buffer_c16_t& data) {
+void WidebandFMAudio::post_message(const buffer_s16_t& data) {
 	// This is called when audio_spectrum_decimator is filled up to 256 samples
-	fft_swap(data, audio_spectrum);
+	fft_swap_real(data, audio_spectrum);
 	audio_spectrum_state = FFT;
 	fft_step = 0;
 }
@@ -146,6 +153,10 @@ void WidebandFMAudio::on_message(const Message* const message) {
 		configure(*reinterpret_cast<const WFMConfigureMessage*>(message));
 		break;
 
+	case Message::ID::SquelchConfigure:
+		squelch.configure(*reinterpret_cast<const SquelchConfigureMessage*>(message));
+		break;
+
 	case Message::ID::CaptureConfig:
 		capture_config(*reinterpret_cast<const CaptureConfigMessage*>(message));
 		break;
@@ -172,9 +183,10 @@ void WidebandFMAudio::configure(const WFMConfigureMessage& message) {
 	channel_filter_low_f = message.decim_1_filter.low_frequency_normalized * decim_1_input_fs;
 	channel_filter_high_f = message.decim_1_filter.high_frequency_normalized * decim_1_input_fs;
 	channel_filter_transition = message.decim_1_filter.transition_normalized * decim_1_input_fs;
-	demod.configure(demod_input_fs, message.deviation);
+	demod.configure(demod_input_fs, message.deviation, dsp::demodulate::Discriminator::Table);
 	audio_filter.configure(message.audio_filter.taps);
 	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config);
+	squelch.set_sampling_rate(demod_input_fs);
 
 	channel_spectrum.set_decimation_factor(1);
 
@@ -59,12 +59,6 @@ private:
 		sizeof(dst) / sizeof(int16_t)
 	};
 
-	std::array<complex16_t, 64> complex_audio { };
-	const buffer_c16_t complex_audio_buffer {
-		complex_audio.data(),
-		complex_audio.size()
-	};
-	
 	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
 	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
 	int32_t channel_filter_low_f = 0;
@@ -77,10 +71,12 @@ private:
 	dsp::decimate::FIR64AndDecimateBy2Real audio_filter { };
 
 	AudioOutput audio_output { };
+	Squelch squelch { Squelch::Kind::FM };
 	
 	// For fs=96kHz FFT streaming
-	BlockDecimator<complex16_t, 256> audio_spectrum_decimator { 1 };
-	std::array<std::complex<float>, 256> audio_spectrum { };
+	// 256 real samples are packed into a 128-point complex FFT (see fft_r_split)
+	BlockDecimator<int16_t, 256> audio_spectrum_decimator { 1 };
+	std::array<std::complex<float>, 128> audio_spectrum { };
 	uint32_t audio_spectrum_timer { 0 };
 	enum AudioSpectrumState {
 		IDLE = 0,
@@ -98,7 +94,7 @@ private:
 	bool configured { false };
 	void configure(const WFMConfigureMessage& message);
 	void capture_config(const CaptureConfigMessage& message);
-	void post_message(const buffer_c16_t& data);
+	void post_message(const buffer_s16_t& data);
 };
 
 #endif/*__PROC_WFM_AUDIO_H__*/
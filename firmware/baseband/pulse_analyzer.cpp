@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "pulse_analyzer.hpp"
+
+#include "pulse_slicer.hpp"
+
+#include <algorithm>
+
+namespace ism {
+
+namespace {
+
+bool near(const uint32_t a, const uint32_t b) {
+	const uint32_t d = (a > b) ? (a - b) : (b - a);
+	return d <= (std::max(a, b) / 4);
+}
+
+/* True if width is close to a whole multiple (1..max_multiple) of unit */
+bool is_multiple(const uint32_t width, const uint32_t unit, const uint32_t max_multiple) {
+	const uint32_t n = (width + unit / 2) / unit;
+	return (n >= 1) && (n <= max_multiple) && near(width, n * unit);
+}
+
+} /* namespace */
+
+/* WidthHistogram *********************************************************/
+
+void WidthHistogram::clear() {
+	count.fill(0);
+	sum_us.fill(0);
+	total_ = 0;
+}
+
+void WidthHistogram::add(const uint32_t width_us) {
+	const size_t bin = width_us / bin_us;
+	if( (bin < bins) && (count[bin] < 0xffff) ) {
+		count[bin]++;
+		sum_us[bin] += width_us;
+		total_++;
+	}
+}
+
+size_t WidthHistogram::clusters(clusters_t& out) const {
+	std::array<Cluster, bins / 2> found;
+	size_t found_count = 0;
+
+	// A cluster is a run of populated bins, bridging single empty bins
+	size_t i = 0;
+	while( i < bins ) {
+		if( count[i] == 0 ) {
+			i++;
+			continue;
+		}
+
+		uint32_t n = 0;
+		uint32_t sum = 0;
+		while( (i < bins) && ((count[i] != 0) || ((i + 1 < bins) && (count[i + 1] != 0))) ) {
+			n += count[i];
+			sum += sum_us[i];
+			i++;
+		}
+
+		if( (found_count < found.size()) && ((n * 16) >= total_) ) {
+			found[found_count++] = { static_cast<uint16_t>(sum / n), static_cast<uint16_t>(std::min<uint32_t>(n, 0xffff)) };
+		}
+	}
+
+	// Keep the most populated, then order by width
+	std::sort(&found[0], &found[found_count], [](const Cluster& a, const Cluster& b) { return a.count > b.count; });
+	const size_t result_count = std::min(found_count, out.size());
+	std::sort(&found[0], &found[result_count], [](const Cluster& a, const Cluster& b) { return a.width_us < b.width_us; });
+
+	out.fill({ 0, 0 });
+	std::copy(&found[0], &found[result_count], out.begin());
+	return result_count;
+}
+
+/* PulseAnalyzer **********************************************************/
+
+void PulseAnalyzer::reset() {
+	highs.clear();
+	lows.clear();
+	periods.clear();
+	sync_us = 0;
+	analysis = { };
+}
+
+const PulseAnalysis& PulseAnalyzer::feed(const PulseTrain& train) {
+	if( train.modulation != analysis.modulation ) {
+		// Don't mix envelope and discriminator widths
+		reset();
+		analysis.modulation = train.modulation;
+	}
+
+	for(size_t i=0; i<train.count; i++) {
+		const uint32_t high_us = uint64_t(train.pulses[i].high) * 1000000 / train.sampling_rate;
+		const uint32_t low_us = uint64_t(train.pulses[i].low) * 1000000 / train.sampling_rate;
+
+		highs.add(high_us);
+		if( low_us == 0 ) {
+			// End of train
+		} else if( low_us >= WidthHistogram::range_us ) {
+			// Row gap, remember the shortest one seen
+			if( (sync_us == 0) || (low_us < sync_us) ) {
+				sync_us = std::min<uint32_t>(low_us, 0xffff);
+			}
+		} else {
+			lows.add(low_us);
+			periods.add(high_us + low_us);
+		}
+	}
+
+	analysis.trains++;
+	analysis.pulses += train.count;
+	analysis.sync_us = sync_us;
+
+	infer();
+
+	analysis.record.clear();
+	if( analysis.valid ) {
+		slice(train, analysis.protocol(), analysis.record);
+	}
+
+	return analysis;
+}
+
+void PulseAnalyzer::infer() {
+	const auto high_count = highs.clusters(analysis.highs);
+	const auto low_count = lows.clusters(analysis.lows);
+	clusters_t period_clusters;
+	const auto period_count = periods.clusters(period_clusters);
+
+	const auto& h = analysis.highs;
+	const auto& l = analysis.lows;
+
+	analysis.valid = false;
+	analysis.pulse_us = 0;
+
+	if( (high_count == 0) || (low_count == 0) ) {
+		return;
+	}
+
+	// One dominant period and two pulse widths: pulse width modulation.
+	// Clusters come back sorted by width, so look for the most populated one.
+	const auto dominant_period = std::max_element(&period_clusters[0], &period_clusters[period_count],
+		[](const Cluster& a, const Cluster& b) { return a.count < b.count; });
+	const bool constant_period = (period_count == 1) ||
+		((period_count > 1) && (dominant_period->count * 4 >= (periods.total() * 3)));
+
+	if( constant_period && (high_count == 2) ) {
+		analysis.coding = Coding::PWM;
+		analysis.short_us = h[0].width_us;
+		analysis.long_us = h[1].width_us;
+		analysis.tolerance_us = (analysis.long_us - analysis.short_us) / 3;
+		analysis.valid = true;
+		return;
+	}
+
+	// Constant pulse, two gap widths: pulse position modulation
+	if( (high_count == 1) && (low_count == 2) ) {
+		analysis.coding = Coding::PPM;
+		analysis.pulse_us = h[0].width_us;
+		analysis.short_us = l[0].width_us;
+		analysis.long_us = l[1].width_us;
+		analysis.tolerance_us = (analysis.long_us - analysis.short_us) / 3;
+		analysis.valid = true;
+		return;
+	}
+
+	const uint32_t unit = std::min(h[0].width_us, l[0].width_us);
+	if( unit == 0 ) {
+		return;
+	}
+
+	// Manchester only ever has runs of one or two half bits
+	bool manchester = true;
+	bool nrz = true;
+	for(size_t i=0; i<high_count; i++) {
+		manchester &= is_multiple(h[i].width_us, unit, 2);
+		nrz &= is_multiple(h[i].width_us, unit, 16);
+	}
+	for(size_t i=0; i<low_count; i++) {
+		manchester &= is_multiple(l[i].width_us, unit, 2);
+		nrz &= is_multiple(l[i].width_us, unit, 16);
+	}
+
+	if( manchester || nrz ) {
+		analysis.coding = manchester ? Coding::Manchester : Coding::NRZ;
+		analysis.short_us = unit;
+		analysis.long_us = unit;
+		analysis.tolerance_us = unit / 3;
+		analysis.valid = true;
+	}
+}
+
+} /* namespace ism */
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PULSE_ANALYZER_H__
+#define __PULSE_ANALYZER_H__
+
+#include "ism_packet.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace ism {
+
+/* Linear width histogram. Bins keep the sum of their widths as well as a
+ * count, so cluster centers aren't limited to the bin resolution.
+ */
+class WidthHistogram {
+public:
+	static constexpr uint32_t bin_us = 32;
+	static constexpr size_t bins = 128;
+	static constexpr uint32_t range_us = bin_us * bins;
+
+	void clear();
+	void add(const uint32_t width_us);
+
+	uint32_t total() const {
+		return total_;
+	}
+
+	/* Up to clusters_max of the most populated peaks, sorted by width.
+	 * Peaks holding less than 1/16 of the total are ignored.
+	 */
+	size_t clusters(clusters_t& out) const;
+
+private:
+	std::array<uint16_t, bins> count { };
+	std::array<uint32_t, bins> sum_us { };
+	uint32_t total_ { 0 };
+};
+
+class PulseAnalyzer {
+public:
+	void reset();
+
+	/* Accumulates the train and updates the analysis */
+	const PulseAnalysis& feed(const PulseTrain& train);
+
+private:
+	WidthHistogram highs { };
+	WidthHistogram lows { };
+	WidthHistogram periods { };
+	uint32_t sync_us { 0 };
+	PulseAnalysis analysis { };
+
+	void infer();
+};
+
+} /* namespace ism */
+
+#endif/*__PULSE_ANALYZER_H__*/
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PULSE_DETECTOR_H__
+#define __PULSE_DETECTOR_H__
+
+#include "dsp_types.hpp"
+#include "ism_packet.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/* Turns a debounced binary level into a list of (high, low) durations. */
+class PulseTrainBuilder {
+public:
+	PulseTrainBuilder(
+		const ism::Modulation modulation,
+		const uint32_t sampling_rate,
+		const size_t debounce
+	) : debounce { debounce }
+	{
+		train_.modulation = modulation;
+		train_.sampling_rate = sampling_rate;
+	}
+
+	void feed(const bool raw) {
+		if( run < 0xffff ) {
+			run++;
+		}
+
+		if( raw != level ) {
+			if( ++pending >= debounce ) {
+				on_edge(run - pending);
+				level = raw;
+				run = pending;
+				pending = 0;
+			}
+		} else {
+			pending = 0;
+		}
+	}
+
+	/* Closes the last pulse. Returns true if the train is worth decoding. */
+	bool finish() {
+		if( level ) {
+			current.high = run;
+			current.low = 0;
+			push();
+		} else if( has_high ) {
+			// The gap after the last pulse is the idle time, not part of the train
+			current.low = 0;
+			push();
+		}
+		const bool usable = (train_.count >= pulses_min);
+		level = false;
+		run = 0;
+		pending = 0;
+		return usable;
+	}
+
+	void clear() {
+		train_.count = 0;
+		has_high = false;
+	}
+
+	bool high() const {
+		return level;
+	}
+
+	size_t run_length() const {
+		return run;
+	}
+
+	bool full() const {
+		return train_.count >= train_.pulses.size();
+	}
+
+	bool empty() const {
+		return (train_.count == 0) && !has_high && !level;
+	}
+
+	const ism::PulseTrain& train() const {
+		return train_;
+	}
+
+private:
+	static constexpr size_t pulses_min = 8;
+
+	const size_t debounce;
+	ism::PulseTrain train_ { };
+	ism::Pulse current { };
+	bool has_high { false };
+	bool level { false };
+	size_t run { 0 };
+	size_t pending { 0 };
+
+	void on_edge(const size_t duration) {
+		if( level ) {
+			current.high = duration;
+			has_high = true;
+		} else if( has_high ) {
+			current.low = duration;
+			push();
+		}
+	}
+
+	void push() {
+		if( train_.count < train_.pulses.size() ) {
+			train_.pulses[train_.count++] = current;
+		}
+		has_high = false;
+	}
+};
+
+/* Shared front end for ISM band decoders: one envelope (OOK) and one FM
+ * discriminator (FSK) pulse train, built in parallel from the same channel.
+ */
+class PulseDetector {
+public:
+	PulseDetector(
+		const uint32_t sampling_rate,
+		const uint32_t reset_us
+	) : reset_samples { static_cast<size_t>(uint64_t(sampling_rate) * reset_us / 1000000) },
+		ook { ism::Modulation::OOK, sampling_rate, debounce },
+		fsk { ism::Modulation::FSK, sampling_rate, debounce }
+	{
+	}
+
+	template<typename TrainHandler>
+	void execute(const buffer_c16_t& src, TrainHandler handler) {
+		for(size_t i=0; i<src.count; i++) {
+			const auto sample = src.p[i];
+			const bool carrier = envelope(sample);
+
+			ook.feed(carrier);
+			const bool ook_idle = !ook.high() && (ook.run_length() >= reset_samples);
+			if( (ook_idle && !ook.empty()) || ook.full() ) {
+				if( ook.finish() ) {
+					handler(ook.train());
+				}
+				ook.clear();
+			}
+
+			if( carrier ) {
+				fsk.feed(discriminator(sample));
+			}
+			if( (!carrier && !fsk.empty()) || fsk.full() ) {
+				if( fsk.finish() ) {
+					handler(fsk.train());
+				}
+				fsk.clear();
+			}
+			prev = sample;
+		}
+	}
+
+private:
+	static constexpr size_t debounce = 2;
+
+	const size_t reset_samples;
+	PulseTrainBuilder ook;
+	PulseTrainBuilder fsk;
+
+	uint32_t noise_floor_q8 { 256 << 8 };	// Fraction bits so the slow update can move it both ways
+	bool carrier_on { false };
+	complex16_t prev { 0, 0 };
+	int32_t freq_avg { 0 };
+
+	bool envelope(const complex16_t sample) {
+		const int32_t re = sample.real();
+		const int32_t im = sample.imag();
+		const uint32_t mag2 = (uint32_t(re * re) + uint32_t(im * im)) >> 8;
+
+		// Open at +9dB over the noise floor, close at +6dB
+		const uint32_t noise_floor = noise_floor_q8 >> 8;
+		const uint32_t threshold = carrier_on ? (noise_floor << 2) : (noise_floor << 3);
+		carrier_on = (mag2 > threshold);
+
+		if( !carrier_on ) {
+			// Slow tracking while idle, so pulses don't pull the floor up
+			noise_floor_q8 = std::max<uint32_t>(noise_floor_q8 - (noise_floor_q8 >> 10) + ((mag2 << 8) >> 10), 16 << 8);
+		}
+		return carrier_on;
+	}
+
+	bool discriminator(const complex16_t sample) {
+		// Sign of the instantaneous frequency, lightly averaged
+		const int32_t cross = (int32_t(prev.real()) * sample.imag() - int32_t(prev.imag()) * sample.real()) >> 8;
+		freq_avg += (cross - freq_avg) >> 2;
+		return freq_avg > 0;
+	}
+};
+
+#endif/*__PULSE_DETECTOR_H__*/
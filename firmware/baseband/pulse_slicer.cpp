@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "pulse_slicer.hpp"
+
+#include <cstdlib>
+
+namespace ism {
+
+namespace {
+
+class Timing {
+public:
+	Timing(
+		const PulseTrain& train,
+		const Protocol& protocol
+	) : sampling_rate { train.sampling_rate },
+		protocol(protocol)
+	{
+	}
+
+	uint32_t us(const uint32_t samples) const {
+		return uint64_t(samples) * 1000000 / sampling_rate;
+	}
+
+	bool is_short(const uint32_t duration_us) const {
+		return near(duration_us, protocol.short_us);
+	}
+
+	bool is_long(const uint32_t duration_us) const {
+		return near(duration_us, protocol.long_us);
+	}
+
+	/* A gap longer than any symbol's ends a row (and the last pulse's gap is
+	 * always zero). Manchester gaps can span two half bits.
+	 */
+	bool is_row_gap(const uint32_t duration_us) const {
+		const uint32_t longest_us = (protocol.coding == Coding::Manchester) ? (protocol.short_us * 2U) : protocol.long_us;
+		return (duration_us == 0) || (duration_us > (longest_us + protocol.tolerance_us * 2U));
+	}
+
+private:
+	const uint32_t sampling_rate;
+	const Protocol& protocol;
+
+	bool near(const uint32_t duration_us, const uint32_t nominal_us) const {
+		return uint32_t(std::abs(int32_t(duration_us) - int32_t(nominal_us))) <= protocol.tolerance_us;
+	}
+};
+
+bool row_ok(const Record& record, const Protocol& protocol) {
+	return (record.bit_count() >= protocol.bits_min) && (record.bit_count() <= protocol.bits_max);
+}
+
+bool slice_pwm(const PulseTrain& train, const Protocol& protocol, Record& record) {
+	const Timing timing { train, protocol };
+	bool valid = true;
+
+	record.clear();
+	for(size_t i=0; i<train.count; i++) {
+		const auto high_us = timing.us(train.pulses[i].high);
+		const auto low_us = timing.us(train.pulses[i].low);
+
+		if( timing.is_short(high_us) ) {
+			record.add(1);
+		} else if( timing.is_long(high_us) ) {
+			record.add(0);
+		} else {
+			valid = false;
+		}
+
+		if( timing.is_row_gap(low_us) ) {
+			if( valid && row_ok(record, protocol) ) {
+				return true;
+			}
+			record.clear();
+			valid = true;
+		}
+	}
+	return false;
+}
+
+bool slice_ppm(const PulseTrain& train, const Protocol& protocol, Record& record) {
+	const Timing timing { train, protocol };
+	bool valid = true;
+
+	record.clear();
+	for(size_t i=0; i<train.count; i++) {
+		const auto low_us = timing.us(train.pulses[i].low);
+
+		if( timing.is_row_gap(low_us) ) {
+			if( valid && row_ok(record, protocol) ) {
+				return true;
+			}
+			record.clear();
+			valid = true;
+		} else if( timing.is_short(low_us) ) {
+			record.add(0);
+		} else if( timing.is_long(low_us) ) {
+			record.add(1);
+		} else {
+			valid = false;
+		}
+	}
+	return false;
+}
+
+/* Feeds one level per period, the duration rounded to whole periods */
+template<typename LevelHandler>
+bool for_each_period(const uint32_t duration_us, const uint32_t period_us, LevelHandler handler, const bool level) {
+	const uint32_t periods = (duration_us + period_us / 2) / period_us;
+	if( (periods == 0) || (periods > 64) ) {
+		return false;
+	}
+	for(uint32_t n=0; n<periods; n++) {
+		if( !handler(level) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* A row starting with a 0 bit (01) loses its leading low half in the gap, so
+ * leading_low re-inserts it at the start of every row.
+ */
+bool slice_manchester(const PulseTrain& train, const Protocol& protocol, Record& record, const bool leading_low) {
+	const Timing timing { train, protocol };
+	bool first_half = false;
+	bool have_first = false;
+	bool in_sync = true;
+
+	auto half_bit = [&](const bool level) {
+		if( !have_first ) {
+			first_half = level;
+			have_first = true;
+			return true;
+		}
+		have_first = false;
+		if( first_half == level ) {
+			return false;
+		}
+		record.add(first_half);
+		return true;
+	};
+
+	record.clear();
+	bool row_start = true;
+	for(size_t i=0; i<train.count; i++) {
+		const auto high_us = timing.us(train.pulses[i].high);
+		const auto low_us = timing.us(train.pulses[i].low);
+		const bool row_end = timing.is_row_gap(low_us);
+
+		if( row_start && leading_low ) {
+			half_bit(false);
+		}
+		row_start = false;
+
+		if( in_sync ) {
+			in_sync = for_each_period(high_us, protocol.short_us, half_bit, true);
+		}
+		if( in_sync && !row_end ) {
+			in_sync = for_each_period(low_us, protocol.short_us, half_bit, false);
+		}
+		if( in_sync && row_end && have_first ) {
+			// Trailing 1 (10), its low half merged into the gap
+			half_bit(false);
+		}
+
+		// A coding error ends the row, keep the bits decoded so far
+		if( row_end || !in_sync ) {
+			if( row_ok(record, protocol) ) {
+				return true;
+			}
+			record.clear();
+			have_first = false;
+			if( row_end ) {
+				in_sync = true;
+				row_start = true;
+			}
+		}
+	}
+	return false;
+}
+
+bool slice_nrz(const PulseTrain& train, const Protocol& protocol, Record& record) {
+	const Timing timing { train, protocol };
+	auto bit = [&record](const bool level) {
+		record.add(level);
+		return true;
+	};
+
+	record.clear();
+	for(size_t i=0; i<train.count; i++) {
+		const auto high_us = timing.us(train.pulses[i].high);
+		const auto low_us = timing.us(train.pulses[i].low);
+
+		if( !for_each_period(high_us, protocol.short_us, bit, true) ) {
+			break;
+		}
+		if( (low_us > 0) && !for_each_period(low_us, protocol.short_us, bit, false) ) {
+			break;
+		}
+	}
+	return row_ok(record, protocol);
+}
+
+} /* namespace */
+
+bool slice(const PulseTrain& train, const Protocol& protocol, Record& record) {
+	if( (train.modulation != protocol.modulation) || (train.sampling_rate == 0) ) {
+		return false;
+	}
+
+	switch(protocol.coding) {
+	case Coding::PWM:			return slice_pwm(train, protocol, record);
+	case Coding::PPM:			return slice_ppm(train, protocol, record);
+	case Coding::Manchester:
+		return slice_manchester(train, protocol, record, false) || slice_manchester(train, protocol, record, true);
+	case Coding::NRZ:			return slice_nrz(train, protocol, record);
+	default:					return false;
+	}
+}
+
+} /* namespace ism */
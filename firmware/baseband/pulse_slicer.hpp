@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PULSE_SLICER_H__
+#define __PULSE_SLICER_H__
+
+#include "ism_packet.hpp"
+
+namespace ism {
+
+/* Decodes a pulse train with a protocol's timings. Rows are split on long
+ * gaps; the first row with an acceptable bit count is returned in record.
+ */
+bool slice(const PulseTrain& train, const Protocol& protocol, Record& record);
+
+} /* namespace ism */
+
+#endif/*__PULSE_SLICER_H__*/
@@ -0,0 +1,534 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "sstv_decoder.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+constexpr float black_hz = 1500.0f;
+constexpr float white_hz = 2300.0f;
+constexpr float sync_hz = 1200.0f;
+constexpr float leader_hz = 1900.0f;
+constexpr float vis_one_hz = 1100.0f;
+constexpr float vis_zero_hz = 1300.0f;
+constexpr float tone_tolerance_hz = 150.0f;
+
+// Anything under this is taken as sync, picture content stays over 1500Hz
+constexpr float sync_threshold_hz = 1350.0f;
+constexpr float sync_release_hz = 1450.0f;
+
+constexpr float vis_edge_hz = (leader_hz + sync_hz) / 2;
+
+constexpr uint32_t leader_ms_min = 100;
+constexpr uint32_t start_bit_ms_min = 20;
+constexpr uint32_t vis_bit_ms = 30;
+
+// Robot modes: separator and porch between luminance and each chrominance
+constexpr float robot_separator_ms = 4.5f;
+constexpr float robot_porch_ms = 1.5f;
+
+// Clock errors over this are not a slant, the fit has gone wrong
+constexpr double clock_error_max = 0.01;
+// Rows the syncs must span before the slope is fitted, and before the fit
+// is trusted to narrow the window
+constexpr int32_t fit_span_min = 2;
+constexpr int32_t fit_span_settled = 12;
+
+bool near(const float frequency, const float target) {
+	return std::fabs(frequency - target) < tone_tolerance_hz;
+}
+
+uint8_t to_level(const float frequency) {
+	const float v = (frequency - black_hz) * (255.0f / (white_hz - black_hz));
+	return std::max(0.0f, std::min(v, 255.0f));
+}
+
+uint8_t clamp_u8(const float v) {
+	return std::max(0.0f, std::min(v, 255.0f));
+}
+
+} /* namespace */
+
+SSTVDecoder::SSTVDecoder() {
+	for(size_t i=0; i<mixer_period; i++) {
+		const float phase = 2.0f * pi * leader_hz * i / sampling_rate;
+		mixer_cos[i] = std::cos(phase);
+		mixer_sin[i] = -std::sin(phase);
+	}
+
+	sync_slope = std::tan(2.0f * pi * (sync_threshold_hz - leader_hz) * step_lag / sampling_rate);
+	sync_release_slope = std::tan(2.0f * pi * (sync_release_hz - leader_hz) * step_lag / sampling_rate);
+
+	// Hamming windowed sinc, keeps +/-1.5kHz around 1900Hz and rejects the
+	// mixing image, 3.4kHz and up
+	constexpr float cutoff = 2400.0f / sampling_rate;
+	constexpr int32_t center = taps_count / 2;
+	float sum = 0;
+	for(size_t i=0; i<taps_count; i++) {
+		const int32_t n = int32_t(i) - center;
+		const float sinc = (n == 0) ? 2.0f * cutoff : std::sin(2.0f * pi * cutoff * n) / (pi * n);
+		const float window = 0.54f - 0.46f * std::cos(2.0f * pi * i / (taps_count - 1));
+		taps[i] = sinc * window;
+		sum += taps[i];
+	}
+	for(auto& tap : taps) {
+		tap /= sum;
+	}
+}
+
+void SSTVDecoder::reset() {
+	state = State::Idle;
+	result = SSTVRxStatusMessage::State::Idle;
+	mode = nullptr;
+	ms_sum = { };
+	ms_count = 0;
+	leader_ms = 0;
+	low_ms = 0;
+	ms_history.fill({ });
+	vis_active = false;
+}
+
+uint32_t SSTVDecoder::process(const float sample) {
+	const auto step = demodulate(sample);
+	sample_count++;
+
+	uint32_t events = 0;
+
+	ms_sum += step;
+	if( ++ms_count >= ms_samples ) {
+		if( on_ms(ms_sum) ) {
+			events |= event_status;
+		}
+		ms_sum = { };
+		ms_count = 0;
+	}
+
+	if( state == State::Image ) {
+		events |= on_image_sample(step);
+	}
+	return events;
+}
+
+/* Phase steps are averaged as vectors and only turned into a frequency at
+ * the end, a noise spike then weighs no more than any other sample.
+ */
+float SSTVDecoder::to_frequency(const PhaseStep& step) {
+	if( (step.i * step.i + step.q * step.q) < 1e-12f ) {
+		return 0;
+	}
+	return leader_hz + std::atan2(step.q, step.i) * (sampling_rate / (2.0f * pi * step_lag));
+}
+
+SSTVDecoder::PhaseStep SSTVDecoder::demodulate(const float sample) {
+	const float mixed_i = sample * mixer_cos[mixer_index];
+	const float mixed_q = sample * mixer_sin[mixer_index];
+	mixer_index = (mixer_index + 1) % mixer_period;
+
+	history_i[history_index] = history_i[history_index + taps_count] = mixed_i;
+	history_q[history_index] = history_q[history_index + taps_count] = mixed_q;
+	history_index = (history_index + 1) % taps_count;
+
+	float i = 0;
+	float q = 0;
+	for(size_t n=0; n<taps_count; n++) {
+		i += taps[n] * history_i[history_index + n];
+		q += taps[n] * history_q[history_index + n];
+	}
+
+	// Phase step over step_lag samples
+	const auto prev_i = previous_i[previous_index];
+	const auto prev_q = previous_q[previous_index];
+	const PhaseStep step {
+		i * prev_i + q * prev_q,
+		q * prev_i - i * prev_q
+	};
+	previous_i[previous_index] = i;
+	previous_q[previous_index] = q;
+	previous_index = (previous_index + 1) % step_lag;
+	return step;
+}
+
+/* VIS ********************************************************************/
+
+bool SSTVDecoder::on_ms(const PhaseStep& step) {
+	if( vis_active ) {
+		// Start bit, 7 data bits LSB first, parity, stop bit, 30ms each.
+		// Only the middle of each bit is used.
+		const auto slot = vis_ms / vis_bit_ms;
+		const auto offset = vis_ms % vis_bit_ms;
+		if( (offset >= 5) && (offset < 25) ) {
+			vis_slots[slot] += step;
+		}
+		if( ++vis_ms >= vis_slots.size() * vis_bit_ms ) {
+			vis_active = false;
+			return on_vis();
+		}
+		return false;
+	}
+
+	// Leader and start bit are found on a 10ms average
+	ms_history[ms_history_index] = step;
+	ms_history_index = (ms_history_index + 1) % ms_history.size();
+	PhaseStep sum { };
+	for(const auto& s : ms_history) {
+		sum += s;
+	}
+	const float frequency = to_frequency(sum);
+
+	if( near(frequency, leader_hz) ) {
+		leader_ms = std::min<uint32_t>(leader_ms + 1, 1000);
+		low_ms = 0;
+	} else if( (frequency > 0) && (frequency < vis_edge_hz) && (leader_ms >= leader_ms_min) ) {
+		// The average crosses halfway 5ms into the start bit. The 10ms break
+		// in the leader is too short to pass for it.
+		if( ++low_ms >= start_bit_ms_min ) {
+			low_ms = 0;
+			leader_ms = 0;
+			if( near(frequency, sync_hz) ) {
+				vis_active = true;
+				vis_ms = start_bit_ms_min + ms_history.size() / 2;
+				vis_slots.fill({ });
+				vis_slots[0] = sum;
+			}
+		}
+	} else {
+		// Leaky, so noise and tone changes don't throw away a long leader
+		leader_ms = (leader_ms > 4) ? (leader_ms - 4) : 0;
+		low_ms = 0;
+	}
+	return false;
+}
+
+bool SSTVDecoder::on_vis() {
+	if( !near(to_frequency(vis_slots.back()), sync_hz) ) {
+		return false;
+	}
+
+	uint8_t code = 0;
+	for(size_t bit=0; bit<8; bit++) {
+		const auto frequency = to_frequency(vis_slots[bit + 1]);
+		// Closest of the two tones, as long as it's one of them
+		if( !near(frequency, vis_one_hz) && !near(frequency, vis_zero_hz) ) {
+			return false;
+		}
+		if( frequency < sync_hz ) {
+			code |= 1 << bit;
+		}
+	}
+
+	if( sstv::sstv_parity(code & 0x7f) != code ) {
+		return false;
+	}
+
+	for(size_t i=0; i<SSTV_MODES_NB; i++) {
+		if( sstv::sstv_modes[i].vis_code == code ) {
+			start_image(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Image ******************************************************************/
+
+void SSTVDecoder::start_image(const size_t index) {
+	mode = &sstv::sstv_modes[index];
+	mode_index = index;
+	robot_36 = (mode->vis_code == sstv::sstv_parity(8));
+
+	const float lead = layout();
+
+	// The first row starts right after the stop bit, or after an extra sync
+	image_start = sample_count;
+	fit_b = period_nominal;
+	fit_a = lead + (mode->sync_on_first ? sync_samples : 0);
+	sum_n = 0;
+	sum_t = 0;
+	sum_nn = 0;
+	sum_nt = 0;
+	fit_count = 0;
+	fit_sloped = false;
+	low_run = 0;
+	high_run = 0;
+	rows_unsynced = 0;
+
+	row = 0;
+	segment_index = 0;
+	pixel_index = 0;
+	pixel_sum = { };
+	pixel_samples = 0;
+	for(auto& channel : channels) {
+		channel.fill(0);
+	}
+	if( mode->color_sequence == sstv::SSTV_COLOR_YUV ) {
+		channels[V].fill(128);
+		channels[U].fill(128);
+	}
+
+	state = State::Image;
+	result = SSTVRxStatusMessage::State::Receiving;
+	update_row_start();
+}
+
+float SSTVDecoder::layout() {
+	// From the exact times, the transmitter's truncated sample counts are
+	// off by up to 500ppm and would have to be fitted away as clock error
+	constexpr float scale = float(sampling_rate) / 1000;
+	const float pixel = mode->pixel_ms * scale;
+	const float gap = mode->gap_ms * scale;
+	const float line = pixel * SSTVRxLine::width;
+	sync_samples = mode->sync_ms * scale;
+
+	if( mode->color_sequence == sstv::SSTV_COLOR_YUV ) {
+		// sync, porch, Y, then separator, porch and half width chrominance,
+		// once for Robot 36 (alternating V and U), V and U for Robot 72
+		constexpr float separator = robot_separator_ms * sampling_rate / 1000;
+		constexpr float porch = robot_porch_ms * sampling_rate / 1000;
+		float t = sync_samples + gap;
+		segments[0] = { t, pixel, SSTVRxLine::width, Y };
+		t += line;
+		if( robot_36 ) {
+			segments[1] = { t, separator, 1, Separator };
+			segments[2] = { t + separator + porch, pixel / 2, SSTVRxLine::width, Chroma };
+			t += separator + porch + line / 2;
+			segment_count = 3;
+		} else {
+			segments[1] = { t + separator + porch, pixel / 2, SSTVRxLine::width, V };
+			t += separator + porch + line / 2;
+			segments[2] = { t + separator + porch, pixel / 2, SSTVRxLine::width, U };
+			t += separator + porch + line / 2;
+			segment_count = 3;
+		}
+		period_nominal = t;
+		return 0;
+	}
+
+	// Each component follows a gap (only the one after the sync if the mode
+	// has no gaps), the sync comes before component sync_index. Components
+	// before it belong to the same row, so they're laid out backwards.
+	const Channel order_gbr[3] { Green, Blue, Red };
+	const Channel order_rgb[3] { Red, Green, Blue };
+	const auto order = (mode->color_sequence == sstv::SSTV_COLOR_GBR) ? order_gbr : order_rgb;
+	const size_t sync_index = mode->sync_index;
+	const float step = line + (mode->gaps ? gap : 0);
+
+	float t = sync_samples;
+	for(size_t c=0; c<3; c++) {
+		if( c < sync_index ) {
+			const float before = sync_index - c;
+			segments[c] = { -before * step + (step - line), pixel, SSTVRxLine::width, order[c] };
+		} else {
+			t += (mode->gaps || (c == sync_index)) ? gap : 0;
+			segments[c] = { t, pixel, SSTVRxLine::width, order[c] };
+			t += line;
+		}
+	}
+	segment_count = 3;
+	// Martin has a porch after each of the three scans and one after sync
+	const size_t gaps = mode->gaps ? ((mode->sync_index == 0) ? 4 : 3) : 1;
+	period_nominal = sync_samples + line * 3 + gap * gaps;
+	return sync_index * step;
+}
+
+void SSTVDecoder::update_row_start() {
+	const double start = fit_a + fit_b * row;
+	const double whole = std::floor(start);
+	row_start = image_start + int32_t(whole);
+	row_start_frac = start - whole;
+}
+
+uint32_t SSTVDecoder::on_image_sample(const PhaseStep& step) {
+	sync_sum += step;
+	sync_sum -= sync_history[sync_history_index];
+	sync_history[sync_history_index] = step;
+	if( ++sync_history_index >= sync_window ) {
+		// Sum again from scratch now and then, so rounding errors don't build up
+		sync_history_index = 0;
+		sync_sum = { };
+		for(const auto& s : sync_history) {
+			sync_sum += s;
+		}
+	}
+
+	// Same as frequency < sync_threshold_hz, without the atan2. Some hysteresis
+	// so noise doesn't break up a sync pulse.
+	const float slope = low_run ? sync_release_slope : sync_slope;
+	if( (sync_sum.i > 0) && (sync_sum.q < slope * sync_sum.i) ) {
+		low_run += 1 + high_run;
+		high_run = 0;
+	} else if( low_run && (++high_run > sync_window) ) {
+		// Short breaks are bridged, so the pulse starts where it really does
+		if( low_run >= sync_samples * 0.6f ) {
+			// The average crosses the threshold half a window after the edge
+			on_sync(sample_count - high_run - low_run - sync_window / 2);
+		}
+		low_run = 0;
+		high_run = 0;
+	}
+
+	uint32_t events = 0;
+	float t = float(int32_t(sample_count - row_start)) - row_start_frac;
+	while( true ) {
+		const auto& segment = segments[segment_index];
+		const float start = segment.offset + pixel_index * segment.pixel;
+		if( t < start ) {
+			break;
+		}
+		if( t < start + segment.pixel ) {
+			pixel_sum += step;
+			pixel_samples++;
+			break;
+		}
+
+		on_pixel(segment, to_frequency(pixel_samples ? pixel_sum : step));
+		pixel_sum = { };
+		pixel_samples = 0;
+
+		if( ++pixel_index >= segment.pixels ) {
+			pixel_index = 0;
+			if( ++segment_index >= segment_count ) {
+				segment_index = 0;
+				events |= on_row_end();
+				if( state != State::Image ) {
+					break;
+				}
+				t = float(int32_t(sample_count - row_start)) - row_start_frac;
+			}
+		}
+	}
+	return events;
+}
+
+void SSTVDecoder::on_sync(const uint32_t start) {
+	const double t = int32_t(start - image_start);
+	const int32_t n = std::lround((t - fit_a) / fit_b);
+	if( (n < 0) || (n + 1 < int32_t(row)) || (n > int32_t(row) + 1) ) {
+		return;
+	}
+
+	// Until the slope is fitted, the rows drift by up to the largest clock
+	// error since the first sync. Wide open until the fit has settled, then
+	// only what it predicts.
+	if( fit_count == 0 ) {
+		fit_first_row = n;
+	}
+	const double residual = t - (fit_a + fit_b * n);
+	double tolerance = sync_samples * 0.5;
+	if( !fit_sloped ) {
+		tolerance = sync_samples + period_nominal * clock_error_max * (n - fit_first_row + 2);
+	} else if( n < fit_first_row + fit_span_settled ) {
+		tolerance = sync_samples;
+	}
+	if( std::fabs(residual) > tolerance ) {
+		return;
+	}
+
+	sum_n += n;
+	sum_t += t;
+	sum_nn += double(n) * n;
+	sum_nt += double(n) * t;
+	fit_count++;
+
+	// The slope is only worth fitting once the syncs span a few rows, until
+	// then a single noisy sync would tilt it
+	const double det = fit_count * sum_nn - sum_n * sum_n;
+	if( (n >= fit_first_row + fit_span_min) && (det > 0) ) {
+		fit_sloped = true;
+		const double b = (fit_count * sum_nt - sum_n * sum_t) / det;
+		fit_b = std::max(period_nominal * (1 - clock_error_max), std::min(b, period_nominal * (1 + clock_error_max)));
+	}
+	fit_a = (sum_t - fit_b * sum_n) / fit_count;
+
+	rows_unsynced = 0;
+	update_row_start();
+}
+
+void SSTVDecoder::on_pixel(const Segment& segment, const float frequency) {
+	switch(segment.channel) {
+	case Separator:
+		separator = frequency;
+		break;
+
+	case Chroma:
+		chroma[pixel_index] = to_level(frequency);
+		break;
+
+	default:
+		channels[segment.channel][pixel_index] = to_level(frequency);
+		break;
+	}
+}
+
+uint32_t SSTVDecoder::on_row_end() {
+	if( robot_36 ) {
+		// Even rows carry R-Y after a 1500Hz separator, odd rows B-Y after 2300Hz
+		channels[(separator > leader_hz) ? U : V] = chroma;
+	}
+
+	make_line();
+	row++;
+	rows_unsynced++;
+
+	if( row >= mode->lines ) {
+		state = State::Idle;
+		result = SSTVRxStatusMessage::State::Done;
+	} else if( rows_unsynced > lost_rows ) {
+		state = State::Idle;
+		result = SSTVRxStatusMessage::State::Lost;
+	} else {
+		update_row_start();
+	}
+	return event_line | event_status;
+}
+
+void SSTVDecoder::make_line() {
+	line.row = row;
+	const bool yuv = (mode->color_sequence == sstv::SSTV_COLOR_YUV);
+	for(size_t x=0; x<SSTVRxLine::width; x++) {
+		auto rgb = &line.rgb[x * 3];
+		if( yuv ) {
+			const float y = channels[Y][x];
+			const float v = channels[V][x] - 128.0f;
+			const float u = channels[U][x] - 128.0f;
+			rgb[0] = clamp_u8(y + 1.402f * v);
+			rgb[1] = clamp_u8(y - 0.344f * u - 0.714f * v);
+			rgb[2] = clamp_u8(y + 1.772f * u);
+		} else {
+			rgb[0] = channels[Red][x];
+			rgb[1] = channels[Green][x];
+			rgb[2] = channels[Blue][x];
+		}
+	}
+}
+
+SSTVRxStatusMessage SSTVDecoder::status() const {
+	const double error = mode ? (fit_b / period_nominal - 1) : 0;
+	return {
+		result,
+		mode_index,
+		static_cast<uint16_t>(row),
+		static_cast<int16_t>(error * 1000000)
+	};
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SSTV_DECODER_H__
+#define __SSTV_DECODER_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "sstv.hpp"
+
+/* SSTV receiver working on 24kHz FM demodulated audio.
+ *
+ * The tone frequency comes from the phase steps of the audio mixed down from
+ * 1900Hz and low pass filtered. A VIS code after the 1900Hz leader selects
+ * the mode in sstv_modes, every row is then laid out from its sync pulse.
+ * Sync pulse times are fitted against the row number, so the row period
+ * follows the sender's sample clock and the picture doesn't slant. Pixels are
+ * the average frequency over their slot, rows are handed out as they finish.
+ */
+class SSTVDecoder {
+public:
+	static constexpr uint32_t sampling_rate = 24000;
+
+	SSTVDecoder();
+
+	template<typename LineHandler, typename StatusHandler>
+	void execute(const buffer_f32_t& src, LineHandler on_line, StatusHandler on_status) {
+		for(size_t i=0; i<src.count; i++) {
+			const auto events = process(src.p[i]);
+			if( events & event_line ) {
+				on_line(line);
+			}
+			if( events & event_status ) {
+				on_status(status());
+			}
+		}
+	}
+
+	void reset();
+
+private:
+	static constexpr uint32_t event_line = 1;
+	static constexpr uint32_t event_status = 2;
+
+	static constexpr size_t taps_count = 41;
+	static constexpr size_t mixer_period = 240;		// 1900Hz is 19 cycles in 240 samples
+	// Phase is compared over 5 samples: noise through the 2400Hz filter no longer
+	// correlates at that lag and doesn't pull the frequency towards 1900Hz
+	static constexpr size_t step_lag = 5;
+	static constexpr size_t sync_window = 24;
+	static constexpr size_t ms_samples = sampling_rate / 1000;
+	static constexpr size_t segments_max = 4;
+	static constexpr size_t lost_rows = 16;
+
+	enum class State {
+		Idle,
+		Image,
+	};
+
+	enum Channel : uint8_t {
+		Red = 0,
+		Green,
+		Blue,
+		Y = 0,
+		V,				// R-Y
+		U,				// B-Y
+		Chroma,			// Robot 36, V or U depending on the separator
+		Separator,
+	};
+
+	struct PhaseStep {
+		float i;
+		float q;
+
+		PhaseStep& operator+=(const PhaseStep& other) {
+			i += other.i;
+			q += other.q;
+			return *this;
+		}
+
+		PhaseStep& operator-=(const PhaseStep& other) {
+			i -= other.i;
+			q -= other.q;
+			return *this;
+		}
+	};
+
+	struct Segment {
+		float offset;		// From the start of the row's sync, in samples
+		float pixel;
+		uint16_t pixels;
+		Channel channel;
+	};
+
+	std::array<float, mixer_period> mixer_cos { };
+	std::array<float, mixer_period> mixer_sin { };
+	std::array<float, taps_count> taps { };
+	// Written twice, so the filter always reads taps_count contiguous samples
+	std::array<float, taps_count * 2> history_i { };
+	std::array<float, taps_count * 2> history_q { };
+	size_t mixer_index { 0 };
+	size_t history_index { 0 };
+	// Filter outputs of the last step_lag samples
+	std::array<float, step_lag> previous_i { };
+	std::array<float, step_lag> previous_q { };
+	size_t previous_index { 0 };
+	float sync_slope { 0 };			// Phase step ratio q/i at the sync threshold
+	float sync_release_slope { 0 };
+
+	uint32_t sample_count { 0 };
+
+	State state { State::Idle };
+
+	// VIS detection on 1ms sums, smoothed over 10ms for the leader and start
+	// bit. Keeps running during a picture.
+	PhaseStep ms_sum { };
+	size_t ms_count { 0 };
+	uint32_t leader_ms { 0 };
+	uint32_t low_ms { 0 };
+	std::array<PhaseStep, 10> ms_history { };
+	size_t ms_history_index { 0 };
+	bool vis_active { false };
+	uint32_t vis_ms { 0 };
+	std::array<PhaseStep, 10> vis_slots { };
+
+	// Image
+	const sstv::sstv_mode* mode { nullptr };
+	uint8_t mode_index { 0 };
+	bool robot_36 { false };
+	std::array<Segment, segments_max> segments { };
+	size_t segment_count { 0 };
+	double period_nominal { 0 };
+	float sync_samples { 0 };
+	uint32_t image_start { 0 };
+
+	// Row start = a + b * row, fitted on the syncs received so far
+	double fit_a { 0 };
+	double fit_b { 0 };
+	double sum_n { 0 };
+	double sum_t { 0 };
+	double sum_nn { 0 };
+	double sum_nt { 0 };
+	uint32_t fit_count { 0 };
+	int32_t fit_first_row { 0 };
+	bool fit_sloped { false };
+	// Sync is tested on a 1ms moving average of the phase steps
+	std::array<PhaseStep, sync_window> sync_history { };
+	size_t sync_history_index { 0 };
+	PhaseStep sync_sum { };
+	uint32_t low_run { 0 };
+	uint32_t high_run { 0 };
+	uint32_t rows_unsynced { 0 };
+
+	uint32_t row { 0 };
+	int32_t row_start { 0 };
+	float row_start_frac { 0 };
+	size_t segment_index { 0 };
+	uint16_t pixel_index { 0 };
+	PhaseStep pixel_sum { };
+	uint32_t pixel_samples { 0 };
+
+	std::array<std::array<uint8_t, SSTVRxLine::width>, 3> channels { };
+	std::array<uint8_t, SSTVRxLine::width> chroma { };
+	float separator { 0 };
+	SSTVRxStatusMessage::State result { SSTVRxStatusMessage::State::Idle };
+
+	SSTVRxLine line { };
+
+	uint32_t process(const float sample);
+	PhaseStep demodulate(const float sample);
+	static float to_frequency(const PhaseStep& step);
+
+	bool on_ms(const PhaseStep& step);
+	bool on_vis();
+	void start_image(const size_t index);
+	float layout();		// Returns how long before its sync a row starts
+
+	uint32_t on_image_sample(const PhaseStep& step);
+	void on_sync(const uint32_t start);
+	void update_row_start();
+	void on_pixel(const Segment& segment, const float frequency);
+	uint32_t on_row_end();
+	void make_line();
+
+	SSTVRxStatusMessage status() const;
+};
+
+#endif/*__SSTV_DECODER_H__*/
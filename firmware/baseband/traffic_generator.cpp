@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "traffic_generator.hpp"
+
+#include "adsb.hpp"
+#include "sine_table.hpp"
+
+#include <cmath>
+
+namespace adsb {
+
+namespace {
+
+struct SquitterTiming {
+	squitter_type type;
+	uint32_t min_ms;
+	uint32_t max_ms;
+};
+
+/* DO-260 transmission rates: position and velocity twice a second, identity
+ * and status every five, each with a random jitter.
+ */
+constexpr std::array<SquitterTiming, 4> timings { {
+	{ SQUITTER_POSITION, 400, 600 },
+	{ SQUITTER_VELOCITY, 400, 600 },
+	{ SQUITTER_IDENTITY, 4800, 5200 },
+	{ SQUITTER_STATUS, 4800, 5200 },
+} };
+
+float cos_f32(const float w) {
+	return sin_f32(w + (pi / 2));
+}
+
+bool is_due(const uint32_t now, const uint32_t due) {
+	// Wraps after ~9 minutes at 8 MHz, differences stay well below that
+	return static_cast<int32_t>(now - due) >= 0;
+}
+
+} /* namespace */
+
+void TrafficGenerator::configure(const ADSBTrafficConfigureMessage& message, const uint32_t new_sampling_rate, const uint32_t now) {
+	sampling_rate = new_sampling_rate;
+	random_state = message.seed | 1;
+	center_latitude = message.aircraft.latitude;
+	center_longitude = message.aircraft.longitude;
+	count_ = 0;
+	next_index = 0;
+
+	if( message.aircraft.squitters ) {
+		auto& a = aircraft[count_++];
+		a.config = message.aircraft;
+		a.radius_nm = 0;
+	}
+
+	const size_t traffic_count = std::min<size_t>(message.traffic_count, traffic_max);
+	for(size_t i=0; i<traffic_count; i++) {
+		make_traffic(aircraft[count_++], i, message.traffic_radius_nm);
+		if( aircraft[count_ - 1].config.ICAO_address == message.aircraft.ICAO_address ) {
+			aircraft[count_ - 1].config.ICAO_address ^= 0x800000;
+		}
+	}
+
+	for(size_t i=0; i<count_; i++) {
+		auto& a = aircraft[i];
+		a.altitude = a.config.altitude;
+		a.last_move = now;
+		a.cpr_parity = 0;
+		schedule(a, now);
+	}
+}
+
+uint32_t TrafficGenerator::random() {
+	// xorshift32
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+uint32_t TrafficGenerator::random_range(const uint32_t min, const uint32_t max) {
+	return min + (random() % (max - min + 1));
+}
+
+uint32_t TrafficGenerator::interval(const size_t type) {
+	const auto ms = random_range(timings[type].min_ms, timings[type].max_ms);
+	return ms * (sampling_rate / 1000);
+}
+
+void TrafficGenerator::make_traffic(Aircraft& a, const size_t index, const uint32_t radius_nm) {
+	auto& c = a.config;
+
+	// Low bits are the index, so addresses are unique within the traffic
+	c.ICAO_address = (random() & 0xffffc0) | index;
+
+	const char callsign[9] = {
+		'T', 'R', 'F',
+		static_cast<char>('0' + (index / 100) % 10),
+		static_cast<char>('0' + (index / 10) % 10),
+		static_cast<char>('0' + index % 10),
+		' ', ' ', 0
+	};
+	std::copy(std::begin(callsign), std::end(callsign), std::begin(c.callsign));
+
+	// No 7xxx codes, those are emergencies
+	c.squawk = (random_range(0, 6) << 12) | (random() & 0x0777);
+	c.squitters = SQUITTER_ALL;
+
+	// Uniform over the disc around the center
+	const float r = radius_nm * std::sqrt(random_range(0, 1000) / 1000.0f);
+	const float bearing = random_range(0, 359) * (pi / 180);
+	c.latitude = center_latitude + (r * cos_f32(bearing)) / 60;
+	c.longitude = center_longitude + (r * sin_f32(bearing)) / (60 * cos_f32(center_latitude * (pi / 180)));
+
+	c.altitude = random_range(10, 400) * 100;
+	c.speed = random_range(120, 480);
+	c.heading = random_range(0, 359);
+	c.v_rate = (random() % 3) ? 0 : (static_cast<int32_t>(random_range(500, 2500)) * ((random() & 1) ? 1 : -1));
+
+	a.radius_nm = radius_nm;
+}
+
+void TrafficGenerator::schedule(Aircraft& a, const uint32_t now) {
+	// Spread the first squitters over a whole interval so nobody starts in sync
+	for(size_t type=0; type<squitter_types; type++) {
+		a.next_due[type] = now + random_range(0, interval(type));
+	}
+}
+
+void TrafficGenerator::move(Aircraft& a, const uint32_t now) {
+	auto& c = a.config;
+	const float dt = static_cast<float>(now - a.last_move) / sampling_rate;
+	a.last_move = now;
+
+	const float heading = c.heading * (pi / 180);
+	const float distance_nm = c.speed * dt / 3600;
+	c.latitude += distance_nm * cos_f32(heading) / 60;
+	c.longitude += distance_nm * sin_f32(heading) / (60 * cos_f32(c.latitude * (pi / 180)));
+	if( c.longitude >= 180 ) c.longitude -= 360;
+	if( c.longitude < -180 ) c.longitude += 360;
+
+	a.altitude += c.v_rate * dt / 60;
+	if( ((a.altitude < 1000) && (c.v_rate < 0)) || ((a.altitude > 45000) && (c.v_rate > 0)) ) {
+		c.v_rate = -c.v_rate;
+	}
+	c.altitude = a.altitude;
+
+	if( a.radius_nm > 0 ) {
+		const float north_nm = (c.latitude - center_latitude) * 60;
+		const float east_nm = (c.longitude - center_longitude) * 60 * cos_f32(center_latitude * (pi / 180));
+		const float outward = north_nm * cos_f32(heading) + east_nm * sin_f32(heading);
+		if( (outward > 0) && ((north_nm * north_nm + east_nm * east_nm) > (a.radius_nm * a.radius_nm)) ) {
+			c.heading = (c.heading + 180) % 360;
+		}
+	}
+}
+
+void TrafficGenerator::encode(Aircraft& a, const size_t type, ADSBFrame& frame) {
+	auto& c = a.config;
+
+	switch(timings[type].type) {
+	case SQUITTER_POSITION:
+		move(a, a.next_due[type]);
+		encode_frame_pos(frame, c.ICAO_address, c.altitude, c.latitude, c.longitude, a.cpr_parity);
+		a.cpr_parity ^= 1;
+		break;
+
+	case SQUITTER_VELOCITY:
+		encode_frame_velo(frame, c.ICAO_address, c.speed, c.heading, c.v_rate);
+		break;
+
+	case SQUITTER_IDENTITY:
+		encode_frame_id(frame, c.ICAO_address, c.callsign);
+		break;
+
+	case SQUITTER_STATUS:
+	default:
+		encode_frame_status(frame, c.ICAO_address, c.squawk);
+		break;
+	}
+}
+
+bool TrafficGenerator::next_frame(const uint32_t now, ADSBFrame& frame) {
+	for(size_t n=0; n<count_; n++) {
+		const size_t index = (next_index + n) % count_;
+		auto& a = aircraft[index];
+
+		for(size_t type=0; type<squitter_types; type++) {
+			if( !(a.config.squitters & timings[type].type) || !is_due(now, a.next_due[type]) ) {
+				continue;
+			}
+
+			encode(a, type, frame);
+
+			// Keep the average rate if a bit late, start over if far behind
+			a.next_due[type] += interval(type);
+			if( is_due(now, a.next_due[type]) ) {
+				a.next_due[type] = now + interval(type);
+			}
+
+			// Round robin, so one aircraft can't starve the others when busy
+			next_index = index + 1;
+			return true;
+		}
+	}
+	return false;
+}
+
+} /* namespace adsb */
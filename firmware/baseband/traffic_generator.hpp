@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TRAFFIC_GENERATOR_H__
+#define __TRAFFIC_GENERATOR_H__
+
+#include "adsb_frame.hpp"
+#include "adsb_traffic.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace adsb {
+
+/* Synthetic ADS-B traffic. Aircraft fly straight lines (random traffic turns
+ * back at the edge of its area) and each squitter type is scheduled on its
+ * own randomized interval, as transponders do to avoid synchronous garbling.
+ * Time is counted in samples of the transmit baseband.
+ */
+class TrafficGenerator {
+public:
+	void configure(const ADSBTrafficConfigureMessage& message, const uint32_t sampling_rate, const uint32_t now);
+
+	/* Encodes the next squitter due at time now. Returns false if none is. */
+	bool next_frame(const uint32_t now, ADSBFrame& frame);
+
+	size_t count() const {
+		return count_;
+	}
+
+private:
+	static constexpr size_t squitter_types = 4;
+
+	struct Aircraft {
+		AircraftConfig config;
+		float altitude;
+		float radius_nm;		// 0 for no limit
+		uint32_t last_move;
+		uint32_t cpr_parity;
+		std::array<uint32_t, squitter_types> next_due;
+	};
+
+	std::array<Aircraft, traffic_max + 1> aircraft { };
+	size_t count_ { 0 };
+	size_t next_index { 0 };
+	uint32_t sampling_rate { 0 };
+	float center_latitude { 0 };
+	float center_longitude { 0 };
+	uint32_t random_state { 1 };
+
+	uint32_t random();
+	uint32_t random_range(const uint32_t min, const uint32_t max);
+	uint32_t interval(const size_t type);
+
+	void make_traffic(Aircraft& a, const size_t index, const uint32_t radius_nm);
+	void schedule(Aircraft& a, const uint32_t now);
+	void move(Aircraft& a, const uint32_t now);
+	void encode(Aircraft& a, const size_t type, ADSBFrame& frame);
+};
+
+} /* namespace adsb */
+
+#endif/*__TRAFFIC_GENERATOR_H__*/
@@ -36,18 +36,24 @@ void make_frame_adsb(ADSBFrame& frame, const uint32_t ICAO_address) {
 }
 
 void encode_frame_id(ADSBFrame& frame, const uint32_t ICAO_address, const std::string& callsign) {
-	std::string callsign_formatted(8, '_');
+	encode_frame_id(frame, ICAO_address, callsign.c_str());
+}
+
+void encode_frame_id(ADSBFrame& frame, const uint32_t ICAO_address, const char* callsign) {
 	uint64_t callsign_coded = 0;
 	uint32_t c, s;
 	char ch;
+	bool ended = false;
 	
 	make_frame_adsb(frame, ICAO_address);
 	
 	frame.push_byte(TC_IDENT << 3);		// No aircraft category
 	
-	// Translate and encode callsign
+	// Translate and encode callsign, padded with spaces
 	for (c = 0; c < 8; c++) {
-		ch = callsign[c];
+		if (!callsign[c])
+			ended = true;
+		ch = ended ? ' ' : callsign[c];
 		
 		for (s = 0; s < 64; s++)
 			if (ch == icao_id_lut[s]) break;
@@ -100,39 +106,44 @@ std::string decode_frame_id(ADSBFrame& frame) {
 	frame.make_CRC();
 }*/
 
+// Squawk as four octal digits packed in nibbles (0xABCD) to the 13-bit
+// identity field, sent as C1 A1 C2 A2 C4 A4 X B1 D1 B2 D2 B4 D4
+uint32_t encode_id13(const uint32_t squawk) {
+	return	((squawk << 8) & 0x1000) |	// C1
+			((squawk >> 1) & 0x0800) |	// A1
+			((squawk << 5) & 0x0400) |	// C2
+			((squawk >> 4) & 0x0200) |	// A2
+			((squawk << 2) & 0x0100) |	// C4
+			((squawk >> 7) & 0x0080) |	// A4
+			((squawk >> 3) & 0x0020) |	// B1
+			((squawk << 4) & 0x0010) |	// D1
+			((squawk >> 6) & 0x0008) |	// B2
+			((squawk << 1) & 0x0004) |	// D2
+			((squawk >> 9) & 0x0002) |	// B4
+			((squawk >> 2) & 0x0001);	// D4
+}
+
 void encode_frame_squawk(ADSBFrame& frame, const uint32_t squawk) {
-	uint32_t squawk_coded;
+	const uint32_t squawk_coded = encode_id13(squawk);
 	
 	frame.clear();
 	
-	frame.push_byte(DF_EHS_SQUAWK << 3);	// DF
-	frame.push_byte(0);
+	frame.push_byte(DF_EHS_SQUAWK << 3);	// DF, FS = 0
+	frame.push_byte(0);						// DR, UM = 0
+	frame.push_byte(squawk_coded >> 8);
+	frame.push_byte(squawk_coded);
+	
+	frame.make_CRC();
+}
+
+void encode_frame_status(ADSBFrame& frame, const uint32_t ICAO_address, const uint32_t squawk) {
+	const uint32_t squawk_coded = encode_id13(squawk);
+	
+	make_frame_adsb(frame, ICAO_address);
 	
-	// 12 11 10  9  8  7  6  5  4  3  2  1  0
-	// 31 30 29 28 27 26 25 24 23 22 21 20 19
-	// D4 B4 D2 B2 D1 B1 __ A4 C4 A2 C2 A1 C1
-	// ABCD = code (octal, 0000~7777)
-	
-	// FEDCBA9876543210
-	// xAAAxBBBxCCCxDDD
-	// x421x421x421x421
-	
-	squawk_coded = ((squawk << 10) & 0x1000) |	// D4
-					((squawk << 1) & 0x0800) |	// B4
-					((squawk << 9) & 0x0400) |	// D2
-					((squawk << 0) & 0x0200) |	// B2
-					((squawk << 8) & 0x0100) |	// D1
-					((squawk >> 1) & 0x0080) |	// B1
-					
-					((squawk >> 9) & 0x0020) |	// A4
-					((squawk >> 2) & 0x0010) |	// C4
-					((squawk >> 10) & 0x0008) |	// A2
-					((squawk >> 3) & 0x0004) |	// C2
-					((squawk >> 11) & 0x0002) |	// A1
-					((squawk >> 4) & 0x0001);	// C1
-	
-	frame.push_byte(squawk_coded >> 5);
-	frame.push_byte(squawk_coded << 3);
+	frame.push_byte((TC_STATUS << 3) | 1);	// Subtype 1: emergency/priority status and Mode A code
+	frame.push_byte(squawk_coded >> 8);		// No emergency
+	frame.push_byte(squawk_coded);
 	
 	frame.make_CRC();
 }
@@ -311,10 +322,11 @@ void encode_frame_velo(ADSBFrame& frame, const uint32_t ICAO_address, const uint
 	uint32_t velo_ew_abs, velo_ns_abs, v_rate_coded_abs;
 	
 	// To get NS and EW speeds from speed and bearing, a polar to cartesian conversion is enough
-	velo_ew = static_cast<int32_t>(sin_f32(DEG_TO_RAD(angle) + (pi / 2)) * speed);
-	velo_ns = static_cast<int32_t>(sin_f32(DEG_TO_RAD(angle)) * speed);
+	velo_ew = static_cast<int32_t>(sin_f32(DEG_TO_RAD(angle)) * speed);
+	velo_ns = static_cast<int32_t>(sin_f32(DEG_TO_RAD(angle) + (pi / 2)) * speed);
 	
-	v_rate_coded = (v_rate / 64) + 1;
+	// Sign and magnitude, the magnitude is in 64 ft/min steps plus one
+	v_rate_coded = (v_rate < 0) ? -((-v_rate / 64) + 1) : ((v_rate / 64) + 1);
 	
 	velo_ew_abs = abs(velo_ew) + 1; 
 	velo_ns_abs = abs(velo_ns) + 1;
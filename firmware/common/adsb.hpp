@@ -39,7 +39,8 @@ enum downlink_format {
 enum type_code {
 	TC_IDENT = 4,
 	TC_AIRBORNE_POS = 11,
-	TC_AIRBORNE_VELO = 19
+	TC_AIRBORNE_VELO = 19,
+	TC_STATUS = 28
 };
 
 enum data_selector {
@@ -90,6 +91,7 @@ const float NZ = 15.0;
 void make_frame_adsb(ADSBFrame& frame, const uint32_t ICAO_address);
 
 void encode_frame_id(ADSBFrame& frame, const uint32_t ICAO_address, const std::string& callsign);
+void encode_frame_id(ADSBFrame& frame, const uint32_t ICAO_address, const char* callsign);
 std::string decode_frame_id(ADSBFrame& frame);
 
 void encode_frame_pos(ADSBFrame& frame, const uint32_t ICAO_address, const int32_t altitude,
@@ -104,7 +106,9 @@ adsb_vel decode_frame_velo(ADSBFrame& frame);
 
 //void encode_frame_emergency(ADSBFrame& frame, const uint32_t ICAO_address, const uint8_t code);
 
+uint32_t encode_id13(const uint32_t squawk);
 void encode_frame_squawk(ADSBFrame& frame, const uint32_t squawk);
+void encode_frame_status(ADSBFrame& frame, const uint32_t ICAO_address, const uint32_t squawk);
 
 } /* namespace adsb */
 
@@ -26,6 +26,8 @@
 #include <cstring>
 #include <string>
 
+#include "crc.hpp"
+
 namespace adsb {
 
 alignas(4) const uint8_t adsb_preamble[16] = { 1, 0, 1, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0 };
@@ -103,26 +105,10 @@ private:
 	uint32_t rx_timestamp { };
 
 	uint32_t compute_CRC() {
-		uint8_t adsb_crc[14] = { 0 };	// Temp buffer
-		uint8_t b, c, s, bitn;
-		const uint32_t crc_poly = 0x1205FFF;
-		
-		// Copy frame data
-		memcpy(adsb_crc, raw_data, 11);
-		
-		// Compute CRC
-		for (c = 0; c < 11; c++) {
-			for (b = 0; b < 8; b++) {
-				if ((adsb_crc[c] << b) & 0x80) {
-					for (s = 0; s < 25; s++) {
-						bitn = (c * 8) + b + s;
-						if ((crc_poly >> s) & 1) adsb_crc[bitn >> 3] ^= (0x80 >> (bitn & 7));
-					}
-				}
-			}
-		}
-		
-		return (adsb_crc[11] << 16) + (adsb_crc[12] << 8) + adsb_crc[13];
+		// Mode S parity, generator 0x1FFF409 over the first 88 bits
+		CRC<24, 0xfff409> crc { };
+		crc.process_bytes(raw_data, 11);
+		return crc.checksum();
 	}
 };
 
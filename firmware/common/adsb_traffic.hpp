@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __ADSB_TRAFFIC_H__
+#define __ADSB_TRAFFIC_H__
+
+#include <cstdint>
+#include <cstddef>
+
+namespace adsb {
+
+/* Extended squitters an aircraft sends, as a bit mask */
+enum squitter_type : uint8_t {
+	SQUITTER_POSITION = 1,
+	SQUITTER_VELOCITY = 2,
+	SQUITTER_IDENTITY = 4,
+	SQUITTER_STATUS = 8,
+	SQUITTER_ALL = 15
+};
+
+/* One aircraft of the traffic generator (proc_adsbtx) */
+struct AircraftConfig {
+	uint32_t ICAO_address;
+	char callsign[9];
+	uint8_t squitters;
+	uint16_t squawk;		// Octal digits in nibbles, 0x7700 is 7700
+	float latitude;
+	float longitude;
+	int32_t altitude;		// ft
+	uint16_t speed;			// kn
+	uint16_t heading;		// Degrees true
+	int16_t v_rate;			// ft/min
+};
+
+constexpr size_t traffic_max = 64;
+
+} /* namespace adsb */
+
+#endif/*__ADSB_TRAFFIC_H__*/
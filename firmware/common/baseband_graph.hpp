@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BASEBAND_GRAPH_H__
+#define __BASEBAND_GRAPH_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Stage descriptors for the baseband graph image (proc_graph). Shared by the
+ * M0, which builds the chain, and the M4, which instantiates it. Checking is
+ * constexpr so that chains known at compile time can be static_assert'ed.
+ */
+
+namespace baseband {
+namespace graph {
+
+constexpr size_t stages_max = 10;
+
+enum class SampleType : uint8_t {
+	None = 0,		// Sink, no output
+	C8,				// complex8_t, raw baseband
+	C16,			// complex16_t
+	S16,			// int16_t, real
+	F32,			// float, real
+	Bits,			// uint8_t, one sliced symbol per byte
+};
+
+enum class StageKind : uint8_t {
+	End = 0,
+	Decim0By4,		// C8 -> C16, FIRC8xR16x24FS4Decim4, decim_0 taps
+	Decim0By8,		// C8 -> C16, FIRC8xR16x24FS4Decim8, decim_0 taps
+	Decim1By8,		// C16 -> C16, FIRC16xR16x32Decim8, decim_1 taps
+	ChannelFilter,	// C16 -> C16, FIRAndDecimateComplex, channel taps, param = decimation
+	ChannelStats,	// C16 -> C16, pass-through, feeds channel statistics
+	ChannelSpectrum,// C16 -> C16, pass-through, feeds channel spectrum
+	DemodFM,		// C16 -> S16, param = deviation (Hz)
+	DemodAM,		// C16 -> F32
+	AudioSinkS16,	// S16 -> None, AudioOutput
+	AudioSinkF32,	// F32 -> None, AudioOutput
+	Squelch,		// C16 -> C16, pass-through, carrier squelch gating AudioOutput
+	SliceFSK,		// C16 -> Bits, matched filter and clock recovery, param = symbol rate,
+					// 2FSK with a modulation index of 0.5 (deviation = symbol rate / 4)
+	DecodeNRZI,		// Bits -> Bits, in place
+	PacketHDLC,		// Bits -> None, unstuffed flag delimited frames, param = PacketKind
+};
+
+/* What a PacketHDLC sink posts its frames as. */
+enum class PacketKind : int32_t {
+	AIS = 0,
+};
+
+struct StageConfig {
+	StageKind kind;
+	int32_t param;
+};
+
+using stages_t = std::array<StageConfig, stages_max>;
+
+constexpr SampleType input_type(const StageKind kind) {
+	switch(kind) {
+	case StageKind::Decim0By4:
+	case StageKind::Decim0By8:
+		return SampleType::C8;
+
+	case StageKind::Decim1By8:
+	case StageKind::ChannelFilter:
+	case StageKind::ChannelStats:
+	case StageKind::ChannelSpectrum:
+	case StageKind::Squelch:
+	case StageKind::DemodFM:
+	case StageKind::DemodAM:
+		return SampleType::C16;
+
+	case StageKind::SliceFSK:
+		return SampleType::C16;
+
+	case StageKind::DecodeNRZI:
+	case StageKind::PacketHDLC:
+		return SampleType::Bits;
+
+	case StageKind::AudioSinkS16:
+		return SampleType::S16;
+
+	case StageKind::AudioSinkF32:
+		return SampleType::F32;
+
+	default:
+		return SampleType::None;
+	}
+}
+
+constexpr SampleType output_type(const StageKind kind) {
+	switch(kind) {
+	case StageKind::Decim0By4:
+	case StageKind::Decim0By8:
+	case StageKind::Decim1By8:
+	case StageKind::ChannelFilter:
+	case StageKind::ChannelStats:
+	case StageKind::ChannelSpectrum:
+	case StageKind::Squelch:
+		return SampleType::C16;
+
+	case StageKind::DemodFM:
+		return SampleType::S16;
+
+	case StageKind::DemodAM:
+		return SampleType::F32;
+
+	case StageKind::SliceFSK:
+	case StageKind::DecodeNRZI:
+		return SampleType::Bits;
+
+	default:
+		return SampleType::None;
+	}
+}
+
+/* Decimation applied by a stage, 0 if invalid. Symbol rate stages are 1, what
+ * follows them doesn't depend on the sampling rate.
+ */
+constexpr size_t decimation_factor(const StageConfig& stage) {
+	switch(stage.kind) {
+	case StageKind::Decim0By4:	return 4;
+	case StageKind::Decim0By8:	return 8;
+	case StageKind::Decim1By8:	return 8;
+	case StageKind::ChannelFilter:
+		return (stage.param > 0) ? stage.param : 0;
+	case StageKind::SliceFSK:
+		return (stage.param > 0) ? 1 : 0;
+	default:					return 1;
+	}
+}
+
+constexpr size_t stage_count(const stages_t& stages) {
+	size_t n = 0;
+	while( (n < stages.size()) && (stages[n].kind != StageKind::End) ) {
+		n++;
+	}
+	return n;
+}
+
+/* A chain is valid if it starts on raw baseband, every stage accepts what the
+ * previous one produces, and it ends with exactly one sink.
+ */
+constexpr bool is_valid(const stages_t& stages) {
+	const auto count = stage_count(stages);
+	if( count == 0 ) {
+		return false;
+	}
+
+	SampleType current = SampleType::C8;
+	for(size_t i=0; i<count; i++) {
+		const auto& stage = stages[i];
+		if( input_type(stage.kind) != current ) {
+			return false;
+		}
+		if( decimation_factor(stage) == 0 ) {
+			return false;
+		}
+		current = output_type(stage.kind);
+		if( (current == SampleType::None) && (i != count - 1) ) {
+			return false;
+		}
+	}
+
+	return current == SampleType::None;
+}
+
+/* AIS, 9600 baud GMSK with NRZI and HDLC framing, at 2.4576MHz. Replaces the
+ * former proc_ais image.
+ */
+constexpr stages_t stages_ais { {
+	{ StageKind::Decim0By8, 0 },
+	{ StageKind::Decim1By8, 0 },
+	{ StageKind::ChannelStats, 0 },
+	{ StageKind::SliceFSK, 9600 },
+	{ StageKind::DecodeNRZI, 0 },
+	{ StageKind::PacketHDLC, static_cast<int32_t>(PacketKind::AIS) },
+	{ StageKind::End, 0 },
+} };
+
+static_assert(is_valid(stages_ais), "Invalid AIS graph");
+
+} /* namespace graph */
+} /* namespace baseband */
+
+#endif/*__BASEBAND_GRAPH_H__*/
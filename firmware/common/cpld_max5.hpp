@@ -176,7 +176,7 @@ private:
 
 	bool is_blank_block(const uint16_t id, const size_t count);
 
-	using crc_t = CRC<32, true, true>;
+	using crc_t = CRC<32, 0x04c11db7, true, true>;
 	void block_crc(const uint16_t id, const size_t count, crc_t& crc);
 };
 /*
@@ -40,19 +40,73 @@
  *
  */
 
-template<size_t Width, bool RevIn = false, bool RevOut = false>
+namespace crc_detail {
+
+constexpr uint32_t reflect(uint32_t x, const size_t width) {
+	uint32_t reflection = 0;
+	for(size_t i=0; i<width; ++i) {
+		reflection = (reflection << 1) | (x & 1);
+		x >>= 1;
+	}
+	return reflection;
+}
+
+/* Polynomial as it sits in the internal register, see CRC */
+constexpr uint32_t register_polynomial(const uint32_t polynomial, const size_t width, const bool reflected) {
+	return reflected
+		? reflect(polynomial, width)
+		: static_cast<uint32_t>(static_cast<uint64_t>(polynomial) << (32 - width));
+}
+
+/* Remainder contribution of each Bits wide group shifted out of the register */
+template<size_t Bits>
+constexpr std::array<uint32_t, 1 << Bits> make_table(const uint32_t polynomial, const bool reflected) {
+	std::array<uint32_t, 1 << Bits> result { };
+	for(size_t i=0; i<result.size(); i++) {
+		uint32_t r = reflected ? i : (static_cast<uint32_t>(i) << (32 - Bits));
+		for(size_t bit=0; bit<Bits; bit++) {
+			if( reflected ) {
+				r = (r >> 1) ^ ((r & 1) ? polynomial : 0);
+			} else {
+				r = (r << 1) ^ ((r & 0x80000000U) ? polynomial : 0);
+			}
+		}
+		result[i] = r;
+	}
+	return result;
+}
+
+} /* namespace crc_detail */
+
+/* Lookup table size, trading flash for speed: a byte table is 1KB and takes one
+ * lookup per byte, a nibble table is 64 bytes and takes two.
+ */
+enum class CRCTable {
+	Nibble,
+	Byte,
+};
+
+/* Polynomial is the truncated polynomial (without the x^Width term). With
+ * RevIn, each byte (or group of bits) is fed LSB first; with RevOut the
+ * remainder is reflected before the final XOR. The table is built at compile
+ * time for each polynomial/RevIn pair, so every instance shares it.
+ *
+ * Internally the remainder is kept left aligned in 32 bits, or reflected when
+ * RevIn is set, so that whole bytes can be consumed with a single lookup.
+ */
+template<size_t Width, uint32_t Polynomial, bool RevIn = false, bool RevOut = false, CRCTable Table = CRCTable::Byte>
 class CRC {
 public:
 	using value_type = uint32_t;
 
+	static_assert((Width > 0) && (Width <= 32), "CRC width out of range");
+
 	constexpr CRC(
-		const value_type truncated_polynomial,
 		const value_type initial_remainder = 0,
 		const value_type final_xor_value = 0
-	) : truncated_polynomial { truncated_polynomial },
-		initial_remainder { initial_remainder },
+	) : initial_remainder { initial_remainder },
 		final_xor_value { final_xor_value },
-		remainder { initial_remainder }
+		state { to_state(initial_remainder) }
 	{
 	}
 
@@ -61,32 +115,62 @@ public:
 	}
 
 	void reset(value_type new_initial_remainder) {
-		remainder = new_initial_remainder;
+		state = to_state(new_initial_remainder);
 	}
 
 	void reset() {
-		remainder = initial_remainder;
+		state = to_state(initial_remainder);
 	}
 
 	void process_bit(bool bit) {
-		remainder ^= (bit ? top_bit() : 0U);
-		const auto do_poly_div = static_cast<bool>(remainder & top_bit());
-		remainder <<= 1;
-		if( do_poly_div ) {
-			remainder ^= truncated_polynomial;
+		if( RevIn ) {
+			state ^= (bit ? 1U : 0U);
+			state = (state >> 1) ^ ((state & 1) ? poly_state : 0);
+		} else {
+			state ^= (bit ? top_bit : 0U);
+			state = (state << 1) ^ ((state & top_bit) ? poly_state : 0);
 		}
 	}
 
+	/* Streams bit_count bits (up to 32), whole bytes through the table and the
+	 * rest one bit at a time. The first bit is the LSB with RevIn, the MSB
+	 * (of bit_count) otherwise.
+	 */
 	void process_bits(value_type bits, size_t bit_count) {
 		if( RevIn ) {
-			process_bits_lsb_first(bits, bit_count);
+			for(; bit_count >= 8; bit_count -= 8, bits >>= 8) {
+				process_byte(bits & 0xff);
+			}
+			for(; bit_count > 0; --bit_count, bits >>= 1) {
+				process_bit(bits & 1);
+			}
 		} else {
-			process_bits_msb_first(bits, bit_count);
+			for(; bit_count >= 8; bit_count -= 8) {
+				process_byte((bits >> (bit_count - 8)) & 0xff);
+			}
+			while( bit_count > 0 ) {
+				--bit_count;
+				process_bit((bits >> bit_count) & 1);
+			}
 		}
 	}
 
 	void process_byte(const uint8_t byte) {
-		process_bits(byte, 8);
+		if( RevIn ) {
+			if( Table == CRCTable::Byte ) {
+				state = (state >> 8) ^ table[(state ^ byte) & 0xff];
+			} else {
+				state = (state >> 4) ^ table[(state ^ byte) & 0x0f];
+				state = (state >> 4) ^ table[(state ^ (byte >> 4)) & 0x0f];
+			}
+		} else {
+			if( Table == CRCTable::Byte ) {
+				state = (state << 8) ^ table[(state >> 24) ^ byte];
+			} else {
+				state = (state << 4) ^ table[(state >> 28) ^ (byte >> 4)];
+				state = (state << 4) ^ table[(state >> 28) ^ (byte & 0x0f)];
+			}
+		}
 	}
 
 	void process_bytes(const void* const data, const size_t length) {
@@ -102,54 +186,32 @@ public:
 	}
 
 	value_type checksum() const {
-		return ((RevOut ? reflect(remainder) : remainder) ^ final_xor_value) & mask();
+		// A reflected state is already the reflected remainder
+		const value_type remainder = RevIn ? state : (state >> (32 - Width));
+		return (((RevIn != RevOut) ? reflect(remainder) : remainder) ^ final_xor_value) & mask();
 	}
 
 private:
-	const value_type truncated_polynomial;
+	static constexpr value_type top_bit = 0x80000000U;
+	static constexpr value_type poly_state = crc_detail::register_polynomial(Polynomial, Width, RevIn);
+	static constexpr auto table = crc_detail::make_table<(Table == CRCTable::Byte) ? 8 : 4>(poly_state, RevIn);
+
 	const value_type initial_remainder;
 	const value_type final_xor_value;
-	value_type remainder;
-
-	static constexpr size_t width() {
-		return Width;
-	}
-
-	static constexpr value_type top_bit() {
-		return 1U << (width() - 1);
-	}
+	value_type state;
 
 	static constexpr value_type mask() {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wshift-count-overflow"
-		return (~(~(0UL) << width()));
-#pragma GCC diagnostic pop
-	}
-
-	static value_type reflect(value_type x) {
-		value_type reflection = 0;
-		for(size_t i=0; i<width(); ++i) {
-			reflection <<= 1;
-			reflection |= (x & 1);
-			x >>= 1;
-		}
-		return reflection;
+		return static_cast<value_type>((static_cast<uint64_t>(1) << Width) - 1);
 	}
 
-	void process_bits_msb_first(value_type bits, size_t bit_count) {
-		constexpr auto digits = std::numeric_limits<value_type>::digits;
-		constexpr auto mask = static_cast<value_type>(1) << (digits - 1);
-
-		bits <<= (std::numeric_limits<value_type>::digits - bit_count);
-		for(size_t i=bit_count; i>0; --i, bits <<= 1) {
-			process_bit(static_cast<bool>(bits & mask));
-		}
+	static constexpr value_type reflect(const value_type x) {
+		return crc_detail::reflect(x, Width);
 	}
 
-	void process_bits_lsb_first(value_type bits, size_t bit_count) {
-		for(size_t i=bit_count; i>0; --i, bits >>= 1) {
-			process_bit(static_cast<bool>(bits & 0x01));
-		}
+	static constexpr value_type to_state(const value_type remainder) {
+		return RevIn
+			? reflect(remainder & mask())
+			: static_cast<value_type>(static_cast<uint64_t>(remainder & mask()) << (32 - Width));
 	}
 };
 
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DCS_CODES_H__
+#define __DCS_CODES_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* DCS codewords are (23,12) Golay codewords: 9 code bits, the fixed 100
+ * marker, then 11 parity bits. Transmitted LSB first, repeated continuously
+ * at 134.4 bps. Any rotation of a codeword is a codeword, so a receiver that
+ * doesn't know where the word starts can still check it with the syndrome.
+ */
+
+namespace dcs {
+
+constexpr uint32_t bit_rate_x10 = 1344;
+constexpr size_t word_bits = 23;
+constexpr uint32_t word_mask = (1UL << word_bits) - 1;
+
+// x^11 + x^10 + x^6 + x^5 + x^4 + x^2 + 1
+constexpr uint32_t generator = 0xc75;
+
+constexpr uint32_t code_mask = 0x1ff;
+constexpr uint32_t marker = 0b100 << 9;
+constexpr uint32_t marker_mask = 0b111 << 9;
+
+/* Code numbers are octal, as printed on radios: 023 is 0023 here */
+constexpr std::array<uint16_t, 104> standard_codes { {
+	0023, 0025, 0026, 0031, 0032, 0036, 0043, 0047, 0051, 0053, 0054, 0065, 0071,
+	0072, 0073, 0074, 0114, 0115, 0116, 0122, 0125, 0131, 0132, 0134, 0143, 0145,
+	0152, 0155, 0156, 0162, 0165, 0172, 0174, 0205, 0212, 0223, 0225, 0226, 0243,
+	0244, 0245, 0246, 0251, 0252, 0255, 0261, 0263, 0265, 0266, 0271, 0274, 0306,
+	0311, 0315, 0325, 0331, 0332, 0343, 0346, 0351, 0356, 0364, 0365, 0371, 0411,
+	0412, 0413, 0423, 0431, 0432, 0445, 0446, 0452, 0454, 0455, 0462, 0464, 0465,
+	0466, 0503, 0506, 0516, 0523, 0526, 0532, 0546, 0565, 0606, 0612, 0624, 0627,
+	0631, 0632, 0654, 0662, 0664, 0703, 0712, 0723, 0731, 0732, 0734, 0743, 0754,
+} };
+
+constexpr bool is_standard(const uint32_t code) {
+	for(const auto c : standard_codes) {
+		if( c == code ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Same equations as tools/make_dcs.py */
+constexpr uint32_t parity(const uint32_t code) {
+	uint32_t b[9] { };
+	for(size_t i=0; i<9; i++) {
+		b[i] = (code >> i) & 1;
+	}
+	return
+		((b[0] ^ b[1] ^ b[2] ^ b[3] ^ b[4] ^ b[7]) << 0) |
+		((b[1] ^ b[2] ^ b[3] ^ b[4] ^ b[5] ^ b[8] ^ 1) << 1) |
+		((b[0] ^ b[1] ^ b[5] ^ b[6] ^ b[7]) << 2) |
+		((b[1] ^ b[2] ^ b[6] ^ b[7] ^ b[8] ^ 1) << 3) |
+		((b[0] ^ b[1] ^ b[4] ^ b[8] ^ 1) << 4) |
+		((b[0] ^ b[3] ^ b[4] ^ b[5] ^ b[7] ^ 1) << 5) |
+		((b[0] ^ b[2] ^ b[3] ^ b[5] ^ b[6] ^ b[7] ^ b[8]) << 6) |
+		((b[1] ^ b[3] ^ b[4] ^ b[6] ^ b[7] ^ b[8]) << 7) |
+		((b[2] ^ b[4] ^ b[5] ^ b[7] ^ b[8]) << 8) |
+		((b[3] ^ b[5] ^ b[6] ^ b[8] ^ 1) << 9) |
+		((b[0] ^ b[1] ^ b[2] ^ b[3] ^ b[6] ^ 1) << 10);
+}
+
+constexpr uint32_t codeword(const uint32_t code) {
+	return (parity(code & code_mask) << 12) | marker | (code & code_mask);
+}
+
+/* Remainder of the word divided by the generator, 0 for any codeword */
+constexpr uint32_t syndrome(uint32_t word) {
+	for(size_t bit=word_bits - 1; bit>=11; bit--) {
+		if( word & (1UL << bit) ) {
+			word ^= generator << (bit - 11);
+		}
+	}
+	return word;
+}
+
+constexpr uint32_t rotate(const uint32_t word, const size_t n) {
+	return ((word >> n) | (word << (word_bits - n))) & word_mask;
+}
+
+static_assert(syndrome(codeword(0023)) == 0, "DCS generator doesn't match parity equations");
+static_assert(syndrome(rotate(codeword(0754), 5)) == 0, "DCS code isn't cyclic");
+static_assert(syndrome(codeword(0754) ^ word_mask) == 0, "DCS inverted word isn't a codeword");
+
+} /* namespace dcs */
+
+#endif/*__DCS_CODES_H__*/
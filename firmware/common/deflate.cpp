@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "deflate.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr std::array<uint16_t, 29> length_base { {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+} };
+
+constexpr std::array<uint16_t, 30> distance_base { {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+} };
+
+constexpr size_t length_extra(const size_t code) {
+	return ((code < 8) || (code == 28)) ? 0 : ((code - 4) / 4);
+}
+
+constexpr size_t distance_extra(const size_t code) {
+	return (code < 4) ? 0 : ((code / 2) - 1);
+}
+
+/* Huffman codes are sent MSB first, everything else LSB first */
+constexpr uint32_t reverse_bits(uint32_t value, size_t count) {
+	uint32_t result = 0;
+	while( count-- ) {
+		result = (result << 1) | (value & 1);
+		value >>= 1;
+	}
+	return result;
+}
+
+} /* namespace */
+
+Deflate::Deflate(
+	Sink sink
+) : sink { sink }
+{
+	reset();
+}
+
+void Deflate::reset() {
+	head.fill(nil);
+	fill = 0;
+	pos = 0;
+	out_count = 0;
+	bits = 0;
+	bit_count = 0;
+
+	put_bits(1, 1);		// BFINAL, the whole stream is one block
+	put_bits(1, 2);		// BTYPE = 01, fixed Huffman codes
+}
+
+void Deflate::write(const void* const data, const size_t count) {
+	auto p = reinterpret_cast<const uint8_t*>(data);
+	size_t remaining = count;
+
+	while( remaining ) {
+		if( fill == buffer.size() ) {
+			slide();
+		}
+
+		const auto n = std::min(remaining, buffer.size() - fill);
+		memcpy(&buffer[fill], p, n);
+		fill += n;
+		p += n;
+		remaining -= n;
+
+		compress(false);
+	}
+}
+
+void Deflate::finish() {
+	compress(true);
+	put_symbol(256);	// End of block
+
+	if( bit_count > 0 ) {
+		put_bits(0, 8 - bit_count);
+	}
+	flush_out();
+}
+
+size_t Deflate::hash(const size_t at) const {
+	const uint32_t v = (buffer[at] << 16) | (buffer[at + 1] << 8) | buffer[at + 2];
+	return (v * 2654435761U) >> (32 - hash_bits);
+}
+
+void Deflate::insert(const size_t at) {
+	head[hash(at)] = at;
+}
+
+void Deflate::compress(const bool flush) {
+	// Leave a full match of lookahead unless this is the end of the stream
+	const size_t lookahead = flush ? 1 : match_max;
+
+	while( (fill - pos) >= lookahead ) {
+		const size_t available = fill - pos;
+		size_t length = 0;
+		size_t distance = 0;
+
+		if( available >= match_min ) {
+			const auto h = hash(pos);
+			const auto candidate = head[h];
+			head[h] = pos;
+
+			if( candidate != nil ) {
+				const size_t limit = std::min(available, match_max);
+				const uint8_t* const a = &buffer[candidate];
+				const uint8_t* const b = &buffer[pos];
+				while( (length < limit) && (a[length] == b[length]) ) {
+					length++;
+				}
+				distance = pos - candidate;
+			}
+		}
+
+		if( length >= match_min ) {
+			put_match(length, distance);
+			if( length <= insert_max ) {
+				const size_t end = std::min(pos + length, fill - (match_min - 1));
+				for(size_t i=pos + 1; i<end; i++) {
+					insert(i);
+				}
+			}
+			pos += length;
+		} else {
+			put_symbol(buffer[pos]);
+			pos++;
+		}
+	}
+}
+
+void Deflate::slide() {
+	// compress() always leaves less than match_max bytes, so pos is past the first half
+	memmove(&buffer[0], &buffer[window_size], fill - window_size);
+	fill -= window_size;
+	pos -= window_size;
+
+	for(auto& entry : head) {
+		entry = (entry >= (int16_t)window_size) ? (entry - window_size) : nil;
+	}
+}
+
+void Deflate::put_bits(const uint32_t value, const size_t count) {
+	bits |= value << bit_count;
+	bit_count += count;
+
+	while( bit_count >= 8 ) {
+		out[out_count++] = bits & 0xff;
+		bits >>= 8;
+		bit_count -= 8;
+
+		if( out_count == out.size() ) {
+			flush_out();
+		}
+	}
+}
+
+void Deflate::put_symbol(const size_t symbol) {
+	// Fixed literal/length code, RFC 1951 3.2.6
+	if( symbol < 144 ) {
+		put_bits(reverse_bits(0x30 + symbol, 8), 8);
+	} else if( symbol < 256 ) {
+		put_bits(reverse_bits(0x190 + symbol - 144, 9), 9);
+	} else if( symbol < 280 ) {
+		put_bits(reverse_bits(symbol - 256, 7), 7);
+	} else {
+		put_bits(reverse_bits(0xc0 + symbol - 280, 8), 8);
+	}
+}
+
+void Deflate::put_match(const size_t length, const size_t distance) {
+	size_t code = length_base.size() - 1;
+	while( length < length_base[code] ) {
+		code--;
+	}
+	put_symbol(257 + code);
+	put_bits(length - length_base[code], length_extra(code));
+
+	code = distance_base.size() - 1;
+	while( distance < distance_base[code] ) {
+		code--;
+	}
+	put_bits(reverse_bits(code, 5), 5);
+	put_bits(distance - distance_base[code], distance_extra(code));
+}
+
+void Deflate::flush_out() {
+	if( out_count > 0 ) {
+		sink(out.data(), out_count);
+		out_count = 0;
+	}
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DEFLATE_H__
+#define __DEFLATE_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <functional>
+
+/* Streaming DEFLATE (RFC 1951) compressor sized for the M0. Greedy LZ77 over a
+ * 1KB window, one hash probe per byte, everything coded in a single fixed
+ * Huffman block. Memory use is fixed at construction, nothing is allocated
+ * while compressing. Compressed bytes are handed to the sink as they fill up.
+ */
+class Deflate {
+public:
+	using Sink = std::function<void(const uint8_t* const, const size_t)>;
+
+	Deflate(Sink sink);
+
+	/* Starts a new, independent stream */
+	void reset();
+
+	void write(const void* const data, const size_t count);
+
+	/* Codes what is still buffered and ends the stream on a byte boundary. */
+	void finish();
+
+private:
+	static constexpr size_t window_size = 1024;
+	static constexpr size_t hash_bits = 9;
+	static constexpr size_t match_min = 3;
+	static constexpr size_t match_max = 258;
+	// Longer matches aren't indexed, long runs would otherwise cost a hash per byte
+	static constexpr size_t insert_max = 32;
+	static constexpr int16_t nil = -1;
+
+	Sink sink;
+	std::array<uint8_t, window_size * 2> buffer { };
+	std::array<int16_t, 1 << hash_bits> head { };
+	std::array<uint8_t, 128> out { };
+	size_t fill { 0 };
+	size_t pos { 0 };
+	size_t out_count { 0 };
+	uint32_t bits { 0 };
+	size_t bit_count { 0 };
+
+	size_t hash(const size_t at) const;
+	void insert(const size_t at);
+	void compress(const bool flush);
+	void slide();
+
+	void put_bits(const uint32_t value, const size_t count);
+	void put_symbol(const size_t symbol);
+	void put_match(const size_t length, const size_t distance);
+	void flush_out();
+};
+
+#endif/*__DEFLATE_H__*/
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "drift_curve.hpp"
+
+#include <algorithm>
+
+namespace drift {
+
+void Curve::clear() {
+	points.fill(unset);
+}
+
+size_t Curve::count() const {
+	return std::count_if(points.begin(), points.end(), [](const int16_t p) { return p != unset; });
+}
+
+int32_t Curve::correction_ppb(const int32_t temperature_q4) const {
+	const int32_t t = std::max<int32_t>(0, std::min<int32_t>(temperature_q4, (points_max - 1) * 16));
+
+	// Nearest learned points at or below, and at or above the temperature
+	int32_t lower = t / 16;
+	while( (lower >= 0) && (points[lower] == unset) ) {
+		lower--;
+	}
+	int32_t upper = (t + 15) / 16;
+	while( (upper < (int32_t)points_max) && (points[upper] == unset) ) {
+		upper++;
+	}
+
+	const bool has_lower = (lower >= 0);
+	const bool has_upper = (upper < (int32_t)points_max);
+
+	if( has_lower && has_upper && (lower != upper) ) {
+		const int32_t p0 = points[lower] * ppb_per_unit;
+		const int32_t p1 = points[upper] * ppb_per_unit;
+		return p0 + (p1 - p0) * (t - lower * 16) / ((upper - lower) * 16);
+	} else if( has_lower ) {
+		return points[lower] * ppb_per_unit;
+	} else if( has_upper ) {
+		return points[upper] * ppb_per_unit;
+	} else {
+		return 0;
+	}
+}
+
+void Curve::learn(const int32_t temperature_q4, const int32_t ppb) {
+	const int32_t index = std::max<int32_t>(0, std::min<int32_t>((temperature_q4 + 8) / 16, points_max - 1));
+	const int32_t value = std::max<int32_t>(INT16_MIN + 1, std::min<int32_t>(ppb / ppb_per_unit, INT16_MAX));
+
+	auto& point = points[index];
+	if( point == unset ) {
+		point = value;
+	} else {
+		// Average with what was learned before, single measurements are noisy
+		point = (point + value) / 2;
+	}
+}
+
+} /* namespace drift */
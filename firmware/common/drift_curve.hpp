@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DRIFT_CURVE_H__
+#define __DRIFT_CURVE_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace drift {
+
+/* Reference frequency correction against the MAX2837 temperature sensor
+ * code, learned from carriers of known frequency. One point per sensor code,
+ * in units of 10 ppb; unlearned codes are interpolated from their neighbours.
+ * Temperatures are sensor codes in Q4 (code * 16), the sensor is filtered
+ * before use. Lives in persistent memory, so it must stay plain data.
+ */
+struct Curve {
+	static constexpr size_t points_max = 32;
+	static constexpr int16_t unset = INT16_MIN;
+	static constexpr int32_t ppb_per_unit = 10;
+
+	std::array<int16_t, points_max> points;
+
+	void clear();
+	size_t count() const;
+
+	/* Correction at a temperature, 0 if nothing was learned yet */
+	int32_t correction_ppb(const int32_t temperature_q4) const;
+
+	/* Blends a measured correction into the point nearest to the temperature */
+	void learn(const int32_t temperature_q4, const int32_t ppb);
+};
+
+} /* namespace drift */
+
+#endif/*__DRIFT_CURVE_H__*/
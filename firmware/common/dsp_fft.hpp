@@ -90,33 +90,55 @@ template<typename T, size_t N>
 void fft_swap_in_place(std::array<T, N>& data) {
 	static_assert(power_of_two(N), "only defined for N == power of two");
 
-	for(size_t i=0; i<N/2; i++) {
+	for(size_t i=0; i<N; i++) {
 		const size_t i_rev = __RBIT(i) >> (32 - log_2(N));
-		std::swap(data[i], data[i_rev]);
+		if( i < i_rev ) {
+			std::swap(data[i], data[i_rev]);
+		}
+	}
+}
+
+template<typename T, size_t N>
+void fft_swap_real(const buffer_s16_t src, std::array<T, N>& dst) {
+	static_assert(power_of_two(N), "only defined for N == power of two");
+
+	/* Pack 2*N real samples into N complex samples (even samples in the real
+	 * part, odd samples in the imaginary part), bit-reversed for
+	 * fft_c_preswapped(). Follow with fft_r_split() to recover the spectrum.
+	 */
+	for(size_t i=0; i<N; i++) {
+		const size_t i_rev = __RBIT(i) >> (32 - log_2(N));
+		dst[i_rev] = {
+			static_cast<typename T::value_type>(src.p[i * 2 + 0]),
+			static_cast<typename T::value_type>(src.p[i * 2 + 1])
+		};
 	}
 }
 
 /* http://beige.ucs.indiana.edu/B673/node14.html */
 /* http://www.drdobbs.com/cpp/a-simple-and-efficient-fft-implementatio/199500857?pgno=3 */
 
+/* Twiddle factor recurrence steps: exp(-j * 2 * pi / 2^(k+1)) - 1 */
+constexpr size_t fft_K_max = 8;
+constexpr std::array<std::complex<float>, fft_K_max> fft_wp_table { {
+	{ -2.0f,                        0.0f                     },	// 2
+	{ -1.0f,                       -1.0f                     },	// 4
+	{ -0.2928932188134524756f,     -0.7071067811865475244f   },	// 8
+	{ -0.076120467488713243872f,   -0.38268343236508977173f  },	// 16
+	{ -0.019214719596769550874f,   -0.19509032201612826785f  },	// 32
+	{ -0.0048152733278031137552f,  -0.098017140329560601994f },	// 64
+	{ -0.0012045437948276072852f,  -0.049067674327418014255f },	// 128
+	{ -0.00030118130379577988423f, -0.024541228522912288032f },	// 256
+} };
+
 template<typename T, size_t N>
 void fft_c_preswapped(std::array<T, N>& data, const size_t from, const size_t to) {
 	static_assert(power_of_two(N), "only defined for N == power of two");
 	constexpr auto K = log_2(N);
 	if ((to > K) || (from > K)) return;
 
-	constexpr size_t K_max = 8;
-	static_assert(K <= K_max, "No FFT twiddle factors for K > 8");
-	static constexpr std::array<std::complex<float>, K_max> wp_table { {
-		{ -2.0f,                        0.0f                     },	// 2
-		{ -1.0f,                       -1.0f                     },	// 4
-		{ -0.2928932188134524756f,     -0.7071067811865475244f   },	// 8
-		{ -0.076120467488713243872f,   -0.38268343236508977173f  },	// 16
-		{ -0.019214719596769550874f,   -0.19509032201612826785f  },	// 32
-		{ -0.0048152733278031137552f,  -0.098017140329560601994f },	// 64
-		{ -0.0012045437948276072852f,  -0.049067674327418014255f },	// 128
-		{ -0.00030118130379577988423f, -0.024541228522912288032f },	// 256
-	} };
+	static_assert(K <= fft_K_max, "No FFT twiddle factors for K > 8");
+	const auto& wp_table = fft_wp_table;
 
 	/* Provide data to this function, pre-swapped. */
 	for(size_t k = from; k < to; k++) {
@@ -135,4 +157,40 @@ void fft_c_preswapped(std::array<T, N>& data, const size_t from, const size_t to
 	}
 }
 
+/* Real-input FFT post-processing ("split" step).
+ * Input: N-point complex FFT (fft_c_preswapped) of 2*N real samples packed by
+ * fft_swap_real().
+ * Output: bins 0..N-1 of the 2*N-point real FFT, in place. Bin 0 holds DC in
+ * the real part and the Nyquist bin (N) in the imaginary part.
+ * Costs about as much as one more FFT stage, so a real FFT is roughly half
+ * the work of a complex FFT of the same length.
+ */
+template<typename T, size_t N>
+void fft_r_split(std::array<T, N>& data) {
+	static_assert(power_of_two(N), "only defined for N == power of two");
+	static_assert(N >= 2, "only defined for N >= 2");
+	static_assert(log_2(N) < fft_K_max, "No FFT twiddle factors for K > 8");
+
+	const auto z0 = data[0];
+	data[0] = { z0.real() + z0.imag(), z0.real() - z0.imag() };
+
+	const auto wp = fft_wp_table[log_2(N)];
+	T w { 1.0f, 0.0f };
+	for(size_t k = 1; k <= N / 2; k++) {
+		w += w * wp;
+
+		const size_t m = N - k;
+		const auto zk = data[k];
+		const auto zm = data[m];
+
+		/* Even/odd sample spectra, scaled by 2 */
+		const T fe { zk.real() + zm.real(), zk.imag() - zm.imag() };
+		const T fo { zk.imag() + zm.imag(), zm.real() - zk.real() };
+		const T t = w * fo;
+
+		data[k] = {  (fe.real() + t.real()) * 0.5f,  (fe.imag() + t.imag()) * 0.5f };
+		data[m] = {  (fe.real() - t.real()) * 0.5f, -(fe.imag() - t.imag()) * 0.5f };
+	}
+}
+
 #endif/*__DSP_FFT_H__*/
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "flex.hpp"
+
+#include "pocsag.hpp"
+#include "string_format.hpp"
+
+#include <array>
+
+namespace flex {
+
+namespace {
+
+constexpr uint32_t data_mask = 0x1FFFFF;
+constexpr uint32_t short_address_offset = 0x8000;
+constexpr uint32_t long_address_offset = 2068480;
+
+/* FLEX sends the 21 data bits LSB first, then BCH and parity: reversed, a
+ * codeword is laid out like a POCSAG one.
+ */
+uint32_t reverse_bits(uint32_t v) {
+	uint32_t result = 0;
+	for(size_t i=0; i<32; i++) {
+		result = (result << 1) | (v & 1);
+		v >>= 1;
+	}
+	return result;
+}
+
+bool correct(uint32_t& word) {
+	uint32_t codeword = reverse_bits(word);
+	const auto errors = pocsag::errorCorrection(&codeword);
+	word = reverse_bits(codeword) & data_mask;
+	return errors < 3;
+}
+
+bool is_idle(const uint32_t word) {
+	return (word == 0) || (word == data_mask);
+}
+
+bool is_long_address(const uint32_t aw) {
+	return (aw < 0x8001) || ((aw > 0x1E0000) && (aw < 0x1F0001)) || (aw > 0x1F7FFE);
+}
+
+void add_char(std::string& text, const uint8_t c) {
+	if( (c >= 0x20) && (c < 0x7F) ) {
+		text += c;
+	} else if( c == '\n' ) {
+		text += ' ';
+	}
+}
+
+std::string decode_alphanumeric(
+	const std::array<uint32_t, words_per_phase>& words,
+	const uint32_t header,
+	const size_t first,
+	const size_t end,
+	bool& fragment
+) {
+	// Fragment number 3 is a whole message, its first character is a
+	// message number, not text
+	const uint32_t frag = (header >> 11) & 3;
+	fragment = ((header >> 10) & 1) != 0;
+
+	std::string text;
+	for(size_t i=first; i<end; i++) {
+		const auto word = words[i];
+		if( (i > first) || (frag != 3) ) {
+			add_char(text, word & 0x7F);
+		}
+		add_char(text, (word >> 7) & 0x7F);
+		add_char(text, (word >> 14) & 0x7F);
+	}
+	return text;
+}
+
+/* BCD digits, LSB first, running across codewords. */
+std::string decode_numeric(
+	const std::array<uint32_t, words_per_phase>& words,
+	uint32_t word,
+	const size_t first,
+	const size_t last,
+	const bool numbered
+) {
+	static constexpr char bcd[] = "0123456789 U -][";
+
+	std::string text;
+	uint8_t digit = 0;
+	// Skip the header bits of the first word
+	size_t count = numbered ? 14 : 6;
+	for(size_t i=first; i<=last; i++) {
+		for(size_t bit=0; bit<21; bit++) {
+			digit = (digit >> 1) | ((word & 1) ? 0x08 : 0);
+			word >>= 1;
+			if( --count == 0 ) {
+				if( digit != 0x0C ) {		// Fill
+					text += bcd[digit];
+				}
+				count = 4;
+			}
+		}
+		if( i < words.size() ) {
+			word = words[i];
+		}
+	}
+	return text;
+}
+
+} /* namespace */
+
+std::string page_type_str(const PageType type) {
+	switch(type) {
+		case SECURE:			return "SEC";
+		case SHORT_INSTRUCTION:	return "INS";
+		case TONE:				return "TON";
+		case STANDARD_NUMERIC:	return "NUM";
+		case SPECIAL_NUMERIC:	return "SNM";
+		case ALPHANUMERIC:		return "ALN";
+		case BINARY:			return "BIN";
+		case NUMBERED_NUMERIC:	return "NNM";
+		default:				return "???";
+	}
+}
+
+std::string phase_str(const Phase& phase) {
+	return to_string_dec_uint(phase.bitrate()) + "/" + char('A' + phase.id);
+}
+
+FrameInfo decode_fiw(const uint32_t fiw) {
+	uint32_t word = fiw;
+	if( !correct(word) ) {
+		return { false, 0, 0 };
+	}
+
+	// Nibbles of the 21 data bits add up to 0xF
+	const uint32_t checksum = (word & 0xF) + ((word >> 4) & 0xF) + ((word >> 8) & 0xF) +
+		((word >> 12) & 0xF) + ((word >> 16) & 0xF) + ((word >> 20) & 0x1);
+
+	return {
+		(checksum & 0xF) == 0xF,
+		static_cast<uint8_t>((word >> 4) & 0xF),
+		static_cast<uint8_t>((word >> 8) & 0x7F)
+	};
+}
+
+size_t decode_phase(const Phase& phase, std::vector<Page>& pages) {
+	auto words = phase.words;
+	std::array<bool, words_per_phase> valid;
+	size_t errors = 0;
+	for(size_t i=0; i<words.size(); i++) {
+		valid[i] = correct(words[i]);
+		if( !valid[i] ) {
+			errors++;
+		}
+	}
+
+	// Block information word: where the address and vector fields start
+	const auto biw = words[0];
+	if( !valid[0] || is_idle(biw) ) {
+		return errors;
+	}
+	const size_t address_start = ((biw >> 8) & 0x03) + 1;
+	const size_t vector_start = (biw >> 10) & 0x3F;
+
+	for(size_t i=address_start; (i < vector_start) && (i < words.size()); i++) {
+		const size_t v = vector_start + i - address_start;
+		if( !valid[i] || is_idle(words[i]) ) {
+			continue;
+		}
+
+		Page page { };
+		page.long_address = is_long_address(words[i]);
+		if( page.long_address ) {
+			// Long addresses take two words, and so do their vectors
+			if( (i + 1 >= words.size()) || (v + 1 >= words.size()) || !valid[i + 1] || !valid[v + 1] ) {
+				i++;
+				continue;
+			}
+			page.capcode = ((words[i + 1] ^ data_mask) << 15) + long_address_offset + words[i];
+		} else {
+			page.capcode = words[i] - short_address_offset;
+		}
+
+		if( (v < words.size()) && valid[v] ) {
+			const auto viw = words[v];
+			page.type = static_cast<PageType>((viw >> 4) & 0x07);
+			const size_t start = (viw >> 7) & 0x7F;
+			const size_t length = (viw >> 14) & 0x7F;
+
+			switch(page.type) {
+			case SECURE:
+			case ALPHANUMERIC:
+				// The message header is in the second vector word of a long address
+				if( page.long_address ) {
+					if( start + length <= words.size() ) {
+						page.text = decode_alphanumeric(words, words[v + 1], start, start + length, page.fragment);
+					}
+				} else if( (start >= 1) && (start + length <= words.size()) && (length >= 1) ) {
+					page.text = decode_alphanumeric(words, words[start], start + 1, start + length, page.fragment);
+				}
+				break;
+
+			case STANDARD_NUMERIC:
+			case SPECIAL_NUMERIC:
+			case NUMBERED_NUMERIC:
+				{
+					// Up to 8 words, the first one in the vector of a long address
+					const size_t last = start + (length & 0x07);
+					const bool numbered = (page.type == NUMBERED_NUMERIC);
+					if( page.long_address ) {
+						page.text = decode_numeric(words, words[v + 1], start, last, numbered);
+					} else if( start < words.size() ) {
+						page.text = decode_numeric(words, words[start], start + 1, last + 1, numbered);
+					}
+				}
+				break;
+
+			default:
+				break;
+			}
+			pages.push_back(page);
+		}
+
+		if( page.long_address ) {
+			i++;
+		}
+	}
+
+	return errors;
+}
+
+} /* namespace flex */
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __FLEX_H__
+#define __FLEX_H__
+
+#include "flex_packet.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace flex {
+
+enum PageType : uint8_t {
+	SECURE = 0,
+	SHORT_INSTRUCTION,
+	TONE,
+	STANDARD_NUMERIC,
+	SPECIAL_NUMERIC,
+	ALPHANUMERIC,
+	BINARY,
+	NUMBERED_NUMERIC
+};
+
+struct FrameInfo {
+	bool valid;
+	uint8_t cycle;
+	uint8_t frame;
+};
+
+struct Page {
+	uint32_t capcode;
+	bool long_address;
+	PageType type;
+	bool fragment;			// More of the message follows in a later frame
+	std::string text;
+};
+
+std::string page_type_str(const PageType type);
+std::string phase_str(const Phase& phase);
+
+FrameInfo decode_fiw(const uint32_t fiw);
+
+/* Error corrects the phase and appends the pages it carries. Pages whose
+ * address or vector can't be corrected are left out. Returns the number of
+ * codewords that couldn't be corrected.
+ */
+size_t decode_phase(const Phase& phase, std::vector<Page>& pages);
+
+} /* namespace flex */
+
+#endif/*__FLEX_H__*/
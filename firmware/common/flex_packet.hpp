@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __FLEX_PACKET_H__
+#define __FLEX_PACKET_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "baseband.hpp"
+
+namespace flex {
+
+/* 11 blocks of 8 interleaved codewords */
+constexpr size_t words_per_phase = 88;
+
+enum PhaseID : uint8_t {
+	PHASE_A = 0,
+	PHASE_B,
+	PHASE_C,
+	PHASE_D
+};
+
+/* One phase of a FLEX frame as received, before error correction. Codewords
+ * hold the first received bit in bit 0.
+ */
+struct Phase {
+	Timestamp timestamp { };
+	uint32_t fiw { 0 };				// Frame information word
+	uint16_t symbol_rate { 0 };
+	uint8_t levels { 0 };			// 2 or 4 level FSK
+	PhaseID id { PHASE_A };
+	std::array<uint32_t, words_per_phase> words { };
+
+	uint32_t bitrate() const {
+		return symbol_rate * ((levels == 4) ? 2 : 1);
+	}
+};
+
+} /* namespace flex */
+
+#endif/*__FLEX_PACKET_H__*/
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __ISM_PACKET_H__
+#define __ISM_PACKET_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "baseband.hpp"
+
+namespace ism {
+
+constexpr size_t pulses_max = 256;
+constexpr size_t bits_max = 128;
+
+enum class Modulation : uint8_t {
+	OOK = 0,	// Envelope, high = carrier on
+	FSK = 1,	// FM discriminator, high = mark (positive deviation)
+};
+
+enum class Coding : uint8_t {
+	PWM = 0,		// Pulse width: short pulse = 1, long pulse = 0
+	PPM,			// Gap width: short gap = 0, long gap = 1
+	Manchester,		// Half bits of short_us, 10 = 1, 01 = 0
+	NRZ,			// Each short_us period is one bit, high = 1
+};
+
+/* One pulse and the gap that follows it, in samples. */
+struct Pulse {
+	uint16_t high;
+	uint16_t low;
+};
+
+struct PulseTrain {
+	Modulation modulation { Modulation::OOK };
+	uint32_t sampling_rate { 0 };
+	size_t count { 0 };
+	std::array<Pulse, pulses_max> pulses { };
+};
+
+struct Protocol {
+	const char* name;
+	Modulation modulation;
+	Coding coding;
+	uint16_t short_us;
+	uint16_t long_us;
+	uint16_t tolerance_us;
+	uint8_t bits_min;
+	uint8_t bits_max;
+};
+
+/* Timings taken from the devices' datasheets or rtl_433 where available. */
+constexpr std::array<Protocol, 8> protocols { {
+	{ "EV1527",     Modulation::OOK, Coding::PWM,         320,  960, 150, 24, 24 },	// Learning code remotes, doorbells
+	{ "PT2262",     Modulation::OOK, Coding::PWM,         400, 1200, 180, 24, 24 },	// Fixed code remotes (tri-state as bit pairs)
+	{ "HT12E",      Modulation::OOK, Coding::PWM,         550, 1100, 200, 12, 13 },
+	{ "Nexus-TH",   Modulation::OOK, Coding::PPM,        1000, 2000, 300, 36, 36 },	// Weather sensors, also Rubicson/Sencor
+	{ "Prologue",   Modulation::OOK, Coding::PPM,        2000, 4000, 500, 36, 37 },
+	{ "Acurite",    Modulation::OOK, Coding::PWM,         200,  400,  80, 56, 56 },	// 592TXR/609TXC family
+	{ "OOK-Manch",  Modulation::OOK, Coding::Manchester,  500,  500, 150, 32, 128 },	// Oregon Scientific v2.1 class
+	{ "FSK-NRZ",    Modulation::FSK, Coding::NRZ,         100,  100,  30, 32, 128 },	// 10 kbps FSK sensors (TPMS-like, Fine Offset)
+} };
+
+class Record {
+public:
+	void set_timestamp(const Timestamp& value) {
+		timestamp_ = value;
+	}
+
+	Timestamp timestamp() const {
+		return timestamp_;
+	}
+
+	void clear() {
+		bit_count_ = 0;
+		data.fill(0);
+	}
+
+	void add(const bool bit) {
+		if( bit_count_ < bits_max ) {
+			if( bit ) {
+				data[bit_count_ >> 3] |= 0x80 >> (bit_count_ & 7);
+			}
+			bit_count_++;
+		}
+	}
+
+	bool operator[](const size_t index) const {
+		return (index < bit_count_) ? ((data[index >> 3] >> (7 - (index & 7))) & 1) : false;
+	}
+
+	size_t bit_count() const {
+		return bit_count_;
+	}
+
+	uint8_t byte(const size_t index) const {
+		return (index < data.size()) ? data[index] : 0;
+	}
+
+	size_t protocol { 0 };
+
+private:
+	Timestamp timestamp_ { };
+	size_t bit_count_ { 0 };
+	std::array<uint8_t, bits_max / 8> data { };
+};
+
+/* A peak of a pulse or gap width histogram */
+struct Cluster {
+	uint16_t width_us;
+	uint16_t count;
+};
+
+constexpr size_t clusters_max = 4;
+
+using clusters_t = std::array<Cluster, clusters_max>;
+
+/* Timing and coding inferred from the pulse and gap histograms of everything
+ * received since the analyzer was reset.
+ */
+struct PulseAnalysis {
+	Modulation modulation { Modulation::OOK };
+	bool valid { false };
+	Coding coding { Coding::PWM };
+	uint16_t short_us { 0 };
+	uint16_t long_us { 0 };
+	uint16_t pulse_us { 0 };		// PPM only, width of the (constant) pulse
+	uint16_t sync_us { 0 };			// Gap between rows, 0 if none seen
+	uint16_t tolerance_us { 0 };
+	uint32_t trains { 0 };
+	uint32_t pulses { 0 };
+	clusters_t highs { };
+	clusters_t lows { };
+	Record record { };				// Latest row, sliced with the inferred timing
+
+	Protocol protocol() const {
+		return { "Learned", modulation, coding, short_us, long_us, tolerance_us, 8, bits_max };
+	}
+};
+
+} /* namespace ism */
+
+#endif/*__ISM_PACKET_H__*/
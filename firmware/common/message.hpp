@@ -34,12 +34,17 @@
 
 #include "acars_packet.hpp"
 #include "adsb_frame.hpp"
+#include "adsb_traffic.hpp"
 #include "ert_packet.hpp"
 #include "pocsag_packet.hpp"
+#include "flex_packet.hpp"
 #include "aprs_packet.hpp"
 #include "sonde_packet.hpp"
 #include "tpms_packet.hpp"
+#include "ism_packet.hpp"
+#include "mode_classification.hpp"
 #include "jammer.hpp"
+#include "baseband_graph.hpp"
 #include "dsp_fir_taps.hpp"
 #include "dsp_iir.hpp"
 #include "fifo.hpp"
@@ -109,6 +114,27 @@ public:
 		AudioSpectrum = 52,
 		APRSPacket = 53,
 		APRSRxConfigure = 54,
+		BasebandGraphConfigure = 55,
+		ISMPacket = 56,
+		ISMConfigure = 57,
+		PulseAnalysis = 58,
+		ChannelPowerConfigure = 59,
+		ChannelPower = 60,
+		DCSConfigure = 61,
+		DCS = 62,
+		AFSKRxBlock = 63,
+		ADSBTrafficConfigure = 64,
+		CWRxConfigure = 65,
+		CWRx = 66,
+		APTLine = 67,
+		SSTVRxLine = 68,
+		SSTVRxStatus = 69,
+		FLEXPhase = 70,
+		ModeClassifierConfigure = 71,
+		ModeClassification = 72,
+		SquelchConfigure = 73,
+		SquelchEvent = 74,
+		ScriptRequest = 75,
 		MAX
 	};
 
@@ -185,6 +211,313 @@ public:
 	ChannelStatistics statistics;
 };
 
+/* Linear power integrated over channel masks, in dBm once the receive gain
+ * and calibration offset are taken out.
+ */
+struct ChannelPower {
+	static constexpr size_t adjacent_max = 3;
+
+	float channel_dbm { -200.0f };
+	float occupied_bandwidth { 0.0f };		// 99% power bandwidth, Hz
+	float occupied_center { 0.0f };			// Center of the occupied bandwidth, Hz from tuning
+	std::array<float, adjacent_max> acpr_lower_dbc { };
+	std::array<float, adjacent_max> acpr_upper_dbc { };
+	uint32_t adjacent_count { 0 };
+	uint32_t frames { 0 };					// FFT frames averaged into this result
+};
+
+class ChannelPowerConfigureMessage : public Message {
+public:
+	constexpr ChannelPowerConfigureMessage(
+		const uint32_t sampling_rate,
+		const uint32_t channel_bandwidth,
+		const uint32_t channel_spacing,
+		const uint32_t adjacent_count,
+		const uint32_t report_interval_ms,
+		const int32_t frequency_offset,
+		const float gain_db
+	) : Message { ID::ChannelPowerConfigure },
+		sampling_rate { sampling_rate },
+		channel_bandwidth { channel_bandwidth },
+		channel_spacing { channel_spacing },
+		adjacent_count { adjacent_count },
+		report_interval_ms { report_interval_ms },
+		frequency_offset { frequency_offset },
+		gain_db { gain_db }
+	{
+	}
+
+	const uint32_t sampling_rate;		// Baseband rate, measured at 1/8 of it
+	const uint32_t channel_bandwidth;
+	const uint32_t channel_spacing;
+	const uint32_t adjacent_count;
+	const uint32_t report_interval_ms;
+	const int32_t frequency_offset;		// Hz, where the channel really is relative to the tuning frequency
+	const float gain_db;				// Receive gain minus calibration offset, subtracted from dBFS
+};
+
+class ChannelPowerMessage : public Message {
+public:
+	constexpr ChannelPowerMessage(
+		const ChannelPower& power
+	) : Message { ID::ChannelPower },
+		power { power }
+	{
+	}
+
+	ChannelPower power;
+};
+
+class DCSConfigureMessage : public Message {
+public:
+	constexpr DCSConfigureMessage(
+		const bool gate,
+		const uint16_t code,
+		const bool inverted
+	) : Message { ID::DCSConfigure },
+		gate { gate },
+		code { code },
+		inverted { inverted }
+	{
+	}
+
+	const bool gate;		// Only pass audio while this code is received
+	const uint16_t code;
+	const bool inverted;
+};
+
+class DCSMessage : public Message {
+public:
+	constexpr DCSMessage(
+		const uint16_t code,
+		const bool inverted,
+		const uint8_t confidence,
+		const bool gate_open
+	) : Message { ID::DCS },
+		code { code },
+		inverted { inverted },
+		confidence { confidence },
+		gate_open { gate_open }
+	{
+	}
+
+	uint16_t code;			// 0 if nothing decoded lately
+	bool inverted;
+	uint8_t confidence;		// Percentage of the expected words that decoded
+	bool gate_open;
+};
+
+class CWRxConfigureMessage : public Message {
+public:
+	constexpr CWRxConfigureMessage(
+		const bool enabled,
+		const uint32_t pitch
+	) : Message { ID::CWRxConfigure },
+		enabled { enabled },
+		pitch { pitch }
+	{
+	}
+
+	const bool enabled;
+	const uint32_t pitch;	// Audio frequency of the keyed carrier (Hz)
+};
+
+class CWRxMessage : public Message {
+public:
+	constexpr CWRxMessage(
+		const char character,
+		const uint8_t wpm,
+		const bool key
+	) : Message { ID::CWRx },
+		character { character },
+		wpm { wpm },
+		key { key }
+	{
+	}
+
+	char character;			// 0 for a periodic status update
+	uint8_t wpm;			// Current speed estimate
+	bool key;				// Carrier keyed right now
+};
+
+class SquelchConfigureMessage : public Message {
+public:
+	constexpr SquelchConfigureMessage(
+		const uint8_t open_db,
+		const uint8_t hysteresis_db,
+		const uint16_t attack_ms,
+		const uint16_t hang_ms
+	) : Message { ID::SquelchConfigure },
+		open_db { open_db },
+		hysteresis_db { hysteresis_db },
+		attack_ms { attack_ms },
+		hang_ms { hang_ms }
+	{
+	}
+
+	const uint8_t open_db;			// SNR over the noise floor to open, 0 for always open
+	const uint8_t hysteresis_db;	// Closes at open_db - hysteresis_db
+	const uint16_t attack_ms;		// Time over the open threshold before opening
+	const uint16_t hang_ms;			// Time under the close threshold before closing
+};
+
+class SquelchEventMessage : public Message {
+public:
+	constexpr SquelchEventMessage(
+		const bool open,
+		const int16_t snr_db,
+		const int16_t noise_floor_db
+	) : Message { ID::SquelchEvent },
+		open { open },
+		snr_db { snr_db },
+		noise_floor_db { noise_floor_db }
+	{
+	}
+
+	bool open;
+	int16_t snr_db;
+	int16_t noise_floor_db;		// dBFS of the channel
+};
+
+/* From the script thread to the UI thread, which owns the radio and views */
+class ScriptRequestMessage : public Message {
+public:
+	enum class Action : uint8_t {
+		Tune,
+		Mode,
+		Bandwidth,
+		LNA,
+		VGA,
+		Amp,
+		Squelch,
+		RecordStart,
+		RecordStop,
+		DecoderStart,
+		DecoderStop,
+	};
+
+	constexpr ScriptRequestMessage(
+		const Action action,
+		const int64_t value,
+		const uint32_t sequence
+	) : Message { ID::ScriptRequest },
+		action { action },
+		value { value },
+		sequence { sequence }
+	{
+	}
+
+	Action action;
+	int64_t value;
+	uint32_t sequence;		// Matches the completion to the request still waiting
+};
+
+class ModeClassifierConfigureMessage : public Message {
+public:
+	constexpr ModeClassifierConfigureMessage(
+		const bool enabled,
+		const uint32_t dwell_ms
+	) : Message { ID::ModeClassifierConfigure },
+		enabled { enabled },
+		dwell_ms { dwell_ms }
+	{
+	}
+
+	const bool enabled;
+	const uint32_t dwell_ms;	// Time between results, evidence keeps building up
+};
+
+class ModeClassificationMessage : public Message {
+public:
+	constexpr ModeClassificationMessage(
+		const classifier::Result& result
+	) : Message { ID::ModeClassification },
+		result { result }
+	{
+	}
+
+	classifier::Result result;
+};
+
+/* One NOAA APT line: sync A, space A, image A, telemetry A, then the same
+ * for channel B, 4160 words per second.
+ */
+struct APTLine {
+	static constexpr size_t words = 2080;
+
+	uint32_t number { 0 };
+	bool synced { false };
+	std::array<uint8_t, words> data { };
+};
+
+using APTLineFIFO = FIFO<APTLine>;
+
+class APTLineMessage : public Message {
+public:
+	static constexpr size_t fifo_k = 2;
+
+	constexpr APTLineMessage(
+		APTLineFIFO* fifo
+	) : Message { ID::APTLine },
+		fifo { fifo }
+	{
+	}
+
+	APTLineFIFO* fifo { nullptr };
+};
+
+/* One decoded SSTV row, already converted to RGB whatever the mode sends. */
+struct SSTVRxLine {
+	static constexpr size_t width = 320;
+
+	uint16_t row { 0 };
+	std::array<uint8_t, width * 3> rgb { };		// R, G, B for each pixel
+};
+
+using SSTVRxLineFIFO = FIFO<SSTVRxLine>;
+
+class SSTVRxLineMessage : public Message {
+public:
+	static constexpr size_t fifo_k = 2;
+
+	constexpr SSTVRxLineMessage(
+		SSTVRxLineFIFO* fifo
+	) : Message { ID::SSTVRxLine },
+		fifo { fifo }
+	{
+	}
+
+	SSTVRxLineFIFO* fifo { nullptr };
+};
+
+class SSTVRxStatusMessage : public Message {
+public:
+	enum class State : uint8_t {
+		Idle = 0,
+		Receiving,
+		Done,
+		Lost,		// No sync for a while, image abandoned
+	};
+
+	constexpr SSTVRxStatusMessage(
+		const State state,
+		const uint8_t mode,
+		const uint16_t row,
+		const int16_t clock_ppm
+	) : Message { ID::SSTVRxStatus },
+		state { state },
+		mode { mode },
+		row { row },
+		clock_ppm { clock_ppm }
+	{
+	}
+
+	State state;
+	uint8_t mode;			// Index in sstv_modes, from the VIS code
+	uint16_t row;			// Rows received so far
+	int16_t clock_ppm;		// Line rate error measured from the syncs
+};
+
 class DisplayFrameSyncMessage : public Message {
 public:
 	constexpr DisplayFrameSyncMessage(
@@ -344,6 +677,42 @@ public:
 	baseband::Packet packet;
 };
 
+class ISMPacketMessage : public Message {
+public:
+	constexpr ISMPacketMessage(
+		const ism::Record& record
+	) : Message { ID::ISMPacket },
+		record { record }
+	{
+	}
+
+	ism::Record record;
+};
+
+class ISMConfigureMessage : public Message {
+public:
+	constexpr ISMConfigureMessage(
+		const bool analyze
+	) : Message { ID::ISMConfigure },
+		analyze { analyze }
+	{
+	}
+
+	const bool analyze;
+};
+
+class PulseAnalysisMessage : public Message {
+public:
+	constexpr PulseAnalysisMessage(
+		const ism::PulseAnalysis& analysis
+	) : Message { ID::PulseAnalysis },
+		analysis { analysis }
+	{
+	}
+
+	ism::PulseAnalysis analysis;
+};
+
 class POCSAGPacketMessage : public Message {
 public:
 	constexpr POCSAGPacketMessage(
@@ -356,6 +725,25 @@ public:
 	pocsag::POCSAGPacket packet;
 };
 
+using FLEXPhaseFIFO = FIFO<flex::Phase>;
+
+/* A FLEX frame is up to four phases of 88 codewords, they're passed through a
+ * FIFO that holds a whole frame.
+ */
+class FLEXPhaseMessage : public Message {
+public:
+	static constexpr size_t fifo_k = 2;
+
+	constexpr FLEXPhaseMessage(
+		FLEXPhaseFIFO* fifo
+	) : Message { ID::FLEXPhase },
+		fifo { fifo }
+	{
+	}
+
+	FLEXPhaseFIFO* fifo { nullptr };
+};
+
 class ACARSPacketMessage : public Message {
 public:
 	constexpr ACARSPacketMessage(
@@ -398,6 +786,25 @@ public:
 	uint32_t value;
 };
 
+/* New words in shared_memory.bb_data.afsk_rx */
+class AFSKRxBlockMessage : public Message {
+public:
+	constexpr AFSKRxBlockMessage(
+		const uint32_t count,
+		const uint32_t dropped,
+		const bool frame_end
+	) : Message { ID::AFSKRxBlock },
+		count { count },
+		dropped { dropped },
+		frame_end { frame_end }
+	{
+	}
+	
+	uint32_t count;
+	uint32_t dropped;		// Total words lost to a full ring since configure
+	bool frame_end;			// Line went idle after the last word
+};
+
 class CodedSquelchMessage : public Message {
 public:
 	constexpr CodedSquelchMessage(
@@ -479,8 +886,7 @@ public:
 		const size_t channel_decimation,
 		const size_t deviation,
 		const iir_biquad_config_t audio_hpf_config,
-		const iir_biquad_config_t audio_deemph_config,
-		const uint8_t squelch_level
+		const iir_biquad_config_t audio_deemph_config
 	) : Message { ID::NBFMConfigure },
 		decim_0_filter(decim_0_filter),
 		decim_1_filter(decim_1_filter),
@@ -488,8 +894,7 @@ public:
 		channel_decimation { channel_decimation },
 		deviation { deviation },
 		audio_hpf_config(audio_hpf_config),
-		audio_deemph_config(audio_deemph_config),
-		squelch_level(squelch_level)
+		audio_deemph_config(audio_deemph_config)
 	{
 	}
 
@@ -500,7 +905,6 @@ public:
 	const size_t deviation;
 	const iir_biquad_config_t audio_hpf_config;
 	const iir_biquad_config_t audio_deemph_config;
-	const uint8_t squelch_level;
 };
 
 class WFMConfigureMessage : public Message {
@@ -798,22 +1202,19 @@ public:
 	constexpr TonesConfigureMessage(
 		const uint32_t fm_delta,
 		const uint32_t pre_silence,
-		const uint16_t tone_count,
-		const bool dual_tone,
+		const bool run,
 		const bool audio_out
 	) : Message { ID::TonesConfigure },
 		fm_delta(fm_delta),
 		pre_silence(pre_silence),
-		tone_count(tone_count),
-		dual_tone(dual_tone),
+		run(run),
 		audio_out(audio_out)
 	{
 	}
 
-	const uint32_t fm_delta;
-	const uint32_t pre_silence;
-	const uint16_t tone_count;
-	const bool dual_tone;
+	const uint32_t fm_delta;		// Bandwidth, full scale deviates by about 0.45 times this
+	const uint32_t pre_silence;		// Samples
+	const bool run;					// Commands are read from shared_memory.bb_data.tones
 	const bool audio_out;
 };
 
@@ -903,17 +1304,26 @@ public:
 	constexpr SigGenConfigMessage(
 		const uint32_t bw,
 		const uint32_t shape,
-		const uint32_t duration
+		const uint32_t duration,
+		const uint32_t sweep_period,
+		const bool awgn,
+		const int32_t snr_db
 	) : Message { ID::SigGenConfig },
 		bw(bw),
 		shape(shape),
-		duration(duration)
+		duration(duration),
+		sweep_period(sweep_period),
+		awgn(awgn),
+		snr_db(snr_db)
 	{
 	}
 
-	const uint32_t bw;
+	const uint32_t bw;				// FM deviation or sweep span, Hz
 	const uint32_t shape;
-	const uint32_t duration;
+	const uint32_t duration;		// Samples, 0 for no auto-off
+	const uint32_t sweep_period;	// Samples
+	const bool awgn;
+	const int32_t snr_db;
 };
 
 class SigGenToneMessage : public Message {
@@ -1045,6 +1455,31 @@ public:
 	const uint32_t test;
 };
 
+/* Starts the ADS-B traffic generator: the given aircraft, plus traffic_count
+ * random ones within traffic_radius_nm of it. An empty aircraft.squitters and
+ * no traffic stops transmission.
+ */
+class ADSBTrafficConfigureMessage : public Message {
+public:
+	constexpr ADSBTrafficConfigureMessage(
+		const adsb::AircraftConfig& aircraft,
+		const uint32_t traffic_count,
+		const uint32_t traffic_radius_nm,
+		const uint32_t seed
+	) : Message { ID::ADSBTrafficConfigure },
+		aircraft(aircraft),
+		traffic_count(traffic_count),
+		traffic_radius_nm(traffic_radius_nm),
+		seed(seed)
+	{
+	}
+
+	const adsb::AircraftConfig aircraft;
+	const uint32_t traffic_count;
+	const uint32_t traffic_radius_nm;
+	const uint32_t seed;
+};
+
 class JammerConfigureMessage : public Message {
 public:
 	constexpr JammerConfigureMessage(
@@ -1137,4 +1572,37 @@ public:
 	uint32_t return_code;
 };
 
+class BasebandGraphConfigureMessage : public Message {
+public:
+	constexpr BasebandGraphConfigureMessage(
+		const baseband::graph::stages_t& stages,
+		const uint32_t baseband_fs,
+		const fir_taps_real<24> decim_0_filter,
+		const fir_taps_real<32> decim_1_filter,
+		const fir_taps_real<32> channel_filter,
+		const iir_biquad_config_t audio_hpf_config,
+		const iir_biquad_config_t audio_deemph_config,
+		const uint8_t squelch_level
+	) : Message { ID::BasebandGraphConfigure },
+		stages(stages),
+		baseband_fs(baseband_fs),
+		decim_0_filter(decim_0_filter),
+		decim_1_filter(decim_1_filter),
+		channel_filter(channel_filter),
+		audio_hpf_config(audio_hpf_config),
+		audio_deemph_config(audio_deemph_config),
+		squelch_level(squelch_level)
+	{
+	}
+
+	const baseband::graph::stages_t stages;
+	const uint32_t baseband_fs;		// As set on the receiver model
+	const fir_taps_real<24> decim_0_filter;
+	const fir_taps_real<32> decim_1_filter;
+	const fir_taps_real<32> channel_filter;
+	const iir_biquad_config_t audio_hpf_config;
+	const iir_biquad_config_t audio_deemph_config;
+	const uint8_t squelch_level;
+};
+
 #endif/*__MESSAGE_H__*/
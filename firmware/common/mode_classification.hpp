@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __MODE_CLASSIFICATION_H__
+#define __MODE_CLASSIFICATION_H__
+
+#include <cstdint>
+#include <cstddef>
+
+namespace classifier {
+
+enum class Mode : uint8_t {
+	Unknown = 0,	// Noise, or nothing conclusive yet
+	Carrier,		// Little or no FM: unmodulated, AM or CW
+	AnalogFM,
+	FSK2,			// Symbol clock found, no known sync word
+	FSK4,
+	DMR,
+	P25,
+	NXDN,
+	dPMR,
+	DSTAR,
+	POCSAG,
+	AIS,
+	APRS,
+};
+
+struct Result {
+	Mode mode { Mode::Unknown };
+	uint8_t confidence { 0 };		// 0 to 100
+	uint16_t symbol_rate { 0 };		// 0 for analog modes
+};
+
+inline const char* mode_name(const Mode mode) {
+	switch(mode) {
+	case Mode::Carrier:		return "Carrier/AM";
+	case Mode::AnalogFM:	return "Analog FM";
+	case Mode::FSK2:		return "2FSK";
+	case Mode::FSK4:		return "4FSK";
+	case Mode::DMR:			return "DMR";
+	case Mode::P25:			return "P25";
+	case Mode::NXDN:		return "NXDN";
+	case Mode::dPMR:		return "dPMR";
+	case Mode::DSTAR:		return "D-STAR";
+	case Mode::POCSAG:		return "POCSAG";
+	case Mode::AIS:			return "AIS";
+	case Mode::APRS:		return "APRS";
+	default:				return "Unknown";
+	}
+}
+
+} /* namespace classifier */
+
+#endif/*__MODE_CLASSIFICATION_H__*/
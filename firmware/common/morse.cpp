@@ -36,14 +36,14 @@ size_t morse_encode(std::string& message, const uint32_t time_unit_ms,
 	
 	size_t i, c;
 	uint16_t code, code_size;
-	uint8_t morse_message[256];
+	uint8_t * const morse_message = baseband::tones_message();
 	uint32_t delta;
 	
 	*time_units = 0;
 	
 	i = 0;
 	for (char& ch : message) {
-		if (i > 256) return 0;						// Message too long
+		if (i + 16 > baseband::tones_message_max) return 0;	// Message too long
 		
 		if ((ch >= 'a') && (ch <= 'z'))				// Make uppercase
 			ch -= 32;
@@ -73,8 +73,6 @@ size_t morse_encode(std::string& message, const uint32_t time_unit_ms,
 		*time_units += morse_symbols[morse_message[c]];
 	}
 	
-	memcpy(shared_memory.bb_data.tones_data.message, morse_message, i);
-	
 	// Setup tone "symbols"
 	for (c = 0; c < 5; c++) {
 		if (c < 2)
@@ -21,6 +21,10 @@
 
 #include "png_writer.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
 static constexpr std::array<uint8_t, 8> png_file_header { {
 	0x89, 0x50, 0x4e, 0x47,
 	0x0d, 0x0a, 0x1a, 0x0a,
@@ -49,6 +53,28 @@ static constexpr std::array<uint8_t, 12> png_iend { {
 	0xae, 0x42, 0x60, 0x82,		// CRC
 } };
 
+namespace {
+
+uint32_t residual(const int v) {
+	return std::abs(static_cast<int8_t>(v));
+}
+
+uint8_t paeth_predictor(const uint8_t a, const uint8_t b, const uint8_t c) {
+	const int p = a + b - c;
+	const int pa = std::abs(p - a);
+	const int pb = std::abs(p - b);
+	const int pc = std::abs(p - c);
+	if( (pa <= pb) && (pa <= pc) ) {
+		return a;
+	} else if( pb <= pc ) {
+		return b;
+	} else {
+		return c;
+	}
+}
+
+} /* namespace */
+
 Optional<File::Error> PNGWriter::create(
 	const std::filesystem::path& filename
 ) {
@@ -59,49 +85,101 @@ Optional<File::Error> PNGWriter::create(
 
 	file.write(png_file_header);
 	file.write(png_ihdr_screen_capture);
-	
-	write_chunk_header(
-		2 + height * (5 + 1 + width * 3) + 4,
-		png_idat_chunk_type
-	);
 
 	constexpr std::array<uint8_t, 2> zlib_header { 0x78, 0x01 };	// Zlib CM, CINFO, FLG.
-	write_chunk_content(zlib_header);
+	write_idat(zlib_header.data(), zlib_header.size());
 
 	return { };
 }
 
 PNGWriter::~PNGWriter() {
-	write_chunk_content(adler_32.bytes());
-	write_chunk_crc();
+	deflate.finish();
+	const auto adler_bytes = adler_32.bytes();
+	write_idat(adler_bytes.data(), adler_bytes.size());
+	flush_idat();
 
 	file.write(png_iend);
 }
 
 void PNGWriter::write_scanline(const std::array<ui::ColorRGB888, 240>& scanline) {
-	constexpr uint8_t scanline_filter_type = 0;
-	constexpr uint32_t deflate_block_length = 1 + sizeof(scanline);
-
-	const std::array<uint8_t, 6> deflate_and_scanline_header {
-		static_cast<uint8_t>((scanline_count == (height - 1)) ? 0x01 : 0x00),	// DEFLATE header bits, bfinal=0, btype=00
-		static_cast<uint8_t>((deflate_block_length >> 0) & 0xff),			// Length LSB
-		static_cast<uint8_t>((deflate_block_length >> 8) & 0xff),			// Length MSB
-		static_cast<uint8_t>((deflate_block_length >> 0) & 0xff) ^ 0xff,	// ~Length LSB
-		static_cast<uint8_t>((deflate_block_length >> 8) & 0xff) ^ 0xff,	// ~Length MSB
-		scanline_filter_type,
-	};
-	write_chunk_content(deflate_and_scanline_header);
-
-	adler_32.feed(scanline_filter_type);
-	adler_32.feed(scanline);
-
-	// Small writes to avoid some sort of large-transfer plus block
-	// boundary FatFs or SDC driver bug?
-	write_chunk_content(&scanline[  0], 80 * sizeof(ui::ColorRGB888));
-	write_chunk_content(&scanline[ 80], 80 * sizeof(ui::ColorRGB888));
-	write_chunk_content(&scanline[160], 80 * sizeof(ui::ColorRGB888));
-
-	scanline_count++;
+	const auto raw = reinterpret_cast<const uint8_t*>(scanline.data());
+
+	apply_filter(choose_filter(raw), raw);
+	adler_32.feed(filtered);
+	deflate.write(filtered.data(), filtered.size());
+
+	memcpy(prior.data(), raw, prior.size());
+}
+
+/* Minimum sum of absolute differences heuristic, from the PNG specification */
+PNGWriter::Filter PNGWriter::choose_filter(const uint8_t* const raw) const {
+	constexpr size_t bpp = sizeof(ui::ColorRGB888);
+
+	std::array<uint32_t, 5> cost { };
+	for(size_t i=0; i<scanline_bytes; i++) {
+		const uint8_t x = raw[i];
+		const uint8_t a = (i >= bpp) ? raw[i - bpp] : 0;
+		const uint8_t b = prior[i];
+		const uint8_t c = (i >= bpp) ? prior[i - bpp] : 0;
+
+		cost[0] += residual(x);
+		cost[1] += residual(x - a);
+		cost[2] += residual(x - b);
+		cost[3] += residual(x - ((a + b) >> 1));
+		cost[4] += residual(x - paeth_predictor(a, b, c));
+	}
+
+	return static_cast<Filter>(std::min_element(cost.begin(), cost.end()) - cost.begin());
+}
+
+void PNGWriter::apply_filter(const Filter filter, const uint8_t* const raw) {
+	constexpr size_t bpp = sizeof(ui::ColorRGB888);
+
+	filtered[0] = static_cast<uint8_t>(filter);
+	uint8_t* const out = &filtered[1];
+
+	for(size_t i=0; i<scanline_bytes; i++) {
+		const uint8_t a = (i >= bpp) ? raw[i - bpp] : 0;
+		const uint8_t b = prior[i];
+		const uint8_t c = (i >= bpp) ? prior[i - bpp] : 0;
+
+		switch(filter) {
+		case Filter::Sub:		out[i] = raw[i] - a;						break;
+		case Filter::Up:		out[i] = raw[i] - b;						break;
+		case Filter::Average:	out[i] = raw[i] - ((a + b) >> 1);			break;
+		case Filter::Paeth:		out[i] = raw[i] - paeth_predictor(a, b, c);	break;
+		default:				out[i] = raw[i];							break;
+		}
+	}
+}
+
+void PNGWriter::write_idat(const void* const p, const size_t count) {
+	auto src = reinterpret_cast<const uint8_t*>(p);
+	size_t remaining = count;
+
+	while( remaining ) {
+		const auto n = std::min(remaining, idat.size() - idat_count);
+		memcpy(&idat[idat_count], src, n);
+		idat_count += n;
+		src += n;
+		remaining -= n;
+
+		if( idat_count == idat.size() ) {
+			flush_idat();
+		}
+	}
+}
+
+void PNGWriter::flush_idat() {
+	if( idat_count == 0 ) {
+		return;
+	}
+
+	// Chunk sized writes also stay clear of the FatFs/SDC large transfer issue
+	write_chunk_header(idat_count, png_idat_chunk_type);
+	write_chunk_content(idat.data(), idat_count);
+	write_chunk_crc();
+	idat_count = 0;
 }
 
 void PNGWriter::write_chunk_header(
@@ -30,7 +30,13 @@
 #include "ui.hpp"
 #include "file.hpp"
 #include "crc.hpp"
+#include "deflate.hpp"
 
+/* Each scanline gets the PNG filter with the smallest sum of absolute
+ * residuals, then goes through the deflate compressor. The compressed stream
+ * is split into fixed size IDAT chunks, so nothing needs to be known up front.
+ * About 5KB of state, allocate on the heap rather than the UI stack.
+ */
 class PNGWriter {
 public:
 	~PNGWriter();
@@ -44,10 +50,30 @@ private:
 	static constexpr int width { 240 };
 	static constexpr int height { 320 };
 
+	static constexpr size_t scanline_bytes { width * sizeof(ui::ColorRGB888) };
+
+	enum class Filter : uint8_t {
+		None = 0,
+		Sub = 1,
+		Up = 2,
+		Average = 3,
+		Paeth = 4,
+	};
+
 	File file { };
-	int scanline_count { 0 };
-	CRC<32, true, true> crc { 0x04c11db7, 0xffffffff, 0xffffffff };
+	CRC<32, 0x04c11db7, true, true> crc { 0xffffffff, 0xffffffff };
 	Adler32 adler_32 { };
+	std::array<uint8_t, scanline_bytes> prior { };
+	std::array<uint8_t, 1 + scanline_bytes> filtered { };
+	std::array<uint8_t, 512> idat { };
+	size_t idat_count { 0 };
+	Deflate deflate { [this](const uint8_t* const p, const size_t count) { this->write_idat(p, count); } };
+
+	Filter choose_filter(const uint8_t* const raw) const;
+	void apply_filter(const Filter filter, const uint8_t* const raw);
+
+	void write_idat(const void* const p, const size_t count);
+	void flush_idat();
 
 	void write_chunk_header(const size_t length, const std::array<uint8_t, 4>& type);
 	void write_chunk_content(const void* const p, const size_t count);
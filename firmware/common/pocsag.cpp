@@ -316,7 +316,7 @@ void setupecc()
 
 // -------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------
-inline int errorCorrection(uint32_t * val)
+int errorCorrection(uint32_t * val)
 {
 	// Set up the tables the first time
 	if (eccSetup == 0)
@@ -82,6 +82,10 @@ void pocsag_encode(const MessageType type, BCHCode& BCH_code, const uint32_t fun
 					const uint32_t address, std::vector<uint32_t>& codewords);
 void pocsag_decode_batch(const POCSAGPacket& batch, POCSAGState * const state);
 
+// BCH(31,21) with even parity, also used by FLEX. Returns the number of bit
+// errors corrected, 3 if there were too many.
+int errorCorrection(uint32_t * val);
+
 } /* namespace pocsag */
 
 #endif/*__POCSAG_H__*/
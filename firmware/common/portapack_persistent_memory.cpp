@@ -98,6 +98,11 @@ struct data_t {
 
 	// Hardware
 	uint32_t hardware_config;
+
+	// Reference drift against temperature
+	uint32_t drift_magic;
+	uint32_t drift_compensation;
+	drift::Curve drift_curve;
 };
 
 static_assert(sizeof(data_t) <= backup_ram.size(), "Persistent memory structure too large for VBAT-maintained region");
@@ -121,7 +126,7 @@ ppb_t correction_ppb() {
 void set_correction_ppb(const ppb_t new_value) {
 	const auto clipped_value = ppb_range.clip(new_value);
 	data->correction_ppb = clipped_value;
-	portapack::clock_manager.set_reference_ppb(clipped_value);
+	portapack::clock_manager.set_reference_ppb(clipped_value + portapack::drift_compensator.drift_ppb());
 }
 
 static constexpr uint32_t touch_calibration_magic = 0x074af82f;
@@ -138,6 +143,36 @@ const touch::Calibration& touch_calibration() {
 	return data->touch_calibration;
 }
 
+static constexpr uint32_t drift_magic = 0x5d1f7c3a;
+
+static void drift_reset_if_invalid() {
+	if( data->drift_magic != drift_magic ) {
+		data->drift_compensation = 0;
+		data->drift_curve.clear();
+		data->drift_magic = drift_magic;
+	}
+}
+
+bool drift_compensation() {
+	drift_reset_if_invalid();
+	return data->drift_compensation != 0;
+}
+
+void set_drift_compensation(const bool v) {
+	drift_reset_if_invalid();
+	data->drift_compensation = v ? 1 : 0;
+}
+
+const drift::Curve& drift_curve() {
+	drift_reset_if_invalid();
+	return data->drift_curve;
+}
+
+void set_drift_curve(const drift::Curve& new_value) {
+	drift_reset_if_invalid();
+	data->drift_curve = new_value;
+}
+
 int32_t tone_mix() {
 	tone_mix_range.reset_if_outside(data->tone_mix, tone_mix_reset_value);
 	return data->tone_mix;
@@ -202,10 +237,15 @@ void set_serial_format(const serial_format_t new_value) {
 
 // ui_config is an uint32_t var storing information bitwise
 // bits 0-2 store the backlight timer
+// bit 3 store the camera button mode, screenshot (0) or screen recording (1)
 // bits 4-19 (16 bits) store the clkout frequency
 // bits 21-31 store the different single bit configs depicted below
 // bit 20 store the display state of the gui return icon, hidden (0) or shown (1)
 
+bool camera_records_video() { // status bar camera starts/stops a screen recording
+	return data->ui_config & (1 << 3);
+}
+
 bool show_gui_return_icon(){ // add return icon in touchscreen menue
 return data->ui_config & (1 << 20);
 }
@@ -262,6 +302,10 @@ uint32_t config_backlight_timer() {
 	return timer_seconds[data->ui_config & 7]; //first three bits, 8 possible values
 }
 
+void set_camera_records_video(bool v) {
+	data->ui_config = (data->ui_config & ~(1 << 3)) | (v << 3);
+}
+
 void set_gui_return_icon(bool v) {
 	data->ui_config = (data->ui_config & ~(1 << 20)) | (v << 20);
 }
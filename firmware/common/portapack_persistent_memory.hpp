@@ -29,6 +29,7 @@
 #include "touch.hpp"
 #include "modems.hpp"
 #include "serializer.hpp"
+#include "drift_curve.hpp"
 
 using namespace modems;
 using namespace serializer;
@@ -47,6 +48,11 @@ void set_correction_ppb(const ppb_t new_value);
 void set_touch_calibration(const touch::Calibration& new_value);
 const touch::Calibration& touch_calibration();
 
+bool drift_compensation();
+void set_drift_compensation(const bool v);
+const drift::Curve& drift_curve();
+void set_drift_curve(const drift::Curve& new_value);
+
 serial_format_t serial_format();
 void set_serial_format(const serial_format_t new_value);
 
@@ -88,6 +94,7 @@ bool config_login();
 bool config_speaker();
 uint32_t config_backlight_timer();
 bool disable_touchscreen();
+bool camera_records_video();
 
 void set_gui_return_icon(bool v);
 void set_load_app_settings(bool v);
@@ -100,6 +107,7 @@ void set_config_login(bool v);
 void set_config_speaker(bool v); 
 void set_config_backlight_timer(uint32_t i);
 void set_disable_touchscreen(bool v);
+void set_camera_records_video(bool v);
 
 //uint8_t ui_config_textentry();
 //void set_config_textentry(uint8_t new_value);
@@ -35,15 +35,44 @@ struct JammerChannel {
 	uint32_t duration;
 };
 
-struct ToneDef {
-	uint32_t delta;
-	uint32_t duration;
+/* One step of a tone sequence for proc_tones. Tones stay phase continuous from
+ * one command to the next, ramps only shape starts from and stops to silence.
+ */
+struct ToneCommand {
+	uint32_t delta_a;		// Phase increments at 1536000Hz
+	uint32_t delta_b;
+	uint16_t amplitude_a;	// Q15, 0 for no tone
+	uint16_t amplitude_b;
+	uint32_t duration;		// Samples of tone
+	uint32_t silence;		// Samples of silence after the tone
+	uint32_t ramp;			// Samples, raised cosine
 };
-	
-struct ToneData {
-	ToneDef tone_defs[32];
-	uint32_t silence;
-	uint8_t message[256];
+
+/* Commands for proc_tones. Only the M0 moves write_index and sets closed, only
+ * the M4 moves read_index (a run TonesConfigure empties the ring by catching it
+ * up). Indexes run freely and wrap modulo size.
+ */
+struct ToneRing {
+	static constexpr size_t size = 16;
+
+	volatile uint32_t write_index;
+	volatile uint32_t read_index;
+	volatile uint32_t closed;		// No more commands will follow
+	ToneCommand commands[size];
+};
+
+/* Words decoded by proc_afskrx. Only the M4 moves write_index and only the M0
+ * moves read_index (baseband::set_afsk() empties the ring by catching it up),
+ * so the ring needs no lock, only barriers. Indexes run freely and wrap
+ * modulo size.
+ */
+struct AFSKRxRing {
+	static constexpr size_t size = 128;
+
+	volatile uint32_t write_index;
+	volatile uint32_t read_index;
+	volatile uint32_t dropped;
+	uint16_t words[size];
 };
 
 /* NOTE: These structures must be located in the same location in both M4 and M0 binaries */
@@ -60,12 +89,16 @@ struct SharedMemory {
 	char m4_panic_msg[32] { 0 };
 	
 	union {
-		ToneData tones_data;
+		ToneRing tones;
 		JammerChannel jammer_channels[24];
+		AFSKRxRing afsk_rx;
 		uint8_t data[512];
-	} bb_data { { { { 0, 0 } }, 0, { 0 } } };
+	} bb_data { { 0, 0, 0, { } } };
 };
 
+static_assert(sizeof(ToneRing) <= 512, "ToneRing doesn't fit bb_data");
+static_assert(sizeof(AFSKRxRing) <= 512, "AFSKRxRing doesn't fit bb_data");
+
 extern SharedMemory& shared_memory;
 
 #endif/*__PORTAPACK_SHARED_MEMORY_H__*/
@@ -80,14 +80,18 @@ constexpr image_tag_t image_tag_afsk_rx				{ 'P', 'A', 'F', 'R' };
 constexpr image_tag_t image_tag_aprs_rx				{ 'P', 'A', 'P', 'R' };
 constexpr image_tag_t image_tag_btle_rx				{ 'P', 'B', 'T', 'R' };
 constexpr image_tag_t image_tag_nrf_rx				{ 'P', 'N', 'R', 'R' };
-constexpr image_tag_t image_tag_ais					{ 'P', 'A', 'I', 'S' };
 constexpr image_tag_t image_tag_am_audio			{ 'P', 'A', 'M', 'A' };
 constexpr image_tag_t image_tag_am_tv			        { 'P', 'A', 'M', 'T' };
+constexpr image_tag_t image_tag_apt_rx				{ 'P', 'A', 'P', 'T' };
 constexpr image_tag_t image_tag_capture				{ 'P', 'C', 'A', 'P' };
+constexpr image_tag_t image_tag_channel_power		{ 'P', 'C', 'P', 'W' };
 constexpr image_tag_t image_tag_ert					{ 'P', 'E', 'R', 'T' };
 constexpr image_tag_t image_tag_nfm_audio			{ 'P', 'N', 'F', 'M' };
+constexpr image_tag_t image_tag_graph				{ 'P', 'G', 'R', 'F' };
+constexpr image_tag_t image_tag_ism					{ 'P', 'I', 'S', 'M' };
 constexpr image_tag_t image_tag_pocsag				{ 'P', 'P', 'O', 'C' };
 constexpr image_tag_t image_tag_sonde				{ 'P', 'S', 'O', 'N' };
+constexpr image_tag_t image_tag_sstv_rx				{ 'P', 'S', 'R', 'X' };
 constexpr image_tag_t image_tag_tpms				{ 'P', 'T', 'P', 'M' };
 constexpr image_tag_t image_tag_wfm_audio			{ 'P', 'W', 'F', 'M' };
 constexpr image_tag_t image_tag_wideband_spectrum	{ 'P', 'S', 'P', 'E' };
@@ -41,7 +41,7 @@ enum sstv_color_seq {
 	SSTV_COLOR_YUV		// Not supported for now
 };
 
-#define SSTV_MODES_NB 6
+#define SSTV_MODES_NB 8
 
 // From http://www.graphics.stanford.edu/~seander/bithacks.html, nice !
 constexpr inline uint8_t sstv_parity(uint8_t code) {
@@ -69,24 +69,32 @@ struct sstv_mode {
 	sstv_color_seq color_sequence;
 	uint16_t pixels;
 	uint16_t lines;
-	uint32_t samples_per_pixel;
+	float pixel_ms;
 	bool sync_on_first;
 	uint8_t sync_index;
 	bool gaps;
-	uint32_t samples_per_sync;
-	uint32_t samples_per_gap;
+	float sync_ms;
+	float gap_ms;
 	//std::pair<uint16_t, uint16_t> luma_range;
+
+	// Truncated to the transmitter's rate, the receiver works from the times
+	constexpr uint32_t samples_per_pixel() const { return SSTV_MS2S(pixel_ms); }
+	constexpr uint32_t samples_per_sync() const { return SSTV_MS2S(sync_ms); }
+	constexpr uint32_t samples_per_gap() const { return SSTV_MS2S(gap_ms); }
 };
 
 constexpr sstv_mode sstv_modes[SSTV_MODES_NB] = {
-	{ "Scottie 1", 	sstv_parity(60),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S(0.4320),	true, 2, true, SSTV_MS2S(9), SSTV_MS2S(1.5) },
-	{ "Scottie 2", 	sstv_parity(56),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S(0.2752),	true, 2, true, SSTV_MS2S(9), SSTV_MS2S(1.5) },
-	{ "Scottie DX",	sstv_parity(76),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S(1.08), 	true, 2, true, SSTV_MS2S(9), SSTV_MS2S(1.5) },
-	{ "Martin 1",	sstv_parity(44),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S(0.4576),	false, 0, true, SSTV_MS2S(4.862), SSTV_MS2S(0.572) },
-	{ "Martin 2",	sstv_parity(40),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S(0.2288),	false, 0, true, SSTV_MS2S(4.862), SSTV_MS2S(0.572) },
-	{ "SC2-180",	sstv_parity(55),	true, SSTV_COLOR_RGB, 320, 256, SSTV_MS2S(0.7344), 	false, 0, false, SSTV_MS2S(5.5225), SSTV_MS2S(0.5) },
-	//{ "PASOKON 3",	sstv_parity(113),	true, SSTV_COLOR_RGB, 640, 496, SSTV_MS2S(0.2083), 	{ 1500, 2300 } },
-	//{ "PASOKON 7",	sstv_parity(115),	true, SSTV_COLOR_RGB, 640, 496, SSTV_MS2S(0.4167), 	{ 1500, 2300 } }
+	{ "Scottie 1", 	sstv_parity(60),	true, SSTV_COLOR_GBR, 320, 256, 0.4320f,	true, 2, true, 9.0f, 1.5f },
+	{ "Scottie 2", 	sstv_parity(56),	true, SSTV_COLOR_GBR, 320, 256, 0.2752f,	true, 2, true, 9.0f, 1.5f },
+	{ "Scottie DX",	sstv_parity(76),	true, SSTV_COLOR_GBR, 320, 256, 1.08f, 	true, 2, true, 9.0f, 1.5f },
+	{ "Martin 1",	sstv_parity(44),	true, SSTV_COLOR_GBR, 320, 256, 0.4576f,	false, 0, true, 4.862f, 0.572f },
+	{ "Martin 2",	sstv_parity(40),	true, SSTV_COLOR_GBR, 320, 256, 0.2288f,	false, 0, true, 4.862f, 0.572f },
+	{ "SC2-180",	sstv_parity(55),	true, SSTV_COLOR_RGB, 320, 256, 0.7344f, 	false, 0, false, 5.5225f, 0.5f },
+	// Receive only. Pixel time is for luminance, chrominance runs twice as fast
+	{ "Robot 36",	sstv_parity(8),		true, SSTV_COLOR_YUV, 320, 240, 0.275f,	false, 0, true, 9.0f, 3.0f },
+	{ "Robot 72",	sstv_parity(12),	true, SSTV_COLOR_YUV, 320, 240, 0.43125f,	false, 0, true, 9.0f, 3.0f },
+	//{ "PASOKON 3",	sstv_parity(113),	true, SSTV_COLOR_RGB, 640, 496, 0.2083f, 	{ 1500, 2300 } },
+	//{ "PASOKON 7",	sstv_parity(115),	true, SSTV_COLOR_RGB, 640, 496, 0.4167f, 	{ 1500, 2300 } }
 };
 
 } /* namespace sstv */
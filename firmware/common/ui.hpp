@@ -335,10 +335,15 @@ struct TouchEvent {
 		Start = 0,
 		Move = 1,
 		End = 2,
+		Drag = 3,		// Moved past the slop, delta = motion since the last Drag
+		Swipe = 4,		// Released while dragging fast, delta = velocity in pixels per 100ms
+		LongPress = 5,	// Held still, fired once
+		Zoom = 6,		// Dragged after a LongPress, delta = motion since the last Zoom
 	};
 
 	Point point;
 	Type type;
+	Point delta { };
 };
 
 Point polar_to_point(float angle, uint32_t distance);
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+
+#
+# Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Converts a screen recording (REC_xxxx.PSR, see application/screen_recorder.hpp)
+# to a video through ffmpeg, or to a sequence of PNG files.
+#
+#   scr2video.py REC_0001.PSR rec.mp4
+#   scr2video.py --png frames/ REC_0001.PSR
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import zlib
+
+def read_frames(path):
+	with open(path, 'rb') as f:
+		data = f.read()
+
+	magic, version, pixel_format, width, height = struct.unpack_from('<4sBBHH', data, 0)
+	if magic != b'PPSR' or version != 1 or pixel_format != 1:
+		raise ValueError('%s: not a PortaPack screen recording' % path)
+
+	offset = 12
+	frames = []
+	while offset + 12 <= len(data):
+		time_ms, rect_count, _, payload_size = struct.unpack_from('<IHHI', data, offset)
+		offset += 12
+		payload = data[offset:offset + payload_size]
+		offset += payload_size
+		# Recording cut short (card removed, power lost). The length is patched in
+		# after the payload, a frame cut off while being written still says 0.
+		if payload_size == 0 or len(payload) < payload_size:
+			break
+
+		rects = []
+		try:
+			raw = zlib.decompress(payload, -15)
+			p = 0
+			for _ in range(rect_count):
+				x, y, w, h = struct.unpack_from('<HHHH', raw, p)
+				p += 8
+				if p + w * h * 2 > len(raw):
+					raise ValueError('short rectangle')
+				rects.append((x, y, w, h, raw[p:p + w * h * 2]))
+				p += w * h * 2
+		except (zlib.error, struct.error, ValueError):
+			print('Frame %d is damaged, stopping there' % len(frames), file=sys.stderr)
+			break
+		frames.append((time_ms, rects))
+
+	return width, height, frames
+
+def apply_rects(screen, width, rects):
+	for x, y, w, h, pixels in rects:
+		for row in range(h):
+			line = bytearray(w * 3)
+			for i, (v,) in enumerate(struct.iter_unpack('<H', pixels[row * w * 2:(row + 1) * w * 2])):
+				r = (v >> 11) & 0x1f
+				g = (v >> 5) & 0x3f
+				b = v & 0x1f
+				line[i * 3 + 0] = (r << 3) | (r >> 2)
+				line[i * 3 + 1] = (g << 2) | (g >> 4)
+				line[i * 3 + 2] = (b << 3) | (b >> 2)
+			start = ((y + row) * width + x) * 3
+			screen[start:start + w * 3] = line
+
+def png_bytes(screen, width, height):
+	def chunk(kind, content):
+		crc = zlib.crc32(kind + content) & 0xffffffff
+		return struct.pack('>I', len(content)) + kind + content + struct.pack('>I', crc)
+
+	stride = width * 3
+	raw = b''.join(b'\x00' + bytes(screen[y * stride:(y + 1) * stride]) for y in range(height))
+	return (b'\x89PNG\r\n\x1a\n' +
+		chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 2, 0, 0, 0)) +
+		chunk(b'IDAT', zlib.compress(raw, 9)) +
+		chunk(b'IEND', b''))
+
+def main():
+	parser = argparse.ArgumentParser(description='Convert a PortaPack screen recording to video')
+	parser.add_argument('recording')
+	parser.add_argument('output', nargs='?', help='video file, encoded by ffmpeg')
+	parser.add_argument('--fps', type=int, default=10, help='output frame rate (default 10)')
+	parser.add_argument('--png', metavar='DIR', help='write one PNG per output frame instead')
+	args = parser.parse_args()
+
+	if not args.output and not args.png:
+		parser.error('give an output video file or --png DIR')
+
+	width, height, frames = read_frames(args.recording)
+	if not frames:
+		print('No frames in recording')
+		return 1
+
+	if args.png:
+		os.makedirs(args.png, exist_ok=True)
+		sink = None
+	else:
+		sink = subprocess.Popen([
+			'ffmpeg', '-y', '-loglevel', 'error',
+			'-f', 'rawvideo', '-pix_fmt', 'rgb24', '-s', '%dx%d' % (width, height), '-r', str(args.fps),
+			'-i', '-', '-pix_fmt', 'yuv420p', args.output
+		], stdin=subprocess.PIPE)
+
+	# Frames are only stored when the screen changed, repeat them to get a constant rate
+	screen = bytearray(width * height * 3)
+	period_ms = 1000.0 / args.fps
+	count = 0
+	for index, (time_ms, rects) in enumerate(frames):
+		apply_rects(screen, width, rects)
+		end_ms = frames[index + 1][0] if index + 1 < len(frames) else time_ms + period_ms
+		while count * period_ms < end_ms:
+			if sink:
+				sink.stdin.write(screen)
+			else:
+				with open(os.path.join(args.png, 'frame_%05d.png' % count), 'wb') as f:
+					f.write(png_bytes(screen, width, height))
+			count += 1
+
+	if sink:
+		sink.stdin.close()
+		sink.wait()
+
+	print('%d recorded frames, %d output frames, %.1f s' % (len(frames), count, count * period_ms / 1000.0))
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main())